@@ -0,0 +1,1123 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../src/Assets/Compression.h"
+
+// Benchmark and fuzz harness for the Compression decoders. It needs no game data: it builds a
+// corpus of synthetic images and voxel maps, encodes them with small encoders for each
+// format, and checks that the decoders give the same bytes as the original element-by-element
+// decoders (kept below as a reference) on both valid and corrupted streams. Then it reports
+// decode throughput for both.
+
+namespace
+{
+	const int DEFAULT_ITERATIONS = 40;
+	const int DEFAULT_FUZZ_CASES = 20000;
+	const unsigned int DEFAULT_SEED = 1;
+
+	// Timed rounds per codec. Rounds alternate between the reference and new decoders so
+	// clock and cache drift affect both alike, and the fastest round of each is reported,
+	// since interference from other processes only ever slows a round down.
+	const int MEASURE_ROUNDS = 15;
+
+	// The decoders before they were rewritten around raw pointers, used as the expected output.
+	// The only change is that type 8 takes a stop size and returns where it stopped, since the
+	// original ran past the end of 'out' on a back-reference that overflowed it.
+	namespace Reference
+	{
+		const std::array<uint8_t, 256> highOffsetBits{
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+			0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+			0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+			0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,
+			0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07,
+			0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09,
+			0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B,
+			0x0C, 0x0C, 0x0C, 0x0C, 0x0D, 0x0D, 0x0D, 0x0D, 0x0E, 0x0E, 0x0E, 0x0E, 0x0F, 0x0F, 0x0F, 0x0F,
+			0x10, 0x10, 0x10, 0x10, 0x11, 0x11, 0x11, 0x11, 0x12, 0x12, 0x12, 0x12, 0x13, 0x13, 0x13, 0x13,
+			0x14, 0x14, 0x14, 0x14, 0x15, 0x15, 0x15, 0x15, 0x16, 0x16, 0x16, 0x16, 0x17, 0x17, 0x17, 0x17,
+			0x18, 0x18, 0x19, 0x19, 0x1A, 0x1A, 0x1B, 0x1B, 0x1C, 0x1C, 0x1D, 0x1D, 0x1E, 0x1E, 0x1F, 0x1F,
+			0x20, 0x20, 0x21, 0x21, 0x22, 0x22, 0x23, 0x23, 0x24, 0x24, 0x25, 0x25, 0x26, 0x26, 0x27, 0x27,
+			0x28, 0x28, 0x29, 0x29, 0x2A, 0x2A, 0x2B, 0x2B, 0x2C, 0x2C, 0x2D, 0x2D, 0x2E, 0x2E, 0x2F, 0x2F,
+			0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F
+		};
+		const std::array<uint8_t, 256> lowOffsetBitCount{
+			0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+			0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+			0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+			0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+			0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+			0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,
+			0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,
+			0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,
+			0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,
+			0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06,
+			0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06,
+			0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06,
+			0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07,
+			0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07,
+			0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07,
+			0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08
+		};
+
+		uint16_t getLE16(const uint8_t *buf)
+		{
+			return static_cast<uint16_t>(buf[0] | (buf[1] << 8));
+		}
+
+		void decodeRLE(const uint8_t *src, int stopCount, std::vector<uint8_t> &out)
+		{
+			int i = 0;
+			int o = 0;
+
+			while (o < stopCount)
+			{
+				const uint8_t sample = src[i];
+				src++;
+
+				if ((sample & 0x80) != 0)
+				{
+					const uint8_t value = src[i];
+					src++;
+
+					const uint32_t count = static_cast<uint32_t>(sample) - 0x7F;
+
+					for (uint32_t j = 0; j < count; j++)
+					{
+						out.at(o) = value;
+						o++;
+					}
+				}
+				else
+				{
+					const uint32_t count = static_cast<uint32_t>(sample) + 1;
+
+					for (uint32_t j = 0; j < count; j++)
+					{
+						out.at(o) = src[i];
+						o++;
+						i++;
+					}
+				}
+			}
+		}
+
+		void decodeRLEWords(const uint8_t *src, int stopCount, std::vector<uint8_t> &out)
+		{
+			int i = 0;
+			int o = 0;
+
+			while (o < stopCount)
+			{
+				const int16_t sample = getLE16(src + i);
+				i += 2;
+
+				if (sample > 0)
+				{
+					for (int16_t j = 0; j < sample; j++)
+					{
+						const uint16_t value = getLE16(src + i);
+						i += 2;
+
+						out.at(o * 2) = value & 0x00FF;
+						out.at((o * 2) + 1) = (value & 0xFF00) >> 8;
+						o++;
+					}
+				}
+				else
+				{
+					const uint16_t value = getLE16(src + i);
+					i += 2;
+
+					const uint16_t count = -sample;
+
+					for (uint16_t j = 0; j < count; j++)
+					{
+						out.at(o * 2) = value & 0x00FF;
+						out.at((o * 2) + 1) = (value & 0xFF00) >> 8;
+						o++;
+					}
+				}
+			}
+		}
+
+		void decodeType04(const uint8_t *src, const uint8_t *srcend, std::vector<uint8_t> &out)
+		{
+			auto dst = out.begin();
+
+			std::array<uint8_t, 4096> history;
+			history.fill(0x20);
+			int historypos = 0;
+
+			int bitcount = 0;
+			int mask = 0;
+			while (src != srcend)
+			{
+				if (!bitcount)
+				{
+					bitcount = 8;
+					mask = *(src++);
+				}
+				else
+				{
+					mask >>= 1;
+				}
+
+				if ((mask & 1))
+				{
+					if (src == srcend)
+					{
+						throw std::runtime_error("Unexpected end of image.");
+					}
+
+					if (dst == out.end())
+					{
+						throw std::runtime_error("Decoded image overflow.");
+					}
+
+					history[historypos++ & 0x0FFF] = *src;
+					*(dst++) = *(src++);
+				}
+				else
+				{
+					if (std::distance(src, srcend) < 2)
+					{
+						throw std::runtime_error("Unexpected end of image.");
+					}
+
+					uint8_t byte1 = *(src++);
+					uint8_t byte2 = *(src++);
+					int tocopy = (byte2 & 0x0F) + 3;
+					int copypos = (((byte2 & 0xF0) << 4) | byte1) + 18;
+
+					if (std::distance(dst, out.end()) < tocopy)
+					{
+						throw std::runtime_error("Decoded image overflow.");
+					}
+
+					for (int i = 0; i < tocopy; i++)
+					{
+						*dst = history[copypos++ & 0x0FFF];
+						history[historypos++ & 0x0FFF] = *(dst++);
+					}
+				}
+
+				bitcount--;
+			}
+
+			std::fill(dst, out.end(), 0);
+		}
+
+		// 'out' must have room for one maximum-length copy past 'stopSize'.
+		size_t decodeType08(const uint8_t *src, const uint8_t *srcend, std::vector<uint8_t> &out,
+			size_t stopSize)
+		{
+			std::array<uint8_t, 4096> history;
+			history.fill(0x20);
+			int historypos = 0;
+
+			std::array<uint16_t, 941> NodeIdxMap;
+			std::iota(NodeIdxMap.begin(), NodeIdxMap.begin() + 626, 0);
+			std::for_each(NodeIdxMap.begin(), NodeIdxMap.begin() + 626,
+				[](uint16_t &val) { val = (val >> 1) + 314; }
+			);
+
+			NodeIdxMap[626] = 0;
+			std::iota(NodeIdxMap.begin() + 627, NodeIdxMap.end(), 0);
+
+			std::array<uint16_t, 627> NodeTree;
+			std::iota(NodeTree.begin(), NodeTree.begin() + 314, 627);
+			std::iota(NodeTree.begin() + 314, NodeTree.end(), 0);
+			std::for_each(NodeTree.begin() + 314, NodeTree.end(),
+				[](uint16_t &val) { val *= 2; }
+			);
+
+			std::array<uint16_t, 627> NodeFreq;
+			std::fill(NodeFreq.begin(), NodeFreq.begin() + 314, 1);
+			{
+				auto iter = NodeFreq.begin();
+				std::for_each(NodeFreq.begin() + 314, NodeFreq.begin() + 627,
+					[&iter](uint16_t &val)
+				{
+					val = *(iter++);
+					val += *(iter++);
+				});
+			}
+
+			uint16_t bitmask = 0;
+			uint8_t validbits = 0;
+
+			auto dst = out.begin();
+			while (dst < (out.begin() + stopSize))
+			{
+				uint16_t node = NodeTree[626];
+				while (node < 627)
+				{
+					while (validbits < 9)
+					{
+						if (src != srcend)
+						{
+							bitmask |= *(src++) << (8 - validbits);
+						}
+
+						validbits += 8;
+					}
+
+					node = NodeTree.at(node + ((bitmask >> 15) & 1));
+					bitmask <<= 1;
+					validbits--;
+				}
+
+				uint16_t freqidx = NodeIdxMap.at(node);
+				do {
+					NodeFreq.at(freqidx) += 1;
+					uint16_t freq = NodeFreq[freqidx];
+					uint16_t nextidx = freqidx + 1;
+					if (nextidx < NodeFreq.size() && NodeFreq[nextidx] < freq)
+					{
+						do {
+							nextidx++;
+						} while (nextidx < NodeFreq.size() && NodeFreq[nextidx] < freq);
+						nextidx--;
+
+						NodeFreq[freqidx] = NodeFreq[nextidx];
+						NodeFreq[nextidx] = freq;
+
+						std::iter_swap(NodeTree.begin() + freqidx, NodeTree.begin() + nextidx);
+
+						uint16_t mapidx = NodeTree[nextidx];
+						NodeIdxMap.at(mapidx) = nextidx;
+						if (mapidx < 627)
+						{
+							NodeIdxMap[mapidx + 1] = nextidx;
+						}
+
+						mapidx = NodeTree[freqidx];
+						NodeIdxMap.at(mapidx) = freqidx;
+						if (mapidx < 627)
+						{
+							NodeIdxMap[mapidx + 1] = freqidx;
+						}
+
+						freqidx = nextidx;
+					}
+					freqidx = NodeIdxMap[freqidx];
+				} while (freqidx != 0);
+
+				uint16_t codeword = node - 627;
+				if (codeword < 256)
+				{
+					uint8_t codewordByte = static_cast<uint8_t>(codeword);
+					history[historypos++ & 0x0FFF] = codewordByte;
+					*(dst++) = codewordByte;
+				}
+				else
+				{
+					while (validbits < 9)
+					{
+						if (src != srcend)
+						{
+							bitmask |= *(src++) << (8 - validbits);
+						}
+
+						validbits += 8;
+					}
+
+					uint8_t tableidx = bitmask >> 8;
+					bitmask <<= 8;
+					validbits -= 8;
+
+					uint16_t offsetHigh = highOffsetBits[tableidx] << 6;
+					uint16_t bitcount = lowOffsetBitCount[tableidx] - 2;
+					uint16_t offsetLow = tableidx;
+					for (uint16_t i = 0; i < bitcount; i++)
+					{
+						while (validbits < 9)
+						{
+							if (src != srcend)
+							{
+								bitmask |= *(src++) << (8 - validbits);
+							}
+
+							validbits += 8;
+						}
+
+						offsetLow = (offsetLow << 1) | ((bitmask >> 15) & 1);
+						bitmask <<= 1;
+						validbits--;
+					}
+
+					uint16_t copypos = historypos - (offsetHigh | (offsetLow & 0x003F)) - 1;
+					uint16_t tocopy = codeword - 256 + 3;
+					for (uint16_t i = 0; i < tocopy; i++)
+					{
+						*dst = history[copypos++ & 0x0FFF];
+						history[historypos++ & 0x0FFF] = *(dst++);
+					}
+				}
+			}
+
+			return static_cast<size_t>(std::distance(out.begin(), dst));
+		}
+	}
+
+	// Greedy LZ match finder shared by the type 4 and type 8 encoders. Only matches inside the
+	// real data, so the decoders' initial window fill is left to the fuzzer.
+	class MatchFinder
+	{
+	private:
+		static const int HASH_SIZE = 1 << 14;
+		static const int MAX_CANDIDATES = 32;
+
+		const std::vector<uint8_t> &data;
+		std::vector<int> head, prev;
+
+		static int hash(const uint8_t *ptr)
+		{
+			return ((ptr[0] << 10) ^ (ptr[1] << 5) ^ ptr[2]) & (HASH_SIZE - 1);
+		}
+	public:
+		MatchFinder(const std::vector<uint8_t> &data)
+			: data(data), head(HASH_SIZE, -1), prev(data.size(), -1) { }
+
+		// Adds position 'pos' and returns the longest earlier match (length 0 if none).
+		int find(int pos, int maxDistance, int maxLength, int &distance)
+		{
+			const int size = static_cast<int>(this->data.size());
+			int bestLength = 0;
+			if ((pos + 3) <= size)
+			{
+				const int h = MatchFinder::hash(this->data.data() + pos);
+				const int limit = std::min(maxLength, size - pos);
+				int candidate = this->head[h];
+				for (int i = 0; (i < MAX_CANDIDATES) && (candidate >= 0) &&
+					((pos - candidate) <= maxDistance); i++)
+				{
+					int length = 0;
+					while ((length < limit) &&
+						(this->data[candidate + length] == this->data[pos + length]))
+					{
+						length++;
+					}
+
+					if (length > bestLength)
+					{
+						bestLength = length;
+						distance = pos - candidate;
+					}
+
+					candidate = this->prev[candidate];
+				}
+
+				this->prev[pos] = this->head[h];
+				this->head[h] = pos;
+			}
+
+			return bestLength;
+		}
+	};
+
+	std::vector<uint8_t> encodeRLE(const std::vector<uint8_t> &data)
+	{
+		std::vector<uint8_t> encoded;
+		size_t i = 0;
+		while (i < data.size())
+		{
+			size_t run = 1;
+			while (((i + run) < data.size()) && (run < 128) && (data[i + run] == data[i]))
+			{
+				run++;
+			}
+
+			if (run >= 3)
+			{
+				encoded.push_back(static_cast<uint8_t>(0x7F + run));
+				encoded.push_back(data[i]);
+				i += run;
+			}
+			else
+			{
+				// Literals until the next run of three.
+				size_t count = 0;
+				while (((i + count) < data.size()) && (count < 128) &&
+					!(((i + count + 2) < data.size()) && (data[i + count] == data[i + count + 1]) &&
+					(data[i + count] == data[i + count + 2])))
+				{
+					count++;
+				}
+
+				count = std::max<size_t>(count, 1);
+				encoded.push_back(static_cast<uint8_t>(count - 1));
+				encoded.insert(encoded.end(), data.begin() + i, data.begin() + i + count);
+				i += count;
+			}
+		}
+
+		return encoded;
+	}
+
+	std::vector<uint8_t> encodeRLEWords(const std::vector<uint8_t> &data)
+	{
+		const size_t wordCount = data.size() / 2;
+		auto word = [&data](size_t i) { return data[i * 2] | (data[(i * 2) + 1] << 8); };
+
+		std::vector<uint8_t> encoded;
+		auto pushWord = [&encoded](int value)
+		{
+			encoded.push_back(value & 0xFF);
+			encoded.push_back((value >> 8) & 0xFF);
+		};
+
+		size_t i = 0;
+		while (i < wordCount)
+		{
+			size_t run = 1;
+			while (((i + run) < wordCount) && (run < 32768) && (word(i + run) == word(i)))
+			{
+				run++;
+			}
+
+			if (run >= 2)
+			{
+				pushWord(-static_cast<int>(run));
+				pushWord(word(i));
+				i += run;
+			}
+			else
+			{
+				size_t count = 1;
+				while (((i + count) < wordCount) && (count < 32767) &&
+					!(((i + count + 1) < wordCount) && (word(i + count) == word(i + count + 1))))
+				{
+					count++;
+				}
+
+				pushWord(static_cast<int>(count));
+				for (size_t j = 0; j < count; j++)
+				{
+					pushWord(word(i + j));
+				}
+
+				i += count;
+			}
+		}
+
+		return encoded;
+	}
+
+	std::vector<uint8_t> encodeType04(const std::vector<uint8_t> &data)
+	{
+		std::vector<uint8_t> encoded;
+		MatchFinder matchFinder(data);
+
+		size_t maskIndex = 0;
+		int bit = 8;
+		int pos = 0;
+		const int size = static_cast<int>(data.size());
+		while (pos < size)
+		{
+			if (bit == 8)
+			{
+				maskIndex = encoded.size();
+				encoded.push_back(0);
+				bit = 0;
+			}
+
+			int distance = 0;
+			const int length = matchFinder.find(pos, 4096, 18, distance);
+			if (length >= 3)
+			{
+				// Absolute ring position of the source, stored minus 18.
+				const int field = ((pos - distance) - 18) & 0x0FFF;
+				encoded.push_back(field & 0xFF);
+				encoded.push_back(((field >> 4) & 0xF0) | (length - 3));
+
+				for (int i = 1; i < length; i++)
+				{
+					int unused;
+					matchFinder.find(pos + i, 4096, 18, unused);
+				}
+
+				pos += length;
+			}
+			else
+			{
+				encoded[maskIndex] |= 1 << bit;
+				encoded.push_back(data[pos]);
+				pos++;
+			}
+
+			bit++;
+		}
+
+		return encoded;
+	}
+
+	// Adaptive Huffman model for the type 8 encoder. The update has to match the decoder's
+	// exactly, so it follows the reference decoder line for line.
+	struct Type08Model
+	{
+		std::array<uint16_t, 941> NodeIdxMap;
+		std::array<uint16_t, 627> NodeTree;
+		std::array<uint16_t, 627> NodeFreq;
+
+		Type08Model()
+		{
+			std::iota(NodeIdxMap.begin(), NodeIdxMap.begin() + 626, 0);
+			std::for_each(NodeIdxMap.begin(), NodeIdxMap.begin() + 626,
+				[](uint16_t &val) { val = (val >> 1) + 314; });
+			NodeIdxMap[626] = 0;
+			std::iota(NodeIdxMap.begin() + 627, NodeIdxMap.end(), 0);
+
+			std::iota(NodeTree.begin(), NodeTree.begin() + 314, 627);
+			std::iota(NodeTree.begin() + 314, NodeTree.end(), 0);
+			std::for_each(NodeTree.begin() + 314, NodeTree.end(), [](uint16_t &val) { val *= 2; });
+
+			std::fill(NodeFreq.begin(), NodeFreq.begin() + 314, 1);
+			for (int i = 314; i < 627; i++)
+			{
+				NodeFreq[i] = NodeFreq[(i - 314) * 2] + NodeFreq[((i - 314) * 2) + 1];
+			}
+		}
+
+		// Gets the root-to-leaf bits for a symbol, first bit first.
+		void getCode(int symbol, std::vector<int> &bits) const
+		{
+			bits.clear();
+			int pos = NodeIdxMap[627 + symbol];
+			while (pos != 626)
+			{
+				bits.push_back(pos & 1);
+				pos = NodeIdxMap[pos];
+			}
+
+			std::reverse(bits.begin(), bits.end());
+		}
+
+		void update(int symbol)
+		{
+			uint16_t freqidx = NodeIdxMap[627 + symbol];
+			do {
+				NodeFreq[freqidx] += 1;
+				uint16_t freq = NodeFreq[freqidx];
+				uint16_t nextidx = freqidx + 1;
+				if (nextidx < NodeFreq.size() && NodeFreq[nextidx] < freq)
+				{
+					do {
+						nextidx++;
+					} while (nextidx < NodeFreq.size() && NodeFreq[nextidx] < freq);
+					nextidx--;
+
+					NodeFreq[freqidx] = NodeFreq[nextidx];
+					NodeFreq[nextidx] = freq;
+					std::swap(NodeTree[freqidx], NodeTree[nextidx]);
+
+					uint16_t mapidx = NodeTree[nextidx];
+					NodeIdxMap[mapidx] = nextidx;
+					if (mapidx < 627)
+					{
+						NodeIdxMap[mapidx + 1] = nextidx;
+					}
+
+					mapidx = NodeTree[freqidx];
+					NodeIdxMap[mapidx] = freqidx;
+					if (mapidx < 627)
+					{
+						NodeIdxMap[mapidx + 1] = freqidx;
+					}
+
+					freqidx = nextidx;
+				}
+				freqidx = NodeIdxMap[freqidx];
+			} while (freqidx != 0);
+		}
+	};
+
+	std::vector<uint8_t> encodeType08(const std::vector<uint8_t> &data)
+	{
+		std::vector<uint8_t> encoded;
+		int bitPos = 0;
+		auto putBits = [&encoded, &bitPos](uint32_t value, int count)
+		{
+			for (int i = count - 1; i >= 0; i--)
+			{
+				if ((bitPos & 7) == 0)
+				{
+					encoded.push_back(0);
+				}
+
+				encoded.back() |= ((value >> i) & 1) << (7 - (bitPos & 7));
+				bitPos++;
+			}
+		};
+
+		// Prefix code for the top 6 bits of a match position, from the decoder's tables.
+		std::array<int, 64> prefixCodes, prefixLengths;
+		for (int i = 255; i >= 0; i--)
+		{
+			const int high = Reference::highOffsetBits[i];
+			prefixLengths[high] = Reference::lowOffsetBitCount[i];
+			prefixCodes[high] = i >> (8 - prefixLengths[high]);
+		}
+
+		Type08Model model;
+		MatchFinder matchFinder(data);
+		std::vector<int> bits;
+
+		int pos = 0;
+		const int size = static_cast<int>(data.size());
+		while (pos < size)
+		{
+			int distance = 0;
+			const int length = matchFinder.find(pos, 4096, 60, distance);
+			const int symbol = (length >= 3) ? (256 + length - 3) : data[pos];
+
+			model.getCode(symbol, bits);
+			for (int bit : bits)
+			{
+				putBits(bit, 1);
+			}
+
+			model.update(symbol);
+
+			if (length >= 3)
+			{
+				const int position = distance - 1;
+				const int high = position >> 6;
+				putBits(prefixCodes[high], prefixLengths[high]);
+				putBits(position & 0x3F, 6);
+
+				for (int i = 1; i < length; i++)
+				{
+					int unused;
+					matchFinder.find(pos + i, 4096, 60, unused);
+				}
+
+				pos += length;
+			}
+			else
+			{
+				pos++;
+			}
+		}
+
+		return encoded;
+	}
+
+	enum class Codec { RLE, RLEWords, Type04, Type08 };
+
+	const char *getCodecName(Codec codec)
+	{
+		switch (codec)
+		{
+		case Codec::RLE:
+			return "RLE";
+		case Codec::RLEWords:
+			return "RLE words";
+		case Codec::Type04:
+			return "Type 4";
+		default:
+			return "Type 8";
+		}
+	}
+
+	std::vector<uint8_t> encode(Codec codec, const std::vector<uint8_t> &data)
+	{
+		switch (codec)
+		{
+		case Codec::RLE:
+			return encodeRLE(data);
+		case Codec::RLEWords:
+			return encodeRLEWords(data);
+		case Codec::Type04:
+			return encodeType04(data);
+		default:
+			return encodeType08(data);
+		}
+	}
+
+	// RLE streams carry no length, so corrupted ones can run on past their end. Pad with 0xFF
+	// (a one-word or 128-byte repeat, so decoding always makes progress) well beyond what
+	// either decoder can read.
+	std::vector<uint8_t> padRLE(const std::vector<uint8_t> &encoded, size_t decodedSize)
+	{
+		std::vector<uint8_t> padded = encoded;
+		padded.resize(encoded.size() + (decodedSize * 4) + 256, 0xFF);
+		return padded;
+	}
+
+	// Decodes with the reference or the new decoder. Returns false if decoding threw.
+	bool decode(Codec codec, bool reference, const std::vector<uint8_t> &src,
+		size_t decodedSize, std::vector<uint8_t> &out)
+	{
+		try
+		{
+			const uint8_t *begin = src.data();
+			const uint8_t *end = begin + src.size();
+			const int stopCount = static_cast<int>(decodedSize);
+			if (codec == Codec::RLE)
+			{
+				out.assign(decodedSize, 0);
+				reference ? Reference::decodeRLE(begin, stopCount, out) :
+					Compression::decodeRLE(begin, stopCount, out);
+			}
+			else if (codec == Codec::RLEWords)
+			{
+				out.assign(decodedSize, 0);
+				reference ? Reference::decodeRLEWords(begin, stopCount / 2, out) :
+					Compression::decodeRLEWords(begin, stopCount / 2, out);
+			}
+			else if (codec == Codec::Type04)
+			{
+				out.assign(decodedSize, 0);
+				reference ? Reference::decodeType04(begin, end, out) :
+					Compression::decodeType04(begin, end, out);
+			}
+			else if (reference)
+			{
+				// Room for the overflowing copy the original decoder would write.
+				out.assign(decodedSize + 64, 0);
+				const size_t stop = Reference::decodeType08(begin, end, out, decodedSize);
+				out.resize(decodedSize);
+				if (stop != decodedSize)
+				{
+					return false;
+				}
+			}
+			else
+			{
+				out.assign(decodedSize, 0);
+				Compression::decodeType08(begin, end, out);
+			}
+		}
+		catch (const std::exception&)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	struct CorpusEntry
+	{
+		std::string name;
+		Codec codec;
+		std::vector<uint8_t> decoded, encoded;
+	};
+
+	// Synthetic stand-ins for Arena's assets: palette-indexed images of a few kinds, and
+	// 16-bit voxel maps.
+	std::vector<uint8_t> makeImage(int width, int height, int kind, std::mt19937 &rng)
+	{
+		std::vector<uint8_t> pixels(width * height);
+		std::uniform_int_distribution<int> noise(0, 255);
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				uint8_t &pixel = pixels[x + (y * width)];
+				if (kind == 0)
+				{
+					// Brick wall: mortar lines and a little noise in each brick.
+					const bool mortar = ((y % 8) == 0) || (((x + ((y / 8) % 2) * 8) % 16) == 0);
+					pixel = mortar ? 20 : static_cast<uint8_t>(100 + (noise(rng) % 4));
+				}
+				else if (kind == 1)
+				{
+					// Sprite: transparent background around a shaded disc.
+					const int dx = x - (width / 2);
+					const int dy = y - (height / 2);
+					const int r = std::min(width, height) / 2 - 2;
+					pixel = ((dx * dx) + (dy * dy) < (r * r)) ?
+						static_cast<uint8_t>(60 + ((dx + dy) / 8)) : 0;
+				}
+				else if (kind == 2)
+				{
+					// Full-screen backdrop: vertical gradient bands with dithering.
+					pixel = static_cast<uint8_t>(((y * 16) / height) + ((x + y) % 2) * 16);
+				}
+				else
+				{
+					pixel = static_cast<uint8_t>(noise(rng));
+				}
+			}
+		}
+
+		return pixels;
+	}
+
+	std::vector<uint8_t> makeVoxelMap(int width, int depth, std::mt19937 &rng)
+	{
+		std::vector<uint8_t> bytes(width * depth * 2);
+		std::uniform_int_distribution<int> chance(0, 99);
+		for (int i = 0; i < (width * depth); i++)
+		{
+			const int x = i % width;
+			const int z = i / width;
+			uint16_t voxel = 0;
+			if ((x == 0) || (z == 0) || (x == (width - 1)) || (z == (depth - 1)) ||
+				(((x % 6) == 0) && (chance(rng) < 70)))
+			{
+				voxel = 0x0808;
+			}
+			else if (chance(rng) < 3)
+			{
+				voxel = 0xA020 | static_cast<uint16_t>(chance(rng) % 8);
+			}
+
+			bytes[i * 2] = voxel & 0xFF;
+			bytes[(i * 2) + 1] = voxel >> 8;
+		}
+
+		return bytes;
+	}
+
+	std::vector<CorpusEntry> makeCorpus(std::mt19937 &rng)
+	{
+		struct Source
+		{
+			std::string name;
+			std::vector<uint8_t> data;
+			bool words;
+		};
+
+		std::vector<Source> sources =
+		{
+			{ "wall 64x64", makeImage(64, 64, 0, rng), false },
+			{ "sprite 48x72", makeImage(48, 72, 1, rng), false },
+			{ "screen 320x200", makeImage(320, 200, 2, rng), false },
+			{ "noise 64x64", makeImage(64, 64, 3, rng), false },
+			{ "voxels 64x64", makeVoxelMap(64, 64, rng), true },
+			{ "voxels 128x128", makeVoxelMap(128, 128, rng), true }
+		};
+
+		std::vector<CorpusEntry> corpus;
+		for (const Source &source : sources)
+		{
+			std::vector<Codec> codecs = { Codec::Type04, Codec::Type08 };
+			codecs.push_back(source.words ? Codec::RLEWords : Codec::RLE);
+
+			for (Codec codec : codecs)
+			{
+				CorpusEntry entry;
+				entry.name = source.name;
+				entry.codec = codec;
+				entry.decoded = source.data;
+				entry.encoded = encode(codec, source.data);
+				if ((codec == Codec::RLE) || (codec == Codec::RLEWords))
+				{
+					entry.encoded = padRLE(entry.encoded, entry.decoded.size());
+				}
+
+				corpus.push_back(std::move(entry));
+			}
+		}
+
+		return corpus;
+	}
+
+	// Checks that both decoders reproduce every corpus entry. Returns the number of failures.
+	int checkCorpus(const std::vector<CorpusEntry> &corpus)
+	{
+		int failures = 0;
+		std::vector<uint8_t> expected, actual;
+		for (const CorpusEntry &entry : corpus)
+		{
+			const bool referenceOk = decode(entry.codec, true, entry.encoded,
+				entry.decoded.size(), expected);
+			const bool ok = decode(entry.codec, false, entry.encoded, entry.decoded.size(), actual);
+			if (!referenceOk || !ok || (expected != entry.decoded) || (actual != entry.decoded))
+			{
+				std::printf("FAIL round trip: %s, %s\n", entry.name.c_str(),
+					getCodecName(entry.codec));
+				failures++;
+			}
+		}
+
+		return failures;
+	}
+
+	// Decodes corrupted corpus streams with both decoders. They must agree on whether the
+	// stream is valid and, if it is, on every output byte. Returns the number of failures.
+	int fuzz(const std::vector<CorpusEntry> &corpus, int caseCount, std::mt19937 &rng)
+	{
+		int failures = 0;
+		std::vector<uint8_t> expected, actual;
+		for (int i = 0; i < caseCount; i++)
+		{
+			const CorpusEntry &entry = corpus[rng() % corpus.size()];
+			const bool isRLE = (entry.codec == Codec::RLE) || (entry.codec == Codec::RLEWords);
+			std::vector<uint8_t> stream = entry.encoded;
+
+			// Random byte changes, sometimes lots; then maybe cut the stream short.
+			const int changes = 1 + static_cast<int>(rng() % ((rng() % 8) == 0 ? 256 : 8));
+			const size_t mutableSize = isRLE ?
+				(stream.size() - (entry.decoded.size() * 4) - 256) : stream.size();
+			for (int j = 0; (j < changes) && (mutableSize > 0); j++)
+			{
+				stream[rng() % mutableSize] = static_cast<uint8_t>(rng());
+			}
+
+			if (!isRLE && ((rng() % 4) == 0))
+			{
+				stream.resize(rng() % (stream.size() + 1));
+			}
+
+			// Sometimes decode into a different size than the stream was made for.
+			size_t decodedSize = entry.decoded.size();
+			if ((rng() % 8) == 0)
+			{
+				decodedSize = (decodedSize / 2) + (rng() % decodedSize);
+				decodedSize &= ~static_cast<size_t>(1);
+			}
+
+			const bool referenceOk = decode(entry.codec, true, stream, decodedSize, expected);
+			const bool ok = decode(entry.codec, false, stream, decodedSize, actual);
+			if ((referenceOk != ok) || (ok && (expected != actual)))
+			{
+				if (failures < 10)
+				{
+					std::printf("FAIL fuzz case %d: %s, %s (reference %s, new %s)\n", i,
+						entry.name.c_str(), getCodecName(entry.codec),
+						referenceOk ? "ok" : "threw", ok ? "ok" : "threw");
+				}
+
+				failures++;
+			}
+		}
+
+		return failures;
+	}
+
+	// Returns decoded megabytes per second over all corpus entries of one codec.
+	double measureOnce(const std::vector<CorpusEntry> &corpus, Codec codec, bool reference,
+		int iterations)
+	{
+		std::vector<uint8_t> out;
+		size_t totalBytes = 0;
+		const auto startTime = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++)
+		{
+			for (const CorpusEntry &entry : corpus)
+			{
+				if (entry.codec == codec)
+				{
+					decode(codec, reference, entry.encoded, entry.decoded.size(), out);
+					totalBytes += out.size();
+				}
+			}
+		}
+
+		const double seconds = std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - startTime).count();
+		return (static_cast<double>(totalBytes) / (1024.0 * 1024.0)) / seconds;
+	}
+
+	// Returns the best speed of the reference and new decoders over several rounds.
+	std::pair<double, double> measure(const std::vector<CorpusEntry> &corpus, Codec codec,
+		int iterations)
+	{
+		double referenceSpeed = 0.0;
+		double speed = 0.0;
+		for (int i = 0; i < MEASURE_ROUNDS; i++)
+		{
+			referenceSpeed = std::max(referenceSpeed, measureOnce(corpus, codec, true, iterations));
+			speed = std::max(speed, measureOnce(corpus, codec, false, iterations));
+		}
+
+		return std::make_pair(referenceSpeed, speed);
+	}
+
+	void printUsage(const char *programName)
+	{
+		std::printf("Usage: %s [--iterations N] [--fuzz N] [--seed N]\n"
+			"  --iterations  decode passes over the corpus per codec and round (default: %d)\n"
+			"  --fuzz        corrupted streams to cross-check (default: %d)\n"
+			"  --seed        random seed for the corpus and fuzzing (default: %u)\n",
+			programName, DEFAULT_ITERATIONS, DEFAULT_FUZZ_CASES, DEFAULT_SEED);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int iterations = DEFAULT_ITERATIONS;
+	int fuzzCases = DEFAULT_FUZZ_CASES;
+	unsigned int seed = DEFAULT_SEED;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		const bool hasValue = (i + 1) < argc;
+		if ((arg == "--iterations") && hasValue)
+		{
+			iterations = std::atoi(argv[++i]);
+		}
+		else if ((arg == "--fuzz") && hasValue)
+		{
+			fuzzCases = std::atoi(argv[++i]);
+		}
+		else if ((arg == "--seed") && hasValue)
+		{
+			seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else
+		{
+			printUsage(argv[0]);
+			return (arg == "--help") ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if ((iterations < 0) || (fuzzCases < 0))
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	std::mt19937 rng(seed);
+	const std::vector<CorpusEntry> corpus = makeCorpus(rng);
+
+	std::printf("%-16s %-10s %9s %9s %7s\n", "corpus", "codec", "decoded", "encoded", "ratio");
+	for (const CorpusEntry &entry : corpus)
+	{
+		const bool isRLE = (entry.codec == Codec::RLE) || (entry.codec == Codec::RLEWords);
+		const size_t encodedSize = isRLE ?
+			(entry.encoded.size() - (entry.decoded.size() * 4) - 256) : entry.encoded.size();
+		std::printf("%-16s %-10s %9zu %9zu %7.3f\n", entry.name.c_str(),
+			getCodecName(entry.codec), entry.decoded.size(), encodedSize,
+			static_cast<double>(encodedSize) / static_cast<double>(entry.decoded.size()));
+	}
+
+	int failures = checkCorpus(corpus);
+	const int fuzzFailures = fuzz(corpus, fuzzCases, rng);
+	std::printf("\nRound trips: %s. Fuzz: %d cases, %d mismatches.\n",
+		(failures == 0) ? "all identical" : "FAILED", fuzzCases, fuzzFailures);
+	failures += fuzzFailures;
+
+	if (iterations > 0)
+	{
+		std::printf("\n%-10s %12s %12s %8s\n", "codec", "ref MB/s", "new MB/s", "speedup");
+		for (Codec codec : { Codec::RLE, Codec::RLEWords, Codec::Type04, Codec::Type08 })
+		{
+			const std::pair<double, double> result = measure(corpus, codec, iterations);
+			const double referenceSpeed = result.first;
+			const double speed = result.second;
+			std::printf("%-10s %12.1f %12.1f %7.2fx\n", getCodecName(codec),
+				referenceSpeed, speed, speed / referenceSpeed);
+		}
+	}
+
+	return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
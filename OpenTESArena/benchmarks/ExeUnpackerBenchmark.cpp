@@ -0,0 +1,767 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/Assets/ExeUnpacker.h"
+
+// Benchmark and fuzz harness for the PKLITE decompressor in ExeUnpacker. It needs no game data:
+// it builds synthetic executable images, compresses them with a small PKLITE encoder, and checks
+// that ExeUnpacker::unpack() gives the same bytes as the original bit tree decoder (kept below as
+// a reference) on both valid and corrupted streams. Then it reports decode throughput for both.
+
+namespace
+{
+	const int DEFAULT_ITERATIONS = 50;
+	const int DEFAULT_FUZZ_CASES = 5000;
+	const unsigned int DEFAULT_SEED = 1;
+
+	const size_t COMPRESSED_OFFSET = 752;
+
+	// Bit tables from pklite_specification.md, sections 4.3.1 and 4.3.2.
+	const std::vector<std::vector<bool>> Duplication1 =
+	{
+		{ true, false }, // 2
+		{ true, true }, // 3
+		{ false, false, false }, // 4
+		{ false, false, true, false }, // 5
+		{ false, false, true, true }, // 6
+		{ false, true, false, false }, // 7
+		{ false, true, false, true, false }, // 8
+		{ false, true, false, true, true }, // 9
+		{ false, true, true, false, false }, // 10
+		{ false, true, true, false, true, false }, // 11
+		{ false, true, true, false, true, true }, // 12
+		{ false, true, true, true, false, false }, // Special case
+		{ false, true, true, true, false, true, false }, // 13
+		{ false, true, true, true, false, true, true }, // 14
+		{ false, true, true, true, true, false, false }, // 15
+		{ false, true, true, true, true, false, true, false }, // 16
+		{ false, true, true, true, true, false, true, true }, // 17
+		{ false, true, true, true, true, true, false, false }, // 18
+		{ false, true, true, true, true, true, false, true, false }, // 19
+		{ false, true, true, true, true, true, false, true, true }, // 20
+		{ false, true, true, true, true, true, true, false, false }, // 21
+		{ false, true, true, true, true, true, true, false, true }, // 22
+		{ false, true, true, true, true, true, true, true, false }, // 23
+		{ false, true, true, true, true, true, true, true, true } // 24
+	};
+
+	const std::vector<std::vector<bool>> Duplication2 =
+	{
+		{ true }, // 0
+		{ false, false, false, false }, // 1
+		{ false, false, false, true }, // 2
+		{ false, false, true, false, false }, // 3
+		{ false, false, true, false, true }, // 4
+		{ false, false, true, true, false }, // 5
+		{ false, false, true, true, true }, // 6
+		{ false, true, false, false, false, false }, // 7
+		{ false, true, false, false, false, true }, // 8
+		{ false, true, false, false, true, false }, // 9
+		{ false, true, false, false, true, true }, // 10
+		{ false, true, false, true, false, false }, // 11
+		{ false, true, false, true, false, true }, // 12
+		{ false, true, false, true, true, false }, // 13
+		{ false, true, false, true, true, true, false }, // 14
+		{ false, true, false, true, true, true, true }, // 15
+		{ false, true, true, false, false, false, false }, // 16
+		{ false, true, true, false, false, false, true }, // 17
+		{ false, true, true, false, false, true, false }, // 18
+		{ false, true, true, false, false, true, true }, // 19
+		{ false, true, true, false, true, false, false }, // 20
+		{ false, true, true, false, true, false, true }, // 21
+		{ false, true, true, false, true, true, false }, // 22
+		{ false, true, true, false, true, true, true }, // 23
+		{ false, true, true, true, false, false, false }, // 24
+		{ false, true, true, true, false, false, true }, // 25
+		{ false, true, true, true, false, true, false }, // 26
+		{ false, true, true, true, false, true, true }, // 27
+		{ false, true, true, true, true, false, false }, // 28
+		{ false, true, true, true, true, false, true }, // 29
+		{ false, true, true, true, true, true, false }, // 30
+		{ false, true, true, true, true, true, true } // 31
+	};
+
+	// The decoder before it was made table-driven, used as the expected output. The only
+	// changes are that it reads from a buffer instead of the VFS, and that reading past the
+	// end of the buffer, a bad last word, or an offset reaching back before the start of the
+	// output throws instead of running on, crashing, or (when the copy range wrapped around)
+	// being silently ignored.
+	namespace Reference
+	{
+		struct BitVector
+		{
+			std::array<bool, 9> bits;
+			int bitsUsed;
+
+			BitVector()
+			{
+				this->bits.fill(false);
+				this->bitsUsed = 0;
+			}
+		};
+
+		class BitTree
+		{
+		private:
+			struct Node
+			{
+				std::unique_ptr<int> value;
+				std::unique_ptr<Node> left;
+				std::unique_ptr<Node> right;
+
+				bool isLeaf() const
+				{
+					return (this->left.get() == nullptr) && (this->right.get() == nullptr);
+				}
+			};
+
+			BitTree::Node root;
+		public:
+			void insert(const std::vector<bool> &bits, int value)
+			{
+				BitTree::Node *node = &this->root;
+				for (size_t i = 0; i < bits.size(); i++)
+				{
+					std::unique_ptr<BitTree::Node> &child = bits.at(i) ? node->right : node->left;
+					if (child.get() == nullptr)
+					{
+						child = std::make_unique<BitTree::Node>();
+					}
+
+					node = child.get();
+					if (i == (bits.size() - 1))
+					{
+						node->value = std::make_unique<int>(value);
+					}
+				}
+			}
+
+			const int *get(const BitVector &bitVector)
+			{
+				const int *value = nullptr;
+				const BitTree::Node *left = this->root.left.get();
+				const BitTree::Node *right = this->root.right.get();
+				for (int i = 0; i < bitVector.bitsUsed; i++)
+				{
+					const BitTree::Node *node = bitVector.bits.at(i) ? right : left;
+					if (node->isLeaf())
+					{
+						value = node->value.get();
+					}
+
+					left = node->left.get();
+					right = node->right.get();
+				}
+
+				return value;
+			}
+		};
+
+		uint16_t getLE16(const uint8_t *buf)
+		{
+			return static_cast<uint16_t>(buf[0] | (buf[1] << 8));
+		}
+
+		void unpack(const std::vector<uint8_t> &srcData, std::vector<uint8_t> &exeData)
+		{
+			BitTree bitTree1, bitTree2;
+			for (int i = 0; i < 11; i++)
+			{
+				bitTree1.insert(Duplication1.at(i), i + 2);
+			}
+
+			bitTree1.insert(Duplication1.at(11), 13);
+
+			for (int i = 12; i < static_cast<int>(Duplication1.size()); i++)
+			{
+				bitTree1.insert(Duplication1.at(i), i + 1);
+			}
+
+			for (int i = 0; i < static_cast<int>(Duplication2.size()); i++)
+			{
+				bitTree2.insert(Duplication2.at(i), i);
+			}
+
+			if (srcData.size() < (COMPRESSED_OFFSET + 10))
+			{
+				throw std::runtime_error("Executable too small.");
+			}
+
+			const uint8_t *compressedStart = srcData.data() + COMPRESSED_OFFSET;
+			const uint8_t *compressedEnd = srcData.data() + (srcData.size() - 8);
+			if (getLE16(compressedEnd - 2) != 0xFFFF)
+			{
+				throw std::runtime_error("Invalid last compressed word.");
+			}
+
+			const size_t decompLen = (getLE16(compressedEnd) * 16) + getLE16(compressedEnd + 2);
+			exeData = std::vector<uint8_t>(decompLen, 0);
+
+			const size_t compressedSize = srcData.size() - COMPRESSED_OFFSET;
+			size_t decompIndex = 0;
+			uint16_t bitArray = getLE16(compressedStart);
+			size_t byteIndex = 2;
+			int bitsRead = 0;
+
+			while (true)
+			{
+				auto getNextByte = [compressedStart, compressedSize, &byteIndex]()
+				{
+					if (byteIndex >= compressedSize)
+					{
+						throw std::runtime_error("Unexpected end of compressed data.");
+					}
+
+					const uint8_t byte = compressedStart[byteIndex];
+					byteIndex++;
+					return byte;
+				};
+
+				auto getNextBit = [&bitArray, &bitsRead, &getNextByte]()
+				{
+					const bool bit = (bitArray & (1 << bitsRead)) != 0;
+					bitsRead++;
+
+					if (bitsRead == 16)
+					{
+						bitsRead = 0;
+						const uint8_t byte1 = getNextByte();
+						const uint8_t byte2 = getNextByte();
+						bitArray = byte1 | (byte2 << 8);
+					}
+
+					return bit;
+				};
+
+				if (getNextBit())
+				{
+					BitVector copyBits;
+					const int *copyPtr = nullptr;
+					while (copyPtr == nullptr)
+					{
+						copyBits.bits.at(copyBits.bitsUsed) = getNextBit();
+						copyBits.bitsUsed++;
+						copyPtr = bitTree1.get(copyBits);
+					}
+
+					uint16_t copyCount = 0;
+					const std::vector<bool> &specialCase = Duplication1.at(11);
+					const bool isSpecialCase = (copyBits.bitsUsed == static_cast<int>(specialCase.size())) &&
+						std::equal(specialCase.begin(), specialCase.end(), copyBits.bits.begin());
+
+					if (isSpecialCase)
+					{
+						const uint8_t encryptedByte = getNextByte();
+						if (encryptedByte == 0xFE)
+						{
+							continue;
+						}
+						else if (encryptedByte == 0xFF)
+						{
+							break;
+						}
+						else
+						{
+							copyCount = encryptedByte + 25;
+						}
+					}
+					else
+					{
+						copyCount = *copyPtr;
+					}
+
+					uint8_t mostSigByte = 0;
+					if (copyCount != 2)
+					{
+						BitVector offsetBits;
+						const int *offsetPtr = nullptr;
+						while (offsetPtr == nullptr)
+						{
+							offsetBits.bits.at(offsetBits.bitsUsed) = getNextBit();
+							offsetBits.bitsUsed++;
+							offsetPtr = bitTree2.get(offsetBits);
+						}
+
+						mostSigByte = *offsetPtr;
+					}
+
+					const uint8_t leastSigByte = getNextByte();
+					const uint16_t offset = leastSigByte | (mostSigByte << 8);
+					if (offset > decompIndex)
+					{
+						throw std::runtime_error("Invalid duplication offset.");
+					}
+
+					const size_t duplicateBegin = decompIndex - offset;
+					const size_t duplicateEnd = duplicateBegin + copyCount;
+					for (size_t i = duplicateBegin; i < duplicateEnd; i++, decompIndex++)
+					{
+						exeData.at(decompIndex) = exeData.at(i);
+					}
+				}
+				else
+				{
+					const uint8_t encryptedByte = getNextByte();
+					const uint8_t key = 16 - bitsRead;
+					exeData.at(decompIndex) = encryptedByte ^ key;
+					decompIndex++;
+				}
+			}
+		}
+	}
+
+	// Writes PKLITE's interleaved bit and byte streams. A bit word is reserved in the byte
+	// stream as soon as the previous one is full, which is when the decoder reads it.
+	class PkliteWriter
+	{
+	private:
+		std::vector<uint8_t> &out;
+		size_t wordIndex;
+		int bitCount;
+	public:
+		PkliteWriter(std::vector<uint8_t> &out)
+			: out(out)
+		{
+			this->wordIndex = out.size();
+			this->out.push_back(0);
+			this->out.push_back(0);
+			this->bitCount = 0;
+		}
+
+		int getBitCount() const
+		{
+			return this->bitCount;
+		}
+
+		void writeBit(bool bit)
+		{
+			if (bit)
+			{
+				this->out[this->wordIndex + (this->bitCount / 8)] |= 1 << (this->bitCount % 8);
+			}
+
+			this->bitCount++;
+			if (this->bitCount == 16)
+			{
+				this->wordIndex = this->out.size();
+				this->out.push_back(0);
+				this->out.push_back(0);
+				this->bitCount = 0;
+			}
+		}
+
+		void writeBits(const std::vector<bool> &bits)
+		{
+			for (const bool bit : bits)
+			{
+				this->writeBit(bit);
+			}
+		}
+
+		void writeByte(uint8_t byte)
+		{
+			this->out.push_back(byte);
+		}
+	};
+
+	const std::vector<bool> &getCountCode(int count)
+	{
+		return Duplication1.at((count <= 12) ? (count - 2) : (count - 1));
+	}
+
+	// Compresses 'data' into an executable image the way PKLITE lays it out: a header, the
+	// compressed stream ending with the 0xFFFF word, then the decompressed size as a
+	// segment:offset pair. Matches are found greedily over a short hash chain.
+	std::vector<uint8_t> encode(const std::vector<uint8_t> &data, std::mt19937 &rng)
+	{
+		const int MAX_DISTANCE = 0x1FFF;
+		const int MAX_LENGTH = 25 + 0xFD;
+		const int HASH_SIZE = 1 << 14;
+		const int MAX_CANDIDATES = 16;
+
+		std::vector<uint8_t> exe(COMPRESSED_OFFSET);
+		for (size_t i = 0; i < exe.size(); i++)
+		{
+			exe[i] = static_cast<uint8_t>(rng());
+		}
+
+		PkliteWriter writer(exe);
+		const int size = static_cast<int>(data.size());
+		std::vector<int> head(HASH_SIZE, -1), prev(data.size(), -1);
+		auto hash = [&data](int pos)
+		{
+			return ((data[pos] << 10) ^ (data[pos + 1] << 5) ^ data[pos + 2]) & (HASH_SIZE - 1);
+		};
+
+		auto insert = [&](int pos)
+		{
+			if ((pos + 3) <= size)
+			{
+				const int h = hash(pos);
+				prev[pos] = head[h];
+				head[h] = pos;
+			}
+		};
+
+		int pos = 0;
+		while (pos < size)
+		{
+			int bestLength = 0;
+			int bestDistance = 0;
+			if ((pos + 3) <= size)
+			{
+				const int limit = std::min(MAX_LENGTH, size - pos);
+				int candidate = head[hash(pos)];
+				for (int i = 0; (i < MAX_CANDIDATES) && (candidate >= 0) &&
+					((pos - candidate) <= MAX_DISTANCE); i++)
+				{
+					int length = 0;
+					while ((length < limit) && (data[candidate + length] == data[pos + length]))
+					{
+						length++;
+					}
+
+					if (length > bestLength)
+					{
+						bestLength = length;
+						bestDistance = pos - candidate;
+					}
+
+					candidate = prev[candidate];
+				}
+			}
+
+			// Two-byte copies are only possible within 255 bytes.
+			if ((bestLength < 3) && ((pos + 2) <= size))
+			{
+				bestLength = 0;
+				for (int distance = 1; (distance <= std::min(pos, 32)); distance++)
+				{
+					if ((data[pos - distance] == data[pos]) &&
+						(data[pos - distance + 1] == data[pos + 1]))
+					{
+						bestLength = 2;
+						bestDistance = distance;
+						break;
+					}
+				}
+			}
+
+			// Now and then a no-op "skip" code, which PKLITE emits at segment boundaries.
+			if ((rng() % 512) == 0)
+			{
+				writer.writeBit(true);
+				writer.writeBits(Duplication1.at(11));
+				writer.writeByte(0xFE);
+			}
+
+			if (bestLength >= 2)
+			{
+				writer.writeBit(true);
+				if (bestLength >= 25)
+				{
+					writer.writeBits(Duplication1.at(11));
+					writer.writeByte(static_cast<uint8_t>(bestLength - 25));
+				}
+				else
+				{
+					writer.writeBits(getCountCode(bestLength));
+				}
+
+				if (bestLength != 2)
+				{
+					writer.writeBits(Duplication2.at(bestDistance >> 8));
+				}
+
+				writer.writeByte(static_cast<uint8_t>(bestDistance & 0xFF));
+
+				for (int i = 0; i < bestLength; i++)
+				{
+					insert(pos + i);
+				}
+
+				pos += bestLength;
+			}
+			else
+			{
+				writer.writeBit(false);
+				writer.writeByte(data[pos] ^ static_cast<uint8_t>(16 - writer.getBitCount()));
+				insert(pos);
+				pos++;
+			}
+		}
+
+		// End of data, then the last word and the trailer.
+		writer.writeBit(true);
+		writer.writeBits(Duplication1.at(11));
+		writer.writeByte(0xFF);
+		exe.push_back(0xFF);
+		exe.push_back(0xFF);
+
+		const size_t segment = data.size() / 16;
+		const size_t offset = data.size() % 16;
+		for (const size_t value : { segment, offset, static_cast<size_t>(0), static_cast<size_t>(0) })
+		{
+			exe.push_back(static_cast<uint8_t>(value & 0xFF));
+			exe.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
+		}
+
+		return exe;
+	}
+
+	// Something shaped like a DOS executable image: code-like noise, repeated instruction
+	// sequences, zero-filled tables and runs of text.
+	std::vector<uint8_t> makeImage(size_t size, std::mt19937 &rng)
+	{
+		static const std::string words[] =
+		{
+			"The ", "Elder ", "Scrolls ", "Arena ", "Imperial ", "City ", "dungeon ",
+			"spell ", "gold ", "You ", "have ", "found ", "a ", "of ", "the ", "\r\n"
+		};
+
+		std::vector<uint8_t> image;
+		image.reserve(size);
+		while (image.size() < size)
+		{
+			const int kind = static_cast<int>(rng() % 10);
+			if (kind < 4)
+			{
+				const int count = 16 + static_cast<int>(rng() % 256);
+				for (int i = 0; i < count; i++)
+				{
+					image.push_back(static_cast<uint8_t>(rng()));
+				}
+			}
+			else if ((kind < 7) && (image.size() > 64))
+			{
+				const size_t length = 4 + (rng() % 300);
+				const size_t distance = 1 + (rng() % std::min<size_t>(image.size(), 12000));
+				const size_t begin = image.size() - distance;
+				for (size_t i = 0; i < length; i++)
+				{
+					image.push_back(image[begin + i]);
+				}
+			}
+			else if (kind < 8)
+			{
+				image.insert(image.end(), rng() % 600, 0);
+			}
+			else
+			{
+				const int count = 8 + static_cast<int>(rng() % 32);
+				for (int i = 0; i < count; i++)
+				{
+					const std::string &word = words[rng() % std::size(words)];
+					image.insert(image.end(), word.begin(), word.end());
+				}
+			}
+		}
+
+		image.resize(size);
+		return image;
+	}
+
+	struct CorpusEntry
+	{
+		std::string name;
+		std::vector<uint8_t> decoded;
+		std::vector<uint8_t> encoded;
+	};
+
+	std::vector<CorpusEntry> makeCorpus(std::mt19937 &rng)
+	{
+		std::vector<CorpusEntry> corpus;
+		for (const size_t size : { 1000, 65536, 160000, 300000 })
+		{
+			CorpusEntry entry;
+			entry.name = "image " + std::to_string(size);
+			entry.decoded = makeImage(size, rng);
+			entry.encoded = encode(entry.decoded, rng);
+			corpus.push_back(std::move(entry));
+		}
+
+		return corpus;
+	}
+
+	bool decode(bool reference, const std::vector<uint8_t> &encoded, std::vector<uint8_t> &out)
+	{
+		try
+		{
+			if (reference)
+			{
+				Reference::unpack(encoded, out);
+			}
+			else
+			{
+				ExeUnpacker::unpack(encoded.data(), encoded.size(), out);
+			}
+
+			return true;
+		}
+		catch (const std::exception&)
+		{
+			return false;
+		}
+	}
+
+	// Checks that both decoders reproduce every corpus entry. Returns the number of failures.
+	int checkCorpus(const std::vector<CorpusEntry> &corpus)
+	{
+		int failures = 0;
+		std::vector<uint8_t> expected, actual;
+		for (const CorpusEntry &entry : corpus)
+		{
+			const bool referenceOk = decode(true, entry.encoded, expected);
+			const bool ok = decode(false, entry.encoded, actual);
+			if (!referenceOk || !ok || (expected != entry.decoded) || (actual != entry.decoded))
+			{
+				std::printf("FAIL round trip: %s\n", entry.name.c_str());
+				failures++;
+			}
+		}
+
+		return failures;
+	}
+
+	// Decodes corrupted corpus streams with both decoders. They must agree on whether the
+	// stream is valid and, if it is, on every output byte. Returns the number of failures.
+	int fuzz(const std::vector<CorpusEntry> &corpus, int caseCount, std::mt19937 &rng)
+	{
+		int failures = 0;
+		std::vector<uint8_t> expected, actual;
+		for (int i = 0; i < caseCount; i++)
+		{
+			const CorpusEntry &entry = corpus[rng() % corpus.size()];
+			std::vector<uint8_t> stream = entry.encoded;
+
+			// Random changes to the compressed data, sometimes lots, then maybe to the trailer.
+			const size_t compressedSize = stream.size() - COMPRESSED_OFFSET - 10;
+			const int changes = 1 + static_cast<int>(rng() % ((rng() % 8) == 0 ? 256 : 8));
+			for (int j = 0; j < changes; j++)
+			{
+				stream[COMPRESSED_OFFSET + (rng() % compressedSize)] = static_cast<uint8_t>(rng());
+			}
+
+			if ((rng() % 8) == 0)
+			{
+				stream[stream.size() - 8 + (rng() % 4)] = static_cast<uint8_t>(rng());
+			}
+
+			const bool referenceOk = decode(true, stream, expected);
+			const bool ok = decode(false, stream, actual);
+			if ((referenceOk != ok) || (ok && (expected != actual)))
+			{
+				if (failures < 10)
+				{
+					std::printf("FAIL fuzz case %d: %s (reference %s, new %s)\n", i,
+						entry.name.c_str(), referenceOk ? "ok" : "threw", ok ? "ok" : "threw");
+				}
+
+				failures++;
+			}
+		}
+
+		return failures;
+	}
+
+	// Returns decoded megabytes per second over the corpus.
+	double measure(const std::vector<CorpusEntry> &corpus, bool reference, int iterations)
+	{
+		std::vector<uint8_t> out;
+		size_t totalBytes = 0;
+		const auto startTime = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++)
+		{
+			for (const CorpusEntry &entry : corpus)
+			{
+				decode(reference, entry.encoded, out);
+				totalBytes += out.size();
+			}
+		}
+
+		const double seconds = std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - startTime).count();
+		return (static_cast<double>(totalBytes) / (1024.0 * 1024.0)) / seconds;
+	}
+
+	void printUsage(const char *programName)
+	{
+		std::printf("Usage: %s [--iterations N] [--fuzz N] [--seed N]\n"
+			"  --iterations  decode passes over the corpus (default: %d)\n"
+			"  --fuzz        corrupted streams to cross-check (default: %d)\n"
+			"  --seed        random seed for the corpus and fuzzing (default: %u)\n",
+			programName, DEFAULT_ITERATIONS, DEFAULT_FUZZ_CASES, DEFAULT_SEED);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int iterations = DEFAULT_ITERATIONS;
+	int fuzzCases = DEFAULT_FUZZ_CASES;
+	unsigned int seed = DEFAULT_SEED;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		const bool hasValue = (i + 1) < argc;
+		if ((arg == "--iterations") && hasValue)
+		{
+			iterations = std::atoi(argv[++i]);
+		}
+		else if ((arg == "--fuzz") && hasValue)
+		{
+			fuzzCases = std::atoi(argv[++i]);
+		}
+		else if ((arg == "--seed") && hasValue)
+		{
+			seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else
+		{
+			printUsage(argv[0]);
+			return (arg == "--help") ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if ((iterations < 0) || (fuzzCases < 0))
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	std::mt19937 rng(seed);
+	const std::vector<CorpusEntry> corpus = makeCorpus(rng);
+
+	std::printf("%-14s %9s %9s %7s\n", "corpus", "decoded", "encoded", "ratio");
+	for (const CorpusEntry &entry : corpus)
+	{
+		const size_t encodedSize = entry.encoded.size() - COMPRESSED_OFFSET;
+		std::printf("%-14s %9zu %9zu %7.3f\n", entry.name.c_str(), entry.decoded.size(),
+			encodedSize, static_cast<double>(encodedSize) / static_cast<double>(entry.decoded.size()));
+	}
+
+	int failures = checkCorpus(corpus);
+	const int fuzzFailures = fuzz(corpus, fuzzCases, rng);
+	std::printf("\nRound trips: %s. Fuzz: %d cases, %d mismatches.\n",
+		(failures == 0) ? "all identical" : "FAILED", fuzzCases, fuzzFailures);
+	failures += fuzzFailures;
+
+	if (iterations > 0)
+	{
+		const double referenceSpeed = measure(corpus, true, iterations);
+		const double speed = measure(corpus, false, iterations);
+		std::printf("\n%12s %12s %8s\n", "ref MB/s", "new MB/s", "speedup");
+		std::printf("%12.1f %12.1f %7.2fx\n", referenceSpeed, speed, speed / referenceSpeed);
+	}
+
+	return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
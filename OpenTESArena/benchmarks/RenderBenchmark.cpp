@@ -0,0 +1,1188 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../src/Math/Constants.h"
+#include "../src/Math/Vector2.h"
+#include "../src/Math/Vector3.h"
+#include "../src/Rendering/RenderParams.h"
+#include "../src/Rendering/Renderer.h"
+#include "../src/Rendering/SoftwareRenderer.h"
+#include "../src/Rendering/Surface.h"
+#include "../src/World/DistantSky.h"
+#include "../src/World/LevelData.h"
+#include "../src/World/VoxelData.h"
+#include "../src/World/VoxelGrid.h"
+
+// Headless benchmark for the software renderer. It builds synthetic levels in memory (no
+// original game data needed) and renders scripted camera paths into a plain frame buffer,
+// then prints per-stage frame times, percentiles, and pixel throughput for each render
+// threads mode. Nothing here opens a window, so it runs on a headless machine.
+
+// It can also compare one fixed frame of each scene against stored reference images, and
+// fails if more than a small share of pixels differ by more than a tolerance. The references in benchmarks/reference
+// are 320x200 and were written with --write-reference by this benchmark built against the
+// baseline renderer (commit 3223499, before any of the span and plane changes), with the
+// frame timing, indexed color, and debug view code taken out since that renderer doesn't
+// have them. Check a build against them with:
+//   RenderBenchmark --width 320 --height 200 --frames 1 --reference OpenTESArena/benchmarks/reference
+
+namespace
+{
+	const int DEFAULT_WIDTH = 1280;
+	const int DEFAULT_HEIGHT = 720;
+	const int DEFAULT_FRAMES = 300;
+	const int WARMUP_FRAMES = 10;
+	const double FOV_Y = 60.0;
+	const double CEILING_HEIGHT = 1.0;
+	const double EYE_HEIGHT = CEILING_HEIGHT + (60.0 / 128.0);
+
+	// Point along each camera path of the frame compared against the reference images, and
+	// the default per-channel difference allowed for floating-point differences between
+	// compilers and instruction sets. Halfway would put several eyes on a voxel boundary.
+	const double REFERENCE_PATH_PERCENT = 0.53;
+	const int DEFAULT_TOLERANCE = 2;
+
+	// Default percent of a frame's pixels allowed past the tolerance. Perspective-correct
+	// columns are only divided out every few pixels, so where a span crosses a texel edge
+	// a pixel can take the neighboring texel (about 0.4% of the terraces frame at 320x200).
+	const double DEFAULT_MAX_MISMATCH_PERCENT = 1.0;
+
+	// Camera paths keep the eye off exact voxel boundaries since the ray caster doesn't
+	// handle starting on one.
+
+	// Voxel texture IDs used by the synthetic levels.
+	enum TextureID
+	{
+		GroundTexture,
+		StreetTexture,
+		WallTexture,
+		BrickTexture,
+		FloorTexture,
+		CeilingTexture,
+		DoorTexture,
+		WindowTexture,
+		TextureCount
+	};
+
+	struct CameraState
+	{
+		Double3 eye, direction;
+		double daytimePercent;
+	};
+
+	struct Scene
+	{
+		std::string name;
+		VoxelGrid voxelGrid;
+		std::vector<LevelData::DoorState> openDoors;
+		std::vector<Double3> flatPositions;
+		double ambient, fogDistance, latitude;
+		bool exterior;
+
+		// Camera position and look direction for some percent [0, 1) through the path.
+		std::function<CameraState(double)> cameraPath;
+
+		// Called each frame before rendering so the scene can animate (i.e., doors).
+		std::function<void(Scene&, double)> update;
+
+		Scene(const std::string &name, int width, int height, int depth)
+			: name(name), voxelGrid(width, height, depth)
+		{
+			this->ambient = 1.0; // Interiors are fully bright in-game until lights exist.
+			this->fogDistance = 50.0;
+			this->latitude = 0.0;
+			this->exterior = true;
+		}
+	};
+
+	struct Stats
+	{
+		double avg, p50, p95, p99, max;
+	};
+
+	Stats makeStats(std::vector<double> values)
+	{
+		Stats stats = Stats();
+		if (values.empty())
+		{
+			return stats;
+		}
+
+		std::sort(values.begin(), values.end());
+
+		auto percentile = [&values](double percent)
+		{
+			const int index = static_cast<int>(std::ceil(percent *
+				static_cast<double>(values.size()))) - 1;
+			return values[std::clamp(index, 0, static_cast<int>(values.size()) - 1)];
+		};
+
+		double sum = 0.0;
+		for (const double value : values)
+		{
+			sum += value;
+		}
+
+		stats.avg = sum / static_cast<double>(values.size());
+		stats.p50 = percentile(0.50);
+		stats.p95 = percentile(0.95);
+		stats.p99 = percentile(0.99);
+		stats.max = values.back();
+		return stats;
+	}
+
+	Double3 makeDirection(double yawRadians, double pitchRadians)
+	{
+		return Double3(
+			std::cos(yawRadians) * std::cos(pitchRadians),
+			std::sin(pitchRadians),
+			std::sin(yawRadians) * std::cos(pitchRadians)).normalized();
+	}
+
+	// Makes a 64x64 voxel texture with a two-tone pattern so every texture is distinguishable
+	// and texture sampling isn't trivially cache-friendly.
+	std::vector<uint32_t> makeVoxelTexels(int id)
+	{
+		const int width = 64;
+		const int height = 64;
+		std::vector<uint32_t> texels(width * height);
+
+		const uint32_t baseColor = 0xFF000000 |
+			(((id * 67) + 60) & 0xFF) << 16 |
+			(((id * 131) + 90) & 0xFF) << 8 |
+			(((id * 29) + 40) & 0xFF);
+		const uint32_t lineColor = 0xFF000000 | ((baseColor & 0x00FEFEFE) >> 1);
+
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				const bool isLine = ((y % 16) == 0) || (((x + ((y / 16) * 8)) % 32) == 0);
+				uint32_t color = isLine ? lineColor : baseColor;
+
+				// Windows have a see-through middle.
+				if ((id == WindowTexture) && (x > 16) && (x < 48) && (y > 16) && (y < 48))
+				{
+					color = 0;
+				}
+
+				texels[x + (y * width)] = color;
+			}
+		}
+
+		return texels;
+	}
+
+	// Makes a flat texture (i.e., a tree or a person) with a transparent border.
+	std::vector<uint32_t> makeFlatTexels(int width, int height, uint32_t color)
+	{
+		std::vector<uint32_t> texels(width * height, 0);
+		const double halfWidth = static_cast<double>(width) / 2.0;
+
+		for (int y = 0; y < height; y++)
+		{
+			const double yPercent = static_cast<double>(y) / static_cast<double>(height);
+			const double rowHalfWidth = halfWidth * (0.25 + (0.75 * yPercent));
+
+			for (int x = 0; x < width; x++)
+			{
+				const double xDist = std::abs((static_cast<double>(x) + 0.50) - halfWidth);
+				if (xDist < rowHalfWidth)
+				{
+					texels[x + (y * width)] = color;
+				}
+			}
+		}
+
+		return texels;
+	}
+
+	Surface makeSkySurface(int width, int height, uint32_t color, bool jagged)
+	{
+		Surface surface = Surface::createWithFormat(width, height,
+			Renderer::DEFAULT_BPP, Renderer::DEFAULT_PIXELFORMAT);
+		uint32_t *pixels = static_cast<uint32_t*>(surface.getPixels());
+
+		for (int x = 0; x < width; x++)
+		{
+			// Jagged surfaces look like a mountain range, the others are solid blobs.
+			const double xPercent = static_cast<double>(x) / static_cast<double>(width);
+			const int top = jagged ? static_cast<int>(static_cast<double>(height) *
+				(0.50 + (0.40 * std::sin(xPercent * Constants::Pi * 6.0)))) : 0;
+
+			for (int y = 0; y < height; y++)
+			{
+				pixels[x + (y * width)] = (y >= top) ? color : 0;
+			}
+		}
+
+		return surface;
+	}
+
+	// Fills the bottom layer of the grid with floor voxels.
+	void addGround(Scene &scene, uint16_t floorID)
+	{
+		VoxelGrid &grid = scene.voxelGrid;
+		for (int z = 0; z < grid.getDepth(); z++)
+		{
+			for (int x = 0; x < grid.getWidth(); x++)
+			{
+				grid.setVoxel(x, 0, z, floorID);
+			}
+		}
+	}
+
+	// Wide open terrain with a few scattered buildings and lots of flats; mostly sky, distant
+	// objects, and floor.
+	Scene makeOpenField()
+	{
+		Scene scene("open field", 128, 4, 128);
+		VoxelGrid &grid = scene.voxelGrid;
+		grid.addVoxelData(VoxelData());
+		const uint16_t groundID = grid.addVoxelData(VoxelData::makeFloor(GroundTexture));
+		const uint16_t wallID = grid.addVoxelData(VoxelData::makeWall(
+			WallTexture, WallTexture, WallTexture, nullptr, VoxelData::WallData::Type::Solid));
+		addGround(scene, groundID);
+
+		for (int i = 0; i < 40; i++)
+		{
+			const int x = 8 + ((i * 37) % 112);
+			const int z = 8 + ((i * 53) % 112);
+			grid.setVoxel(x, 1, z, wallID);
+		}
+
+		for (int i = 0; i < 150; i++)
+		{
+			const double x = 2.0 + static_cast<double>((i * 71) % 124) + 0.50;
+			const double z = 2.0 + static_cast<double>((i * 43) % 124) + 0.50;
+			scene.flatPositions.push_back(Double3(x, CEILING_HEIGHT, z));
+		}
+
+		scene.fogDistance = 75.0;
+		scene.latitude = 0.25;
+		scene.cameraPath = [](double percent)
+		{
+			// Slow circle around the middle of the field, looking slightly outward.
+			const double angle = percent * Constants::TwoPi;
+			const Double3 eye(64.0 + (30.0 * std::cos(angle)), EYE_HEIGHT,
+				64.0 + (30.0 * std::sin(angle)));
+			return CameraState { eye, makeDirection(angle + (Constants::Pi * 0.60), 0.05), 0.40 };
+		};
+
+		return scene;
+	}
+
+	// City blocks with streets between them; lots of tall walls and windows at medium range.
+	Scene makeDenseCity()
+	{
+		Scene scene("dense city", 96, 6, 96);
+		VoxelGrid &grid = scene.voxelGrid;
+		grid.addVoxelData(VoxelData());
+		const uint16_t streetID = grid.addVoxelData(VoxelData::makeFloor(StreetTexture));
+		const uint16_t brickID = grid.addVoxelData(VoxelData::makeWall(
+			BrickTexture, BrickTexture, BrickTexture, nullptr, VoxelData::WallData::Type::Solid));
+		const uint16_t windowID = grid.addVoxelData(VoxelData::makeTransparentWall(
+			WindowTexture, true));
+		addGround(scene, streetID);
+
+		// 6x6 blocks separated by 2-wide streets. Building height varies per block.
+		for (int z = 0; z < grid.getDepth(); z++)
+		{
+			for (int x = 0; x < grid.getWidth(); x++)
+			{
+				const bool isStreet = ((x % 8) < 2) || ((z % 8) < 2);
+				if (isStreet)
+				{
+					continue;
+				}
+
+				const int blockHeight = 1 + (((x / 8) * 7 + (z / 8) * 3) % 4);
+				for (int y = 1; y <= blockHeight; y++)
+				{
+					const bool isWindow = (y > 1) && (((x + z) % 3) == 0);
+					grid.setVoxel(x, y, z, isWindow ? windowID : brickID);
+				}
+			}
+		}
+
+		for (int i = 0; i < 100; i++)
+		{
+			// People standing in the streets.
+			const double x = static_cast<double>(((i * 5) % 12) * 8) + 1.0;
+			const double z = static_cast<double>((i * 29) % 96) + 0.50;
+			scene.flatPositions.push_back(Double3(x, CEILING_HEIGHT, z));
+		}
+
+		scene.fogDistance = 40.0;
+		scene.latitude = 0.10;
+		scene.cameraPath = [](double percent)
+		{
+			// Walk down a street while looking side to side.
+			const double z = 4.0 + (percent * 88.0);
+			const Double3 eye(8.85, EYE_HEIGHT, z);
+			const double yaw = (Constants::Pi * 0.50) +
+				(0.80 * std::sin(percent * 4.0 * Constants::Pi));
+			return CameraState { eye, makeDirection(yaw, 0.0), 0.55 };
+		};
+
+		return scene;
+	}
+
+	// Interior maze of one-voxel corridors with a floor and ceiling; short views and lots of
+	// walls at close range.
+	Scene makeMazeDungeon()
+	{
+		Scene scene("maze dungeon", 65, 3, 65);
+		VoxelGrid &grid = scene.voxelGrid;
+		grid.addVoxelData(VoxelData());
+		const uint16_t floorID = grid.addVoxelData(VoxelData::makeFloor(FloorTexture));
+		const uint16_t ceilingID = grid.addVoxelData(VoxelData::makeCeiling(CeilingTexture));
+		const uint16_t wallID = grid.addVoxelData(VoxelData::makeWall(
+			WallTexture, FloorTexture, CeilingTexture, nullptr, VoxelData::WallData::Type::Solid));
+		addGround(scene, floorID);
+
+		// Start with walls everywhere, then carve a deterministic maze with a randomized
+		// depth-first search on the odd cells.
+		for (int z = 0; z < grid.getDepth(); z++)
+		{
+			for (int x = 0; x < grid.getWidth(); x++)
+			{
+				grid.setVoxel(x, 1, z, wallID);
+				grid.setVoxel(x, 2, z, ceilingID);
+			}
+		}
+
+		uint32_t seed = 12345;
+		auto nextRandom = [&seed]()
+		{
+			seed = (seed * 1103515245) + 12345;
+			return static_cast<int>((seed >> 16) & 0x7FFF);
+		};
+
+		std::vector<Int2> stack;
+		stack.push_back(Int2(1, 1));
+		grid.setVoxel(1, 1, 1, 0);
+		while (!stack.empty())
+		{
+			const Int2 cell = stack.back();
+			std::vector<Int2> neighbors;
+			const Int2 offsets[] = { Int2(2, 0), Int2(-2, 0), Int2(0, 2), Int2(0, -2) };
+			for (const Int2 &offset : offsets)
+			{
+				const Int2 next(cell.x + offset.x, cell.y + offset.y);
+				const bool inside = (next.x > 0) && (next.x < (grid.getWidth() - 1)) &&
+					(next.y > 0) && (next.y < (grid.getDepth() - 1));
+				if (inside && (grid.getVoxel(next.x, 1, next.y) != 0))
+				{
+					neighbors.push_back(next);
+				}
+			}
+
+			if (neighbors.empty())
+			{
+				stack.pop_back();
+				continue;
+			}
+
+			const Int2 next = neighbors[nextRandom() % neighbors.size()];
+			grid.setVoxel((cell.x + next.x) / 2, 1, (cell.y + next.y) / 2, 0);
+			grid.setVoxel(next.x, 1, next.y, 0);
+			stack.push_back(next);
+		}
+
+		// Open up the middle row and column so the camera has long corridors to look down.
+		for (int i = 1; i < (grid.getWidth() - 1); i++)
+		{
+			grid.setVoxel(i, 1, 33, 0);
+			grid.setVoxel(33, 1, i, 0);
+		}
+
+		for (int i = 0; i < 40; i++)
+		{
+			const double x = static_cast<double>(1 + ((i * 14) % 63)) + 0.50;
+			scene.flatPositions.push_back(Double3(x, CEILING_HEIGHT, 33.50));
+		}
+
+		scene.fogDistance = 25.0;
+		scene.exterior = false;
+		scene.cameraPath = [](double percent)
+		{
+			// Walk the long corridor, turning around at the end.
+			const double t = (percent < 0.50) ? (percent * 2.0) : (2.0 - (percent * 2.0));
+			const Double3 eye(1.50 + (t * 62.0), EYE_HEIGHT, 33.50);
+			const double yaw = (percent < 0.50) ? 0.0 : Constants::Pi;
+			return CameraState { eye, makeDirection(yaw + (0.30 * std::sin(percent * 20.0)),
+				-0.05), 0.0 };
+		};
+
+		return scene;
+	}
+
+	// Long interior halls lined with doors that open and close over time.
+	Scene makeDoorPalace()
+	{
+		Scene scene("door palace", 64, 3, 64);
+		VoxelGrid &grid = scene.voxelGrid;
+		grid.addVoxelData(VoxelData());
+		const uint16_t floorID = grid.addVoxelData(VoxelData::makeFloor(FloorTexture));
+		const uint16_t ceilingID = grid.addVoxelData(VoxelData::makeCeiling(CeilingTexture));
+		const uint16_t wallID = grid.addVoxelData(VoxelData::makeWall(
+			BrickTexture, FloorTexture, CeilingTexture, nullptr, VoxelData::WallData::Type::Solid));
+		const VoxelData::DoorData::Type doorTypes[] =
+		{
+			VoxelData::DoorData::Type::Swinging,
+			VoxelData::DoorData::Type::Sliding,
+			VoxelData::DoorData::Type::Raising,
+			VoxelData::DoorData::Type::Splitting
+		};
+
+		std::vector<uint16_t> doorIDs;
+		for (const auto doorType : doorTypes)
+		{
+			doorIDs.push_back(grid.addVoxelData(VoxelData::makeDoor(DoorTexture, doorType)));
+		}
+
+		addGround(scene, floorID);
+
+		// Four parallel halls along X, with rooms between them and a door every other voxel.
+		for (int z = 0; z < grid.getDepth(); z++)
+		{
+			for (int x = 0; x < grid.getWidth(); x++)
+			{
+				grid.setVoxel(x, 2, z, ceilingID);
+
+				const bool isHall = ((z % 16) >= 7) && ((z % 16) <= 8) &&
+					(x > 0) && (x < (grid.getWidth() - 1));
+				const bool isDoorRow = ((z % 16) == 6) || ((z % 16) == 9);
+				if (isHall)
+				{
+					continue;
+				}
+
+				if (isDoorRow && ((x % 2) == 1) && (x > 1) && (x < (grid.getWidth() - 2)))
+				{
+					const uint16_t doorID = doorIDs[(x / 2) % doorIDs.size()];
+					grid.setVoxel(x, 1, z, doorID);
+					scene.openDoors.push_back(LevelData::DoorState(Int2(x, z), 0.0,
+						LevelData::DoorState::Direction::None));
+				}
+				else
+				{
+					grid.setVoxel(x, 1, z, wallID);
+				}
+			}
+		}
+
+		for (int i = 0; i < 60; i++)
+		{
+			const double x = static_cast<double>(2 + ((i * 9) % 60)) + 0.50;
+			const double z = static_cast<double>(((i % 4) * 16) + 7) + 0.50 + ((i % 2) * 1.0);
+			scene.flatPositions.push_back(Double3(x, CEILING_HEIGHT, z));
+		}
+
+		scene.fogDistance = 25.0;
+		scene.exterior = false;
+		scene.cameraPath = [](double percent)
+		{
+			// Walk along the second hall, glancing into the doorways.
+			const Double3 eye(2.0 + (percent * 60.0), EYE_HEIGHT, 23.60);
+			const double yaw = 0.70 * std::sin(percent * 6.0 * Constants::Pi);
+			return CameraState { eye, makeDirection(yaw, 0.0), 0.0 };
+		};
+
+		scene.update = [](Scene &scene, double percent)
+		{
+			// Each door swings between closed and open at its own phase.
+			for (size_t i = 0; i < scene.openDoors.size(); i++)
+			{
+				LevelData::DoorState &door = scene.openDoors[i];
+				const double phase = (percent * 8.0) + (static_cast<double>(i) * 0.37);
+				const double percentOpen = 0.50 + (0.50 * std::sin(phase * Constants::TwoPi));
+				door = LevelData::DoorState(door.getVoxel(), percentOpen,
+					LevelData::DoorState::Direction::None);
+			}
+		};
+
+		return scene;
+	}
+
+	// Stepped terraces of different heights under a partial roof, seen from above. Floors and
+	// ceilings at many heights and with different textures meet along the same screen rows.
+	// Thin platforms float over the lowest terraces and hang under the roof, so raised voxel
+	// tops and bottoms (the perspective-correct column path) are covered too.
+	Scene makeTerraces()
+	{
+		Scene scene("terraces", 48, 8, 48);
+		VoxelGrid &grid = scene.voxelGrid;
+		grid.addVoxelData(VoxelData());
+		const uint16_t groundID = grid.addVoxelData(VoxelData::makeFloor(GroundTexture));
+		const uint16_t roofID = grid.addVoxelData(VoxelData::makeCeiling(CeilingTexture));
+		const int topTextures[] = { FloorTexture, StreetTexture, BrickTexture };
+
+		// A wall's top face uses its ceiling texture.
+		std::vector<uint16_t> stepIDs;
+		for (const int topTexture : topTextures)
+		{
+			stepIDs.push_back(grid.addVoxelData(VoxelData::makeWall(
+				WallTexture, CeilingTexture, topTexture, nullptr,
+				VoxelData::WallData::Type::Solid)));
+		}
+
+		// Raised platforms, one seen from above and one from below.
+		auto makePlatform = [](int topTexture, double yOffset, double ySize)
+		{
+			const double vTop = std::max(0.0, 1.0 - yOffset - ySize);
+			const double vBottom = std::min(vTop + ySize, 1.0);
+			return VoxelData::makeRaised(WallTexture, topTexture, topTexture, yOffset, ySize,
+				vTop, vBottom);
+		};
+
+		const uint16_t lowPlatformID = grid.addVoxelData(makePlatform(StreetTexture, 0.40, 0.20));
+		const uint16_t highPlatformID = grid.addVoxelData(makePlatform(FloorTexture, 0.80, 0.10));
+
+		addGround(scene, groundID);
+
+		// 3x3 terraces from one to four voxels tall.
+		for (int z = 0; z < grid.getDepth(); z++)
+		{
+			for (int x = 0; x < grid.getWidth(); x++)
+			{
+				const int blockX = x / 3;
+				const int blockZ = z / 3;
+				const int stepHeight = 1 + ((blockX + (blockZ * 3)) % 4);
+				const uint16_t stepID = stepIDs[(blockX + blockZ) % stepIDs.size()];
+				for (int y = 1; y <= stepHeight; y++)
+				{
+					grid.setVoxel(x, y, z, stepID);
+				}
+
+				if (stepHeight == 1)
+				{
+					grid.setVoxel(x, 3, z, lowPlatformID);
+				}
+				else if ((stepHeight == 2) && (z >= (grid.getDepth() / 2)))
+				{
+					grid.setVoxel(x, 6, z, highPlatformID);
+				}
+
+				// Roof over the far half, above the camera.
+				if (z >= (grid.getDepth() / 2))
+				{
+					grid.setVoxel(x, 7, z, roofID);
+				}
+			}
+		}
+
+		scene.fogDistance = 40.0;
+		scene.exterior = false;
+		scene.cameraPath = [](double percent)
+		{
+			// Fly along the near half above the tallest terraces, looking down and across.
+			const Double3 eye(4.30 + (percent * 39.40), (CEILING_HEIGHT * 5.0) + EYE_HEIGHT,
+				10.40);
+			const double yaw = (Constants::Pi * 0.50) + (0.60 * std::sin(percent * Constants::TwoPi));
+			return CameraState { eye, makeDirection(yaw, -0.15), 0.0 };
+		};
+
+		return scene;
+	}
+
+	// Makes a 256 color palette for indexed color mode: a 6x7x6 color cube plus grays.
+	std::vector<uint32_t> makeVoxelPalette()
+	{
+		std::vector<uint32_t> palette;
+		palette.push_back(0);
+
+		for (int r = 0; r < 6; r++)
+		{
+			for (int g = 0; g < 7; g++)
+			{
+				for (int b = 0; b < 6; b++)
+				{
+					palette.push_back(0xFF000000 | ((r * 51) << 16) | ((g * 42) << 8) | (b * 51));
+				}
+			}
+		}
+
+		while (palette.size() < 256)
+		{
+			const int gray = static_cast<int>(((palette.size() - 253) * 64) + 32) & 0xFF;
+			palette.push_back(0xFF000000 | (gray << 16) | (gray << 8) | gray);
+		}
+
+		return palette;
+	}
+
+	// Palette indices of voxel texels in makeVoxelPalette()'s color cube, standing in for the
+	// indices a texture file would have. Transparent texels are index 0.
+	std::vector<uint8_t> makeVoxelPaletteIndices(const std::vector<uint32_t> &texels)
+	{
+		std::vector<uint8_t> indices(texels.size());
+		std::transform(texels.begin(), texels.end(), indices.begin(), [](uint32_t texel)
+		{
+			if ((texel & 0xFF000000) == 0)
+			{
+				return static_cast<uint8_t>(0);
+			}
+
+			const int r = (((texel >> 16) & 0xFF) + 25) / 51;
+			const int g = (((texel >> 8) & 0xFF) + 21) / 42;
+			const int b = ((texel & 0xFF) + 25) / 51;
+			return static_cast<uint8_t>(1 + (r * 42) + (g * 6) + b);
+		});
+
+		return indices;
+	}
+
+	// Fills the renderer's distant sky with mountains, clouds, moons, stars, and a sun.
+	void makeDistantSky(DistantSky &distantSky, std::deque<Surface> &surfaces)
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			surfaces.push_back(makeSkySurface(320, 60, 0xFF405060, true));
+			const double angle = static_cast<double>(i) * (Constants::TwoPi / 8.0);
+			distantSky.addLandObject(DistantSky::LandObject(surfaces.back(), angle));
+		}
+
+		for (int i = 0; i < 12; i++)
+		{
+			surfaces.push_back(makeSkySurface(120, 30, 0xFFE0E0F0, false));
+			const double angle = static_cast<double>(i) * (Constants::TwoPi / 12.0);
+			const double height = 0.20 + (0.10 * static_cast<double>(i % 5));
+			distantSky.addAirObject(DistantSky::AirObject(surfaces.back(), angle, height));
+		}
+
+		surfaces.push_back(makeSkySurface(32, 32, 0xFFC0C0B0, false));
+		distantSky.addMoonObject(DistantSky::MoonObject(surfaces.back(), 0.25,
+			DistantSky::MoonObject::Type::First));
+		distantSky.addMoonObject(DistantSky::MoonObject(surfaces.back(), 0.60,
+			DistantSky::MoonObject::Type::Second));
+
+		for (int i = 0; i < 500; i++)
+		{
+			const double yaw = static_cast<double>(i) * 2.39996;
+			const double pitch = 0.10 + (static_cast<double>((i * 7) % 100) / 100.0);
+			distantSky.addStarObject(DistantSky::StarObject::makeSmall(
+				0xFFFFFFFF, makeDirection(yaw, pitch)));
+		}
+
+		surfaces.push_back(makeSkySurface(48, 48, 0xFFFFF0A0, false));
+		distantSky.setSunSurface(surfaces.back());
+	}
+
+	// Gives the renderer the textures, flats, and sky for a scene.
+	void setupRenderer(SoftwareRenderer &renderer, const Scene &scene,
+		const DistantSky &distantSky)
+	{
+		renderer.clearTextures();
+		renderer.clearDistantSky();
+
+		for (int i = 0; i < TextureCount; i++)
+		{
+			const std::vector<uint32_t> texels = makeVoxelTexels(i);
+			const std::vector<uint8_t> paletteIndices = makeVoxelPaletteIndices(texels);
+			renderer.setVoxelTexture(i, texels.data(), paletteIndices.data());
+		}
+
+		const uint32_t flatColors[] = { 0xFF2E7D32, 0xFF8D6E63, 0xFF3949AB, 0xFFC62828 };
+		for (int i = 0; i < 4; i++)
+		{
+			const int width = 32 + (i * 16);
+			const int height = 64 + (i * 8);
+			const std::vector<uint32_t> texels = makeFlatTexels(width, height, flatColors[i]);
+			renderer.setFlatTexture(i, texels.data(), width, height);
+		}
+
+		for (size_t i = 0; i < scene.flatPositions.size(); i++)
+		{
+			const int id = static_cast<int>(i);
+			const int textureID = id % 4;
+			renderer.addFlat(id, scene.flatPositions[i], 0.50 + (0.25 * (id % 3)),
+				0.80 + (0.20 * (id % 4)), textureID);
+		}
+
+		if (scene.exterior)
+		{
+			// Night to noon to night, like the exterior sky palette.
+			std::vector<uint32_t> skyPalette(64);
+			for (int i = 0; i < static_cast<int>(skyPalette.size()); i++)
+			{
+				const double percent = static_cast<double>(i) /
+					static_cast<double>(skyPalette.size());
+				const double brightness = 0.50 - (0.50 * std::cos(percent * Constants::TwoPi));
+				skyPalette[i] = Double3(0.20 + (0.30 * brightness), 0.25 + (0.45 * brightness),
+					0.35 + (0.60 * brightness)).toRGB();
+			}
+
+			renderer.setSkyPalette(skyPalette.data(), static_cast<int>(skyPalette.size()));
+			renderer.setDistantSky(distantSky);
+		}
+		else
+		{
+			const uint32_t black = 0;
+			renderer.setSkyPalette(&black, 1);
+		}
+
+		renderer.setFogDistance(scene.fogDistance);
+		renderer.setNightLightsActive(false);
+	}
+
+	// Removes the scene's flats so the next scene can reuse the IDs.
+	void clearFlats(SoftwareRenderer &renderer, const Scene &scene)
+	{
+		for (size_t i = 0; i < scene.flatPositions.size(); i++)
+		{
+			renderer.removeFlat(static_cast<int>(i));
+		}
+	}
+
+	// Renders one pass of a scene's camera path and prints the results as one table row.
+	void runScene(SoftwareRenderer &renderer, Scene &scene, int threadsMode, int width,
+		int height, int frameCount, std::vector<uint32_t> &colorBuffer)
+	{
+		renderer.setRenderThreadsMode(threadsMode);
+
+		std::vector<double> frameTimes, skyGradientTimes, distantVisTimes, distantSkyTimes,
+			voxelTimes, planeTimes, flatVisTimes, flatTimes, paletteTimes, postTimes;
+
+		double totalSeconds = 0.0;
+		for (int i = -WARMUP_FRAMES; i < frameCount; i++)
+		{
+			const double percent = static_cast<double>(std::max(i, 0)) /
+				static_cast<double>(frameCount);
+			if (scene.update)
+			{
+				scene.update(scene, percent);
+			}
+
+			const CameraState cameraState = scene.cameraPath(percent);
+
+			// Parallax sky is off like the default options.
+			const auto frameStart = std::chrono::high_resolution_clock::now();
+			renderer.render(cameraState.eye, cameraState.direction, FOV_Y, scene.ambient,
+				cameraState.daytimePercent, scene.latitude, false, CEILING_HEIGHT,
+				scene.openDoors, scene.voxelGrid, colorBuffer.data());
+			const auto frameEnd = std::chrono::high_resolution_clock::now();
+
+			if (i < 0)
+			{
+				continue;
+			}
+
+			const double frameMs = std::chrono::duration<double, std::milli>(
+				frameEnd - frameStart).count();
+			totalSeconds += frameMs / 1000.0;
+			frameTimes.push_back(frameMs);
+
+			const SoftwareRenderer::FrameTimings &timings = renderer.getFrameTimings();
+			skyGradientTimes.push_back(timings.skyGradient);
+			distantVisTimes.push_back(timings.distantVisibility);
+			distantSkyTimes.push_back(timings.distantSky);
+			voxelTimes.push_back(timings.voxels);
+			planeTimes.push_back(timings.planes);
+			flatVisTimes.push_back(timings.flatVisibility);
+			flatTimes.push_back(timings.flats);
+			paletteTimes.push_back(timings.paletteResolve);
+			postTimes.push_back(timings.postProcessing);
+		}
+
+		// Simple checksum of the last frame so output changes are easy to spot between runs.
+		uint32_t checksum = 2166136261;
+		for (const uint32_t color : colorBuffer)
+		{
+			checksum = (checksum ^ color) * 16777619;
+		}
+
+		const Stats frameStats = makeStats(frameTimes);
+		const double pixelsPerSecond = (static_cast<double>(width) *
+			static_cast<double>(height) * static_cast<double>(frameCount)) / totalSeconds;
+
+		std::printf("%-13s %4d %7d | %7.2f %7.2f %7.2f %7.2f %7.2f | %8.1f |"
+			" %6.2f %6.2f %6.2f %6.2f %6.2f %6.2f %6.2f %6.2f %6.2f | %08x\n",
+			scene.name.c_str(), threadsMode, SoftwareRenderer::getRenderThreadsFromMode(threadsMode),
+			frameStats.avg, frameStats.p50, frameStats.p95, frameStats.p99, frameStats.max,
+			pixelsPerSecond / 1000000.0,
+			makeStats(skyGradientTimes).avg, makeStats(distantVisTimes).avg,
+			makeStats(distantSkyTimes).avg, makeStats(voxelTimes).avg, makeStats(planeTimes).avg,
+			makeStats(flatVisTimes).avg, makeStats(flatTimes).avg, makeStats(paletteTimes).avg,
+			makeStats(postTimes).avg, checksum);
+		std::fflush(stdout);
+	}
+
+	// Writes the frame buffer as a binary PPM image for eyeballing the output.
+	bool writePPM(const std::string &filename, const std::vector<uint32_t> &colorBuffer,
+		int width, int height)
+	{
+		std::FILE *file = std::fopen(filename.c_str(), "wb");
+		if (file == nullptr)
+		{
+			return false;
+		}
+
+		std::fprintf(file, "P6\n%d %d\n255\n", width, height);
+
+		std::vector<uint8_t> row(width * 3);
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				const uint32_t color = colorBuffer[x + (y * width)];
+				row[(x * 3)] = static_cast<uint8_t>(color >> 16);
+				row[(x * 3) + 1] = static_cast<uint8_t>(color >> 8);
+				row[(x * 3) + 2] = static_cast<uint8_t>(color);
+			}
+
+			std::fwrite(row.data(), 1, row.size(), file);
+		}
+
+		std::fclose(file);
+		return true;
+	}
+
+	// Reads a binary PPM image written by writePPM().
+	bool readPPM(const std::string &filename, std::vector<uint32_t> &colorBuffer,
+		int *width, int *height)
+	{
+		std::FILE *file = std::fopen(filename.c_str(), "rb");
+		if (file == nullptr)
+		{
+			return false;
+		}
+
+		int maxValue = 0;
+		const bool validHeader = (std::fscanf(file, "P6 %d %d %d", width, height, &maxValue) == 3) &&
+			(*width > 0) && (*height > 0) && (maxValue == 255) && (std::fgetc(file) == '\n');
+		if (!validHeader)
+		{
+			std::fclose(file);
+			return false;
+		}
+
+		std::vector<uint8_t> pixels(*width * *height * 3);
+		const bool success = std::fread(pixels.data(), 1, pixels.size(), file) == pixels.size();
+		std::fclose(file);
+
+		colorBuffer.resize(*width * *height);
+		for (size_t i = 0; i < colorBuffer.size(); i++)
+		{
+			colorBuffer[i] = 0xFF000000 | (pixels[(i * 3)] << 16) |
+				(pixels[(i * 3) + 1] << 8) | pixels[(i * 3) + 2];
+		}
+
+		return success;
+	}
+
+	// Renders the frame of a scene that is compared against its reference image.
+	void renderReferenceFrame(SoftwareRenderer &renderer, Scene &scene,
+		std::vector<uint32_t> &colorBuffer)
+	{
+		if (scene.update)
+		{
+			scene.update(scene, REFERENCE_PATH_PERCENT);
+		}
+
+		const CameraState cameraState = scene.cameraPath(REFERENCE_PATH_PERCENT);
+		renderer.render(cameraState.eye, cameraState.direction, FOV_Y, scene.ambient,
+			cameraState.daytimePercent, scene.latitude, false, CEILING_HEIGHT,
+			scene.openDoors, scene.voxelGrid, colorBuffer.data());
+	}
+
+	// Compares a frame against a scene's reference image and prints the result. Returns
+	// whether no more than the given percent of pixels are past the tolerance on any of the
+	// three channels.
+	bool compareReferenceFrame(const std::string &filename,
+		const std::vector<uint32_t> &colorBuffer, int width, int height, int tolerance,
+		double maxMismatchPercent)
+	{
+		std::vector<uint32_t> reference;
+		int referenceWidth, referenceHeight;
+		if (!readPPM(filename, reference, &referenceWidth, &referenceHeight))
+		{
+			std::printf("%-13s couldn't read reference \"%s\"\n", "", filename.c_str());
+			return false;
+		}
+
+		if ((referenceWidth != width) || (referenceHeight != height))
+		{
+			std::printf("%-13s reference \"%s\" is %dx%d, not %dx%d\n", "", filename.c_str(),
+				referenceWidth, referenceHeight, width, height);
+			return false;
+		}
+
+		int badPixelCount = 0;
+		int maxDiff = 0;
+		int firstBadX = -1;
+		int firstBadY = -1;
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				const int index = x + (y * width);
+				const uint32_t color = colorBuffer[index];
+				const uint32_t referenceColor = reference[index];
+
+				int pixelDiff = 0;
+				for (int shift = 0; shift <= 16; shift += 8)
+				{
+					const int channel = static_cast<int>((color >> shift) & 0xFF);
+					const int referenceChannel = static_cast<int>((referenceColor >> shift) & 0xFF);
+					pixelDiff = std::max(pixelDiff, std::abs(channel - referenceChannel));
+				}
+
+				maxDiff = std::max(maxDiff, pixelDiff);
+				if (pixelDiff > tolerance)
+				{
+					if (badPixelCount == 0)
+					{
+						firstBadX = x;
+						firstBadY = y;
+					}
+
+					badPixelCount++;
+				}
+			}
+		}
+
+		const double badPixelPercent = (static_cast<double>(badPixelCount) * 100.0) /
+			static_cast<double>(width * height);
+		if (badPixelPercent > maxMismatchPercent)
+		{
+			std::printf("%-13s reference FAILED: %d pixels (%.2f%%) differ by more than %d "
+				"(max %d, first at %d, %d)\n", "", badPixelCount, badPixelPercent, tolerance,
+				maxDiff, firstBadX, firstBadY);
+			return false;
+		}
+
+		std::printf("%-13s reference ok (max difference %d, %d pixels (%.2f%%) past %d)\n",
+			"", maxDiff, badPixelCount, badPixelPercent, tolerance);
+		return true;
+	}
+
+	void printUsage(const char *programName)
+	{
+		std::printf("Usage: %s [--width N] [--height N] [--frames N] [--mode N] [--scene NAME]"
+			" [--indexed] [--debug-view overdraw|steps] [--dump]\n"
+			"  [--reference DIR] [--write-reference DIR] [--tolerance N] [--max-mismatch P]\n"
+			"  --mode     render threads mode 0-5 (default: every mode)\n"
+			"  --scene    open, city, maze, palace, or terraces (default: every scene)\n"
+			"  --indexed  draw voxels with indexed color\n"
+			"  --debug-view  draw an overdraw or ray step heatmap and print its counters\n"
+			"  --dump     write each scene's last frame to <scene>.ppm\n"
+			"  --reference  compare each scene's reference frame with DIR/<scene>.ppm and\n"
+			"               fail if too many pixels differ by more than the tolerance\n"
+			"  --write-reference  write each scene's reference frame to DIR/<scene>.ppm\n"
+			"  --tolerance  max per-channel difference for --reference (default: %d)\n"
+			"  --max-mismatch  max percent of pixels past the tolerance (default: %.1f)\n",
+			programName, DEFAULT_TOLERANCE, DEFAULT_MAX_MISMATCH_PERCENT);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int width = DEFAULT_WIDTH;
+	int height = DEFAULT_HEIGHT;
+	int frameCount = DEFAULT_FRAMES;
+	int onlyMode = -1;
+	std::string onlyScene;
+	bool indexedColor = false;
+	uint32_t debugViewParams = 0;
+	bool dumpFrames = false;
+	std::string referenceDir, writeReferenceDir;
+	int tolerance = DEFAULT_TOLERANCE;
+	double maxMismatchPercent = DEFAULT_MAX_MISMATCH_PERCENT;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		const bool hasValue = (i + 1) < argc;
+		if ((arg == "--width") && hasValue)
+		{
+			width = std::atoi(argv[++i]);
+		}
+		else if ((arg == "--height") && hasValue)
+		{
+			height = std::atoi(argv[++i]);
+		}
+		else if ((arg == "--frames") && hasValue)
+		{
+			frameCount = std::atoi(argv[++i]);
+		}
+		else if ((arg == "--mode") && hasValue)
+		{
+			onlyMode = std::atoi(argv[++i]);
+		}
+		else if ((arg == "--scene") && hasValue)
+		{
+			onlyScene = argv[++i];
+		}
+		else if (arg == "--indexed")
+		{
+			indexedColor = true;
+		}
+		else if ((arg == "--debug-view") && hasValue)
+		{
+			const std::string debugView = argv[++i];
+			if (debugView == "overdraw")
+			{
+				debugViewParams = RenderParams::DebugOverdraw;
+			}
+			else if (debugView == "steps")
+			{
+				debugViewParams = RenderParams::DebugRaySteps;
+			}
+			else
+			{
+				printUsage(argv[0]);
+				return EXIT_FAILURE;
+			}
+		}
+		else if (arg == "--dump")
+		{
+			dumpFrames = true;
+		}
+		else if ((arg == "--reference") && hasValue)
+		{
+			referenceDir = argv[++i];
+		}
+		else if ((arg == "--write-reference") && hasValue)
+		{
+			writeReferenceDir = argv[++i];
+		}
+		else if ((arg == "--tolerance") && hasValue)
+		{
+			tolerance = std::atoi(argv[++i]);
+		}
+		else if ((arg == "--max-mismatch") && hasValue)
+		{
+			maxMismatchPercent = std::atof(argv[++i]);
+		}
+		else
+		{
+			printUsage(argv[0]);
+			return (arg == "--help") ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if ((width <= 0) || (height <= 0) || (frameCount <= 0) || (tolerance < 0) ||
+		(maxMismatchPercent < 0.0))
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	std::vector<std::pair<std::string, std::function<Scene()>>> sceneMakers =
+	{
+		{ "open", makeOpenField },
+		{ "city", makeDenseCity },
+		{ "maze", makeMazeDungeon },
+		{ "palace", makeDoorPalace },
+		{ "terraces", makeTerraces }
+	};
+
+	std::deque<Surface> skySurfaces;
+	DistantSky distantSky;
+	makeDistantSky(distantSky, skySurfaces);
+
+	SoftwareRenderer renderer;
+	renderer.init(width, height, 0,
+		(indexedColor ? RenderParams::IndexedColor : 0) | debugViewParams);
+
+	if (indexedColor)
+	{
+		const std::vector<uint32_t> voxelPalette = makeVoxelPalette();
+		renderer.setVoxelPalette(voxelPalette.data(), static_cast<int>(voxelPalette.size()));
+	}
+
+	std::vector<uint32_t> colorBuffer(width * height);
+	bool referencesMatch = true;
+
+	std::printf("%dx%d, %d frames per run (+%d warmup)%s\n", width, height, frameCount,
+		WARMUP_FRAMES, indexedColor ? ", indexed color" : "");
+	std::printf("%-13s %4s %7s | %7s %7s %7s %7s %7s | %8s |"
+		" %6s %6s %6s %6s %6s %6s %6s %6s %6s | %8s\n",
+		"scene", "mode", "threads", "avg ms", "p50", "p95", "p99", "max", "Mpix/s",
+		"sky", "disVis", "dist", "voxel", "plane", "flatVs", "flat", "pal", "post", "checksum");
+
+	for (const auto &sceneMaker : sceneMakers)
+	{
+		if (!onlyScene.empty() && (onlyScene != sceneMaker.first))
+		{
+			continue;
+		}
+
+		Scene scene = sceneMaker.second();
+		setupRenderer(renderer, scene, distantSky);
+
+		int prevThreadCount = -1;
+		for (int mode = 0; mode <= 5; mode++)
+		{
+			if ((onlyMode >= 0) && (mode != onlyMode))
+			{
+				continue;
+			}
+
+			// Skip modes that resolve to the same thread count on this machine.
+			const int threadCount = SoftwareRenderer::getRenderThreadsFromMode(mode);
+			if ((onlyMode < 0) && (threadCount == prevThreadCount))
+			{
+				continue;
+			}
+
+			prevThreadCount = threadCount;
+			runScene(renderer, scene, mode, width, height, frameCount, colorBuffer);
+		}
+
+		if (debugViewParams != 0)
+		{
+			// Counters from the scene's last frame.
+			const SoftwareRenderer::DebugViewStats &debugViewStats = renderer.getDebugViewStats();
+			std::printf("%-13s overdraw avg %.2f max %d, ray steps avg %.1f max %d\n", "",
+				debugViewStats.avgOverdraw, debugViewStats.maxOverdraw,
+				debugViewStats.avgRaySteps, debugViewStats.maxRaySteps);
+		}
+
+		if (dumpFrames)
+		{
+			const std::string filename = sceneMaker.first + ".ppm";
+			if (!writePPM(filename, colorBuffer, width, height))
+			{
+				std::fprintf(stderr, "Couldn't write \"%s\".\n", filename.c_str());
+			}
+		}
+
+		if (!referenceDir.empty() || !writeReferenceDir.empty())
+		{
+			renderReferenceFrame(renderer, scene, colorBuffer);
+
+			if (!writeReferenceDir.empty())
+			{
+				const std::string filename = writeReferenceDir + "/" + sceneMaker.first + ".ppm";
+				if (!writePPM(filename, colorBuffer, width, height))
+				{
+					std::fprintf(stderr, "Couldn't write \"%s\".\n", filename.c_str());
+					referencesMatch = false;
+				}
+			}
+
+			if (!referenceDir.empty())
+			{
+				const std::string filename = referenceDir + "/" + sceneMaker.first + ".ppm";
+				referencesMatch &= compareReferenceFrame(filename, colorBuffer, width, height,
+					tolerance, maxMismatchPercent);
+			}
+		}
+
+		clearFlats(renderer, scene);
+	}
+
+	return referencesMatch ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,427 @@
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../src/Assets/ArenaSave.h"
+#include "../src/Assets/ArenaTypes.h"
+#include "../src/Utilities/File.h"
+#include "../src/Utilities/String.h"
+
+// Round-trip and crash recovery checks for the save files, on synthetic data only (no game
+// files needed). Each record type is initialized from random bytes and written back, which
+// must give the same bytes. Then a slot is saved to a scratch folder and loaded again, with
+// the files of an interrupted save (before and after its commit) left behind in between.
+// Then it reports how long saving and loading a slot take.
+
+namespace
+{
+	const int DEFAULT_ITERATIONS = 20;
+	const int ROUND_TRIPS = 20;
+	const unsigned int DEFAULT_SEED = 1;
+	const int SLOT_INDEX = 3;
+
+	// Every file a slot check can leave in the scratch folder.
+	const std::array<const char*, 9> SlotFilenames =
+	{
+		"AUTOMAP", "LOG", "MANIFEST", "SAVEENGN", "SAVEGAME", "SPELLS", "SPELLSG", "STATE", "NAMES"
+	};
+
+	void printUsage(const char *programName)
+	{
+		std::printf("Usage: %s <scratch folder> [--iterations N] [--seed N]\n", programName);
+	}
+
+	double getElapsedMilliseconds(std::chrono::steady_clock::time_point start)
+	{
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+		return std::chrono::duration<double, std::milli>(elapsed).count();
+	}
+
+	std::vector<uint8_t> makeRandomBytes(size_t size, std::mt19937 &rng)
+	{
+		std::uniform_int_distribution<int> byteDist(0, 255);
+		std::vector<uint8_t> bytes(size);
+		for (uint8_t &byte : bytes)
+		{
+			byte = static_cast<uint8_t>(byteDist(rng));
+		}
+
+		return bytes;
+	}
+
+	template <typename T>
+	std::vector<uint8_t> getRecordBytes(const T &record)
+	{
+		std::vector<uint8_t> bytes(T::SIZE, 0);
+		record.write(bytes.data());
+		return bytes;
+	}
+
+	template <typename T>
+	std::vector<uint8_t> getSpellsBytes(const T &spells)
+	{
+		std::vector<uint8_t> bytes(ArenaTypes::SpellData::SIZE * spells.size(), 0);
+		ArenaTypes::SpellData::writeArray(spells, bytes.data());
+		return bytes;
+	}
+
+	template <typename T>
+	std::unique_ptr<T> makeRecord(const std::vector<uint8_t> &bytes)
+	{
+		auto record = std::make_unique<T>();
+		record->init(bytes.data());
+		return record;
+	}
+
+	template <typename T>
+	std::unique_ptr<T> makeSpells(const std::vector<uint8_t> &bytes)
+	{
+		auto spells = std::make_unique<T>();
+		ArenaTypes::SpellData::initArray(*spells, bytes.data());
+		return spells;
+	}
+
+	std::string makeLogText(int entryCount, std::mt19937 &rng)
+	{
+		std::uniform_int_distribution<int> numberDist(0, 9999);
+		std::string text;
+		for (int i = 0; i < entryCount; i++)
+		{
+			text += "&Entry " + std::to_string(numberDist(rng)) + "\nBody of entry " +
+				std::to_string(i) + ", " + std::to_string(numberDist(rng)) + ". *";
+		}
+
+		return text;
+	}
+
+	// Reports a failed check and returns 1, for adding to the failure count.
+	int fail(const std::string &message)
+	{
+		std::printf("FAILED: %s\n", message.c_str());
+		return 1;
+	}
+
+	// Checks that write(init(bytes)) == bytes on random records of a fixed size.
+	template <typename T>
+	int checkRecordRoundTrip(const char *name, std::mt19937 &rng)
+	{
+		int failures = 0;
+		for (int i = 0; i < ROUND_TRIPS; i++)
+		{
+			const std::vector<uint8_t> bytes = makeRandomBytes(T::SIZE, rng);
+			if (getRecordBytes(*makeRecord<T>(bytes)) != bytes)
+			{
+				failures += fail(std::string(name) + " round trip " + std::to_string(i));
+			}
+		}
+
+		return failures;
+	}
+
+	template <typename T>
+	int checkSpellsRoundTrip(const char *name, std::mt19937 &rng)
+	{
+		int failures = 0;
+		for (int i = 0; i < ROUND_TRIPS; i++)
+		{
+			const std::vector<uint8_t> bytes = makeRandomBytes(
+				ArenaTypes::SpellData::SIZE * std::tuple_size<T>::value, rng);
+			if (getSpellsBytes(*makeSpells<T>(bytes)) != bytes)
+			{
+				failures += fail(std::string(name) + " round trip " + std::to_string(i));
+			}
+		}
+
+		return failures;
+	}
+
+	int checkLogRoundTrip(std::mt19937 &rng)
+	{
+		int failures = 0;
+		for (int i = 0; i < ROUND_TRIPS; i++)
+		{
+			const std::string text = makeLogText(i, rng);
+			ArenaTypes::Log log;
+			log.init(text);
+			if (log.write() != text)
+			{
+				failures += fail("LOG round trip " + std::to_string(i));
+			}
+		}
+
+		return failures;
+	}
+
+	std::unique_ptr<ArenaSave::Slot> makeSlot(std::mt19937 &rng)
+	{
+		auto slot = std::make_unique<ArenaSave::Slot>();
+		slot->automap = makeRecord<ArenaTypes::Automap>(
+			makeRandomBytes(ArenaTypes::Automap::SIZE, rng));
+		slot->log = std::make_unique<ArenaTypes::Log>();
+		slot->log->init(makeLogText(8, rng));
+		slot->spells = makeSpells<ArenaTypes::Spells>(makeRandomBytes(
+			ArenaTypes::SpellData::SIZE * std::tuple_size<ArenaTypes::Spells>::value, rng));
+		slot->spellsg = makeSpells<ArenaTypes::Spellsg>(makeRandomBytes(
+			ArenaTypes::SpellData::SIZE * std::tuple_size<ArenaTypes::Spellsg>::value, rng));
+		slot->state = makeRecord<ArenaTypes::MQLevelState>(
+			makeRandomBytes(ArenaTypes::MQLevelState::SIZE, rng));
+		slot->saveEngine = makeRandomBytes(ArenaTypes::SaveEngine::SIZE, rng);
+		slot->saveGame = makeRandomBytes(ArenaTypes::SaveGame::SIZE, rng);
+		return slot;
+	}
+
+	// Compares two slots record by record. Returns the number of records that differ.
+	int compareSlots(const ArenaSave::Slot &a, const ArenaSave::Slot &b, const std::string &what)
+	{
+		int failures = 0;
+		auto check = [&failures, &what](bool same, const char *record)
+		{
+			if (!same)
+			{
+				failures += fail(what + ": " + record + " differs");
+			}
+		};
+
+		check((a.automap == nullptr) == (b.automap == nullptr) && ((a.automap == nullptr) ||
+			(getRecordBytes(*a.automap) == getRecordBytes(*b.automap))), "AUTOMAP");
+		check((a.log == nullptr) == (b.log == nullptr) && ((a.log == nullptr) ||
+			(a.log->write() == b.log->write())), "LOG");
+		check((a.spells == nullptr) == (b.spells == nullptr) && ((a.spells == nullptr) ||
+			(getSpellsBytes(*a.spells) == getSpellsBytes(*b.spells))), "SPELLS");
+		check((a.spellsg == nullptr) == (b.spellsg == nullptr) && ((a.spellsg == nullptr) ||
+			(getSpellsBytes(*a.spellsg) == getSpellsBytes(*b.spellsg))), "SPELLSG");
+		check((a.state == nullptr) == (b.state == nullptr) && ((a.state == nullptr) ||
+			(getRecordBytes(*a.state) == getRecordBytes(*b.state))), "STATE");
+		check(a.saveEngine == b.saveEngine, "SAVEENGN");
+		check(a.saveGame == b.saveGame, "SAVEGAME");
+		return failures;
+	}
+
+	void writeRawFile(const std::string &filename, const std::vector<uint8_t> &bytes)
+	{
+		std::ofstream ofs(filename, std::ios::binary);
+		ofs.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+	}
+
+	// Leaves the temporary files of a slot save behind as if the game had crashed while
+	// writing it, either before or after its manifest was committed.
+	void writeInterruptedSave(const std::string &folder, const ArenaSave::Slot &slot,
+		bool committed)
+	{
+		const std::string extension = ".0" + std::to_string(SLOT_INDEX);
+		const std::vector<std::pair<std::string, std::vector<uint8_t>>> files =
+		{
+			{ "AUTOMAP" + extension, getRecordBytes(*slot.automap) },
+			{ "SPELLS" + extension, getSpellsBytes(*slot.spells) },
+			{ "STATE" + extension, getRecordBytes(*slot.state) },
+			{ "SAVEGAME" + extension, slot.saveGame }
+		};
+
+		for (const auto &file : files)
+		{
+			writeRawFile(folder + file.first + ".TMP", file.second);
+		}
+
+		if (committed)
+		{
+			// Same format as ArenaSave's manifests.
+			std::string manifest = "PENDING\n";
+			for (const auto &file : files)
+			{
+				manifest += file.first + '\n';
+			}
+
+			writeRawFile(folder + "MANIFEST" + extension,
+				std::vector<uint8_t>(manifest.begin(), manifest.end()));
+		}
+	}
+
+	bool anyTempFiles(const std::string &folder)
+	{
+		const std::string extension = ".0" + std::to_string(SLOT_INDEX);
+		for (const char *filename : SlotFilenames)
+		{
+			if (File::exists(folder + filename + extension + ".TMP"))
+			{
+				return true;
+			}
+		}
+
+		return File::exists(folder + "NAMES.DAT.TMP");
+	}
+
+	void removeSlotFiles(const std::string &folder)
+	{
+		const std::string extension = ".0" + std::to_string(SLOT_INDEX);
+		for (const char *filename : SlotFilenames)
+		{
+			std::remove((folder + filename + extension).c_str());
+			std::remove((folder + filename + extension + ".TMP").c_str());
+		}
+
+		std::remove((folder + "NAMES.DAT").c_str());
+		std::remove((folder + "NAMES.DAT.TMP").c_str());
+	}
+
+	int checkSlots(const std::string &folder, std::mt19937 &rng)
+	{
+		int failures = 0;
+
+		// Plain save and load.
+		const auto slot = makeSlot(rng);
+		ArenaSave::saveSlot(folder, SLOT_INDEX, "Check", *slot);
+		failures += compareSlots(*slot, *ArenaSave::loadSlot(folder, SLOT_INDEX), "save/load");
+
+		const auto headers = ArenaSave::loadSlotHeaders(folder);
+		if (!headers.at(SLOT_INDEX).used || (headers.at(SLOT_INDEX).name != "Check"))
+		{
+			failures += fail("slot header after saving");
+		}
+
+		// A crash before the commit leaves the old slot.
+		const auto newSlot = makeSlot(rng);
+		writeInterruptedSave(folder, *newSlot, false);
+		failures += compareSlots(*slot, *ArenaSave::loadSlot(folder, SLOT_INDEX),
+			"uncommitted save");
+
+		if (anyTempFiles(folder))
+		{
+			failures += fail("temporary files left after an uncommitted save");
+		}
+
+		// A crash after the commit is finished on the next load.
+		writeInterruptedSave(folder, *newSlot, true);
+		const auto recoveredSlot = ArenaSave::loadSlot(folder, SLOT_INDEX);
+		failures += (getRecordBytes(*recoveredSlot->automap) ==
+			getRecordBytes(*newSlot->automap)) ? 0 : fail("committed save: AUTOMAP differs");
+		failures += (getRecordBytes(*recoveredSlot->state) ==
+			getRecordBytes(*newSlot->state)) ? 0 : fail("committed save: STATE differs");
+		failures += (recoveredSlot->saveGame == newSlot->saveGame) ? 0 :
+			fail("committed save: SAVEGAME differs");
+
+		// Records that the committed save didn't list are from an older save.
+		failures += (recoveredSlot->log == nullptr) ? 0 :
+			fail("committed save: LOG from the older save was read");
+
+		if (anyTempFiles(folder))
+		{
+			failures += fail("temporary files left after a committed save");
+		}
+
+		// A slot saved without some records doesn't pick up the old files.
+		auto partialSlot = makeSlot(rng);
+		partialSlot->automap = nullptr;
+		partialSlot->spellsg = nullptr;
+		ArenaSave::saveSlot(folder, SLOT_INDEX, "Partial", *partialSlot);
+		failures += compareSlots(*partialSlot, *ArenaSave::loadSlot(folder, SLOT_INDEX),
+			"partial save");
+
+		return failures;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const std::string folder = String::addTrailingSlashIfMissing(argv[1]);
+	int iterations = DEFAULT_ITERATIONS;
+	unsigned int seed = DEFAULT_SEED;
+
+	for (int i = 2; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		const bool hasValue = (i + 1) < argc;
+		if ((arg == "--iterations") && hasValue)
+		{
+			iterations = std::atoi(argv[++i]);
+		}
+		else if ((arg == "--seed") && hasValue)
+		{
+			seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else
+		{
+			printUsage(argv[0]);
+			return (arg == "--help") ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (iterations < 0)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	// Don't touch a folder with real saves in it.
+	if (File::exists(folder + "NAMES.DAT"))
+	{
+		std::printf("\"%s\" already has a NAMES.DAT. Use an empty folder.\n", folder.c_str());
+		return EXIT_FAILURE;
+	}
+
+	std::mt19937 rng(seed);
+	int failures = 0;
+	failures += checkRecordRoundTrip<ArenaTypes::Automap>("AUTOMAP", rng);
+	failures += checkRecordRoundTrip<ArenaTypes::MQLevelState>("STATE", rng);
+	failures += checkRecordRoundTrip<ArenaTypes::Names>("NAMES", rng);
+	failures += checkRecordRoundTrip<ArenaTypes::Repair>("RE", rng);
+	failures += checkRecordRoundTrip<ArenaTypes::Tavern>("IN", rng);
+	failures += checkSpellsRoundTrip<ArenaTypes::Spells>("SPELLS", rng);
+	failures += checkSpellsRoundTrip<ArenaTypes::Spellsg>("SPELLSG", rng);
+	failures += checkLogRoundTrip(rng);
+	std::printf("Record round trips: %s.\n", (failures == 0) ? "all identical" : "FAILED");
+
+	const int slotFailures = [&folder, &rng]()
+	{
+		try
+		{
+			return checkSlots(folder, rng);
+		}
+		catch (const std::exception &e)
+		{
+			return fail(std::string("slot check threw: ") + e.what());
+		}
+	}();
+
+	std::printf("Slot save, load, and recovery: %s.\n", (slotFailures == 0) ? "ok" : "FAILED");
+	failures += slotFailures;
+
+	if ((iterations > 0) && (failures == 0))
+	{
+		const auto slot = makeSlot(rng);
+		double saveMs = 0.0;
+		double loadMs = 0.0;
+		for (int i = 0; i < iterations; i++)
+		{
+			auto saveStart = std::chrono::steady_clock::now();
+			ArenaSave::saveSlot(folder, SLOT_INDEX, "Benchmark", *slot);
+			saveMs += getElapsedMilliseconds(saveStart);
+
+			auto loadStart = std::chrono::steady_clock::now();
+			ArenaSave::loadSlot(folder, SLOT_INDEX);
+			loadMs += getElapsedMilliseconds(loadStart);
+		}
+
+		std::printf("\n%12s %12s\n", "save ms", "load ms");
+		std::printf("%12.2f %12.2f\n", saveMs / static_cast<double>(iterations),
+			loadMs / static_cast<double>(iterations));
+	}
+
+	removeSlotFiles(folder);
+	return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
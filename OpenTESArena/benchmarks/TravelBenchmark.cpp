@@ -0,0 +1,467 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/Assets/CityDataFile.h"
+#include "../src/Assets/ExeData.h"
+#include "../src/Assets/MiscAssets.h"
+#include "../src/Math/Random.h"
+#include "../src/Math/Rect.h"
+#include "../src/Utilities/File.h"
+#include "../src/Utilities/String.h"
+#include "../src/World/WeatherType.h"
+
+#include "components/vfs/manager.hpp"
+
+// Cross-check and benchmark for the travel cost raster in CityDataFile. Travel times depend
+// on the world map terrain and the executable's speed tables, so it either reads the original
+// game data, or with --synthetic writes a made-up CITYDATA.00 and TERRAIN.IMG into a scratch
+// folder and uses random speed tables. For every pair of locations (visible and hidden),
+// every month, and a few weather sets, it checks that the raster queries give the same days as
+// the original per-pixel getTravelDays(). The per-province batch skips hidden locations, so
+// like the province map it falls back to the single raster query for them. Then it reports
+// query times.
+
+namespace
+{
+	const int DEFAULT_WEATHER_SETS = 4;
+	const unsigned int DEFAULT_SEED = 1;
+	const int MONTH_COUNT = 12;
+	const int PROVINCE_COUNT = 9;
+	const int LOCATION_COUNT = 48;
+	const int WEATHER_TYPE_COUNT = 8;
+
+	using Weathers = std::array<WeatherType, 36>;
+
+	// Synthetic world map layout. Provinces tile the map in a 3x3 grid, since a trip
+	// through a point outside every province is an error.
+	const int WORLD_MAP_WIDTH = 320;
+	const int WORLD_MAP_HEIGHT = 200;
+	const int PROVINCE_GRID_SIZE = 3;
+	const uint8_t TERRAIN_FIRST = 248; // Sea. Land types go up to TERRAIN_LAST.
+	const uint8_t TERRAIN_LAST = 254;
+
+	// Every file the synthetic mode writes.
+	const std::array<const char*, 3> SyntheticFilenames =
+	{
+		"GLOBAL.BSA", "CITYDATA.00", "TERRAIN.IMG"
+	};
+
+	using ClimateSpeedTables = std::array<std::array<uint8_t, 12>, 7>;
+	using WeatherSpeedTables = std::array<std::array<uint8_t, 8>, 7>;
+
+	struct LocationRef
+	{
+		int locationID, provinceID;
+	};
+
+	void printUsage(const char *programName)
+	{
+		std::printf("Usage: %s <arena path> [--weathers N] [--seed N]\n", programName);
+		std::printf("       %s --synthetic <scratch folder> [--weathers N] [--seed N]\n",
+			programName);
+	}
+
+	void writeLE16(std::vector<uint8_t> &bytes, size_t offset, int value)
+	{
+		bytes[offset] = static_cast<uint8_t>(value & 0xFF);
+		bytes[offset + 1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+	}
+
+	bool writeFile(const std::string &path, const std::vector<uint8_t> &bytes)
+	{
+		std::ofstream stream(path, std::ios::binary);
+		stream.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+		return stream.good();
+	}
+
+	// Gets a province's rectangle in the 3x3 grid. The center province is last, like in
+	// CITYDATA.00. Rectangles include their right and bottom edges.
+	Rect getSyntheticProvinceRect(int provinceID)
+	{
+		const int cell = (provinceID < 4) ? provinceID :
+			((provinceID < (PROVINCE_COUNT - 1)) ? (provinceID + 1) : 4);
+		const int cellX = cell % PROVINCE_GRID_SIZE;
+		const int cellY = cell / PROVINCE_GRID_SIZE;
+		const int left = (cellX * WORLD_MAP_WIDTH) / PROVINCE_GRID_SIZE;
+		const int top = (cellY * WORLD_MAP_HEIGHT) / PROVINCE_GRID_SIZE;
+		const int right = (((cellX + 1) * WORLD_MAP_WIDTH) / PROVINCE_GRID_SIZE) - 1;
+		const int bottom = (((cellY + 1) * WORLD_MAP_HEIGHT) / PROVINCE_GRID_SIZE) - 1;
+		return Rect(left, top, right - left, bottom - top);
+	}
+
+	// Writes GLOBAL.BSA (empty), CITYDATA.00, and TERRAIN.IMG into the folder. Locations
+	// are at random points. Cities, towns, and villages are visible, the main quest dungeons
+	// are hidden, and random dungeons are visible half of the time. The center province
+	// only has its city, with every other location zeroed like in the original file.
+	bool writeSyntheticData(const std::string &folder, std::mt19937 &rng)
+	{
+		const std::vector<uint8_t> globalBsa(2, 0);
+
+		const size_t provinceSize = 1228;
+		const size_t locationSize = 25;
+		const size_t nameSize = 20;
+		std::vector<uint8_t> cityData(provinceSize * PROVINCE_COUNT, 0);
+		std::uniform_int_distribution<int> xDist(0, WORLD_MAP_WIDTH - 1);
+		std::uniform_int_distribution<int> yDist(0, WORLD_MAP_HEIGHT - 1);
+		std::uniform_int_distribution<int> coinDist(0, 1);
+		for (int provinceID = 0; provinceID < PROVINCE_COUNT; provinceID++)
+		{
+			const size_t provinceOffset = provinceSize * provinceID;
+			const std::string provinceName = "Province" + std::to_string(provinceID);
+			std::copy(provinceName.begin(), provinceName.end(), cityData.begin() + provinceOffset);
+
+			const Rect rect = getSyntheticProvinceRect(provinceID);
+			writeLE16(cityData, provinceOffset + nameSize, rect.getLeft());
+			writeLE16(cityData, provinceOffset + nameSize + 2, rect.getTop());
+			writeLE16(cityData, provinceOffset + nameSize + 4, rect.getWidth());
+			writeLE16(cityData, provinceOffset + nameSize + 6, rect.getHeight());
+
+			// Locations are in file order: cities, towns, villages, the two main quest
+			// dungeons, then random dungeons.
+			const bool isCenter = provinceID == (PROVINCE_COUNT - 1);
+			const int locationCount = isCenter ? 1 : LOCATION_COUNT;
+			for (int i = 0; i < locationCount; i++)
+			{
+				const size_t offset = provinceOffset + nameSize + 8 + (locationSize * i);
+				const std::string name = "Location" + std::to_string(i);
+				std::copy(name.begin(), name.end(), cityData.begin() + offset);
+				writeLE16(cityData, offset + nameSize, xDist(rng));
+				writeLE16(cityData, offset + nameSize + 2, yDist(rng));
+
+				const bool isMainQuestDungeon = (i == 32) || (i == 33);
+				const bool isRandomDungeon = i > 33;
+				const bool isVisible = !isMainQuestDungeon &&
+					(!isRandomDungeon || (coinDist(rng) != 0));
+				cityData[offset + nameSize + 4] = isVisible ? 0x02 : 0;
+			}
+		}
+
+		// The terrain reader skips the 12-byte .IMG header, so it's left zeroed.
+		const size_t imgHeaderSize = 12;
+		std::vector<uint8_t> terrain(imgHeaderSize + (WORLD_MAP_WIDTH * WORLD_MAP_HEIGHT), 0);
+		std::uniform_int_distribution<int> terrainDist(TERRAIN_FIRST, TERRAIN_LAST);
+		std::generate(terrain.begin() + imgHeaderSize, terrain.end(),
+			[&terrainDist, &rng]() { return static_cast<uint8_t>(terrainDist(rng)); });
+
+		return writeFile(folder + SyntheticFilenames[0], globalBsa) &&
+			writeFile(folder + SyntheticFilenames[1], cityData) &&
+			writeFile(folder + SyntheticFilenames[2], terrain);
+	}
+
+	void removeSyntheticData(const std::string &folder)
+	{
+		for (const char *filename : SyntheticFilenames)
+		{
+			std::remove((folder + filename).c_str());
+		}
+	}
+
+	// Random speed tables. Weather speeds are sometimes zero, which means 100.
+	void makeSyntheticSpeedTables(ClimateSpeedTables &climateSpeedTables,
+		WeatherSpeedTables &weatherSpeedTables, std::mt19937 &rng)
+	{
+		std::uniform_int_distribution<int> climateDist(10, 60);
+		std::uniform_int_distribution<int> weatherDist(50, 120);
+		std::uniform_int_distribution<int> zeroDist(0, 3);
+		for (auto &speeds : climateSpeedTables)
+		{
+			for (uint8_t &speed : speeds)
+			{
+				speed = static_cast<uint8_t>(climateDist(rng));
+			}
+		}
+
+		for (auto &speeds : weatherSpeedTables)
+		{
+			for (uint8_t &speed : speeds)
+			{
+				speed = (zeroDist(rng) == 0) ? 0 : static_cast<uint8_t>(weatherDist(rng));
+			}
+		}
+	}
+
+	double getElapsedMilliseconds(std::chrono::steady_clock::time_point start)
+	{
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+		return std::chrono::duration<double, std::milli>(elapsed).count();
+	}
+
+	std::vector<LocationRef> getLocations()
+	{
+		std::vector<LocationRef> locations;
+		for (int provinceID = 0; provinceID < PROVINCE_COUNT; provinceID++)
+		{
+			for (int locationID = 0; locationID < LOCATION_COUNT; locationID++)
+			{
+				locations.push_back(LocationRef { locationID, provinceID });
+			}
+		}
+
+		return locations;
+	}
+
+	int getHiddenLocationCount(const CityDataFile &cityData)
+	{
+		int count = 0;
+		for (int provinceID = 0; provinceID < PROVINCE_COUNT; provinceID++)
+		{
+			const auto &province = cityData.getProvinceData(provinceID);
+			for (int locationID = 0; locationID < LOCATION_COUNT; locationID++)
+			{
+				count += province.getLocationData(locationID).isVisible() ? 0 : 1;
+			}
+		}
+
+		return count;
+	}
+
+	// The first set is all clear, and the rest are random.
+	std::vector<Weathers> makeWeatherSets(int count, std::mt19937 &rng)
+	{
+		std::uniform_int_distribution<int> weatherDist(0, WEATHER_TYPE_COUNT - 1);
+		std::vector<Weathers> weatherSets;
+		for (int i = 0; i < count; i++)
+		{
+			Weathers weathers;
+			for (WeatherType &weather : weathers)
+			{
+				weather = (i == 0) ? WeatherType::Clear :
+					static_cast<WeatherType>(weatherDist(rng));
+			}
+
+			weatherSets.push_back(weathers);
+		}
+
+		return weatherSets;
+	}
+
+	// Gets the travel days with the original per-pixel path, or -1 if it throws.
+	int getReferenceDays(const CityDataFile &cityData, const LocationRef &start,
+		const LocationRef &end, int month, const Weathers &weathers, const ArenaRandom &random,
+		const MiscAssets &miscAssets)
+	{
+		try
+		{
+			ArenaRandom tempRandom = random;
+			return cityData.getTravelDays(start.locationID, start.provinceID, end.locationID,
+				end.provinceID, month, weathers, tempRandom, miscAssets);
+		}
+		catch (const std::exception&)
+		{
+			return -1;
+		}
+	}
+
+	// Same as above, with the raster.
+	int getRasterDays(const CityDataFile &cityData, const LocationRef &start,
+		const LocationRef &end, int month, const CityDataFile::TravelCostRaster &raster,
+		const ArenaRandom &random, const MiscAssets &miscAssets)
+	{
+		try
+		{
+			ArenaRandom tempRandom = random;
+			return cityData.getTravelDays(start.locationID, start.provinceID, end.locationID,
+				end.provinceID, month, raster, tempRandom, miscAssets);
+		}
+		catch (const std::exception&)
+		{
+			return -1;
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const bool isSynthetic = std::string(argv[1]) == "--synthetic";
+	const int pathIndex = isSynthetic ? 2 : 1;
+	if (pathIndex >= argc)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const std::string arenaPath = String::addTrailingSlashIfMissing(argv[pathIndex]);
+	int weatherSetCount = DEFAULT_WEATHER_SETS;
+	unsigned int seed = DEFAULT_SEED;
+
+	for (int i = pathIndex + 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		const bool hasValue = (i + 1) < argc;
+		if ((arg == "--weathers") && hasValue)
+		{
+			weatherSetCount = std::atoi(argv[++i]);
+		}
+		else if ((arg == "--seed") && hasValue)
+		{
+			seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else
+		{
+			printUsage(argv[0]);
+			return (arg == "--help") ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (weatherSetCount < 1)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	std::mt19937 rng(seed);
+	MiscAssets miscAssets;
+	if (isSynthetic)
+	{
+		// Don't touch a folder with real game data in it.
+		for (const char *filename : SyntheticFilenames)
+		{
+			if (File::exists(arenaPath + filename))
+			{
+				std::printf("\"%s\" already has a %s. Use an empty folder.\n",
+					arenaPath.c_str(), filename);
+				return EXIT_FAILURE;
+			}
+		}
+
+		if (!writeSyntheticData(arenaPath, rng))
+		{
+			std::printf("Couldn't write the synthetic data to \"%s\".\n", arenaPath.c_str());
+			removeSyntheticData(arenaPath);
+			return EXIT_FAILURE;
+		}
+
+		ClimateSpeedTables climateSpeedTables;
+		WeatherSpeedTables weatherSpeedTables;
+		makeSyntheticSpeedTables(climateSpeedTables, weatherSpeedTables, rng);
+
+		VFS::Manager::get().initialize(std::string(arenaPath));
+		miscAssets.initTravelData(climateSpeedTables, weatherSpeedTables);
+
+		// Everything is in memory now.
+		removeSyntheticData(arenaPath);
+	}
+	else
+	{
+		// Same version check as the game.
+		const bool isCdVersion = File::exists(arenaPath + ExeData::CD_VERSION_EXE_FILENAME);
+		const bool isFloppyVersion = File::exists(arenaPath + ExeData::FLOPPY_VERSION_EXE_FILENAME);
+		if (!isCdVersion && !isFloppyVersion)
+		{
+			std::printf("\"%s\" does not have an Arena executable.\n", arenaPath.c_str());
+			return EXIT_FAILURE;
+		}
+
+		VFS::Manager::get().initialize(std::string(arenaPath));
+		miscAssets.init(!isCdVersion);
+	}
+
+	const CityDataFile &cityData = miscAssets.getCityDataFile();
+	const std::vector<LocationRef> locations = getLocations();
+	const int hiddenLocationCount = getHiddenLocationCount(cityData);
+	const std::vector<Weathers> weatherSets = makeWeatherSets(weatherSetCount, rng);
+	const ArenaRandom random(static_cast<uint32_t>(rng()));
+
+	double referenceMs = 0.0;
+	double singleMs = 0.0;
+	double batchMs = 0.0;
+	double rasterMs = 0.0;
+	int64_t pairCount = 0;
+	int64_t mismatchCount = 0;
+
+	for (const Weathers &weathers : weatherSets)
+	{
+		auto rasterStart = std::chrono::steady_clock::now();
+		const CityDataFile::TravelCostRaster raster =
+			cityData.makeTravelCostRaster(weathers, miscAssets);
+		rasterMs += getElapsedMilliseconds(rasterStart);
+
+		for (int month = 0; month < MONTH_COUNT; month++)
+		{
+			for (const LocationRef &start : locations)
+			{
+				for (int provinceID = 0; provinceID < PROVINCE_COUNT; provinceID++)
+				{
+					auto batchStart = std::chrono::steady_clock::now();
+					std::array<int, LOCATION_COUNT> batchDays;
+					try
+					{
+						batchDays = cityData.getTravelDays(start.locationID, start.provinceID,
+							provinceID, month, raster, random, miscAssets);
+					}
+					catch (const std::exception&)
+					{
+						batchDays.fill(-1);
+					}
+
+					batchMs += getElapsedMilliseconds(batchStart);
+
+					for (int locationID = 0; locationID < LOCATION_COUNT; locationID++)
+					{
+						const LocationRef end { locationID, provinceID };
+
+						auto referenceStart = std::chrono::steady_clock::now();
+						const int referenceDays = getReferenceDays(cityData, start, end,
+							month, weathers, random, miscAssets);
+						referenceMs += getElapsedMilliseconds(referenceStart);
+
+						auto singleStart = std::chrono::steady_clock::now();
+						const int singleDays = getRasterDays(cityData, start, end, month,
+							raster, random, miscAssets);
+						singleMs += getElapsedMilliseconds(singleStart);
+
+						// Hidden locations are zero in the batch, and the province map
+						// asks for them one at a time instead.
+						const int batchDay = (batchDays[locationID] != 0) ?
+							batchDays[locationID] : singleDays;
+						if ((singleDays != referenceDays) || (batchDay != referenceDays))
+						{
+							if (mismatchCount < 10)
+							{
+								std::printf("Mismatch: (%d, %d) -> (%d, %d), month %d: "
+									"reference %d, raster %d, batch %d\n",
+									start.provinceID, start.locationID, provinceID,
+									locationID, month, referenceDays, singleDays, batchDay);
+							}
+
+							mismatchCount++;
+						}
+
+						pairCount++;
+					}
+				}
+			}
+		}
+	}
+
+	std::printf("%lld location pairs checked (%d locations, %d of them hidden, %d weather "
+		"sets, %d months), %lld mismatches\n", static_cast<long long>(pairCount),
+		static_cast<int>(locations.size()), hiddenLocationCount, weatherSetCount,
+		MONTH_COUNT, static_cast<long long>(mismatchCount));
+	std::printf("%-18s %10s %12s\n", "query", "total ms", "us/query");
+	std::printf("%-18s %10.1f %12.3f\n", "per-pixel", referenceMs,
+		(referenceMs * 1000.0) / static_cast<double>(pairCount));
+	std::printf("%-18s %10.1f %12.3f\n", "raster", singleMs,
+		(singleMs * 1000.0) / static_cast<double>(pairCount));
+	std::printf("%-18s %10.1f %12.3f\n", "raster (batch)", batchMs,
+		(batchMs * 1000.0) / static_cast<double>(pairCount));
+	std::printf("raster build: %.1f ms per weather set\n",
+		rasterMs / static_cast<double>(weatherSetCount));
+
+	return (mismatchCount == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
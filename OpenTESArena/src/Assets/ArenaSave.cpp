@@ -1,9 +1,15 @@
+#include <algorithm>
+#include <cstdio>
 #include <fstream>
 #include <iomanip>
+#include <mutex>
 #include <sstream>
+#include <utility>
 
 #include "ArenaSave.h"
 #include "../Utilities/Debug.h"
+#include "../Utilities/File.h"
+#include "../Utilities/Platform.h"
 
 namespace
 {
@@ -26,21 +32,59 @@ namespace
 		return numberStr.substr(offset);
 	}
 
+	// Reads all of a file's bytes in one go. Returns false if the file can't be opened.
+	bool readBytes(const std::string &filename, std::vector<uint8_t> &bytes)
+	{
+		std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
+
+		if (!ifs.is_open())
+		{
+			return false;
+		}
+
+		bytes.resize(static_cast<size_t>(ifs.tellg()));
+		ifs.seekg(0, std::ios::beg);
+		ifs.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+		return true;
+	}
+
+	// Initializes a record from a file's bytes. Short files are padded with zeroes.
+	template <typename T>
+	std::unique_ptr<T> makeRecord(std::vector<uint8_t> &bytes)
+	{
+		bytes.resize(T::SIZE);
+
+		// Using heap-allocated objects to avoid stack warnings.
+		auto obj = std::make_unique<T>();
+		obj->init(bytes.data());
+		return obj;
+	}
+
+	// Same as above, but for spell lists, which don't have a size of their own.
+	template <typename T>
+	std::unique_ptr<T> makeSpells(std::vector<uint8_t> &bytes)
+	{
+		auto spells = std::make_unique<T>();
+		bytes.resize(ArenaTypes::SpellData::SIZE * spells->size());
+		ArenaTypes::SpellData::initArray(*spells, bytes.data());
+		return spells;
+	}
+
+	std::unique_ptr<ArenaTypes::Log> makeLog(const std::vector<uint8_t> &bytes)
+	{
+		auto log = std::make_unique<ArenaTypes::Log>();
+		log->init(std::string(bytes.begin(), bytes.end()));
+		return log;
+	}
+
 	// Convenience function for loading a binary save file and returning the initialized record.
 	template <typename T>
 	std::unique_ptr<T> loadBinary(const std::string &filename)
 	{
-		std::ifstream ifs(filename, std::ios::binary);
-
-		if (ifs.is_open())
+		std::vector<uint8_t> bytes;
+		if (readBytes(filename, bytes))
 		{
-			// Using heap-allocated objects to avoid stack warnings.
-			std::vector<uint8_t> buffer(T::SIZE);
-			ifs.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
-
-			auto obj = std::make_unique<T>();
-			obj->init(buffer.data());
-			return obj;
+			return makeRecord<T>(bytes);
 		}
 		else
 		{
@@ -48,11 +92,128 @@ namespace
 			return nullptr;
 		}
 	}
+
+	// Gets the bytes of a record as they're stored on disk.
+	template <typename T>
+	std::vector<uint8_t> getRecordBytes(const T &record)
+	{
+		std::vector<uint8_t> bytes(T::SIZE, 0);
+		record.write(bytes.data());
+		return bytes;
+	}
+
+	template <typename T>
+	std::vector<uint8_t> getSpellsBytes(const T &spells)
+	{
+		std::vector<uint8_t> bytes(ArenaTypes::SpellData::SIZE * spells.size(), 0);
+		ArenaTypes::SpellData::writeArray(spells, bytes.data());
+		return bytes;
+	}
+
+	std::vector<uint8_t> getLogBytes(const ArenaTypes::Log &log)
+	{
+		const std::string text = log.write();
+		return std::vector<uint8_t>(text.begin(), text.end());
+	}
+
+	// Extension of files written next to their destination before replacing it.
+	const std::string TempExtension = ".TMP";
+
+	// Held while save files are written, recovered, or read as a slot, so the background
+	// writer and the game thread never see each other's half-finished changes.
+	std::mutex SaveFilesMutex;
+
+	// A file to be written and the bytes to write to it.
+	typedef std::pair<std::string, std::vector<uint8_t>> FileBytes;
+
+	// Writes a file next to its destination and syncs it to disk, then renames it over
+	// the destination, so the destination is always either the old or the new file.
+	void writeFile(const FileBytes &file)
+	{
+		const std::vector<uint8_t> &bytes = file.second;
+		Platform::writeFileDurably(file.first + TempExtension, bytes.data(), bytes.size());
+		Platform::replaceFile(file.first + TempExtension, file.first);
+	}
+
+	// The files of a slot written by ArenaSave::saveSlot(). While it's pending, the slot's
+	// files are waiting next to their destinations as temporary files.
+	struct Manifest
+	{
+		std::vector<std::string> filenames; // Relative to the save folder.
+		bool pending;
+	};
+
+	const std::string ManifestPending = "PENDING";
+	const std::string ManifestComplete = "COMPLETE";
+
+	// Reads a manifest (its state on the first line, then one filename per line). Returns
+	// false if there isn't one.
+	bool readManifest(const std::string &filename, Manifest &manifest)
+	{
+		std::vector<uint8_t> bytes;
+		if (!readBytes(filename, bytes))
+		{
+			return false;
+		}
+
+		std::istringstream iss(std::string(bytes.begin(), bytes.end()));
+		std::string line;
+		std::getline(iss, line);
+		manifest.pending = line == ManifestPending;
+		manifest.filenames.clear();
+
+		while (std::getline(iss, line))
+		{
+			if (line.size() > 0)
+			{
+				manifest.filenames.push_back(line);
+			}
+		}
+
+		return true;
+	}
+
+	void writeManifest(const std::string &filename, const Manifest &manifest)
+	{
+		std::string text = (manifest.pending ? ManifestPending : ManifestComplete) + '\n';
+		for (const std::string &manifestFilename : manifest.filenames)
+		{
+			text += manifestFilename + '\n';
+		}
+
+		writeFile(FileBytes(filename, std::vector<uint8_t>(text.begin(), text.end())));
+	}
+
+	bool manifestHasFile(const Manifest &manifest, const std::string &filename)
+	{
+		return std::find(manifest.filenames.begin(), manifest.filenames.end(),
+			filename) != manifest.filenames.end();
+	}
+
+	// Renames a pending manifest's temporary files over their destinations and marks it
+	// complete. Files already renamed (i.e., before a crash) no longer have a temporary
+	// file, so this can be repeated until it finishes.
+	void finishManifest(const std::string &savePath, const std::string &manifestFilename,
+		Manifest &manifest)
+	{
+		for (const std::string &filename : manifest.filenames)
+		{
+			const std::string path = savePath + filename;
+			if (File::exists(path + TempExtension))
+			{
+				Platform::replaceFile(path + TempExtension, path);
+			}
+		}
+
+		manifest.pending = false;
+		writeManifest(manifestFilename, manifest);
+	}
 }
 
 const std::string ArenaSave::AUTOMAP_FILENAME = "AUTOMAP";
 const std::string ArenaSave::IN_FILENAME = "IN";
 const std::string ArenaSave::LOG_FILENAME = "LOG";
+const std::string ArenaSave::MANIFEST_FILENAME = "MANIFEST";
 const std::string ArenaSave::NAMES_FILENAME = "NAMES.DAT";
 const std::string ArenaSave::RE_FILENAME = "RE";
 const std::string ArenaSave::SAVEENGN_FILENAME = "SAVEENGN";
@@ -78,18 +239,11 @@ std::unique_ptr<ArenaTypes::Log> ArenaSave::loadLOG(const std::string &savePath,
 {
 	const std::string filename = savePath +
 		ArenaSave::LOG_FILENAME + makeSaveExtension(index);
-	std::ifstream ifs(filename);
 
-	if (ifs.is_open())
+	std::vector<uint8_t> bytes;
+	if (readBytes(filename, bytes))
 	{
-		ifs.seekg(0, std::ios::end);
-		std::string buffer(ifs.tellg(), '\0');
-		ifs.seekg(0, std::ios::beg);
-		ifs.read(&buffer.front(), buffer.size());
-
-		auto log = std::make_unique<ArenaTypes::Log>();
-		log->init(buffer);
-		return log;
+		return makeLog(bytes);
 	}
 	else
 	{
@@ -128,22 +282,11 @@ std::unique_ptr<ArenaTypes::Spells> ArenaSave::loadSPELLS(const std::string &sav
 {
 	const std::string filename = savePath +
 		ArenaSave::SPELLS_FILENAME + makeSaveExtension(index);
-	std::ifstream ifs(filename, std::ios::binary);
 
-	if (ifs.is_open())
+	std::vector<uint8_t> bytes;
+	if (readBytes(filename, bytes))
 	{
-		// Using heap-allocated objects to avoid stack warnings.
-		auto spells = std::make_unique<ArenaTypes::Spells>();
-
-		std::vector<uint8_t> buffer(ArenaTypes::SpellData::SIZE * spells->size());
-		ifs.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
-
-		for (size_t i = 0; i < spells->size(); i++)
-		{
-			spells->at(i).init(buffer.data() + (ArenaTypes::SpellData::SIZE * i));
-		}
-
-		return spells;
+		return makeSpells<ArenaTypes::Spells>(bytes);
 	}
 	else
 	{
@@ -156,22 +299,11 @@ std::unique_ptr<ArenaTypes::Spellsg> ArenaSave::loadSPELLSG(const std::string &s
 {
 	const std::string filename = savePath +
 		ArenaSave::SPELLSG_FILENAME + makeSaveExtension(index);
-	std::ifstream ifs(filename, std::ios::binary);
 
-	if (ifs.is_open())
+	std::vector<uint8_t> bytes;
+	if (readBytes(filename, bytes))
 	{
-		// Using heap-allocated objects to avoid stack warnings.
-		auto spellsg = std::make_unique<ArenaTypes::Spellsg>();
-
-		std::vector<uint8_t> buffer(ArenaTypes::SpellData::SIZE * spellsg->size());
-		ifs.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
-
-		for (size_t i = 0; i < spellsg->size(); i++)
-		{
-			spellsg->at(i).init(buffer.data() + (ArenaTypes::SpellData::SIZE * i));
-		}
-
-		return spellsg;
+		return makeSpells<ArenaTypes::Spellsg>(bytes);
 	}
 	else
 	{
@@ -187,40 +319,199 @@ std::unique_ptr<ArenaTypes::MQLevelState> ArenaSave::loadSTATE(
 		savePath + ArenaSave::STATE_FILENAME + makeSaveExtension(index));
 }
 
+void ArenaSave::recoverSlots(const std::string &savePath)
+{
+	// Finish any slot whose manifest was committed before the renames were done.
+	for (int i = 0; i < SLOT_COUNT; i++)
+	{
+		const std::string manifestFilename = savePath +
+			ArenaSave::MANIFEST_FILENAME + makeSaveExtension(i);
+
+		Manifest manifest;
+		if (readManifest(manifestFilename, manifest) && manifest.pending)
+		{
+			finishManifest(savePath, manifestFilename, manifest);
+		}
+	}
+
+	// Any temporary files left now are from writes that never committed.
+	const std::array<const std::string*, 8> slotFilenames =
+	{
+		&ArenaSave::AUTOMAP_FILENAME,
+		&ArenaSave::LOG_FILENAME,
+		&ArenaSave::MANIFEST_FILENAME,
+		&ArenaSave::SAVEENGN_FILENAME,
+		&ArenaSave::SAVEGAME_FILENAME,
+		&ArenaSave::SPELLS_FILENAME,
+		&ArenaSave::SPELLSG_FILENAME,
+		&ArenaSave::STATE_FILENAME
+	};
+
+	std::vector<std::string> tempFilenames;
+	tempFilenames.push_back(savePath + ArenaSave::NAMES_FILENAME + TempExtension);
+
+	for (int i = 0; i < SLOT_COUNT; i++)
+	{
+		for (const std::string *filename : slotFilenames)
+		{
+			tempFilenames.push_back(savePath + *filename + makeSaveExtension(i) + TempExtension);
+		}
+	}
+
+	for (const std::string &tempFilename : tempFilenames)
+	{
+		if (File::exists(tempFilename))
+		{
+			DebugMention("Removing unfinished save file \"" + tempFilename + "\".");
+			std::remove(tempFilename.c_str());
+		}
+	}
+}
+
+void ArenaSave::saveRecord(const std::string &savePath, const std::string &filename,
+	const std::string &manifestFilename, const std::vector<uint8_t> &bytes)
+{
+	std::lock_guard<std::mutex> lock(SaveFilesMutex);
+
+	// An unfinished slot save could otherwise rename its copy over this one later.
+	ArenaSave::recoverSlots(savePath);
+	writeFile(FileBytes(savePath + filename, bytes));
+
+	Manifest manifest;
+	if ((manifestFilename.size() > 0) && readManifest(manifestFilename, manifest) &&
+		!manifestHasFile(manifest, filename))
+	{
+		manifest.filenames.push_back(filename);
+		writeManifest(manifestFilename, manifest);
+	}
+}
+
+std::array<ArenaSave::SlotHeader, ArenaSave::SLOT_COUNT> ArenaSave::loadSlotHeaders(
+	const std::string &savePath)
+{
+	std::lock_guard<std::mutex> lock(SaveFilesMutex);
+	ArenaSave::recoverSlots(savePath);
+
+	std::array<SlotHeader, SLOT_COUNT> headers;
+
+	// Only NAMES.DAT and the manifests are read. Whether a slot is in use comes from its
+	// files existing.
+	std::vector<uint8_t> bytes;
+	const bool hasNames = readBytes(savePath + ArenaSave::NAMES_FILENAME, bytes);
+	const auto names = hasNames ? makeRecord<ArenaTypes::Names>(bytes) : nullptr;
+
+	for (int i = 0; i < SLOT_COUNT; i++)
+	{
+		SlotHeader &header = headers.at(i);
+
+		if (names != nullptr)
+		{
+			const auto &entryName = names->entries.at(i).name;
+			header.name = std::string(entryName.data(),
+				std::find(entryName.begin(), entryName.end(), '\0'));
+		}
+
+		const std::string extension = makeSaveExtension(i);
+		const std::string saveGameFilename = ArenaSave::SAVEGAME_FILENAME + extension;
+
+		Manifest manifest;
+		const bool hasManifest = readManifest(
+			savePath + ArenaSave::MANIFEST_FILENAME + extension, manifest);
+		header.used = (!hasManifest || manifestHasFile(manifest, saveGameFilename)) &&
+			File::exists(savePath + saveGameFilename);
+	}
+
+	return headers;
+}
+
+std::unique_ptr<ArenaSave::Slot> ArenaSave::loadSlot(const std::string &savePath, int index)
+{
+	std::lock_guard<std::mutex> lock(SaveFilesMutex);
+	ArenaSave::recoverSlots(savePath);
+
+	const std::string extension = makeSaveExtension(index);
+	auto slot = std::make_unique<Slot>();
+
+	// Slots from the original game have no manifest, so all of their files are read.
+	Manifest manifest;
+	const bool hasManifest = readManifest(
+		savePath + ArenaSave::MANIFEST_FILENAME + extension, manifest);
+
+	// Each record is read whole and parsed from memory.
+	auto readRecord = [&savePath, &extension, &manifest, hasManifest](
+		const std::string &name, std::vector<uint8_t> &bytes)
+	{
+		const std::string filename = name + extension;
+		return (!hasManifest || manifestHasFile(manifest, filename)) &&
+			readBytes(savePath + filename, bytes);
+	};
+
+	std::vector<uint8_t> bytes;
+	if (readRecord(ArenaSave::AUTOMAP_FILENAME, bytes))
+	{
+		slot->automap = makeRecord<ArenaTypes::Automap>(bytes);
+	}
+
+	if (readRecord(ArenaSave::LOG_FILENAME, bytes))
+	{
+		slot->log = makeLog(bytes);
+	}
+
+	if (readRecord(ArenaSave::SPELLS_FILENAME, bytes))
+	{
+		slot->spells = makeSpells<ArenaTypes::Spells>(bytes);
+	}
+
+	if (readRecord(ArenaSave::SPELLSG_FILENAME, bytes))
+	{
+		slot->spellsg = makeSpells<ArenaTypes::Spellsg>(bytes);
+	}
+
+	if (readRecord(ArenaSave::STATE_FILENAME, bytes))
+	{
+		slot->state = makeRecord<ArenaTypes::MQLevelState>(bytes);
+	}
+
+	readRecord(ArenaSave::SAVEENGN_FILENAME, slot->saveEngine);
+	readRecord(ArenaSave::SAVEGAME_FILENAME, slot->saveGame);
+
+	return slot;
+}
+
 void ArenaSave::saveAUTOMAP(const std::string &savePath, int index,
 	const ArenaTypes::Automap &data)
 {
-	const std::string filename = savePath +
-		ArenaSave::AUTOMAP_FILENAME + makeSaveExtension(index);
-
-	DebugNotImplemented();
+	const std::string extension = makeSaveExtension(index);
+	ArenaSave::saveRecord(savePath, ArenaSave::AUTOMAP_FILENAME + extension,
+		savePath + ArenaSave::MANIFEST_FILENAME + extension, getRecordBytes(data));
 }
 
 void ArenaSave::saveIN(const std::string &savePath, int number, int index,
 	const ArenaTypes::Tavern &data)
 {
-	const std::string filename = savePath + ArenaSave::IN_FILENAME +
+	const std::string filename = ArenaSave::IN_FILENAME +
 		getServiceNumberString(number) + makeSaveExtension(index);
 
-	DebugNotImplemented();
+	// Not part of a slot, so there's no manifest to update.
+	ArenaSave::saveRecord(savePath, filename, std::string(), getRecordBytes(data));
 }
 
 void ArenaSave::saveLOG(const std::string &savePath, int index,
 	const ArenaTypes::Log &data)
 {
-	const std::string filename = savePath +
-		ArenaSave::LOG_FILENAME + makeSaveExtension(index);
-
-	DebugNotImplemented();
+	const std::string extension = makeSaveExtension(index);
+	ArenaSave::saveRecord(savePath, ArenaSave::LOG_FILENAME + extension,
+		savePath + ArenaSave::MANIFEST_FILENAME + extension, getLogBytes(data));
 }
 
 void ArenaSave::saveRE(const std::string &savePath, int number, int index,
 	const ArenaTypes::Repair &data)
 {
-	const std::string filename = savePath + ArenaSave::RE_FILENAME +
+	const std::string filename = ArenaSave::RE_FILENAME +
 		getServiceNumberString(number) + makeSaveExtension(index);
 
-	DebugNotImplemented();
+	// Not part of a slot, so there's no manifest to update.
+	ArenaSave::saveRecord(savePath, filename, std::string(), getRecordBytes(data));
 }
 
 void ArenaSave::saveSAVEENGN(const std::string &savePath, int index,
@@ -244,26 +535,128 @@ void ArenaSave::saveSAVEGAME(const std::string &savePath, int index,
 void ArenaSave::saveSPELLS(const std::string &savePath, int index,
 	const ArenaTypes::Spells &data)
 {
-	const std::string filename = savePath +
-		ArenaSave::SPELLS_FILENAME + makeSaveExtension(index);
-
-	DebugNotImplemented();
+	const std::string extension = makeSaveExtension(index);
+	ArenaSave::saveRecord(savePath, ArenaSave::SPELLS_FILENAME + extension,
+		savePath + ArenaSave::MANIFEST_FILENAME + extension, getSpellsBytes(data));
 }
 
 void ArenaSave::saveSPELLSG(const std::string &savePath, int index,
 	const ArenaTypes::Spellsg &data)
 {
-	const std::string filename = savePath +
-		ArenaSave::SPELLSG_FILENAME + makeSaveExtension(index);
-
-	DebugNotImplemented();
+	const std::string extension = makeSaveExtension(index);
+	ArenaSave::saveRecord(savePath, ArenaSave::SPELLSG_FILENAME + extension,
+		savePath + ArenaSave::MANIFEST_FILENAME + extension, getSpellsBytes(data));
 }
 
 void ArenaSave::saveSTATE(const std::string &savePath, int index,
 	const ArenaTypes::MQLevelState &data)
 {
-	const std::string filename = savePath +
-		ArenaSave::STATE_FILENAME + makeSaveExtension(index);
+	const std::string extension = makeSaveExtension(index);
+	ArenaSave::saveRecord(savePath, ArenaSave::STATE_FILENAME + extension,
+		savePath + ArenaSave::MANIFEST_FILENAME + extension, getRecordBytes(data));
+}
 
-	DebugNotImplemented();
+void ArenaSave::saveSlot(const std::string &savePath, int index, const std::string &name,
+	const Slot &slot)
+{
+	DebugAssertMsg((index >= 0) && (index < SLOT_COUNT),
+		"Save slot \"" + std::to_string(index) + "\" out of range.");
+
+	std::lock_guard<std::mutex> lock(SaveFilesMutex);
+
+	// Finish or clean up after an earlier save first, so its temporary files aren't
+	// mistaken for this one's.
+	ArenaSave::recoverSlots(savePath);
+
+	// Filenames are relative to the save folder so the manifest can list them.
+	const std::string extension = makeSaveExtension(index);
+	std::vector<FileBytes> files;
+
+	if (slot.automap != nullptr)
+	{
+		files.push_back(FileBytes(ArenaSave::AUTOMAP_FILENAME + extension,
+			getRecordBytes(*slot.automap)));
+	}
+
+	if (slot.log != nullptr)
+	{
+		files.push_back(FileBytes(ArenaSave::LOG_FILENAME + extension,
+			getLogBytes(*slot.log)));
+	}
+
+	if (slot.spells != nullptr)
+	{
+		files.push_back(FileBytes(ArenaSave::SPELLS_FILENAME + extension,
+			getSpellsBytes(*slot.spells)));
+	}
+
+	if (slot.spellsg != nullptr)
+	{
+		files.push_back(FileBytes(ArenaSave::SPELLSG_FILENAME + extension,
+			getSpellsBytes(*slot.spellsg)));
+	}
+
+	if (slot.state != nullptr)
+	{
+		files.push_back(FileBytes(ArenaSave::STATE_FILENAME + extension,
+			getRecordBytes(*slot.state)));
+	}
+
+	if (slot.saveEngine.size() > 0)
+	{
+		files.push_back(FileBytes(ArenaSave::SAVEENGN_FILENAME + extension,
+			slot.saveEngine));
+	}
+
+	if (slot.saveGame.size() > 0)
+	{
+		files.push_back(FileBytes(ArenaSave::SAVEGAME_FILENAME + extension,
+			slot.saveGame));
+	}
+
+	// The slot's name in NAMES.DAT changes along with its records.
+	auto names = [&savePath]()
+	{
+		std::vector<uint8_t> bytes;
+		if (readBytes(savePath + ArenaSave::NAMES_FILENAME, bytes))
+		{
+			return makeRecord<ArenaTypes::Names>(bytes);
+		}
+		else
+		{
+			auto names = std::make_unique<ArenaTypes::Names>();
+			for (auto &entry : names->entries)
+			{
+				entry.name.fill('\0');
+			}
+
+			return names;
+		}
+	}();
+
+	auto &entryName = names->entries.at(index).name;
+	entryName.fill('\0');
+	std::copy(name.begin(), name.begin() + std::min(name.size(), entryName.size() - 1),
+		entryName.begin());
+
+	files.push_back(FileBytes(ArenaSave::NAMES_FILENAME, getRecordBytes(*names)));
+
+	// Write every file next to its destination and sync it to disk. A crash here leaves
+	// the old slot, and the temporary files are removed by the next recovery.
+	Manifest manifest;
+	for (const FileBytes &file : files)
+	{
+		const std::vector<uint8_t> &bytes = file.second;
+		Platform::writeFileDurably(savePath + file.first + TempExtension,
+			bytes.data(), bytes.size());
+		manifest.filenames.push_back(file.first);
+	}
+
+	// Replacing the manifest with a pending one commits the save. From here on, a crash
+	// is finished by the next recovery instead.
+	const std::string manifestFilename = savePath + ArenaSave::MANIFEST_FILENAME + extension;
+	manifest.pending = true;
+	writeManifest(manifestFilename, manifest);
+
+	finishManifest(savePath, manifestFilename, manifest);
 }
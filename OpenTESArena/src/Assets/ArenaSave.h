@@ -1,8 +1,11 @@
 #ifndef ARENA_SAVE_H
 #define ARENA_SAVE_H
 
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "ArenaTypes.h"
 
@@ -10,10 +13,33 @@
 
 class ArenaSave
 {
+public:
+	// What the save slot list needs to know about a slot, without parsing its records.
+	struct SlotHeader
+	{
+		std::string name; // From NAMES.DAT.
+		bool used; // Whether the slot's SAVEGAME.0x exists.
+	};
+
+	// The records of one save slot. Loading reads them all at once, and saving writes
+	// whichever are present. SAVEENGN and SAVEGAME are kept as bytes because their
+	// records can't be fully parsed yet.
+	struct Slot
+	{
+		std::unique_ptr<ArenaTypes::Automap> automap;
+		std::unique_ptr<ArenaTypes::Log> log;
+		std::unique_ptr<ArenaTypes::Spells> spells;
+		std::unique_ptr<ArenaTypes::Spellsg> spellsg;
+		std::unique_ptr<ArenaTypes::MQLevelState> state;
+		std::vector<uint8_t> saveEngine, saveGame;
+	};
+
+	static constexpr int SLOT_COUNT = 10;
 private:
 	static const std::string AUTOMAP_FILENAME;
 	static const std::string IN_FILENAME;
 	static const std::string LOG_FILENAME;
+	static const std::string MANIFEST_FILENAME;
 	static const std::string NAMES_FILENAME;
 	static const std::string RE_FILENAME;
 	static const std::string SAVEENGN_FILENAME;
@@ -24,6 +50,16 @@ private:
 
 	ArenaSave() = delete;
 	~ArenaSave() = delete;
+
+	// Finishes any slot save that was committed but interrupted before all of its files
+	// were renamed into place, then removes temporary files left by saves that weren't
+	// committed. Called with the save files lock held.
+	static void recoverSlots(const std::string &savePath);
+
+	// Writes a single record file, and lists it in its slot's manifest (if the slot has
+	// one) so loadSlot() reads it. The manifest filename is empty for files outside a slot.
+	static void saveRecord(const std::string &savePath, const std::string &filename,
+		const std::string &manifestFilename, const std::vector<uint8_t> &bytes);
 public:
 	// Using heap-allocated pointers to avoid stack overflow warnings.
 	static std::unique_ptr<ArenaTypes::Automap> loadAUTOMAP(const std::string &savePath, int index);
@@ -40,6 +76,14 @@ public:
 	// @todo: load INN.0x.
 	// @todo: load wild 001, 002, 003, 004.
 
+	// Reads the name of each slot and checks which slots are in use.
+	static std::array<SlotHeader, SLOT_COUNT> loadSlotHeaders(const std::string &savePath);
+
+	// Reads all records of a slot. A slot written by saveSlot() only has the records listed
+	// in its manifest read, so files left over from older saves aren't mixed in. Records
+	// that are missing are left empty.
+	static std::unique_ptr<Slot> loadSlot(const std::string &savePath, int index);
+
 	static void saveAUTOMAP(const std::string &savePath, int index,
 		const ArenaTypes::Automap &data);
 	static void saveIN(const std::string &savePath, int number, int index,
@@ -61,6 +105,15 @@ public:
 	// @todo: save city data.
 	// @todo: save INN.0x.
 	// @todo: save wild 001, 002, 003, 004.
+
+	// Writes a slot's records and its name in NAMES.DAT as one change. Each file goes to a
+	// temporary file that is synced to disk, and then the slot's manifest (MANIFEST.0x, the
+	// list of its files) is replaced with a pending one, which commits the save. Only then
+	// are the temporary files renamed into place. A crash before the commit leaves the old
+	// slot, and a crash after it is finished by the next call that recovers the slots. This
+	// blocks (see ArenaSaveWriter for doing it in the background).
+	static void saveSlot(const std::string &savePath, int index, const std::string &name,
+		const Slot &slot);
 };
 
 #endif
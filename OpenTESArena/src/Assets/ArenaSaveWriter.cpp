@@ -0,0 +1,108 @@
+#include <exception>
+
+#include "ArenaSaveWriter.h"
+#include "../Utilities/Debug.h"
+
+ArenaSaveWriter::ArenaSaveWriter()
+{
+	this->writing = false;
+	this->stopping = false;
+}
+
+ArenaSaveWriter::~ArenaSaveWriter()
+{
+	if (this->thread.joinable())
+	{
+		this->wait();
+
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->stopping = true;
+		}
+
+		this->condition.notify_all();
+		this->thread.join();
+	}
+}
+
+void ArenaSaveWriter::writeLoop()
+{
+	while (true)
+	{
+		Job job;
+
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->condition.wait(lock, [this]()
+			{
+				return this->stopping || (this->jobs.size() > 0);
+			});
+
+			if (this->jobs.size() == 0)
+			{
+				return;
+			}
+
+			job = std::move(this->jobs.front());
+			this->jobs.pop_front();
+			this->writing = true;
+		}
+
+		try
+		{
+			ArenaSave::saveSlot(job.savePath, job.index, job.name, *job.slot);
+		}
+		catch (const std::exception &e)
+		{
+			// The old slot is still intact if writing failed.
+			DebugWarning("Could not save slot " + std::to_string(job.index) +
+				": " + std::string(e.what()));
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->writing = false;
+		}
+
+		this->condition.notify_all();
+	}
+}
+
+bool ArenaSaveWriter::isBusy()
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->writing || (this->jobs.size() > 0);
+}
+
+void ArenaSaveWriter::save(const std::string &savePath, int index, const std::string &name,
+	std::unique_ptr<ArenaSave::Slot> slot)
+{
+	DebugAssertMsg(slot != nullptr, "Save slot " + std::to_string(index) + " has no data.");
+
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+
+		Job job;
+		job.savePath = savePath;
+		job.name = name;
+		job.slot = std::move(slot);
+		job.index = index;
+		this->jobs.push_back(std::move(job));
+
+		if (!this->thread.joinable())
+		{
+			this->thread = std::thread([this]() { this->writeLoop(); });
+		}
+	}
+
+	this->condition.notify_all();
+}
+
+void ArenaSaveWriter::wait()
+{
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->condition.wait(lock, [this]()
+	{
+		return !this->writing && (this->jobs.size() == 0);
+	});
+}
@@ -0,0 +1,54 @@
+#ifndef ARENA_SAVE_WRITER_H
+#define ARENA_SAVE_WRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "ArenaSave.h"
+
+// Writes save slots on a background thread so saving doesn't stall the game. The game
+// thread snapshots its state into an ArenaSave::Slot and hands it over, and the slot is
+// written with ArenaSave::saveSlot() in the order it was queued.
+
+class ArenaSaveWriter
+{
+private:
+	struct Job
+	{
+		std::string savePath, name;
+		std::unique_ptr<ArenaSave::Slot> slot;
+		int index;
+	};
+
+	std::deque<Job> jobs;
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::thread thread; // Started by the first save.
+	bool writing; // Whether a job has been taken off the queue and is being written.
+	bool stopping;
+
+	// Writes queued slots until the writer is destroyed.
+	void writeLoop();
+public:
+	ArenaSaveWriter();
+
+	// Finishes writing any queued slots before returning, so quitting right after saving
+	// doesn't lose the save.
+	~ArenaSaveWriter();
+
+	// Returns whether any slots are queued or being written.
+	bool isBusy();
+
+	// Queues a snapshot of a slot to be written. Returns immediately.
+	void save(const std::string &savePath, int index, const std::string &name,
+		std::unique_ptr<ArenaSave::Slot> slot);
+
+	// Blocks until every queued slot has been written.
+	void wait();
+};
+
+#endif
@@ -42,6 +42,13 @@ void ArenaTypes::MIFLock::init(const uint8_t *data)
 	this->lockLevel = *(data + 2);
 }
 
+void ArenaTypes::MIFLock::write(uint8_t *data) const
+{
+	*data = this->x;
+	*(data + 1) = this->y;
+	*(data + 2) = this->lockLevel;
+}
+
 void ArenaTypes::MIFTarget::init(const uint8_t *data)
 {
 	this->x = *data;
@@ -56,6 +63,14 @@ void ArenaTypes::MIFTrigger::init(const uint8_t *data)
 	this->soundIndex = *(data + 3);
 }
 
+void ArenaTypes::MIFTrigger::write(uint8_t *data) const
+{
+	*data = this->x;
+	*(data + 1) = this->y;
+	*(data + 2) = this->textIndex;
+	*(data + 3) = this->soundIndex;
+}
+
 void ArenaTypes::DynamicTrigger::init(const uint8_t *data)
 {
 	std::copy(data, data + this->unknown.size(), this->unknown.begin());
@@ -102,6 +117,23 @@ void ArenaTypes::InventoryItem::init(const uint8_t *data)
 	this->attribute = *(data + 18);
 }
 
+void ArenaTypes::InventoryItem::write(uint8_t *data) const
+{
+	*data = this->slotID;
+	Bytes::setLE16(data + 1, this->weight);
+	*(data + 3) = this->hands;
+	*(data + 4) = this->param1;
+	*(data + 5) = this->param2;
+	Bytes::setLE16(data + 6, this->health);
+	Bytes::setLE16(data + 8, this->maxHealth);
+	Bytes::setLE32(data + 10, this->price);
+	*(data + 14) = this->flags;
+	*(data + 15) = this->x;
+	*(data + 16) = this->material;
+	*(data + 17) = this->y;
+	*(data + 18) = this->attribute;
+}
+
 void ArenaTypes::SaveEngine::CreatureData::init(const uint8_t *data)
 {
 	std::copy(data, data + this->unknown.size(), this->unknown.begin());
@@ -317,6 +349,25 @@ void ArenaTypes::MQLevelState::HashTable::init(const uint8_t *data)
 	}
 }
 
+void ArenaTypes::MQLevelState::HashTable::write(uint8_t *data) const
+{
+	*data = this->triggerCount;
+
+	uint8_t *triggersStart = data + 1;
+	for (size_t i = 0; i < this->triggers.size(); i++)
+	{
+		this->triggers.at(i).write(triggersStart + (MIFTrigger::SIZE * i));
+	}
+
+	*(data + 257) = this->lockCount;
+
+	uint8_t *locksStart = data + 258;
+	for (size_t i = 0; i < this->locks.size(); i++)
+	{
+		this->locks.at(i).write(locksStart + (MIFLock::SIZE * i));
+	}
+}
+
 void ArenaTypes::MQLevelState::init(const uint8_t *data)
 {
 	const uint8_t *hashTablesStart = data;
@@ -326,6 +377,15 @@ void ArenaTypes::MQLevelState::init(const uint8_t *data)
 	}
 }
 
+void ArenaTypes::MQLevelState::write(uint8_t *data) const
+{
+	uint8_t *hashTablesStart = data;
+	for (size_t i = 0; i < this->hashTables.size(); i++)
+	{
+		this->hashTables.at(i).write(hashTablesStart + (HashTable::SIZE * i));
+	}
+}
+
 void ArenaTypes::SpellData::init(const uint8_t *data)
 {
 	for (size_t i = 0; i < this->params.size(); i++)
@@ -356,12 +416,45 @@ void ArenaTypes::SpellData::init(const uint8_t *data)
 	std::copy(nameStart, nameEnd, this->name.begin());
 }
 
+void ArenaTypes::SpellData::write(uint8_t *data) const
+{
+	for (size_t i = 0; i < this->params.size(); i++)
+	{
+		const size_t offset = i * 6;
+		const auto &param = this->params.at(i);
+		Bytes::setLE16(data + offset, param.at(0));
+		Bytes::setLE16(data + offset + 2, param.at(1));
+		Bytes::setLE16(data + offset + 4, param.at(2));
+	}
+
+	*(data + 36) = this->targetType;
+	*(data + 37) = this->unknown;
+	*(data + 38) = this->element;
+	Bytes::setLE16(data + 39, this->flags);
+
+	for (size_t i = 0; i < 3; i++)
+	{
+		*(data + 41 + i) = this->effects.at(i);
+		*(data + 44 + i) = this->subEffects.at(i);
+		*(data + 47 + i) = this->affectedAttributes.at(i);
+	}
+
+	Bytes::setLE16(data + 50, this->cost);
+	std::copy(this->name.begin(), this->name.end(), reinterpret_cast<char*>(data + 52));
+}
+
 void ArenaTypes::Tavern::init(const uint8_t *data)
 {
 	this->remainingHours = Bytes::getLE16(data);
 	this->timeLimit = Bytes::getLE32(data + 2);
 }
 
+void ArenaTypes::Tavern::write(uint8_t *data) const
+{
+	Bytes::setLE16(data, this->remainingHours);
+	Bytes::setLE32(data + 2, this->timeLimit);
+}
+
 void ArenaTypes::Repair::Job::init(const uint8_t *data)
 {
 	this->valid = *data;
@@ -369,6 +462,13 @@ void ArenaTypes::Repair::Job::init(const uint8_t *data)
 	this->item.init(data + 5);
 }
 
+void ArenaTypes::Repair::Job::write(uint8_t *data) const
+{
+	*data = this->valid;
+	Bytes::setLE32(data + 1, this->dueTo);
+	this->item.write(data + 5);
+}
+
 void ArenaTypes::Repair::init(const uint8_t *data)
 {
 	const uint8_t *jobsStart = data;
@@ -378,6 +478,15 @@ void ArenaTypes::Repair::init(const uint8_t *data)
 	}
 }
 
+void ArenaTypes::Repair::write(uint8_t *data) const
+{
+	uint8_t *jobsStart = data;
+	for (size_t i = 0; i < this->jobs.size(); i++)
+	{
+		this->jobs.at(i).write(jobsStart + (Job::SIZE * i));
+	}
+}
+
 void ArenaTypes::Automap::FogOfWarCache::Note::init(const uint8_t *data)
 {
 	this->x = Bytes::getLE16(data);
@@ -388,6 +497,13 @@ void ArenaTypes::Automap::FogOfWarCache::Note::init(const uint8_t *data)
 	std::copy(textStart, textEnd, this->text.begin());
 }
 
+void ArenaTypes::Automap::FogOfWarCache::Note::write(uint8_t *data) const
+{
+	Bytes::setLE16(data, this->x);
+	Bytes::setLE16(data + 2, this->y);
+	std::copy(this->text.begin(), this->text.end(), reinterpret_cast<char*>(data + 4));
+}
+
 void ArenaTypes::Automap::FogOfWarCache::init(const uint8_t *data)
 {
 	this->levelHash = Bytes::getLE32(data);
@@ -404,6 +520,20 @@ void ArenaTypes::Automap::FogOfWarCache::init(const uint8_t *data)
 	std::copy(bitmapStart, bitmapEnd, this->bitmap.begin());
 }
 
+void ArenaTypes::Automap::FogOfWarCache::write(uint8_t *data) const
+{
+	Bytes::setLE32(data, this->levelHash);
+
+	uint8_t *notesStart = data + 4;
+	uint8_t *notesEnd = notesStart + (Note::SIZE * this->notes.size());
+	for (size_t i = 0; i < this->notes.size(); i++)
+	{
+		this->notes.at(i).write(notesStart + (Note::SIZE * i));
+	}
+
+	std::copy(this->bitmap.begin(), this->bitmap.end(), notesEnd);
+}
+
 void ArenaTypes::Automap::init(const uint8_t *data)
 {
 	const uint8_t *cachesStart = data;
@@ -413,6 +543,15 @@ void ArenaTypes::Automap::init(const uint8_t *data)
 	}
 }
 
+void ArenaTypes::Automap::write(uint8_t *data) const
+{
+	uint8_t *cachesStart = data;
+	for (size_t i = 0; i < this->caches.size(); i++)
+	{
+		this->caches.at(i).write(cachesStart + (FogOfWarCache::SIZE * i));
+	}
+}
+
 void ArenaTypes::Log::Entry::init(const std::string &data)
 {
 	// Split the title and body on the first newline (there are no carriage returns).
@@ -423,6 +562,11 @@ void ArenaTypes::Log::Entry::init(const std::string &data)
 	this->body = data.substr(index + 1);
 }
 
+std::string ArenaTypes::Log::Entry::write() const
+{
+	return this->title + '\n' + this->body;
+}
+
 void ArenaTypes::Log::init(const std::string &data)
 {
 	const std::string delimiter = " *";
@@ -440,6 +584,18 @@ void ArenaTypes::Log::init(const std::string &data)
 	}
 }
 
+std::string ArenaTypes::Log::write() const
+{
+	// Each entry starts with an ampersand and ends with the delimiter.
+	std::string data;
+	for (const Entry &entry : this->entries)
+	{
+		data += '&' + entry.write() + " *";
+	}
+
+	return data;
+}
+
 void ArenaTypes::Names::Entry::init(const uint8_t *data)
 {
 	const char *nameStart = reinterpret_cast<const char*>(data);
@@ -447,6 +603,11 @@ void ArenaTypes::Names::Entry::init(const uint8_t *data)
 	std::copy(nameStart, nameEnd, this->name.begin());
 }
 
+void ArenaTypes::Names::Entry::write(uint8_t *data) const
+{
+	std::copy(this->name.begin(), this->name.end(), reinterpret_cast<char*>(data));
+}
+
 void ArenaTypes::Names::init(const uint8_t *data)
 {
 	const uint8_t *entriesStart = data;
@@ -455,3 +616,12 @@ void ArenaTypes::Names::init(const uint8_t *data)
 		this->entries.at(i).init(entriesStart + (Entry::SIZE * i));
 	}
 }
+
+void ArenaTypes::Names::write(uint8_t *data) const
+{
+	uint8_t *entriesStart = data;
+	for (size_t i = 0; i < this->entries.size(); i++)
+	{
+		this->entries.at(i).write(entriesStart + (Entry::SIZE * i));
+	}
+}
@@ -44,6 +44,7 @@ public:
 		uint8_t x, y, lockLevel;
 
 		void init(const uint8_t *data);
+		void write(uint8_t *data) const;
 	};
 
 	struct MIFTarget
@@ -66,6 +67,7 @@ public:
 		int8_t textIndex, soundIndex;
 
 		void init(const uint8_t *data);
+		void write(uint8_t *data) const;
 	};
 
 	struct DynamicTrigger
@@ -143,6 +145,7 @@ public:
 		uint8_t flags, x, material, y, attribute;
 
 		void init(const uint8_t *data);
+		void write(uint8_t *data) const;
 	};
 
 	// For SAVEENGN.0x.
@@ -375,12 +378,14 @@ public:
 			std::array<MIFLock, 64> locks;
 
 			void init(const uint8_t *data);
+			void write(uint8_t *data) const;
 		};
 
 		// Index is (((provinceID * 2) + localDungeonID) * 4) + level.
 		std::array<HashTable, 64> hashTables;
 
 		void init(const uint8_t *data);
+		void write(uint8_t *data) const;
 	};
 
 	// For each spell in SPELLS.0x and SPELLSG.0x.
@@ -400,6 +405,7 @@ public:
 		std::array<char, 33> name;
 
 		void init(const uint8_t *data);
+		void write(uint8_t *data) const;
 
 		template <size_t T>
 		static void initArray(std::array<SpellData, T> &arr, const uint8_t *data)
@@ -409,6 +415,15 @@ public:
 				arr.at(i).init(data + (SpellData::SIZE * i));
 			}
 		}
+
+		template <size_t T>
+		static void writeArray(const std::array<SpellData, T> &arr, uint8_t *data)
+		{
+			for (size_t i = 0; i < arr.size(); i++)
+			{
+				arr.at(i).write(data + (SpellData::SIZE * i));
+			}
+		}
 	};
 
 	// For SPELLS.0x (custom spells).
@@ -426,6 +441,7 @@ public:
 		uint32_t timeLimit;
 
 		void init(const uint8_t *data);
+		void write(uint8_t *data) const;
 	};
 
 	// For RE#.0x (EQ#.0x can be ignored).
@@ -442,11 +458,13 @@ public:
 			InventoryItem item;
 
 			void init(const uint8_t *data);
+			void write(uint8_t *data) const;
 		};
 
 		std::array<Job, 5> jobs;
 
 		void init(const uint8_t *data);
+		void write(uint8_t *data) const;
 	};
 
 	// For AUTOMAP.0x.
@@ -466,6 +484,7 @@ public:
 				std::array<char, 60> text;
 
 				void init(const uint8_t *data);
+				void write(uint8_t *data) const;
 			};
 
 			uint32_t levelHash;
@@ -473,11 +492,13 @@ public:
 			std::array<uint8_t, 4096> bitmap; // 2 bits per block.
 
 			void init(const uint8_t *data);
+			void write(uint8_t *data) const;
 		};
 
 		std::array<FogOfWarCache, 16> caches;
 
 		void init(const uint8_t *data);
+		void write(uint8_t *data) const;
 	};
 
 	// For LOG.0x.
@@ -488,11 +509,13 @@ public:
 			std::string title, body;
 
 			void init(const std::string &data);
+			std::string write() const;
 		};
 
 		std::vector<Entry> entries;
 
 		void init(const std::string &data);
+		std::string write() const;
 	};
 
 	// For NAMES.DAT.
@@ -507,11 +530,13 @@ public:
 			std::array<char, 48> name;
 
 			void init(const uint8_t *data);
+			void write(uint8_t *data) const;
 		};
 
 		std::array<Entry, 10> entries;
 
 		void init(const uint8_t *data);
+		void write(uint8_t *data) const;
 	};
 };
 
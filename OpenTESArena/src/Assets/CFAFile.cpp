@@ -10,13 +10,8 @@
 
 CFAFile::CFAFile(const std::string &filename)
 {
-	VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
-
-	stream->seekg(0, std::ios::end);
-	std::vector<uint8_t> srcData(stream->tellg());
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+	const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+	DebugAssertMsg(srcData.isValid(), "Could not open \"" + filename + "\".");
 
 	// Read CFA header. Fortunately, all CFAs have headers, unlike IMGs and CIFs.
 	const uint16_t widthUncompressed = Bytes::getLE16(srcData.data());
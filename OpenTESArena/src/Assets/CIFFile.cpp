@@ -28,13 +28,8 @@ CIFFile::CIFFile(const std::string &filename)
 	// Some filenames (i.e., Arrows.cif) have different casing between the floppy version and
 	// CD version, so this needs to use the case-insensitive open() method for correct behavior
 	// on Unix-based systems.
-	VFS::IStreamPtr stream = VFS::Manager::get().openCaseInsensitive(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
-
-	stream->seekg(0, std::ios::end);
-	std::vector<uint8_t> srcData(stream->tellg());
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+	const VFS::DataView srcData = VFS::Manager::get().openViewCaseInsensitive(filename);
+	DebugAssertMsg(srcData.isValid(), "Could not open \"" + filename + "\".");
 
 	// X and Y offset might be useful for weapon positions on the screen.
 	uint16_t xoff, yoff, width, height, flags, len;
@@ -14,6 +14,13 @@
 
 #include "components/vfs/manager.hpp"
 
+namespace
+{
+	// Dimensions of the world map in pixels.
+	const int WorldMapWidth = 320;
+	const int WorldMapHeight = 200;
+}
+
 bool CityDataFile::ProvinceData::LocationData::isVisible() const
 {
 	return (this->visibility & 0x2) != 0;
@@ -396,22 +403,59 @@ int CityDataFile::getGlobalQuarter(const Int2 &globalPoint) const
 	return globalQuarter;
 }
 
-int CityDataFile::getTravelDays(int startLocationID, int startProvinceID, int endLocationID,
-	int endProvinceID, int month, const std::array<WeatherType, 36> &weathers,
-	ArenaRandom &random, const MiscAssets &miscAssets) const
+Int2 CityDataFile::getLocationGlobalPoint(int locationID, int provinceID) const
 {
-	auto getGlobalPoint = [this](int locationID, int provinceID)
+	const auto &province = this->getProvinceData(provinceID);
+	const auto &location = province.getLocationData(locationID);
+	return CityDataFile::localPointToGlobal(
+		Int2(location.x, location.y), province.getGlobalRect());
+}
+
+int CityDataFile::getTravelSpeed(int terrainIndex, int weatherIndex, int monthIndex,
+	const ExeData &exeData)
+{
+	// Calculate the travel speed based on climate and weather.
+	const auto &climateSpeedTables = exeData.locations.climateSpeedTables;
+	const auto &weatherSpeedTables = exeData.locations.weatherSpeedTables;
+	const int climateSpeed = climateSpeedTables.at(terrainIndex).at(monthIndex);
+	const int weatherMod = [terrainIndex, weatherIndex, &weatherSpeedTables]()
 	{
-		const auto &province = this->getProvinceData(provinceID);
-		const auto &location = province.getLocationData(locationID);
-		return CityDataFile::localPointToGlobal(
-			Int2(location.x, location.y), province.getGlobalRect());
-	};
+		const int weatherSpeed = weatherSpeedTables.at(terrainIndex).at(weatherIndex);
 
-	// The two world map points to calculate between.
-	const Int2 startGlobalPoint = getGlobalPoint(startLocationID, startProvinceID);
-	const Int2 endGlobalPoint = getGlobalPoint(endLocationID, endProvinceID);
+		// Special case: 0 equals 100.
+		return (weatherSpeed == 0) ? 100 : weatherSpeed;
+	}();
 
+	return (climateSpeed * weatherMod) / 100;
+}
+
+int CityDataFile::getPixelTravelTime(const Int2 &globalPoint, int monthIndex,
+	const std::array<WeatherType, 36> &weathers, const MiscAssets &miscAssets) const
+{
+	const int weatherIndex = [this, &weathers, &globalPoint]()
+	{
+		// Find which province quarter the global point is in.
+		const int quarterIndex = this->getGlobalQuarter(globalPoint);
+
+		// Convert the weather type to its equivalent index.
+		return static_cast<int>(weathers.at(quarterIndex));
+	}();
+
+	// The type of terrain at the world map point.
+	const auto &worldMapTerrain = miscAssets.getWorldMapTerrain();
+	const uint8_t terrainIndex = MiscAssets::WorldMapTerrain::getNormalizedIndex(
+		worldMapTerrain.getAt(globalPoint.x, globalPoint.y));
+
+	const int travelSpeed = CityDataFile::getTravelSpeed(
+		terrainIndex, weatherIndex, monthIndex, miscAssets.getExeData());
+
+	return 2000 / travelSpeed;
+}
+
+int CityDataFile::getTotalTravelTime(const Int2 &startGlobalPoint, const Int2 &endGlobalPoint,
+	int month, const std::array<WeatherType, 36> &weathers, const TravelCostRaster *raster,
+	const MiscAssets &miscAssets) const
+{
 	// Get all the points along the line between the two points.
 	const std::vector<Int2> points = Int2::bresenhamLine(startGlobalPoint, endGlobalPoint);
 
@@ -419,58 +463,175 @@ int CityDataFile::getTravelDays(int startLocationID, int startProvinceID, int en
 	for (const Int2 &point : points)
 	{
 		const int monthIndex = (month + (totalTime / 3000)) % 12;
-		const int weatherIndex = [this, &weathers, &point]()
-		{
-			// Find which province quarter the global point is in.
-			const int quarterIndex = this->getGlobalQuarter(point);
-
-			// Convert the weather type to its equivalent index.
-			return static_cast<int>(weathers.at(quarterIndex));
-		}();
 
-		// The type of terrain at the world map point.
-		const auto &worldMapTerrain = miscAssets.getWorldMapTerrain();
-		const uint8_t terrainIndex = MiscAssets::WorldMapTerrain::getNormalizedIndex(
-			worldMapTerrain.getAt(point.x, point.y));
-
-		// Calculate the travel speed based on climate and weather.
-		const auto &exeData = miscAssets.getExeData();
-		const auto &climateSpeedTables = exeData.locations.climateSpeedTables;
-		const auto &weatherSpeedTables = exeData.locations.weatherSpeedTables;
-		const int climateSpeed = climateSpeedTables.at(terrainIndex).at(monthIndex);
-		const int weatherMod = [terrainIndex, weatherIndex, &weatherSpeedTables]()
+		int pixelTravelTime = 0;
+		if (raster != nullptr)
 		{
-			const int weatherSpeed = weatherSpeedTables.at(terrainIndex).at(weatherIndex);
+			const bool inRaster = (point.x >= 0) && (point.x < WorldMapWidth) &&
+				(point.y >= 0) && (point.y < WorldMapHeight);
 
-			// Special case: 0 equals 100.
-			return (weatherSpeed == 0) ? 100 : weatherSpeed;
-		}();
+			if (inRaster)
+			{
+				const int index = point.x + (point.y * WorldMapWidth);
+				pixelTravelTime = raster->pixelTimes[monthIndex][index];
+			}
+		}
 
-		const int travelSpeed = (climateSpeed * weatherMod) / 100;
+		// Pixels the raster doesn't cover are worked out here.
+		if (pixelTravelTime == 0)
+		{
+			pixelTravelTime = this->getPixelTravelTime(point, monthIndex, weathers, miscAssets);
+		}
 
 		// Add the pixel's travel time onto the total time.
-		const int pixelTravelTime = 2000 / travelSpeed;
 		totalTime += pixelTravelTime;
 	}
 
+	return totalTime;
+}
+
+int CityDataFile::getTravelDaysFromTime(int totalTime, ArenaRandom &random)
+{
+	const int minDays = 1;
+	const int maxDays = 2000;
+	int days = std::clamp(totalTime / 100, minDays, maxDays);
+
+	if (days > 20)
+	{
+		days += (random.next() % 10) - 5;
+	}
+
+	return days;
+}
+
+int CityDataFile::getTravelDays(int startLocationID, int startProvinceID, int endLocationID,
+	int endProvinceID, int month, const std::array<WeatherType, 36> &weathers,
+	ArenaRandom &random, const MiscAssets &miscAssets) const
+{
+	// The two world map points to calculate between.
+	const Int2 startGlobalPoint = this->getLocationGlobalPoint(startLocationID, startProvinceID);
+	const Int2 endGlobalPoint = this->getLocationGlobalPoint(endLocationID, endProvinceID);
+
+	const int totalTime = this->getTotalTravelTime(startGlobalPoint, endGlobalPoint,
+		month, weathers, nullptr, miscAssets);
+
 	// Calculate the actual travel days based on the total time.
-	const int travelDays = [&random, totalTime]()
+	return CityDataFile::getTravelDaysFromTime(totalTime, random);
+}
+
+int CityDataFile::getTravelDays(int startLocationID, int startProvinceID, int endLocationID,
+	int endProvinceID, int month, const TravelCostRaster &raster, ArenaRandom &random,
+	const MiscAssets &miscAssets) const
+{
+	const Int2 startGlobalPoint = this->getLocationGlobalPoint(startLocationID, startProvinceID);
+	const Int2 endGlobalPoint = this->getLocationGlobalPoint(endLocationID, endProvinceID);
+
+	const int totalTime = this->getTotalTravelTime(startGlobalPoint, endGlobalPoint,
+		month, raster.weathers, &raster, miscAssets);
+
+	return CityDataFile::getTravelDaysFromTime(totalTime, random);
+}
+
+std::array<int, 48> CityDataFile::getTravelDays(int startLocationID, int startProvinceID,
+	int endProvinceID, int month, const TravelCostRaster &raster, const ArenaRandom &random,
+	const MiscAssets &miscAssets) const
+{
+	const Int2 startGlobalPoint = this->getLocationGlobalPoint(startLocationID, startProvinceID);
+	const auto &endProvince = this->getProvinceData(endProvinceID);
+	const Rect endProvinceRect = endProvince.getGlobalRect();
+
+	std::array<int, 48> travelDays;
+	for (int i = 0; i < static_cast<int>(travelDays.size()); i++)
 	{
-		const int minDays = 1;
-		const int maxDays = 2000;
-		int days = std::clamp(totalTime / 100, minDays, maxDays);
+		const auto &location = endProvince.getLocationData(i);
 
-		if (days > 20)
+		if (location.isVisible())
 		{
-			days += (random.next() % 10) - 5;
-		}
+			const Int2 endGlobalPoint = CityDataFile::localPointToGlobal(
+				Int2(location.x, location.y), endProvinceRect);
+			const int totalTime = this->getTotalTravelTime(startGlobalPoint, endGlobalPoint,
+				month, raster.weathers, &raster, miscAssets);
 
-		return days;
-	}();
+			ArenaRandom tempRandom = random;
+			travelDays[i] = CityDataFile::getTravelDaysFromTime(totalTime, tempRandom);
+		}
+		else
+		{
+			travelDays[i] = 0;
+		}
+	}
 
 	return travelDays;
 }
 
+CityDataFile::TravelCostRaster CityDataFile::makeTravelCostRaster(
+	const std::array<WeatherType, 36> &weathers, const MiscAssets &miscAssets) const
+{
+	const auto &worldMapTerrain = miscAssets.getWorldMapTerrain();
+	const auto &exeData = miscAssets.getExeData();
+	const auto &climateSpeedTables = exeData.locations.climateSpeedTables;
+	const auto &weatherSpeedTables = exeData.locations.weatherSpeedTables;
+
+	TravelCostRaster raster;
+	raster.weathers = weathers;
+
+	for (std::vector<uint16_t> &pixelTimes : raster.pixelTimes)
+	{
+		pixelTimes = std::vector<uint16_t>(WorldMapWidth * WorldMapHeight, 0);
+	}
+
+	for (int y = 0; y < WorldMapHeight; y++)
+	{
+		for (int x = 0; x < WorldMapWidth; x++)
+		{
+			const Int2 point(x, y);
+
+			// Pixels outside every province are left for getGlobalQuarter() to report if a
+			// trip ever crosses one.
+			const bool inProvince = std::any_of(this->provinces.begin(), this->provinces.end(),
+				[&point](const CityDataFile::ProvinceData &province)
+			{
+				return province.getGlobalRect().containsInclusive(point);
+			});
+
+			if (!inProvince)
+			{
+				continue;
+			}
+
+			const int weatherIndex = static_cast<int>(
+				weathers.at(this->getGlobalQuarter(point)));
+			const int terrainIndex = MiscAssets::WorldMapTerrain::getNormalizedIndex(
+				worldMapTerrain.getAt(x, y));
+
+			// Leave pixels without speeds (i.e., the terrain isn't in the tables) for the
+			// per-query path, so it can report them.
+			const bool hasSpeeds =
+				(terrainIndex < static_cast<int>(climateSpeedTables.size())) &&
+				(weatherIndex < static_cast<int>(weatherSpeedTables.front().size()));
+
+			if (!hasSpeeds)
+			{
+				continue;
+			}
+
+			const int index = x + (y * WorldMapWidth);
+			for (int month = 0; month < static_cast<int>(raster.pixelTimes.size()); month++)
+			{
+				const int travelSpeed = CityDataFile::getTravelSpeed(
+					terrainIndex, weatherIndex, month, exeData);
+
+				if (travelSpeed > 0)
+				{
+					raster.pixelTimes[month][index] = static_cast<uint16_t>(2000 / travelSpeed);
+				}
+			}
+		}
+	}
+
+	return raster;
+}
+
 uint32_t CityDataFile::getCitySeed(int localCityID, int provinceID) const
 {
 	const auto &province = this->getProvinceData(provinceID);
@@ -556,13 +717,11 @@ Int2 CityDataFile::getLocalCityPoint(uint32_t citySeed)
 
 void CityDataFile::init(const std::string &filename)
 {
-	VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
-
-	stream->seekg(0, std::ios::end);
-	std::vector<uint8_t> srcData(stream->tellg());
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+	const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+	if (!srcData.isValid())
+	{
+		throw DebugException("Could not open \"" + filename + "\".");
+	}
 
 	// Iterate over each province and initialize the location data.
 	for (size_t i = 0; i < this->provinces.size(); i++)
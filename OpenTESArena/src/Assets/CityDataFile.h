@@ -4,6 +4,7 @@
 #include <array>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "../Math/Rect.h"
 #include "../Math/Vector2.h"
@@ -54,9 +55,39 @@ public:
 		// Gets the location associated with the given location ID.
 		const CityDataFile::ProvinceData::LocationData &getLocationData(int locationID) const;
 	};
+
+	// The time to cross each world map pixel, one raster per month, for the province
+	// quarter weathers it was made with. A time of zero means the pixel is worked out per
+	// query instead (it's outside every province, or its speed tables don't allow travel),
+	// which gives the same result (or error) as without a raster.
+	struct TravelCostRaster
+	{
+		std::array<std::vector<uint16_t>, 12> pixelTimes; // 320x200, indexed by month.
+		std::array<WeatherType, 36> weathers;
+	};
 private:
 	// These are ordered the same as usual (read left to right, and center is last).
 	std::array<ProvinceData, 9> provinces;
+
+	// Gets the world map point of a location.
+	Int2 getLocationGlobalPoint(int locationID, int provinceID) const;
+
+	// Gets the travel speed over the given terrain in some month and weather.
+	static int getTravelSpeed(int terrainIndex, int weatherIndex, int monthIndex,
+		const ExeData &exeData);
+
+	// Gets the time it takes to cross a world map pixel in the given month.
+	int getPixelTravelTime(const Int2 &globalPoint, int monthIndex,
+		const std::array<WeatherType, 36> &weathers, const MiscAssets &miscAssets) const;
+
+	// Adds up the time to cross each pixel on the line between two world map points. Pixel
+	// times are looked up in the raster if there is one.
+	int getTotalTravelTime(const Int2 &startGlobalPoint, const Int2 &endGlobalPoint,
+		int month, const std::array<WeatherType, 36> &weathers,
+		const TravelCostRaster *raster, const MiscAssets &miscAssets) const;
+
+	// Converts the total time of a trip to days. Long trips vary by a few days.
+	static int getTravelDaysFromTime(int totalTime, ArenaRandom &random);
 public:
 	static const int PROVINCE_COUNT;
 
@@ -124,6 +155,24 @@ public:
 		int endProvinceID, int month, const std::array<WeatherType, 36> &weathers,
 		ArenaRandom &random, const MiscAssets &miscAssets) const;
 
+	// Same as above, with the weathers and pixel times taken from a travel cost raster.
+	int getTravelDays(int startLocationID, int startProvinceID, int endLocationID,
+		int endProvinceID, int month, const TravelCostRaster &raster, ArenaRandom &random,
+		const MiscAssets &miscAssets) const;
+
+	// Gets the number of days required to travel from one location to each visible location
+	// in a province, indexed by location ID (hidden ones are zero). Each one uses its own
+	// copy of the random generator, so they match separate getTravelDays() calls that are
+	// each given a copy of it.
+	std::array<int, 48> getTravelDays(int startLocationID, int startProvinceID,
+		int endProvinceID, int month, const TravelCostRaster &raster,
+		const ArenaRandom &random, const MiscAssets &miscAssets) const;
+
+	// Works out the time to cross every world map pixel in every month with the given
+	// weathers. It takes a pass over the whole map, so keep it while the weathers last.
+	TravelCostRaster makeTravelCostRaster(const std::array<WeatherType, 36> &weathers,
+		const MiscAssets &miscAssets) const;
+
 	// Gets the 32-bit seed for a city.
 	uint32_t getCitySeed(int localCityID, int provinceID) const;
 
@@ -1,84 +1,450 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
+
 #include "Compression.h"
-#include "../Utilities/Bytes.h"
+#include "../Utilities/Debug.h"
+
+namespace
+{
+	// The LZ decoders copy from a 4 KiB window of previous output. Arena's encoder starts
+	// with the window full of spaces, so back-references that reach before the start of
+	// the output read this value.
+	const uint8_t HISTORY_FILL = 0x20;
+	const int HISTORY_MASK = 0x0FFF;
+
+	// Copies a back-reference of 'count' bytes from 'distance' bytes behind dst, reading
+	// straight from the output instead of keeping a separate history ring.
+	void copyBackReference(const uint8_t *outBegin, uint8_t *dst, int distance, int count)
+	{
+		const int srcIndex = static_cast<int>(dst - outBegin) - distance;
+		if ((srcIndex >= 0) && (distance >= count))
+		{
+			std::memcpy(dst, dst - distance, count);
+		}
+		else
+		{
+			// Either a repeating pattern (the copy overlaps its own output) or it starts in
+			// the initial window fill, so go byte by byte.
+			for (int i = 0; i < count; i++)
+			{
+				dst[i] = ((srcIndex + i) >= 0) ? dst[i - distance] : HISTORY_FILL;
+			}
+		}
+	}
+
+	// Type 4 back-references give an absolute position in the 4 KiB history ring, which is
+	// in step with the output position. Converts that to a distance in [1, 4096].
+	int getType04Distance(int outIndex, int ringPos)
+	{
+		return ((outIndex - ringPos - 1) & HISTORY_MASK) + 1;
+	}
+
+	// Type 8 is an adaptive Huffman code (314 symbols: 256 literals plus match lengths
+	// 3-60) over LZ back-references, much like LZHUF.
+	const int TYPE08_LEAF_COUNT = 314;
+	const int TYPE08_NODE_COUNT = (TYPE08_LEAF_COUNT * 2) - 1;
+	const int TYPE08_ROOT = TYPE08_NODE_COUNT - 1;
+
+	struct Type08Tree
+	{
+		// Index of each node's frequency slot, with leaves after the internal nodes.
+		std::array<uint16_t, TYPE08_NODE_COUNT + TYPE08_LEAF_COUNT> NodeIdxMap;
+
+		// Child pair base (internal node) or leaf ID (>= node count), sorted by frequency.
+		std::array<uint16_t, TYPE08_NODE_COUNT> NodeTree;
+		std::array<uint16_t, TYPE08_NODE_COUNT> NodeFreq;
+	};
+
+	Type08Tree makeType08Tree()
+	{
+		Type08Tree tree;
+
+		std::iota(tree.NodeIdxMap.begin(), tree.NodeIdxMap.begin() + 626, 0);
+		std::for_each(tree.NodeIdxMap.begin(), tree.NodeIdxMap.begin() + 626,
+			[](uint16_t &val) { val = (val >> 1) + 314; });
+
+		tree.NodeIdxMap[626] = 0;
+		std::iota(tree.NodeIdxMap.begin() + 627, tree.NodeIdxMap.end(), 0);
+
+		std::iota(tree.NodeTree.begin(), tree.NodeTree.begin() + 314, 627);
+		std::iota(tree.NodeTree.begin() + 314, tree.NodeTree.end(), 0);
+		std::for_each(tree.NodeTree.begin() + 314, tree.NodeTree.end(),
+			[](uint16_t &val) { val *= 2; });
+
+		std::fill(tree.NodeFreq.begin(), tree.NodeFreq.begin() + 314, 1);
+		for (int i = 314; i < TYPE08_NODE_COUNT; i++)
+		{
+			const int child = (i - 314) * 2;
+			tree.NodeFreq[i] = tree.NodeFreq[child] + tree.NodeFreq[child + 1];
+		}
+
+		return tree;
+	}
+
+	const std::array<uint8_t, 256> Type08HighOffsetBits =
+	{
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+		0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+		0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+		0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,
+		0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07,
+		0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09,
+		0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B,
+		0x0C, 0x0C, 0x0C, 0x0C, 0x0D, 0x0D, 0x0D, 0x0D, 0x0E, 0x0E, 0x0E, 0x0E, 0x0F, 0x0F, 0x0F, 0x0F,
+		0x10, 0x10, 0x10, 0x10, 0x11, 0x11, 0x11, 0x11, 0x12, 0x12, 0x12, 0x12, 0x13, 0x13, 0x13, 0x13,
+		0x14, 0x14, 0x14, 0x14, 0x15, 0x15, 0x15, 0x15, 0x16, 0x16, 0x16, 0x16, 0x17, 0x17, 0x17, 0x17,
+		0x18, 0x18, 0x19, 0x19, 0x1A, 0x1A, 0x1B, 0x1B, 0x1C, 0x1C, 0x1D, 0x1D, 0x1E, 0x1E, 0x1F, 0x1F,
+		0x20, 0x20, 0x21, 0x21, 0x22, 0x22, 0x23, 0x23, 0x24, 0x24, 0x25, 0x25, 0x26, 0x26, 0x27, 0x27,
+		0x28, 0x28, 0x29, 0x29, 0x2A, 0x2A, 0x2B, 0x2B, 0x2C, 0x2C, 0x2D, 0x2D, 0x2E, 0x2E, 0x2F, 0x2F,
+		0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F
+	};
+
+	const std::array<uint8_t, 256> Type08LowOffsetBitCount =
+	{
+		0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+		0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+		0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+		0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+		0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+		0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,
+		0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,
+		0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,
+		0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,
+		0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06,
+		0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06,
+		0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06,
+		0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07,
+		0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07,
+		0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07,
+		0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08
+	};
+
+	// Most-significant-first bit reader for type 8 data. Past the end of the input it reads
+	// zeroes, which the format relies on for its last few codes.
+	class Type08BitReader
+	{
+	private:
+		const uint8_t *src, *srcEnd;
+		uint32_t bits; // Unread bits, left-aligned.
+		int bitCount;
+
+		void refill()
+		{
+			while (this->bitCount <= 24)
+			{
+				const uint32_t byte = (this->src != this->srcEnd) ? *this->src++ : 0;
+				this->bits |= byte << (24 - this->bitCount);
+				this->bitCount += 8;
+			}
+		}
+	public:
+		Type08BitReader(const uint8_t *src, const uint8_t *srcEnd)
+		{
+			this->src = src;
+			this->srcEnd = srcEnd;
+			this->bits = 0;
+			this->bitCount = 0;
+		}
+
+		// Reads 1 to 24 bits.
+		uint32_t read(int count)
+		{
+			if (this->bitCount < count)
+			{
+				this->refill();
+			}
+
+			const uint32_t value = this->bits >> (32 - count);
+			this->bits <<= count;
+			this->bitCount -= count;
+			return value;
+		}
+	};
+}
 
 void Compression::decodeRLE(const uint8_t *src, int stopCount,
 	std::vector<uint8_t> &out)
 {
-	// Adapted from WinArena.
-	int i = 0;
-	int o = 0;
+	// Adapted from WinArena. Runs may go past the stop count as long as they fit in 'out'.
+	uint8_t *const outBegin = out.data();
+	uint8_t *const outEnd = outBegin + out.size();
+	uint8_t *dst = outBegin;
 
-	while (o < stopCount)
+	while ((dst - outBegin) < stopCount)
 	{
-		const uint8_t sample = src[i];
-		src++;
+		const uint8_t sample = *src++;
 
 		// Is the selected byte part of a compressed packet?
 		if ((sample & 0x80) != 0)
 		{
-			const uint8_t value = src[i];
-			src++;
-
-			const uint32_t count = static_cast<uint32_t>(sample) - 0x7F;
-
-			for (uint32_t j = 0; j < count; j++)
+			const int count = static_cast<int>(sample) - 0x7F;
+			if ((outEnd - dst) < count)
 			{
-				out.at(o) = value;
-				o++;
+				throw DebugException("RLE output overflow.");
 			}
+
+			std::memset(dst, *src++, count);
+			dst += count;
 		}
 		else
 		{
-			const uint32_t count = static_cast<uint32_t>(sample) + 1;
-
-			for (uint32_t j = 0; j < count; j++)
+			const int count = static_cast<int>(sample) + 1;
+			if ((outEnd - dst) < count)
 			{
-				out.at(o) = src[i];
-				o++;
-				i++;
+				throw DebugException("RLE output overflow.");
 			}
+
+			std::memcpy(dst, src, count);
+			src += count;
+			dst += count;
 		}
 	}
 }
 
-void Compression::decodeRLEWords(const uint8_t *src, int stopCount, 
+void Compression::decodeRLEWords(const uint8_t *src, int stopCount,
 	std::vector<uint8_t> &out)
 {
-	int i = 0;
-	int o = 0;
+	uint8_t *const outBegin = out.data();
+	uint8_t *const outEnd = outBegin + out.size();
+	uint8_t *dst = outBegin;
 
-	while (o < stopCount)
+	while ((dst - outBegin) < (stopCount * 2))
 	{
-		const int16_t sample = Bytes::getLE16(src + i);
-		i += 2;
+		// Read inline; a call to Bytes::getLE16() per run costs more than the short runs do.
+		const int16_t sample = static_cast<int16_t>(src[0] | (src[1] << 8));
+		src += 2;
 
 		// If "sample" is positive, then "sample" literal words follow. Otherwise,
-		// repeat the next word "sample" times.
+		// repeat the next word "sample" times. Words are stored little-endian in both.
+		const int count = (sample > 0) ? sample : -static_cast<int>(sample);
+		if ((outEnd - dst) < (count * 2))
+		{
+			throw DebugException("RLE output overflow.");
+		}
+
+		// Runs are mostly a few words long, so words are moved whole instead of calling
+		// memcpy per run. Copying a word's bytes keeps them in file order on any host, and
+		// the output position is always even, so word stores are aligned.
+		uint16_t *dstWords = reinterpret_cast<uint16_t*>(dst);
 		if (sample > 0)
 		{
-			for (int16_t j = 0; j < sample; j++)
+			for (int i = 0; i < count; i++)
 			{
-				const uint16_t value = Bytes::getLE16(src + i);
-				i += 2;
-
-				out.at(o * 2) = value & 0x00FF;
-				out.at((o * 2) + 1) = (value & 0xFF00) >> 8;
-				o++;
+				std::memcpy(dstWords + i, src, sizeof(uint16_t));
+				src += 2;
 			}
 		}
 		else
 		{
-			const uint16_t value = Bytes::getLE16(src + i);
-			i += 2;
+			uint16_t word;
+			std::memcpy(&word, src, sizeof(word));
+			src += 2;
+
+			std::fill_n(dstWords, count, word);
+		}
+
+		dst += count * 2;
+	}
+}
 
-			const uint16_t count = -sample;
+void Compression::decodeType04(const uint8_t *src, const uint8_t *srcEnd,
+	std::vector<uint8_t> &out)
+{
+	// This appears to be some form of LZ compression. It starts with a 1-byte-
+	// wide bitmask, where each bit declares if the next pixel comes directly
+	// from the input, or refers back to a previous run of output pixels that
+	// get duplicated. After each bit in the mask is used, another byte is read
+	// for another bitmask and the cycle repeats until the end of input.
+	const int maxGroupInput = 8 * 2;
+	const int maxGroupOutput = 8 * 18;
 
-			for (uint16_t j = 0; j < count; j++)
+	uint8_t *const outBegin = out.data();
+	uint8_t *const outEnd = outBegin + out.size();
+	uint8_t *dst = outBegin;
+
+	while (src != srcEnd)
+	{
+		int mask = *src++;
+
+		if (((srcEnd - src) >= maxGroupInput) && ((outEnd - dst) >= maxGroupOutput))
+		{
+			// The whole group of eight fits in both buffers, so no per-pixel bounds checks.
+			for (int bit = 0; bit < 8; bit++, mask >>= 1)
 			{
-				out.at(o * 2) = value & 0x00FF;
-				out.at((o * 2) + 1) = (value & 0xFF00) >> 8;
-				o++;
+				if ((mask & 1) != 0)
+				{
+					*dst++ = *src++;
+				}
+				else
+				{
+					const uint8_t byte1 = src[0];
+					const uint8_t byte2 = src[1];
+					src += 2;
+
+					const int tocopy = (byte2 & 0x0F) + 3;
+					const int copypos = (((byte2 & 0xF0) << 4) | byte1) + 18;
+					const int distance = getType04Distance(
+						static_cast<int>(dst - outBegin), copypos & HISTORY_MASK);
+					copyBackReference(outBegin, dst, distance, tocopy);
+					dst += tocopy;
+				}
 			}
+
+			continue;
+		}
+
+		// Near the end of either buffer. Decoding stops after any token that ends the input.
+		int bit = 0;
+		do
+		{
+			if ((mask & 1) != 0)
+			{
+				if (src == srcEnd)
+				{
+					throw DebugException("Unexpected end of image.");
+				}
+
+				if (dst == outEnd)
+				{
+					throw DebugException("Decoded image overflow.");
+				}
+
+				*dst++ = *src++;
+			}
+			else
+			{
+				if ((srcEnd - src) < 2)
+				{
+					throw DebugException("Unexpected end of image.");
+				}
+
+				const uint8_t byte1 = src[0];
+				const uint8_t byte2 = src[1];
+				src += 2;
+
+				const int tocopy = (byte2 & 0x0F) + 3;
+				const int copypos = (((byte2 & 0xF0) << 4) | byte1) + 18;
+
+				if ((outEnd - dst) < tocopy)
+				{
+					throw DebugException("Decoded image overflow.");
+				}
+
+				const int distance = getType04Distance(
+					static_cast<int>(dst - outBegin), copypos & HISTORY_MASK);
+				copyBackReference(outBegin, dst, distance, tocopy);
+				dst += tocopy;
+			}
+
+			mask >>= 1;
+			bit++;
+		} while ((bit < 8) && (src != srcEnd));
+	}
+
+	std::fill(dst, outEnd, 0);
+}
+
+void Compression::decodeType08(const uint8_t *src, const uint8_t *srcEnd,
+	std::vector<uint8_t> &out)
+{
+	// Built once and copied per call; decoding adapts the tree as it goes.
+	static const Type08Tree initialTree = makeType08Tree();
+	Type08Tree tree = initialTree;
+	auto &NodeIdxMap = tree.NodeIdxMap;
+	auto &NodeTree = tree.NodeTree;
+	auto &NodeFreq = tree.NodeFreq;
+
+	Type08BitReader reader(src, srcEnd);
+
+	uint8_t *const outBegin = out.data();
+	uint8_t *const outEnd = outBegin + out.size();
+	uint8_t *dst = outBegin;
+
+	// This feels like some form of adaptive Huffman coding, with a form of LZ
+	// compression. DEFLATE?
+	while (dst != outEnd)
+	{
+		// Starting with the root, append bits from the input while traversing
+		// the tree until a leaf node is found (indicated by being >= 627).
+		uint16_t node = NodeTree[TYPE08_ROOT];
+		while (node < TYPE08_NODE_COUNT)
+		{
+			node = NodeTree[node + reader.read(1)];
+		}
+
+		// Increment the use count (frequency) of this node, and ensure the
+		// tree remains sorted.
+		uint16_t freqidx = NodeIdxMap[node];
+		do {
+			NodeFreq[freqidx] += 1;
+			const uint16_t freq = NodeFreq[freqidx];
+			uint16_t nextidx = freqidx + 1;
+			if ((nextidx < TYPE08_NODE_COUNT) && (NodeFreq[nextidx] < freq))
+			{
+				// Find the next frequency count that's not greater than the new frequency.
+				do {
+					nextidx++;
+				} while ((nextidx < TYPE08_NODE_COUNT) && (NodeFreq[nextidx] < freq));
+				nextidx--;
+
+				// Swap 'em, placing the new frequency just before the next
+				// greater one. Since the freq only incremented by 1, this
+				// won't put it out of order.
+				NodeFreq[freqidx] = NodeFreq[nextidx];
+				NodeFreq[nextidx] = freq;
+
+				std::swap(NodeTree[freqidx], NodeTree[nextidx]);
+
+				// Update the index mappings
+				uint16_t mapidx = NodeTree[nextidx];
+				NodeIdxMap[mapidx] = nextidx;
+				if (mapidx < TYPE08_NODE_COUNT)
+				{
+					NodeIdxMap[mapidx + 1] = nextidx;
+				}
+
+				mapidx = NodeTree[freqidx];
+				NodeIdxMap[mapidx] = freqidx;
+				if (mapidx < TYPE08_NODE_COUNT)
+				{
+					NodeIdxMap[mapidx + 1] = freqidx;
+				}
+
+				freqidx = nextidx;
+			}
+			// Recurse up the tree
+			freqidx = NodeIdxMap[freqidx];
+		} while (freqidx != 0);
+
+		// Get the value from the node. If it's less than 256, it's a direct pixel value.
+		const uint16_t codeword = node - TYPE08_NODE_COUNT;
+		if (codeword < 256)
+		{
+			*dst++ = static_cast<uint8_t>(codeword);
+		}
+		else
+		{
+			// Otherwise, get the next 8 bits from input to construct the
+			// offset to previous pixels to repeat, with the count being
+			// derived from the node's value.
+			const uint8_t tableidx = static_cast<uint8_t>(reader.read(8));
+			const int offsetHigh = Type08HighOffsetBits[tableidx] << 6;
+			const int bitcount = Type08LowOffsetBitCount[tableidx] - 2;
+			const int offsetLow = (tableidx << bitcount) | reader.read(bitcount);
+
+			const int distance = (offsetHigh | (offsetLow & 0x003F)) + 1;
+			const int tocopy = codeword - 256 + 3;
+			if ((outEnd - dst) < tocopy)
+			{
+				throw DebugException("Decoded image overflow.");
+			}
+
+			copyBackReference(outBegin, dst, distance, tocopy);
+			dst += tocopy;
 		}
 	}
 }
@@ -725,8 +725,11 @@ int ExeData::get(const std::string &section, const std::string &key,
 	const std::string &valueStr = keyValueMap.getString(section, key);
 
 	// Make sure the value only has an offset and isn't an offset + length pair.
-	DebugAssertMsg(valueStr.find(ExeData::PAIR_SEPARATOR) == std::string::npos,
-		"\"" + key + "\" (section \"" + section + "\") should only have an offset.");
+	if (valueStr.find(ExeData::PAIR_SEPARATOR) != std::string::npos)
+	{
+		throw DebugException("\"" + key + "\" (section \"" + section +
+			"\") should only have an offset.");
+	}
 
 	int offset;
 
@@ -743,8 +746,11 @@ std::pair<int, int> ExeData::getPair(const std::string &section, const std::stri
 
 	// Make sure the value has a comma-separated offset + length pair.
 	const std::vector<std::string> tokens = String::split(valueStr, ExeData::PAIR_SEPARATOR);
-	DebugAssertMsg(tokens.size() == 2, "\"" + key + "\" (section \"" + section +
-		"\") should have an offset and length.");
+	if (tokens.size() != 2)
+	{
+		throw DebugException("\"" + key + "\" (section \"" + section +
+			"\") should have an offset and length.");
+	}
 
 	const std::string &offsetStr = tokens.front();
 	const std::string &lengthStr = tokens.at(1);
@@ -804,10 +810,10 @@ bool ExeData::isFloppyVersion() const
 
 void ExeData::init(bool floppyVersion)
 {
-	// Load executable.
+	// Load executable. The decompressed image is cached between runs.
 	const std::string &exeFilename = floppyVersion ?
 		ExeData::FLOPPY_VERSION_EXE_FILENAME : ExeData::CD_VERSION_EXE_FILENAME;
-	const ExeUnpacker exe(exeFilename);
+	const ExeUnpacker exe(exeFilename, Platform::getCachePath());
 	const char *exeDataPtr = reinterpret_cast<const char*>(exe.getData().data());
 
 	// Load key-value map file.
@@ -1,7 +1,7 @@
-#include <algorithm>
 #include <array>
-#include <cassert>
-#include <memory>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 
 #include "ExeUnpacker.h"
 #include "../Utilities/Bytes.h"
@@ -12,129 +12,6 @@
 
 namespace
 {
-	// Performance optimization for bit reading (replaces the unnecessary heap 
-	// allocation of std::vector<bool>). Use BitVector::bitsUsed instead of 
-	// BitVector::bits.size().
-	struct BitVector
-	{
-		std::array<bool, 9> bits;
-		int bitsUsed;
-
-		BitVector()
-		{
-			this->bits.fill(false);
-			this->bitsUsed = 0;
-		}
-	};
-
-	// A simple binary tree for retrieving a decoded value, given a vector of bits.
-	class BitTree
-	{
-	private:
-		struct Node
-		{
-			// Only leaves will have non-null values.
-			std::unique_ptr<int> value;
-			std::unique_ptr<Node> left;
-			std::unique_ptr<Node> right;
-
-			bool isLeaf() const
-			{
-				return (this->left.get() == nullptr) && (this->right.get() == nullptr);
-			}
-		};
-
-		BitTree::Node root;
-	public:
-		// Inserts a node into the tree, overwriting any existing entry.
-		void insert(const std::vector<bool> &bits, int value)
-		{
-			BitTree::Node *node = &this->root;
-
-			// Walk the tree, creating new nodes as necessary. Internal nodes have null values.
-			for (size_t i = 0; i < bits.size(); i++)
-			{
-				const bool bit = bits.at(i);
-
-				// Decide which branch to use.
-				if (bit)
-				{
-					// Right.
-					if (node->right.get() == nullptr)
-					{
-						// Make a new node.
-						node->right = std::make_unique<BitTree::Node>();
-					}
-
-					node = node->right.get();
-				}
-				else
-				{
-					// Left.
-					if (node->left.get() == nullptr)
-					{
-						// Make a new node.
-						node->left = std::make_unique<BitTree::Node>();
-					}
-
-					node = node->left.get();
-				}
-				
-				// Set the node's value if it's the desired leaf.
-				if (i == (bits.size() - 1))
-				{
-					node->value = std::make_unique<int>(value);
-				}
-			}
-		}
-
-		// Returns a pointer to a decoded value in the tree, or null if no entry exists.
-		const int *get(const BitVector &bitVector)
-		{
-			const int *value = nullptr;
-			const BitTree::Node *left = this->root.left.get();
-			const BitTree::Node *right = this->root.right.get();
-
-			// Walk the tree.
-			for (int i = 0; i < bitVector.bitsUsed; i++)
-			{
-				const bool bit = bitVector.bits.at(i);
-
-				// Decide which branch to use.
-				if (bit)
-				{
-					// Right.
-					assert(right != nullptr);
-
-					// Check if it's a leaf.
-					if (right->isLeaf())
-					{
-						value = right->value.get();
-					}
-
-					left = right->left.get();
-					right = right->right.get();
-				}
-				else
-				{
-					// Left.
-					assert(left != nullptr);
-
-					// Check if it's a leaf.
-					if (left->isLeaf())
-					{
-						value = left->value.get();
-					}
-
-					right = left->right.get();
-					left = left->left.get();
-				}
-			}
-
-			return value;
-		}
-	};
-
 	// Bit table from pklite_specification.md, section 4.3.1 "Number of bytes".
 	// The decoded value for a given vector is (index + 2) before index 11, and
 	// (index + 1) after index 11.
@@ -203,47 +80,296 @@ namespace
 		{ false, true, true, true, true, true, false }, // 30
 		{ false, true, true, true, true, true, true } // 31
 	};
+
+	// Offset of the compressed data in the executable, and size of the trailer after it.
+	const size_t CompressedOffset = 752;
+	const size_t TrailerSize = 8;
+
+	// Number of bits peeked per lookup; the longest code in each bit table.
+	const int CountBitCount = 9;
+	const int OffsetBitCount = 7;
+
+	// Placeholder copy count for the Duplication1 special case, whose count is read from
+	// the next compressed byte instead.
+	const uint8_t SpecialCaseCount = 0;
+
+	// Flat lookup table for one of the bit tables. It's indexed by the next N bits of the
+	// stream (the first bit in the lowest position), so a code of length L fills every
+	// entry that starts with it, and one lookup decodes a whole code.
+	template <int N>
+	class DecodeTable
+	{
+	public:
+		struct Entry
+		{
+			uint8_t value;
+			uint8_t bitCount; // Zero if no code matches.
+		};
+	private:
+		std::array<Entry, 1 << N> entries;
+	public:
+		DecodeTable()
+		{
+			this->entries.fill(Entry { 0, 0 });
+		}
+
+		void insert(const std::vector<bool> &bits, uint8_t value)
+		{
+			const int bitCount = static_cast<int>(bits.size());
+			int code = 0;
+			for (int i = 0; i < bitCount; i++)
+			{
+				code |= bits[i] ? (1 << i) : 0;
+			}
+
+			for (int suffix = 0; suffix < (1 << (N - bitCount)); suffix++)
+			{
+				Entry &entry = this->entries[code | (suffix << bitCount)];
+				entry.value = value;
+				entry.bitCount = static_cast<uint8_t>(bitCount);
+			}
+		}
+
+		const Entry &get(uint32_t index) const
+		{
+			return this->entries[index];
+		}
+	};
+
+	struct DecodeTables
+	{
+		DecodeTable<CountBitCount> counts;
+		DecodeTable<OffsetBitCount> offsets;
+
+		DecodeTables()
+		{
+			// The Duplication1 table has a special case at index 11.
+			for (int i = 0; i < static_cast<int>(Duplication1.size()); i++)
+			{
+				const int value = (i < 11) ? (i + 2) : ((i == 11) ? SpecialCaseCount : (i + 1));
+				this->counts.insert(Duplication1[i], static_cast<uint8_t>(value));
+			}
+
+			for (int i = 0; i < static_cast<int>(Duplication2.size()); i++)
+			{
+				this->offsets.insert(Duplication2[i], static_cast<uint8_t>(i));
+			}
+		}
+	};
+
+	const DecodeTables &getDecodeTables()
+	{
+		static const DecodeTables tables;
+		return tables;
+	}
+
+	// Reads the interleaved bit and byte streams of the compressed data. Bits come from
+	// 16-bit little endian words, lowest bit first. The next word is taken from the byte
+	// stream as soon as the last bit of the current one is used, so any bytes read after
+	// that come after the new word.
+	class BitReader
+	{
+	private:
+		const uint8_t *src;
+		const uint8_t *srcEnd;
+		uint32_t word;
+		int bitsRead; // Number of bits used in the current word.
+
+		uint32_t readWord()
+		{
+			if ((this->srcEnd - this->src) < 2)
+			{
+				throw DebugException("Unexpected end of compressed data.");
+			}
+
+			const uint32_t value = this->src[0] | (this->src[1] << 8);
+			this->src += 2;
+			return value;
+		}
+	public:
+		BitReader(const uint8_t *src, const uint8_t *srcEnd)
+			: src(src), srcEnd(srcEnd)
+		{
+			this->word = this->readWord();
+			this->bitsRead = 0;
+		}
+
+		int getBitsRead() const
+		{
+			return this->bitsRead;
+		}
+
+		// Gets the next 'count' bits (at most 16) without using them. If they run into the
+		// next word, it's looked at without being taken from the byte stream yet.
+		uint32_t peek(int count) const
+		{
+			uint32_t bits = this->word >> this->bitsRead;
+			const int available = 16 - this->bitsRead;
+			if ((available < count) && ((this->srcEnd - this->src) >= 2))
+			{
+				bits |= static_cast<uint32_t>(this->src[0] | (this->src[1] << 8)) << available;
+			}
+
+			return bits & ((1u << count) - 1);
+		}
+
+		void skip(int count)
+		{
+			this->bitsRead += count;
+			if (this->bitsRead >= 16)
+			{
+				this->bitsRead -= 16;
+				this->word = this->readWord();
+			}
+		}
+
+		bool readBit()
+		{
+			const bool bit = ((this->word >> this->bitsRead) & 1) != 0;
+			this->skip(1);
+			return bit;
+		}
+
+		uint8_t readByte()
+		{
+			if (this->src == this->srcEnd)
+			{
+				throw DebugException("Unexpected end of compressed data.");
+			}
+
+			const uint8_t byte = *this->src;
+			this->src++;
+			return byte;
+		}
+	};
+
+	// Header of a cached decompressed image. The image follows it.
+	struct CacheHeader
+	{
+		char tag[8];
+		uint64_t exeHash; // Hash of the compressed executable.
+		uint64_t dataSize;
+		uint64_t dataHash; // Hash of the decompressed image, to catch damaged files.
+	};
+
+	const char CacheTag[8] = { 'P', 'K', 'L', 'C', 'A', 'C', 'H', '1' };
 }
 
 ExeUnpacker::ExeUnpacker(const std::string &filename)
+	: ExeUnpacker(filename, std::string()) { }
+
+ExeUnpacker::ExeUnpacker(const std::string &filename, const std::string &cachePath)
 {
-	VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
+	const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+	if (!srcData.isValid())
+	{
+		throw DebugException("Could not open \"" + filename + "\".");
+	}
 
-	stream->seekg(0, std::ios::end);
-	std::vector<uint8_t> srcData(stream->tellg());
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+	if (cachePath.empty())
+	{
+		ExeUnpacker::unpack(srcData.data(), srcData.size(), this->exeData);
+		return;
+	}
 
-	// Generate the bit trees for "duplication mode". Since the Duplication1 table has 
-	// a special case at index 11, split the insertions up for the first bit tree.
-	BitTree bitTree1, bitTree2;
+	// Cached images are keyed by the executable's hash, so a different or patched copy of
+	// the game is never given a stale image.
+	const uint64_t exeHash = ExeUnpacker::getHash(srcData.data(), srcData.size());
+	const std::string cacheFilename = cachePath + String::replace(filename, '/', '_') + ".unpacked";
+	if (!this->tryReadCache(cacheFilename, exeHash))
+	{
+		ExeUnpacker::unpack(srcData.data(), srcData.size(), this->exeData);
+		this->writeCache(cacheFilename, exeHash);
+	}
+}
 
-	for (int i = 0; i < 11; i++)
+uint64_t ExeUnpacker::getHash(const uint8_t *data, size_t size)
+{
+	uint64_t hash = 0xCBF29CE484222325;
+	for (size_t i = 0; i < size; i++)
 	{
-		bitTree1.insert(Duplication1.at(i), i + 2);
+		hash = (hash ^ data[i]) * 0x100000001B3;
 	}
 
-	bitTree1.insert(Duplication1.at(11), 13);
+	return hash;
+}
 
-	for (int i = 12; i < Duplication1.size(); i++)
+bool ExeUnpacker::tryReadCache(const std::string &cacheFilename, uint64_t exeHash)
+{
+	std::ifstream ifs(cacheFilename, std::ios::binary);
+	if (!ifs.is_open())
 	{
-		bitTree1.insert(Duplication1.at(i), i + 1);
+		return false;
 	}
 
-	for (int i = 0; i < Duplication2.size(); i++)
+	CacheHeader header;
+	ifs.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!ifs.good() || (std::memcmp(header.tag, CacheTag, sizeof(CacheTag)) != 0) ||
+		(header.exeHash != exeHash) || (header.dataSize > (16 * 1024 * 1024)))
 	{
-		bitTree2.insert(Duplication2.at(i), i);
+		return false;
+	}
+
+	std::vector<uint8_t> data(static_cast<size_t>(header.dataSize));
+	ifs.read(reinterpret_cast<char*>(data.data()), data.size());
+	if (!ifs.good() || (ExeUnpacker::getHash(data.data(), data.size()) != header.dataHash))
+	{
+		DebugWarning("Ignoring damaged cache file \"" + cacheFilename + "\".");
+		return false;
+	}
+
+	this->exeData = std::move(data);
+	return true;
+}
+
+void ExeUnpacker::writeCache(const std::string &cacheFilename, uint64_t exeHash) const
+{
+	CacheHeader header;
+	std::memcpy(header.tag, CacheTag, sizeof(CacheTag));
+	header.exeHash = exeHash;
+	header.dataSize = this->exeData.size();
+	header.dataHash = ExeUnpacker::getHash(this->exeData.data(), this->exeData.size());
+
+	// Write to a temporary file and then move it into place, so an interrupted write never
+	// leaves a partial image under the real name.
+	const std::string tempFilename = cacheFilename + ".tmp";
+	bool success;
+
+	{
+		std::ofstream ofs(tempFilename, std::ios::binary | std::ios::trunc);
+		ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		ofs.write(reinterpret_cast<const char*>(this->exeData.data()), this->exeData.size());
+		ofs.close();
+		success = !ofs.fail();
+	}
+
+	// std::rename() doesn't replace existing files on Windows.
+	std::remove(cacheFilename.c_str());
+	if (!success || (std::rename(tempFilename.c_str(), cacheFilename.c_str()) != 0))
+	{
+		DebugWarning("Could not write cache file \"" + cacheFilename + "\".");
+		std::remove(tempFilename.c_str());
+	}
+}
+
+void ExeUnpacker::unpack(const uint8_t *srcData, size_t srcSize, std::vector<uint8_t> &dstData)
+{
+	if (srcSize < (CompressedOffset + TrailerSize + 2))
+	{
+		throw DebugException("Executable too small (" + std::to_string(srcSize) + " bytes).");
 	}
 
 	// Beginning and end of compressed data in the executable.
-	const uint8_t *compressedStart = srcData.data() + 752;
-	const uint8_t *compressedEnd = srcData.data() + (srcData.size() - 8);
+	const uint8_t *compressedStart = srcData + CompressedOffset;
+	const uint8_t *compressedEnd = srcData + (srcSize - TrailerSize);
 
 	// Last word of compressed data must be 0xFFFF.
 	const uint16_t lastCompWord = Bytes::getLE16(compressedEnd - 2);
-	DebugAssertMsg(lastCompWord == 0xFFFF, "Invalid last compressed word \"" +
-		String::toHexString(lastCompWord) + "\".");
+	if (lastCompWord != 0xFFFF)
+	{
+		throw DebugException("Invalid last compressed word \"" +
+			String::toHexString(lastCompWord) + "\".");
+	}
 
 	// Calculate length of decompressed data -- more precise method (for A.EXE).
 	const size_t decompLen = [compressedEnd]()
@@ -254,101 +380,30 @@ ExeUnpacker::ExeUnpacker(const std::string &filename)
 	}();
 
 	// Buffer for the decompressed data (also little endian).
-	this->exeData = std::vector<uint8_t>(decompLen, 0);
-
-	// Current position for inserting decompressed data.
-	size_t decompIndex = 0;
+	dstData.assign(decompLen, 0);
+	uint8_t *dstBegin = dstData.data();
+	uint8_t *dst = dstBegin;
+	uint8_t *dstEnd = dstBegin + dstData.size();
 
-	// A 16-bit array of compressed data.
-	uint16_t bitArray = Bytes::getLE16(compressedStart);
+	// The byte stream may run into the trailer, like the original decompressor's.
+	BitReader reader(compressedStart, srcData + srcSize);
+	const DecodeTables &tables = getDecodeTables();
 
-	// Offset from start of compressed data (start at 2 because of the bit array).
-	int byteIndex = 2;
-
-	// Number of bits consumed in the current 16-bit array.
-	int bitsRead = 0;
-
-	// Continually read bit arrays from the compressed data and interpret each bit. 
-	// Break once a compressed byte equals 0xFF in duplication mode.
+	// Interpret each mode bit until a compressed byte equals 0xFF in duplication mode.
 	while (true)
 	{
-		// Lambda for getting the next byte from compressed data.
-		auto getNextByte = [compressedStart, &byteIndex]()
-		{
-			const uint8_t byte = compressedStart[byteIndex];
-			byteIndex++;
-
-			return byte;
-		};
-
-		// Lambda for getting the next bit in the theoretical bit stream.
-		auto getNextBit = [&bitArray, &bitsRead, &getNextByte]()
-		{
-			const bool bit = (bitArray & (1 << bitsRead)) != 0;
-			bitsRead++;
-
-			// Advance the bit array if done with the current one.
-			if (bitsRead == 16)
-			{
-				bitsRead = 0;
-
-				// Get two bytes in little endian format.
-				const uint8_t byte1 = getNextByte();
-				const uint8_t byte2 = getNextByte();
-				bitArray = byte1 | (byte2 << 8);
-			}
-
-			return bit;
-		};
-
-		// Decide which mode to use for the current bit.
-		if (getNextBit())
+		if (reader.readBit())
 		{
 			// "Duplication" mode.
 			// Calculate which bytes in the decompressed data to duplicate and append.
-			BitVector copyBits;
-			const int *copyPtr = nullptr;
-
-			// Read bits until they match a bit tree leaf.
-			while (copyPtr == nullptr)
-			{
-				copyBits.bits.at(copyBits.bitsUsed) = getNextBit();
-				copyBits.bitsUsed++;
-				copyPtr = bitTree1.get(copyBits);
-			}
-
-			// Calculate the number of bytes in the decompressed data to copy.
-			uint16_t copyCount = 0;
-
-			// Lambda for comparing a bit vector's equality with the special case.
-			auto matchesSpecialCase = [](const BitVector &bitVector)
-			{
-				const std::vector<bool> &specialCase = Duplication1.at(11);
-				const bool equalSize = bitVector.bitsUsed == specialCase.size();
-
-				if (!equalSize)
-				{
-					return false;
-				}
-				else
-				{
-					for (int i = 0; i < bitVector.bitsUsed; i++)
-					{
-						if (bitVector.bits.at(i) != specialCase.at(i))
-						{
-							return false;
-						}
-					}
-
-					return true;
-				}
-			};
+			const auto &countEntry = tables.counts.get(reader.peek(CountBitCount));
+			reader.skip(countEntry.bitCount);
 
-			// Check for the special bit vector case "011100".
-			if (matchesSpecialCase(copyBits))
+			int copyCount = countEntry.value;
+			if (copyCount == SpecialCaseCount)
 			{
-				// Read a compressed byte.
-				const uint8_t encryptedByte = getNextByte();
+				// Special bit vector case "011100"; the count is in the next byte.
+				const uint8_t encryptedByte = reader.readByte();
 
 				if (encryptedByte == 0xFE)
 				{
@@ -366,70 +421,50 @@ ExeUnpacker::ExeUnpacker(const std::string &filename)
 					copyCount = encryptedByte + 25;
 				}
 			}
-			else
-			{
-				// Use the decoded value from the first bit table.
-				copyCount = *copyPtr;
-			}
-
-			// Calculate the offset in decompressed data. It is a two byte value.
-			// The most significant byte is 0 by default.
-			uint8_t mostSigByte = 0;
 
-			// If the copy count is not 2, decode the most significant byte.
+			// The offset's most significant byte is 0 unless the copy count is not 2.
+			size_t offset = 0;
 			if (copyCount != 2)
 			{
-				BitVector offsetBits;
-				const int* offsetPtr = nullptr;
-
-				// Read bits until they match a bit tree leaf.
-				while (offsetPtr == nullptr)
-				{
-					offsetBits.bits.at(offsetBits.bitsUsed) = getNextBit();
-					offsetBits.bitsUsed++;
-					offsetPtr = bitTree2.get(offsetBits);
-				}
-
-				// Use the decoded value from the second bit table.
-				mostSigByte = *offsetPtr;
+				const auto &offsetEntry = tables.offsets.get(reader.peek(OffsetBitCount));
+				reader.skip(offsetEntry.bitCount);
+				offset = static_cast<size_t>(offsetEntry.value) << 8;
 			}
 
-			// Get the least significant byte of the two bytes.
-			const uint8_t leastSigByte = getNextByte();
+			offset |= reader.readByte();
 
-			// Combine the two bytes.
-			const uint16_t offset = leastSigByte | (mostSigByte << 8);
+			// Finally, duplicate the decompressed data. The ranges may overlap, in which case
+			// the copy repeats the bytes just written.
+			if ((offset > static_cast<size_t>(dst - dstBegin)) || (copyCount > (dstEnd - dst)))
+			{
+				throw DebugException("Invalid duplication (offset " + std::to_string(offset) +
+					", count " + std::to_string(copyCount) + ").");
+			}
 
-			// Finally, duplicate the decompressed data using the calculated offset and size.
-			const size_t duplicateBegin = decompIndex - offset;
-			const size_t duplicateEnd = duplicateBegin + copyCount;
-			for (size_t i = duplicateBegin; i < duplicateEnd; i++, decompIndex++)
+			const uint8_t *copySrc = dst - offset;
+			for (int i = 0; i < copyCount; i++)
 			{
-				this->exeData.at(decompIndex) = this->exeData.at(i);
+				dst[i] = copySrc[i];
 			}
+
+			dst += copyCount;
 		}
 		else
 		{
 			// "Decryption" mode.
-			// Read the next byte from the compressed data.
-			const uint8_t encryptedByte = getNextByte();
+			// The byte is XORed with a key based on the current bit index. "bitsRead" is
+			// between 0 and 15. It is 0 if the 16th bit of the previous word was used to
+			// get here.
+			const uint8_t key = 16 - reader.getBitsRead();
+			const uint8_t encryptedByte = reader.readByte();
 
-			// Lambda for decrypting an encrypted byte with an XOR operation based on 
-			// the current bit index. "bitsRead" is between 0 and 15. It is 0 if the
-			// 16th bit of the previous array was used to get here.
-			auto decrypt = [](uint8_t encryptedByte, int bitsRead)
+			if (dst == dstEnd)
 			{
-				const uint8_t key = 16 - bitsRead;
-				const uint8_t decryptedByte = encryptedByte ^ key;
-				return decryptedByte;
-			};
-
-			// Decrypt the byte.
-			const uint8_t decryptedByte = decrypt(encryptedByte, bitsRead);
+				throw DebugException("Decompressed data overflow.");
+			}
 
-			// Append the decrypted byte onto the decompressed data.
-			this->exeData.at(decompIndex) = decryptedByte;
-			decompIndex++;
+			*dst = encryptedByte ^ key;
+			dst++;
 		}
 	}
 }
@@ -1,6 +1,7 @@
 #ifndef EXE_UNPACKER_H
 #define EXE_UNPACKER_H
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -11,10 +12,29 @@ class ExeUnpacker
 {
 private:
 	std::vector<uint8_t> exeData;
+
+	// Gets a 64-bit FNV-1a hash of the given bytes. Used to tell whether a cached image
+	// belongs to the executable being loaded.
+	static uint64_t getHash(const uint8_t *data, size_t size);
+
+	// Reads a decompressed image from the cache file. Returns false if the file is missing
+	// or doesn't match the given executable hash.
+	bool tryReadCache(const std::string &cacheFilename, uint64_t exeHash);
+
+	// Writes the decompressed image to the cache file. Failing to write is not an error.
+	void writeCache(const std::string &cacheFilename, uint64_t exeHash) const;
 public:
 	// Reads in a compressed EXE file and decompresses it.
 	ExeUnpacker(const std::string &filename);
 
+	// Same as above, but first looks in the given cache folder for an image unpacked on an
+	// earlier run from the same executable, and stores the image there if there isn't one.
+	// An empty path disables the cache.
+	ExeUnpacker(const std::string &filename, const std::string &cachePath);
+
+	// Decompresses a PKLITE-compressed executable image in memory.
+	static void unpack(const uint8_t *srcData, size_t srcSize, std::vector<uint8_t> &dstData);
+
 	// Gets the decompressed executable data.
 	const std::vector<uint8_t> &getData() const;
 };
@@ -0,0 +1,68 @@
+#ifndef FLC_DECODER_H
+#define FLC_DECODER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Media/Palette.h"
+
+#include "components/vfs/manager.hpp"
+
+// Incremental FLC/CEL decoder. Only the running frame and palette are kept, and each
+// call to readFrame() applies the next image chunk to them, so a movie can be played
+// without decoding all of its frames up front. See FLCFile for the format notes.
+
+class FLCDecoder
+{
+private:
+	VFS::DataView srcData;
+	std::vector<uint8_t> framePixels; // Palette indices of the current frame.
+	Palette palette; // Palette of the current frame.
+	double frameDuration;
+	int width;
+	int height;
+	int frameCount;
+	int frameIndex; // Index of the current frame, or -1 before the first frame.
+	uint32_t frameOffset; // Offset of the frame header being read.
+	int chunkIndex; // Next chunk to read in that frame.
+	uint32_t chunkOffset; // Offset of that chunk from the frame header.
+
+	// Reads a palette chunk into the current palette.
+	void readPalette(const uint8_t *chunkData);
+
+	// Decodes a fullscreen FLC chunk, replacing the whole current frame.
+	void decodeFullFrame(const uint8_t *chunkData, int chunkSize);
+
+	// Decodes a delta FLC chunk by partially updating the current frame.
+	void decodeDeltaFrame(const uint8_t *chunkData, int chunkSize);
+public:
+	FLCDecoder(const std::string &filename);
+
+	// Gets the number of frames. The looping frame at the end is not counted.
+	int getFrameCount() const;
+
+	// Gets the duration of each frame in seconds.
+	double getFrameDuration() const;
+
+	// Gets the width of each frame.
+	int getWidth() const;
+
+	// Gets the height of each frame.
+	int getHeight() const;
+
+	// Gets the index of the most recently read frame, or -1 if none has been read.
+	int getFrameIndex() const;
+
+	// Gets the palette of the most recently read frame.
+	const Palette &getPalette() const;
+
+	// Gets the palette indices of the most recently read frame.
+	const uint8_t *getPixels() const;
+
+	// Decodes the next frame. Returns false once all frames have been read, and throws if
+	// the frame's data is malformed.
+	bool readFrame();
+};
+
+#endif
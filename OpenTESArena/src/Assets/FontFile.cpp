@@ -27,13 +27,8 @@ namespace
 
 FontFile::FontFile(const std::string &filename)
 {
-	VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
-
-	stream->seekg(0, std::ios::end);
-	std::vector<uint8_t> srcData(stream->tellg());
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+	const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+	DebugAssertMsg(srcData.isValid(), "Could not open \"" + filename + "\".");
 
 	// The character height is in the first byte.
 	const uint8_t charHeight = srcData.front();
@@ -149,13 +149,11 @@ INFFile::INFFile(const std::string &filename)
 	// Some filenames (i.e., Crystal3.inf) have different casing between the floppy version and
 	// CD version, so this needs to use the case-insensitive open() method for correct behavior
 	// on Unix-based systems.
-	VFS::IStreamPtr stream = VFS::Manager::get().openCaseInsensitive(filename, inGlobalBSA);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
+	const VFS::DataView srcView = VFS::Manager::get().openViewCaseInsensitive(filename, inGlobalBSA);
+	DebugAssertMsg(srcView.isValid(), "Could not open \"" + filename + "\".");
 
-	stream->seekg(0, std::ios::end);
-	std::vector<uint8_t> srcData(stream->tellg());
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+	// Copied since it may be decrypted in place.
+	std::vector<uint8_t> srcData(srcView.begin(), srcView.end());
 
 	// Check if the .INF is encrypted.
 	const bool isEncrypted = inGlobalBSA;
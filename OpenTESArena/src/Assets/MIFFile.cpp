@@ -55,13 +55,8 @@ const uint8_t MIFFile::LAVA_CHASM = 0xE;
 
 MIFFile::MIFFile(const std::string &filename)
 {
-	VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
-
-	stream->seekg(0, std::ios::end);
-	std::vector<uint8_t> srcData(stream->tellg());
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+	const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+	DebugAssertMsg(srcData.isValid(), "Could not open \"" + filename + "\".");
 
 	const uint16_t headerSize = Bytes::getLE16(srcData.data() + 4);
 
@@ -89,7 +84,7 @@ MIFFile::MIFFile(const std::string &filename)
 	int levelOffset = headerSize + 6;
 
 	// The level count is unused since it's inferred by this level loading loop.
-	while (levelOffset < srcData.size())
+	while (levelOffset < static_cast<int>(srcData.size()))
 	{
 		MIFFile::Level level;
 
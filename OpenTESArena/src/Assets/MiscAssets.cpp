@@ -1,6 +1,8 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <chrono>
+#include <functional>
 #include <numeric>
 #include <sstream>
 
@@ -13,6 +15,7 @@
 #include "../Utilities/Debug.h"
 #include "../Utilities/Platform.h"
 #include "../Utilities/String.h"
+#include "../Utilities/ThreadPool.h"
 #include "../World/ClimateType.h"
 #include "../World/Location.h"
 #include "../World/LocationType.h"
@@ -291,14 +294,14 @@ void MiscAssets::TemplateDat::init()
 {
 	const std::string filename = "TEMPLATE.DAT";
 
-	VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
+	const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+	if (!srcData.isValid())
+	{
+		throw DebugException("Could not open \"" + filename + "\".");
+	}
 
 	// Read TEMPLATE.DAT into a string.
-	stream->seekg(0, std::ios::end);
-	std::string srcText(stream->tellg(), '\0');
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(&srcText.front()), srcText.size());
+	const std::string srcText(reinterpret_cast<const char*>(srcData.data()), srcData.size());
 
 	// Step line by line through the text, inserting keys and values into the proper lists.
 	std::istringstream iss(srcText);
@@ -614,61 +617,252 @@ void MiscAssets::WorldMapTerrain::init()
 {
 	const std::string filename("TERRAIN.IMG");
 
-	VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
+	const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+	if (!srcData.isValid())
+	{
+		throw DebugException("Could not open \"" + filename + "\".");
+	}
 
 	// Skip the .IMG header.
-	stream->seekg(12);
-	stream->read(reinterpret_cast<char*>(this->indices.data()), this->indices.size());
+	const size_t headerSize = 12;
+	if (srcData.size() < (headerSize + this->indices.size()))
+	{
+		throw DebugException("\"" + filename + "\" is too small.");
+	}
+	std::copy(srcData.begin() + headerSize, srcData.begin() + headerSize + this->indices.size(),
+		this->indices.begin());
 }
 
 MiscAssets::MiscAssets()
 {
 	// Initialized by init().
+	for (std::atomic<bool> &done : this->initTasksDone)
+	{
+		done = false;
+	}
+
+	this->initTaskSeconds.fill(0.0);
+	this->initTimingsLogged = false;
+}
+
+MiscAssets::~MiscAssets()
+{
+	if (this->initThread.joinable())
+	{
+		this->initThread.join();
+	}
 }
 
 void MiscAssets::init(bool floppyVersion)
 {
 	DebugMention("Initializing.");
 
-	// Load the executable data.
-	this->parseExecutableData(floppyVersion);
+	// Load everything in the background, but wait for the executable data since the main
+	// menu and the intro need it right away.
+	this->initThread = std::thread([this, floppyVersion]()
+	{
+		this->runInitTasks(floppyVersion);
+	});
+
+	this->waitForInitTask(InitTask::ExeData);
+}
+
+void MiscAssets::initTravelData(
+	const std::array<std::array<uint8_t, 12>, 7> &climateSpeedTables,
+	const std::array<std::array<uint8_t, 8>, 7> &weatherSpeedTables)
+{
+	this->exeData.locations.climateSpeedTables = climateSpeedTables;
+	this->exeData.locations.weatherSpeedTables = weatherSpeedTables;
+	this->cityDataFile.init("CITYDATA.00");
+	this->worldMapTerrain.init();
+
+	// Mark their steps done so the getters don't wait on them. Getters for anything else
+	// would wait forever, since their steps never run.
+	this->initTasksDone[static_cast<int>(InitTask::ExeData)] = true;
+	this->initTasksDone[static_cast<int>(InitTask::CityData)] = true;
+	this->initTasksDone[static_cast<int>(InitTask::WorldMapTerrain)] = true;
+}
+
+void MiscAssets::runInitTasks(bool floppyVersion)
+{
+	struct Task
+	{
+		InitTask id;
+		std::vector<InitTask> dependencies;
+		std::function<void()> load;
+	};
+
+	// Dependencies must come before the steps that use them.
+	const std::vector<Task> tasks =
+	{
+		// Load the executable data. This is the longest step, so it goes first.
+		{ InitTask::ExeData, {}, [this, floppyVersion]() { this->parseExecutableData(floppyVersion); } },
 
-	// Read in TEMPLATE.DAT, using "#..." as keys and the text as values.
-	this->templateDat.init();
+		// Read in TEMPLATE.DAT, using "#..." as keys and the text as values.
+		{ InitTask::TemplateDat, {}, [this]() { this->templateDat.init(); } },
 
-	// Read in QUESTION.TXT and create character question objects.
-	this->parseQuestionTxt();
+		// Read in QUESTION.TXT and create character question objects.
+		{ InitTask::QuestionTxt, {}, [this]() { this->parseQuestionTxt(); } },
 
-	// Read in CLASSES.DAT.
-	this->parseClasses(this->getExeData());
+		// Read in CLASSES.DAT.
+		{ InitTask::Classes, { InitTask::ExeData }, [this]() { this->parseClasses(this->exeData); } },
 
-	// Read in DUNGEON.TXT and pair each dungeon name with its description.
-	this->parseDungeonTxt();
+		// Read in DUNGEON.TXT and pair each dungeon name with its description.
+		{ InitTask::DungeonTxt, {}, [this]() { this->parseDungeonTxt(); } },
 
-	// Read in ARTFACT1.DAT and ARTFACT2.DAT.
-	this->parseArtifactText();
+		// Read in ARTFACT1.DAT and ARTFACT2.DAT.
+		{ InitTask::ArtifactText, {}, [this]() { this->parseArtifactText(); } },
 
-	// Read in EQUIP.DAT, MUGUILD.DAT, SELLING.DAT, and TAVERN.DAT.
-	this->parseTradeText();
+		// Read in EQUIP.DAT, MUGUILD.DAT, SELLING.DAT, and TAVERN.DAT.
+		{ InitTask::TradeText, {}, [this]() { this->parseTradeText(); } },
 
-	// Read in NAMECHNK.DAT.
-	this->parseNameChunks();
+		// Read in NAMECHNK.DAT.
+		{ InitTask::NameChunks, {}, [this]() { this->parseNameChunks(); } },
 
-	// Read in SPELLSG.65.
-	this->parseStandardSpells();
+		// Read in SPELLSG.65.
+		{ InitTask::StandardSpells, {}, [this]() { this->parseStandardSpells(); } },
 
-	// Read in SPELLMKR.TXT.
-	this->parseSpellMakerDescriptions();
+		// Read in SPELLMKR.TXT.
+		{ InitTask::SpellMakerDescriptions, {}, [this]() { this->parseSpellMakerDescriptions(); } },
 
-	// Read city data file.
-	this->cityDataFile.init("CITYDATA.00");
+		// Read city data file.
+		{ InitTask::CityData, {}, [this]() { this->cityDataFile.init("CITYDATA.00"); } },
 
-	// Read in the world map mask data from TAMRIEL.MNU.
-	this->parseWorldMapMasks();
+		// Read in the world map mask data from TAMRIEL.MNU.
+		{ InitTask::WorldMapMasks, {}, [this]() { this->parseWorldMapMasks(); } },
 
-	// Read in the terrain map from TERRAIN.IMG.
-	this->worldMapTerrain.init();
+		// Read in the terrain map from TERRAIN.IMG.
+		{ InitTask::WorldMapTerrain, {}, [this]() { this->worldMapTerrain.init(); } }
+	};
+
+	// This runs on a background thread, so errors are thrown (crashing would exit from
+	// here) and handed to the game thread, which rethrows them from waitForInitTask() and
+	// updateInit().
+	try
+	{
+		// Sort the steps into waves, where each step only depends on steps in earlier waves.
+		std::vector<int> taskWaves(INIT_TASK_COUNT, -1);
+		int waveCount = 0;
+		for (const Task &task : tasks)
+		{
+			int wave = 0;
+			for (const InitTask dependency : task.dependencies)
+			{
+				const int dependencyWave = taskWaves.at(static_cast<int>(dependency));
+				if (dependencyWave < 0)
+				{
+					throw DebugException("Loading step dependencies must come first.");
+				}
+
+				wave = std::max(wave, dependencyWave + 1);
+			}
+
+			taskWaves.at(static_cast<int>(task.id)) = wave;
+			waveCount = std::max(waveCount, wave + 1);
+		}
+
+		ThreadPool threadPool;
+		threadPool.init(std::max(Platform::getThreadCount() - 1, 0));
+
+		for (int wave = 0; wave < waveCount; wave++)
+		{
+			std::vector<const Task*> waveTasks;
+			for (const Task &task : tasks)
+			{
+				if (taskWaves.at(static_cast<int>(task.id)) == wave)
+				{
+					waveTasks.push_back(&task);
+				}
+			}
+
+			threadPool.run(static_cast<int>(waveTasks.size()), [this, &waveTasks](int index)
+			{
+				const Task &task = *waveTasks[index];
+				const auto startTime = std::chrono::steady_clock::now();
+				task.load();
+
+				const int taskIndex = static_cast<int>(task.id);
+				this->initTaskSeconds[taskIndex] = std::chrono::duration<double>(
+					std::chrono::steady_clock::now() - startTime).count();
+
+				{
+					std::lock_guard<std::mutex> lock(this->initMutex);
+					this->initTasksDone[taskIndex] = true;
+				}
+
+				this->initCondition.notify_all();
+			});
+		}
+	}
+	catch (...)
+	{
+		{
+			std::lock_guard<std::mutex> lock(this->initMutex);
+			this->initException = std::current_exception();
+		}
+
+		this->initCondition.notify_all();
+	}
+}
+
+void MiscAssets::waitForInitTask(InitTask task) const
+{
+	const std::atomic<bool> &done = this->initTasksDone[static_cast<int>(task)];
+	if (done)
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(this->initMutex);
+	this->initCondition.wait(lock, [this, &done]()
+	{
+		return done || (this->initException != nullptr);
+	});
+
+	if (!done)
+	{
+		std::rethrow_exception(this->initException);
+	}
+}
+
+void MiscAssets::updateInit()
+{
+	if (this->initTimingsLogged)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(this->initMutex);
+		if (this->initException != nullptr)
+		{
+			std::rethrow_exception(this->initException);
+		}
+	}
+
+	const bool allDone = std::all_of(this->initTasksDone.begin(), this->initTasksDone.end(),
+		[](const std::atomic<bool> &done) { return done.load(); });
+
+	if (!allDone)
+	{
+		return;
+	}
+
+	const std::array<const char*, INIT_TASK_COUNT> taskNames =
+	{
+		"executable data", "TEMPLATE.DAT", "QUESTION.TXT", "CLASSES.DAT", "DUNGEON.TXT",
+		"artifact text", "trade text", "NAMECHNK.DAT", "SPELLSG.65", "SPELLMKR.TXT",
+		"CITYDATA.00", "TAMRIEL.MNU masks", "TERRAIN.IMG"
+	};
+
+	for (int i = 0; i < INIT_TASK_COUNT; i++)
+	{
+		const double milliseconds = this->initTaskSeconds[i] * 1000.0;
+		DebugMention("Loaded " + std::string(taskNames[i]) + " in " +
+			String::fixedPrecision(milliseconds, 2) + "ms.");
+	}
+
+	this->initTimingsLogged = true;
 }
 
 void MiscAssets::parseExecutableData(bool floppyVersion)
@@ -680,13 +874,11 @@ void MiscAssets::parseQuestionTxt()
 {
 	const std::string filename = "QUESTION.TXT";
 
-	VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
-
-	stream->seekg(0, std::ios::end);
-	std::vector<uint8_t> srcData(stream->tellg());
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+	const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+	if (!srcData.isValid())
+	{
+		throw DebugException("Could not open \"" + filename + "\".");
+	}
 
 	// Read QUESTION.TXT into a string.
 	const std::string text(reinterpret_cast<const char*>(srcData.data()), srcData.size());
@@ -802,13 +994,11 @@ void MiscAssets::parseClasses(const ExeData &exeData)
 {
 	const std::string filename = "CLASSES.DAT";
 
-	VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
-
-	stream->seekg(0, std::ios::end);
-	std::vector<uint8_t> srcData(stream->tellg());
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+	const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+	if (!srcData.isValid())
+	{
+		throw DebugException("Could not open \"" + filename + "\".");
+	}
 
 	// Character class generation members (to be set).
 	auto &classes = this->classesDat.classes;
@@ -1014,13 +1204,11 @@ void MiscAssets::parseDungeonTxt()
 {
 	const std::string filename = "DUNGEON.TXT";
 
-	VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
-
-	stream->seekg(0, std::ios::end);
-	std::vector<uint8_t> srcData(stream->tellg());
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+	const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+	if (!srcData.isValid())
+	{
+		throw DebugException("Could not open \"" + filename + "\".");
+	}
 
 	const std::string text(reinterpret_cast<const char*>(srcData.data()), srcData.size());
 
@@ -1077,13 +1265,11 @@ void MiscAssets::parseArtifactText()
 	auto loadArtifactText = [](const std::string &filename,
 		std::array<MiscAssets::ArtifactTavernText, 16> &artifactTavernText)
 	{
-		VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-		DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
-
-		stream->seekg(0, std::ios::end);
-		std::vector<uint8_t> srcData(stream->tellg());
-		stream->seekg(0, std::ios::beg);
-		stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+		const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+		if (!srcData.isValid())
+		{
+			throw DebugException("Could not open \"" + filename + "\".");
+		}
 
 		// Write the null-terminated strings to the output array.
 		const char *stringPtr = reinterpret_cast<const char*>(srcData.data());
@@ -1115,13 +1301,11 @@ void MiscAssets::parseTradeText()
 	auto loadTradeText = [](const std::string &filename,
 		MiscAssets::TradeText::FunctionArray &functionArr)
 	{
-		VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-		DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
-
-		stream->seekg(0, std::ios::end);
-		std::vector<uint8_t> srcData(stream->tellg());
-		stream->seekg(0, std::ios::beg);
-		stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+		const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+		if (!srcData.isValid())
+		{
+			throw DebugException("Could not open \"" + filename + "\".");
+		}
 
 		// Write the null-terminated strings to the output array.
 		const char *stringPtr = reinterpret_cast<const char*>(srcData.data());
@@ -1148,13 +1332,11 @@ void MiscAssets::parseNameChunks()
 {
 	const std::string filename("NAMECHNK.DAT");
 
-	VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
-
-	stream->seekg(0, std::ios::end);
-	std::vector<uint8_t> srcData(stream->tellg());
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+	const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+	if (!srcData.isValid())
+	{
+		throw DebugException("Could not open \"" + filename + "\".");
+	}
 
 	size_t offset = 0;
 	while (offset < srcData.size())
@@ -1185,13 +1367,11 @@ void MiscAssets::parseStandardSpells()
 	// case-insensitive open method so it works on case-sensitive systems (i.e., Unix).
 	const std::string filename = "SPELLSG.65";
 
-	VFS::IStreamPtr stream = VFS::Manager::get().openCaseInsensitive(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
-
-	stream->seekg(0, std::ios::end);
-	std::vector<uint8_t> srcData(stream->tellg());
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+	const VFS::DataView srcData = VFS::Manager::get().openViewCaseInsensitive(filename);
+	if (!srcData.isValid())
+	{
+		throw DebugException("Could not open \"" + filename + "\".");
+	}
 
 	ArenaTypes::SpellData::initArray(this->standardSpells, srcData.data());
 }
@@ -1200,13 +1380,11 @@ void MiscAssets::parseSpellMakerDescriptions()
 {
 	const std::string filename = "SPELLMKR.TXT";
 
-	VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
-
-	stream->seekg(0, std::ios::end);
-	std::vector<uint8_t> srcData(stream->tellg());
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+	const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+	if (!srcData.isValid())
+	{
+		throw DebugException("Could not open \"" + filename + "\".");
+	}
 
 	const std::string text(reinterpret_cast<const char*>(srcData.data()), srcData.size());
 
@@ -1266,13 +1444,11 @@ void MiscAssets::parseWorldMapMasks()
 {
 	const std::string filename = "TAMRIEL.MNU";
 
-	VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
-
-	stream->seekg(0, std::ios::end);
-	std::vector<uint8_t> srcData(stream->tellg());
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+	const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+	if (!srcData.isValid())
+	{
+		throw DebugException("Could not open \"" + filename + "\".");
+	}
 
 	// Beginning of the mask data.
 	const int startOffset = 0x87D5;
@@ -1323,41 +1499,49 @@ const ExeData &MiscAssets::getExeData() const
 
 const MiscAssets::TemplateDat &MiscAssets::getTemplateDat() const
 {
+	this->waitForInitTask(InitTask::TemplateDat);
 	return this->templateDat;
 }
 
 const std::vector<CharacterQuestion> &MiscAssets::getQuestionTxtQuestions() const
 {
+	this->waitForInitTask(InitTask::QuestionTxt);
 	return this->questionTxt;
 }
 
 const CharacterClassGeneration &MiscAssets::getClassGenData() const
 {
+	this->waitForInitTask(InitTask::Classes);
 	return this->classesDat;
 }
 
 const std::vector<CharacterClass> &MiscAssets::getClassDefinitions() const
 {
+	this->waitForInitTask(InitTask::Classes);
 	return this->classDefinitions;
 }
 
 const std::vector<std::pair<std::string, std::string>> &MiscAssets::getDungeonTxtDungeons() const
 {
+	this->waitForInitTask(InitTask::DungeonTxt);
 	return this->dungeonTxt;
 }
 
 const std::array<MiscAssets::ArtifactTavernText, 16> &MiscAssets::getArtifactTavernText1() const
 {
+	this->waitForInitTask(InitTask::ArtifactText);
 	return this->artifactTavernText1;
 }
 
 const std::array<MiscAssets::ArtifactTavernText, 16> &MiscAssets::getArtifactTavernText2() const
 {
+	this->waitForInitTask(InitTask::ArtifactText);
 	return this->artifactTavernText2;
 }
 
 const MiscAssets::TradeText &MiscAssets::getTradeText() const
 {
+	this->waitForInitTask(InitTask::TradeText);
 	return this->tradeText;
 }
 
@@ -1392,6 +1576,8 @@ const std::string &MiscAssets::getRulerTitle(int provinceID, LocationType locati
 
 std::string MiscAssets::generateNpcName(int raceID, bool isMale, ArenaRandom &random) const
 {
+	this->waitForInitTask(InitTask::NameChunks);
+
 	// Get the rules associated with the race and gender.
 	const auto &chunkRules = NameRules.at((raceID * 2) + (isMale ? 0 : 1));
 
@@ -1437,25 +1623,30 @@ std::string MiscAssets::generateNpcName(int raceID, bool isMale, ArenaRandom &ra
 
 const CityDataFile &MiscAssets::getCityDataFile() const
 {
+	this->waitForInitTask(InitTask::CityData);
 	return this->cityDataFile;
 }
 
 const ArenaTypes::Spellsg &MiscAssets::getStandardSpells() const
 {
+	this->waitForInitTask(InitTask::StandardSpells);
 	return this->standardSpells;
 }
 
 const std::array<std::string, 43> &MiscAssets::getSpellMakerDescriptions() const
 {
+	this->waitForInitTask(InitTask::SpellMakerDescriptions);
 	return this->spellMakerDescriptions;
 }
 
 const std::array<WorldMapMask, 10> &MiscAssets::getWorldMapMasks() const
 {
+	this->waitForInitTask(InitTask::WorldMapMasks);
 	return this->worldMapMasks;
 }
 
 const MiscAssets::WorldMapTerrain &MiscAssets::getWorldMapTerrain() const
 {
+	this->waitForInitTask(InitTask::WorldMapTerrain);
 	return this->worldMapTerrain;
 }
@@ -2,7 +2,12 @@
 #define MISC_ASSETS_H
 
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -116,6 +121,28 @@ public:
 		void init();
 	};
 private:
+	// Loading steps run by init(). Steps run in parallel where their dependencies allow, and
+	// only the executable data is waited on before init() returns. Getters for anything
+	// else wait for the step that loads it.
+	enum class InitTask
+	{
+		ExeData,
+		TemplateDat,
+		QuestionTxt,
+		Classes,
+		DungeonTxt,
+		ArtifactText,
+		TradeText,
+		NameChunks,
+		StandardSpells,
+		SpellMakerDescriptions,
+		CityData,
+		WorldMapMasks,
+		WorldMapTerrain
+	};
+
+	static const int INIT_TASK_COUNT = 13;
+
 	ExeData exeData; // Either floppy version or CD version (depends on ArenaPath).
 	TemplateDat templateDat;
 	std::vector<CharacterQuestion> questionTxt;
@@ -130,6 +157,19 @@ private:
 	std::array<std::string, 43> spellMakerDescriptions; // From SPELLMKR.TXT.
 	std::array<WorldMapMask, 10> worldMapMasks;
 	WorldMapTerrain worldMapTerrain;
+	std::array<std::atomic<bool>, INIT_TASK_COUNT> initTasksDone;
+	std::array<double, INIT_TASK_COUNT> initTaskSeconds;
+	mutable std::mutex initMutex;
+	mutable std::condition_variable initCondition;
+	std::thread initThread;
+	std::exception_ptr initException; // First error thrown by a loading step.
+	bool initTimingsLogged;
+
+	// Runs the loading steps on a worker pool, each after the steps it depends on.
+	void runInitTasks(bool floppyVersion);
+
+	// Blocks until the given loading step is done. Rethrows the error if loading failed.
+	void waitForInitTask(InitTask task) const;
 
 	// Loads the executable associated with the current Arena data path (either A.EXE
 	// for the floppy version or ACD.EXE for the CD version).
@@ -163,6 +203,7 @@ private:
 	void parseWorldMapMasks();
 public:
 	MiscAssets();
+	~MiscAssets();
 
 	// Gets the ExeData object. There may be slight differences between A.EXE and ACD.EXE,
 	// but only one will be available at a time for the lifetime of the program (dependent
@@ -214,6 +255,16 @@ public:
 	const WorldMapTerrain &getWorldMapTerrain() const;
 
 	void init(bool floppyVersion);
+
+	// Loads only what travel times need (CITYDATA.00 and TERRAIN.IMG), with the given speed
+	// tables standing in for the executable's. For checking travel without an executable.
+	void initTravelData(const std::array<std::array<uint8_t, 12>, 7> &climateSpeedTables,
+		const std::array<std::array<uint8_t, 8>, 7> &weatherSpeedTables);
+
+	// Logs how long each loading step took once they're all done, and rethrows any error
+	// from the background steps. Called once per frame by the main thread, since logging
+	// isn't thread-safe.
+	void updateInit();
 };
 
 #endif
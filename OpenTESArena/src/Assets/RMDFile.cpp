@@ -16,13 +16,8 @@ RMDFile::RMDFile(const std::string &filename)
 	: flor(RMDFile::ELEMENTS_PER_FLOOR), map1(RMDFile::ELEMENTS_PER_FLOOR),
 	map2(RMDFile::ELEMENTS_PER_FLOOR)
 {
-	VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
-
-	stream->seekg(0, std::ios::end);
-	std::vector<uint8_t> srcData(stream->tellg());
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+	const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+	DebugAssertMsg(srcData.isValid(), "Could not open \"" + filename + "\".");
 
 	// The first word is the uncompressed length. Some .RMD files (#001 - #004) have 0 for 
 	// this value. They are used for storing uncompressed quarters of cities when in the 
@@ -11,34 +11,29 @@ const int SETFile::CHUNK_SIZE = SETFile::CHUNK_WIDTH * SETFile::CHUNK_HEIGHT;
 
 SETFile::SETFile(const std::string &filename)
 {
-	VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
+	const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+	DebugAssertMsg(srcData.isValid(), "Could not open \"" + filename + "\".");
 
-	stream->seekg(0, std::ios::end);
-	std::vector<uint8_t> srcData(stream->tellg());
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
-
-	// There is one .SET file with a file size of 0x3FFF, so it is a special case.
+	// There is one .SET file with a file size of 0x3FFF, so it is a special case. It's
+	// treated as having a dummy byte on the end.
 	const bool isSpecialCase = filename == "TBS2.SET";
-
-	if (isSpecialCase)
-	{
-		// Add a dummy byte onto the end.
-		srcData.push_back(0);
-	}
+	const int srcSize = static_cast<int>(srcData.size());
+	const int paddedSize = srcSize + (isSpecialCase ? 1 : 0);
 
 	// Number of uncompressed chunks packed in the .SET.
-	const int chunkCount = static_cast<int>(srcData.size()) / SETFile::CHUNK_SIZE;
+	const int chunkCount = paddedSize / SETFile::CHUNK_SIZE;
 
-	// Create an image for each uncompressed chunk.
+	// Create an image for each uncompressed chunk. Chunks start zeroed, so a missing
+	// dummy byte stays zero.
 	for (int i = 0; i < chunkCount; i++)
 	{
 		this->pixels.push_back(std::make_unique<uint8_t[]>(SETFile::CHUNK_SIZE));
 
-		const uint8_t *srcPixels = srcData.data() + (SETFile::CHUNK_SIZE * i);
+		const int srcOffset = SETFile::CHUNK_SIZE * i;
+		const int copyCount = std::min(SETFile::CHUNK_SIZE, srcSize - srcOffset);
+		const uint8_t *srcPixels = srcData.data() + srcOffset;
 		uint8_t *dstPixels = this->pixels.back().get();
-		std::copy(srcPixels, srcPixels + SETFile::CHUNK_SIZE, dstPixels);
+		std::copy(srcPixels, srcPixels + copyCount, dstPixels);
 	}
 }
 
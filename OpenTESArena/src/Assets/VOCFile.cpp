@@ -24,13 +24,8 @@ enum class BlockType : uint8_t
 
 VOCFile::VOCFile(const std::string &filename)
 {
-	VFS::IStreamPtr stream = VFS::Manager::get().open(filename);
-	DebugAssertMsg(stream != nullptr, "Could not open \"" + filename + "\".");
-
-	stream->seekg(0, std::ios::end);
-	std::vector<uint8_t> srcData(stream->tellg());
-	stream->seekg(0, std::ios::beg);
-	stream->read(reinterpret_cast<char*>(srcData.data()), srcData.size());
+	const VFS::DataView srcData = VFS::Manager::get().openView(filename);
+	DebugAssertMsg(srcData.isValid(), "Could not open \"" + filename + "\".");
 
 	// Read part of the .VOC header. Bytes 0 to 18 contain "Creative Voice File",
 	// and byte 19 prevents the whole file from being printed by accident.
@@ -54,7 +49,7 @@ VOCFile::VOCFile(const std::string &filename)
 
 	// Read data blocks.
 	int offset = headerSize;
-	while (offset < srcData.size())
+	while (offset < static_cast<int>(srcData.size()))
 	{
 		const int blockHeaderSize = 4;
 
@@ -3,8 +3,11 @@
 #include "SDL.h"
 
 #include "Game.h"
+#include "../Media/TextureManager.h"
 #include "../Rendering/RenderParams.h"
+#include "../Rendering/RenderProfiler.h"
 #include "../Utilities/Debug.h"
+#include "../Utilities/String.h"
 
 #define CVAR_OPTIONS_BOOL(cvar_name, option_name, additional_lines) \
 addConsoleCommand(#cvar_name, [this](const std::string &str) \
@@ -158,6 +161,98 @@ ConsoleManager::ConsoleManager()
 
 	CVAR_OPTIONS_BOOL(r_bloom, Graphics_PostProcessingBloom, game->getRenderer().setRenderParam(RenderParams::Bloom, r_bloom == 1));
 
+	CVAR_OPTIONS_BOOL(r_indexed_color, Graphics_IndexedColor, game->getRenderer().setRenderParam(RenderParams::IndexedColor, r_indexed_color == 1));
+
+	// Selects a false color debug view: 0 = off, 1 = overdraw, 2 = ray steps.
+	addConsoleCommand("r_debug_view", [this](const std::string &str)
+	{
+		Game *game = (Game*)this->game;
+
+		const int debugView = [&str]()
+		{
+			try
+			{
+				return std::stoi(str);
+			}
+			catch (...)
+			{
+				return -1;
+			}
+		}();
+
+		if ((debugView < 0) || (debugView > 2))
+		{
+			putString("r_debug_view: 0 = off, 1 = overdraw, 2 = ray steps");
+			return;
+		}
+
+		auto &renderer = game->getRenderer();
+		renderer.setRenderParam(RenderParams::DebugOverdraw, debugView == 1);
+		renderer.setRenderParam(RenderParams::DebugRaySteps, debugView == 2);
+	});
+
+	// Dumps min/avg/p99 of recent game world render phases to the log.
+	addConsoleCommand("r_profile", [this](const std::string&)
+	{
+		Game *game = (Game*)this->game;
+		const RenderProfiler &renderProfiler = game->getRenderer().getRenderProfiler();
+
+		auto formatSummary = [](const RenderProfiler::Summary &summary)
+		{
+			return String::fixedPrecision(summary.min, 3) + " / " +
+				String::fixedPrecision(summary.avg, 3) + " / " +
+				String::fixedPrecision(summary.p99, 3);
+		};
+
+		DebugMention("Render profile over " + std::to_string(renderProfiler.getFrameCount()) +
+			" frames (min / avg / p99 ms):");
+
+		for (int i = 0; i < RenderProfiler::PHASE_COUNT; i++)
+		{
+			const RenderProfiler::Phase phase = static_cast<RenderProfiler::Phase>(i);
+			DebugMention(std::string(RenderProfiler::getPhaseName(phase)) + ": " +
+				formatSummary(renderProfiler.getPhaseSummary(phase)));
+		}
+
+		for (int i = 0; i < renderProfiler.getThreadCount(); i++)
+		{
+			DebugMention("Thread " + std::to_string(i) + " busy: " +
+				formatSummary(renderProfiler.getThreadBusySummary(i)));
+		}
+
+		putString("Render profile written to log.");
+	});
+
+	CVAR_OPTIONS_INT(r_texture_cache_size, Graphics_TextureCacheSize, game->getTextureManager().setCacheBudget(static_cast<size_t>(r_texture_cache_size) * 1024 * 1024));
+
+	// Prints how much of the texture cache is in use and how well it's doing.
+	addConsoleCommand("r_texture_cache", [this](const std::string&)
+	{
+		Game *game = (Game*)this->game;
+		const TextureManager::CacheStats stats = game->getTextureManager().getCacheStats();
+
+		auto formatMegabytes = [](size_t byteCount)
+		{
+			return String::fixedPrecision(static_cast<double>(byteCount) / (1024.0 * 1024.0), 1);
+		};
+
+		const std::string budget = (stats.byteBudget > 0) ?
+			(formatMegabytes(stats.byteBudget) + " MB") : "unlimited";
+		const uint64_t lookupCount = stats.hitCount + stats.missCount;
+		const double hitRate = (lookupCount > 0) ?
+			(100.0 * static_cast<double>(stats.hitCount) / static_cast<double>(lookupCount)) : 0.0;
+
+		putString("Resident: " + formatMegabytes(stats.byteCount) + " MB of " + budget +
+			" (" + formatMegabytes(stats.pinnedByteCount) + " MB pinned)");
+		putString("Entries: " + std::to_string(stats.surfaceCount) + " surfaces, " +
+			std::to_string(stats.textureCount) + " textures, " +
+			std::to_string(stats.surfaceSetCount) + " surface sets, " +
+			std::to_string(stats.textureSetCount) + " texture sets");
+		putString("Hits: " + std::to_string(stats.hitCount) + ", misses: " +
+			std::to_string(stats.missCount) + " (" + String::fixedPrecision(hitRate, 1) +
+			"% hit), evictions: " + std::to_string(stats.evictionCount));
+	});
+
 	// Audio cvars	
 	CVAR_OPTIONS_DOUBLE(a_music_volume, Audio_MusicVolume, game->getAudioManager().setMusicVolume(game->getOptions().getAudio_MusicVolume()));
 
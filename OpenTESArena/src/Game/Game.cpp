@@ -1,3 +1,4 @@
+#include <array>
 #include <cassert>
 #include <chrono>
 #include <cmath>
@@ -14,10 +15,13 @@
 #include "PlayerInterface.h"
 #include "../Assets/CityDataFile.h"
 #include "../Interface/Panel.h"
+#include "../Math/Rect.h"
 #include "../Media/FontManager.h"
 #include "../Media/MusicFile.h"
 #include "../Media/MusicName.h"
+#include "../Media/TextureFile.h"
 #include "../Media/TextureManager.h"
+#include "../Media/TextureName.h"
 #include "../Rendering/Renderer.h"
 #include "../Rendering/RenderParams.h"
 #include "../Rendering/Surface.h"
@@ -31,7 +35,10 @@
 Game::Game()
 {
 	consoleManager.setGame(this);
-	Debug::consoleManager = &this->consoleManager;
+	Debug::setOutputListener([this](const std::string &str)
+	{
+		this->consoleManager.putString(str);
+	});
 
 	DebugMention("Initializing (Platform: " + Platform::getPlatform() + ").");
 
@@ -65,6 +72,7 @@ Game::Game()
 	uint32_t renderParams = 0;
 	if (options.getGraphics_PostProcessing()) renderParams |= RenderParams::PostProcessing;
 	if (options.getGraphics_PostProcessingBloom()) renderParams |= RenderParams::Bloom;
+	if (options.getGraphics_IndexedColor()) renderParams |= RenderParams::IndexedColor;
 
 	// Initialize the SDL renderer and window with the given settings.
 	this->renderer.init(this->options.getGraphics_ScreenWidth(),
@@ -72,8 +80,31 @@ Game::Game()
 		this->options.getGraphics_LetterboxMode(),
 		renderParams);
 
+	// Load the fonts and pack them into the glyph atlas.
+	this->fontManager.init(this->renderer);
+
 	// Initialize the texture manager.
 	this->textureManager.init();
+	this->textureManager.setCacheBudget(
+		static_cast<size_t>(this->options.getGraphics_TextureCacheSize()) * 1024 * 1024);
+
+	// Interface images that are on screen most of the time shouldn't be evicted.
+	const std::array<TextureName, 8> pinnedTextureNames =
+	{
+		TextureName::ArrowCursors,
+		TextureName::QuillCursor,
+		TextureName::SwordCursor,
+		TextureName::CompassFrame,
+		TextureName::CompassSlider,
+		TextureName::GameWorldInterface,
+		TextureName::NoSpell,
+		TextureName::StatusGradients
+	};
+
+	for (const TextureName textureName : pinnedTextureNames)
+	{
+		this->textureManager.pin(TextureFile::fromName(textureName));
+	}
 
 	// Determine which version of the game the Arena path is pointing to.
 	const bool isFloppyVersion = [this, arenaPathIsRelative]()
@@ -144,6 +175,20 @@ Game::Game()
 	// This keeps the programmer from deleting a sub-panel the same frame it's in use.
 	// The pop is delayed until the beginning of the next frame.
 	this->requestedSubPanelPop = false;
+
+	this->fullRedraw = true;
+	this->idleFrame = false;
+	this->screenshotRequested = false;
+}
+
+Game::~Game()
+{
+	// The game data's levels hold pins in the texture manager, which is destroyed first
+	// otherwise.
+	this->gameData = nullptr;
+
+	// The console goes away with the game.
+	Debug::setOutputListener(nullptr);
 }
 
 Panel *Game::getActivePanel() const
@@ -205,6 +250,19 @@ MiscAssets &Game::getMiscAssets()
 	return this->miscAssets;
 }
 
+ArenaSaveWriter &Game::getSaveWriter()
+{
+	return this->saveWriter;
+}
+
+std::string Game::getArenaSavesPath()
+{
+	const std::string &arenaSavesPath = this->options.getMisc_ArenaSavesPath();
+	const bool savesPathIsRelative = File::pathIsRelative(arenaSavesPath);
+	const std::string path = (savesPathIsRelative ? Platform::getBasePath() : "") + arenaSavesPath;
+	return String::addTrailingSlashIfMissing(path);
+}
+
 const FPSCounter &Game::getFPSCounter() const
 {
 	return this->fpsCounter;
@@ -320,6 +378,7 @@ void Game::handlePanelChanges()
 	{
 		this->subPanels.pop_back();
 		this->requestedSubPanelPop = false;
+		this->fullRedraw = true;
 		
 		// Unpause the panel that is now the top-most one.
 		const bool paused = false;
@@ -334,6 +393,7 @@ void Game::handlePanelChanges()
 		this->getActivePanel()->onPauseChanged(paused);
 
 		this->subPanels.push_back(std::move(this->nextSubPanel));
+		this->fullRedraw = true;
 	}
 
 	// If a new panel was requested, switch to it. If it will be the active panel 
@@ -341,6 +401,7 @@ void Game::handlePanelChanges()
 	if (this->nextPanel.get() != nullptr)
 	{
 		this->panel = std::move(this->nextPanel);
+		this->fullRedraw = true;
 	}
 }
 
@@ -355,6 +416,10 @@ void Game::handleEvents(bool &running)
 		bool resized = this->inputManager.windowResized(e);
 		bool takeScreenshot = this->inputManager.keyPressed(e, SDLK_PRINTSCREEN);
 
+		// Render target contents are lost when the targets or the whole device are reset.
+		bool renderReset = (e.type == SDL_RENDER_TARGETS_RESET) ||
+			(e.type == SDL_RENDER_DEVICE_RESET);
+
 		if (applicationExit)
 		{
 			running = false;
@@ -375,14 +440,22 @@ void Game::handleEvents(bool &running)
 			{
 				subPanel->resize(width, height);
 			}
+
+			// The native frame buffer is recreated, so nothing in it can be reused.
+			this->fullRedraw = true;
+		}
+
+		if (renderReset)
+		{
+			// The native frame buffer can't be reused.
+			this->fullRedraw = true;
 		}
 
 		if (takeScreenshot)
 		{
-			// Save a screenshot to the local folder.
-			const auto &renderer = this->getRenderer();
-			const Surface screenshot = renderer.getScreenshot();
-			this->saveScreenshot(screenshot);
+			// Save a screenshot to the local folder once the next frame (with the cursor)
+			// is drawn.
+			this->screenshotRequested = true;
 		}
 
 		// Panel-specific events are handled by the active panel.
@@ -402,7 +475,7 @@ void Game::tick(double dt)
 	this->handlePanelChanges();
 }
 
-void Game::render()
+void Game::renderPanels()
 {
 	// Draw the panel's main content.
 	this->panel->render(this->renderer);
@@ -415,10 +488,62 @@ void Game::render()
 
 	// Call the active panel's secondary render method. Secondary render items are those
 	// that are hidden on panels below the active one.
-	Panel *activePanel = this->getActivePanel();
-	activePanel->renderSecondary(this->renderer);
+	this->getActivePanel()->renderSecondary(this->renderer);
+}
+
+void Game::render()
+{
+	// The native frame buffer keeps the last frame, so if every panel tracks its changes,
+	// only the changed regions need redrawing. Each region is redrawn by running all the
+	// panels clipped to it, which is cheap next to redrawing the whole screen.
+	bool redrawAll = this->fullRedraw;
+	std::vector<Rect> dirtyRects;
+
+	auto addDirtyRegions = [&redrawAll, &dirtyRects](const Panel &panel)
+	{
+		if (!panel.tracksDirtyRegions() || panel.isAllDirty())
+		{
+			redrawAll = true;
+		}
+		else
+		{
+			const std::vector<Rect> &panelDirtyRects = panel.getDirtyRegions();
+			dirtyRects.insert(dirtyRects.end(), panelDirtyRects.begin(), panelDirtyRects.end());
+		}
+	};
+
+	addDirtyRegions(*this->panel);
+	for (const auto &subPanel : this->subPanels)
+	{
+		addDirtyRegions(*subPanel);
+	}
+
+	if (redrawAll)
+	{
+		this->renderPanels();
+	}
+	else
+	{
+		for (const Rect &dirtyRect : dirtyRects)
+		{
+			this->renderer.setRepaintRect(&dirtyRect);
+			this->renderPanels();
+		}
+
+		this->renderer.setRepaintRect(nullptr);
+	}
+
+	this->panel->clearDirtyRegions();
+	for (auto &subPanel : this->subPanels)
+	{
+		subPanel->clearDirtyRegions();
+	}
+
+	this->fullRedraw = false;
+	this->idleFrame = !redrawAll && dirtyRects.empty();
 
 	// Get the active panel's cursor texture and alignment.
+	Panel *activePanel = this->getActivePanel();
 	const std::pair<SDL_Texture*, CursorAlignment> cursor = activePanel->getCurrentCursor();
 
 	// Draw cursor if not null. Some panels do not define a cursor (like cinematics), 
@@ -427,10 +552,20 @@ void Game::render()
 	{
 		// The panel should not be drawing the cursor themselves. It's done here 
 		// just to make sure that the cursor is drawn only once and is always drawn last.
+		// Moving it doesn't need anything else redrawn.
 		this->renderer.drawCursor(cursor.first, cursor.second,
 			this->inputManager.getMousePosition(), this->options.getGraphics_CursorScale());
 	}
 
+	this->renderer.drawFrame();
+
+	if (this->screenshotRequested)
+	{
+		const Surface screenshot = this->renderer.getScreenshot();
+		this->saveScreenshot(screenshot);
+		this->screenshotRequested = false;
+	}
+
 	this->renderer.present();
 }
 
@@ -443,6 +578,10 @@ void Game::loop()
 	// Longest allowed frame time.
 	const std::chrono::duration<int64_t, std::nano> maxFrameTime(timeUnits / Options::MIN_FPS);
 
+	// Longest wait for input when the previous frame had nothing to redraw. Any event
+	// ends the wait early, so the cursor and buttons stay responsive.
+	const int idleTimeoutMs = 1000 / Options::MIN_FPS;
+
 	// On some platforms, thread sleeping takes longer than it should, so include a value to
 	// help compensate.
 	std::chrono::nanoseconds sleepBias(0);
@@ -453,6 +592,13 @@ void Game::loop()
 	bool running = true;
 	while (running)
 	{
+		// Throttle static screens like menus instead of redrawing nothing at the target
+		// frame rate. The event is left in the queue for handleEvents().
+		if (this->idleFrame)
+		{
+			SDL_WaitEventTimeout(nullptr, idleTimeoutMs);
+		}
+
 		const auto lastTime = thisTime;
 		thisTime = std::chrono::high_resolution_clock::now();
 
@@ -527,6 +673,22 @@ void Game::loop()
 		{
 			DebugCrash("render() exception! " + std::string(e.what()));
 		}
+
+		// Free least recently used images if the texture cache is over budget.
+		this->textureManager.trim();
+
+		// Report on assets still loading in the background.
+		try
+		{
+			this->miscAssets.updateInit();
+		}
+		catch (const std::exception &e)
+		{
+			DebugCrash("Asset loading exception! " + std::string(e.what()));
+		}
+
+		// Show messages logged by background threads in the console.
+		Debug::flushOutput();
 	}
 
 	// At this point, the program has received an exit signal, and is now 
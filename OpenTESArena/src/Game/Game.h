@@ -9,6 +9,7 @@
 #include "GameData.h"
 #include "InputManager.h"
 #include "Options.h"
+#include "../Assets/ArenaSaveWriter.h"
 #include "../Assets/MiscAssets.h"
 #include "../Interface/FPSCounter.h"
 #include "../Interface/Panel.h"
@@ -48,9 +49,13 @@ private:
 	Renderer renderer;
 	TextureManager textureManager;
 	MiscAssets miscAssets;
+	ArenaSaveWriter saveWriter;
 	FPSCounter fpsCounter;
 	std::string basePath, optionsPath;
 	bool requestedSubPanelPop;
+	bool fullRedraw; // Whether every panel must be redrawn, i.e., after a panel change.
+	bool idleFrame; // Whether nothing was redrawn last frame.
+	bool screenshotRequested; // Whether to save the next frame as a screenshot.
 
 	// Gets the top-most sub-panel if one exists, or the main panel if no sub-panels exist.
 	Panel *getActivePanel() const;
@@ -73,12 +78,17 @@ private:
 	// Animates the game state by delta time.
 	void tick(double dt);
 
-	// Runs the current panel's render method for drawing to the screen.
+	// Draws the panels back to front and the active panel's secondary contents.
+	void renderPanels();
+
+	// Runs the current panel's render method for drawing to the screen. Panels that
+	// track their dirty regions are only redrawn where they've changed.
 	void render();
 public:
 	Game();
 	Game(const Game&) = delete;
 	Game(Game&&) = delete;
+	~Game();
 
 	Game &operator=(const Game&) = delete;
 	Game &operator=(Game&&) = delete;
@@ -116,6 +126,12 @@ public:
 	// Gets the miscellaneous assets object for loading some Arena-related files.
 	MiscAssets &getMiscAssets();
 
+	// Gets the save writer for writing save slots without stalling the game loop.
+	ArenaSaveWriter &getSaveWriter();
+
+	// Gets the folder with the original game's save files, with a trailing slash.
+	std::string getArenaSavesPath();
+
 	// Gets the frames-per-second counter. This is updated in the game loop.
 	const FPSCounter &getFPSCounter() const;
 
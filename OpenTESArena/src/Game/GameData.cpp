@@ -612,6 +612,18 @@ const std::array<WeatherType, 36> &GameData::getWeathersArray() const
 	return this->weathers;
 }
 
+const CityDataFile::TravelCostRaster &GameData::getTravelCostRaster(
+	const MiscAssets &miscAssets)
+{
+	if ((this->travelCostRaster == nullptr) || (this->travelCostRaster->weathers != this->weathers))
+	{
+		this->travelCostRaster = std::make_unique<CityDataFile::TravelCostRaster>(
+			this->cityData.makeTravelCostRaster(this->weathers, miscAssets));
+	}
+
+	return *this->travelCostRaster;
+}
+
 Player &GameData::getPlayer()
 {
 	return this->player;
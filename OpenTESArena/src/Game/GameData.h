@@ -75,6 +75,9 @@ private:
 	// One weather for each of the 36 province quadrants (updated hourly).
 	std::array<WeatherType, 36> weathers;
 
+	// Travel times over the world map for the current weathers. Made when first needed.
+	std::unique_ptr<CityDataFile::TravelCostRaster> travelCostRaster;
+
 	Player player;
 	std::unique_ptr<WorldData> worldData;
 	Location location;
@@ -160,6 +163,9 @@ public:
 
 	const std::array<WeatherType, 36> &getWeathersArray() const;
 
+	// Gets the travel cost raster for the current weathers, remaking it if they changed.
+	const CityDataFile::TravelCostRaster &getTravelCostRaster(const MiscAssets &miscAssets);
+
 	Player &getPlayer();
 	WorldData &getWorldData();
 	Location &getLocation();
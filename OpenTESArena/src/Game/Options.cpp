@@ -29,7 +29,9 @@ namespace
 		{ "ModernInterface", OptionType::Bool },
 		{ "RenderThreadsMode", OptionType::Int },
 		{ "PostProcessing", OptionType::Bool },
-		{ "PostProcessingBloom", OptionType::Bool }
+		{ "PostProcessingBloom", OptionType::Bool },
+		{ "IndexedColor", OptionType::Bool },
+		{ "TextureCacheSize", OptionType::Int }
 	};
 
 	const std::vector<std::pair<std::string, OptionType>> AudioMappings =
@@ -505,6 +507,11 @@ void Options::checkGraphics_RenderThreadsMode(int value) const
 		std::to_string(Options::MAX_RENDER_THREADS_MODE) + ".");
 }
 
+void Options::checkGraphics_TextureCacheSize(int value) const
+{
+	DebugAssertMsg(value >= 0, "Texture cache size cannot be negative.");
+}
+
 void Options::checkAudio_MusicVolume(double value) const
 {
 	DebugAssertMsg(value >= Options::MIN_VOLUME, "Music volume cannot be negative.");
@@ -147,6 +147,8 @@ void set##section##_##name(const std::string &value) \
 	// Post processing section
 	OPTION_BOOL(Graphics, PostProcessing)
 	OPTION_BOOL(Graphics, PostProcessingBloom)
+	OPTION_BOOL(Graphics, IndexedColor)
+	OPTION_INT(Graphics, TextureCacheSize)
 
 	OPTION_DOUBLE(Audio, MusicVolume)
 	OPTION_DOUBLE(Audio, SoundVolume)
@@ -13,6 +13,7 @@
 #include "../Game/CardinalDirection.h"
 #include "../Game/CardinalDirectionName.h"
 #include "../Game/Game.h"
+#include "../Game/GameData.h"
 #include "../Game/Options.h"
 #include "../Interface/TextAlignment.h"
 #include "../Math/Rect.h"
@@ -28,9 +29,9 @@
 #include "../Rendering/Renderer.h"
 #include "../Rendering/Surface.h"
 #include "../Utilities/Debug.h"
-#include "../World/VoxelData.h"
-#include "../World/VoxelDataType.h"
+#include "../World/LevelData.h"
 #include "../World/VoxelGrid.h"
+#include "../World/WorldData.h"
 
 namespace
 {
@@ -43,18 +44,8 @@ namespace
 	// The "canvas" area for drawing automap content.
 	const Rect DrawingArea(25, 40, 179, 125);
 
-	// Colors for automap pixels. Ground pixels (y == 0) are transparent.
+	// Color of the player's arrow.
 	const Color AutomapPlayer(247, 255, 0);
-	const Color AutomapFloor(0, 0, 0, 0);
-	const Color AutomapWall(130, 89, 48);
-	const Color AutomapRaised(97, 85, 60);
-	const Color AutomapDoor(146, 0, 0);
-	const Color AutomapLevelUp(0, 105, 0);
-	const Color AutomapLevelDown(0, 0, 255);
-	const Color AutomapDryChasm(20, 40, 40);
-	const Color AutomapWetChasm(109, 138, 174);
-	const Color AutomapLavaChasm(255, 0, 0);
-	const Color AutomapNotImplemented(255, 0, 255);
 
 	// Sets of sub-pixel coordinates for drawing each of the player's arrow directions. 
 	// These are offsets from the top-left corner of the 3x3 map pixel that the player 
@@ -73,7 +64,7 @@ namespace
 }
 
 AutomapPanel::AutomapPanel(Game &game, const Double2 &playerPosition,
-	const Double2 &playerDirection, const VoxelGrid &voxelGrid, const std::string &locationName)
+	const Double2 &playerDirection, LevelData &level, const std::string &locationName)
 	: Panel(game), automapOffset(playerPosition)
 {
 	this->locationTextBox = [&game, &locationName]()
@@ -88,7 +79,7 @@ AutomapPanel::AutomapPanel(Game &game, const Double2 &playerPosition,
 			game.getFontManager());
 
 		const TextBox::ShadowData shadowData(Color(150, 101, 52), Int2(2, 2));
-		return std::make_unique<TextBox>(center, richText, &shadowData, game.getRenderer());
+		return std::make_unique<TextBox>(center, richText, &shadowData);
 	}();
 
 	this->backToGameButton = []()
@@ -103,87 +94,40 @@ AutomapPanel::AutomapPanel(Game &game, const Double2 &playerPosition,
 		return Button<Game&>(center, width, height, function);
 	}();
 
-	this->mapTexture = [this, &playerPosition, &playerDirection, &voxelGrid]()
-	{
-		// Create scratch surface. For the purposes of the automap, the bottom left corner
-		// is (0, 0), left to right is the Z axis, and up and down is the X axis, because 
-		// north is +X in-game. It is scaled by 3 so that all directions of the player's 
-		// arrow are representable.
-		Surface surface = Surface::createWithFormat(
-			voxelGrid.getDepth() * 3, voxelGrid.getWidth() * 3, Renderer::DEFAULT_BPP,
-			Renderer::DEFAULT_PIXELFORMAT);
-
-		// Fill with transparent color first (used by floor voxels).
-		SDL_FillRect(surface.get(), nullptr, AutomapFloor.toARGB());
-
-		// Lambda for filling in a square in the map surface.
-		auto drawSquare = [&surface](int x, int z, const Color &color)
-		{
-			SDL_Rect rect;
-			rect.x = z * 3;
-			rect.y = surface.getHeight() - 3 - (x * 3);
-			rect.w = 3;
-			rect.h = 3;
-
-			SDL_FillRect(surface.get(), &rect, color.toARGB());
-		};
+	auto &automap = level.getAutomap();
+	const VoxelGrid &voxelGrid = level.getVoxelGrid();
+	const int playerVoxelX = static_cast<int>(std::floor(playerPosition.x));
+	const int playerVoxelZ = static_cast<int>(std::floor(playerPosition.y));
 
-		auto getVoxelData = [&voxelGrid](int x, int y, int z) -> const VoxelData&
-		{
-			const uint16_t voxelID = voxelGrid.getVoxel(x, y, z);
-			return voxelGrid.getVoxelData(voxelID);
-		};
-
-		// For each voxel, start at the lowest Y and walk upwards. The color depends 
-		// on a couple factors, like whether the voxel is a wall, a door, water, etc.,
-		// and some context-sensitive cases like whether a dry chasm has a wall
-		// over it.
-		for (int x = 0; x < voxelGrid.getWidth(); x++)
-		{
-			for (int z = 0; z < voxelGrid.getDepth(); z++)
-			{
-				const VoxelData &floorData = getVoxelData(x, 0, z);
-				const VoxelData &wallData = getVoxelData(x, 1, z);
+	// Verify that the player is within the bounds of the map before exploring around
+	// them and drawing their arrow.
+	this->playerInMap = (playerVoxelX >= 0) && (playerVoxelX < voxelGrid.getWidth()) &&
+		(playerVoxelZ >= 0) && (playerVoxelZ < voxelGrid.getDepth());
 
-				// Decide which color to use for the automap pixel.
-				const Color &color = AutomapPanel::getPixelColor(floorData, wallData);
+	if (this->playerInMap)
+	{
+		automap.reveal(Int2(playerVoxelX, playerVoxelZ), voxelGrid);
+		this->playerArrowPosition = automap.getColumnPosition(playerVoxelX, playerVoxelZ);
+	}
 
-				// Draw the automap pixel.
-				drawSquare(x, z, color);
-			}
-		}
+	// Upload any newly explored part of the map now so drawing it is just a copy.
+	automap.getTexture(this->getGame().getRenderer());
 
-		// Lambda for drawing the player's arrow in the automap. It's drawn differently 
-		// depending on their direction.
-		auto drawPlayer = [&surface](int x, int z, const Double2 &direction)
-		{
-			const CardinalDirectionName cardinalDirection =
-				CardinalDirection::getDirectionName(direction);
-
-			const int surfaceX = z * 3;
-			const int surfaceY = surface.getHeight() - 3 - (x * 3);
-
-			uint32_t *pixels = static_cast<uint32_t*>(surface.get()->pixels);
-
-			// Draw the player's arrow within the 3x3 map pixel.
-			const std::vector<Int2> &offsets = AutomapPlayerArrowPatterns.at(cardinalDirection);
-			for (const auto &offset : offsets)
-			{
-				const int index = (surfaceX + offset.x) +
-					((surfaceY + offset.y) * surface.getWidth());
-				pixels[index] = AutomapPlayer.toARGB();
-			}
-		};
+	// The player's arrow is drawn differently depending on their direction.
+	this->playerArrowTexture = [this, &playerDirection]()
+	{
+		Surface surface = Surface::createWithFormat(3, 3, Renderer::DEFAULT_BPP,
+			Renderer::DEFAULT_PIXELFORMAT);
+		SDL_FillRect(surface.get(), nullptr, Color::Transparent.toARGB());
 
-		const int playerVoxelX = static_cast<int>(std::floor(playerPosition.x));
-		const int playerVoxelZ = static_cast<int>(std::floor(playerPosition.y));
+		const CardinalDirectionName cardinalDirection =
+			CardinalDirection::getDirectionName(playerDirection);
 
-		// Draw player last. Verify that the player is within the bounds of the map 
-		// before drawing.
-		if ((playerVoxelX >= 0) && (playerVoxelX < voxelGrid.getWidth()) &&
-			(playerVoxelZ >= 0) && (playerVoxelZ < voxelGrid.getDepth()))
+		uint32_t *pixels = static_cast<uint32_t*>(surface.get()->pixels);
+		const std::vector<Int2> &offsets = AutomapPlayerArrowPatterns.at(cardinalDirection);
+		for (const auto &offset : offsets)
 		{
-			drawPlayer(playerVoxelX, playerVoxelZ, playerDirection);
+			pixels[offset.x + (offset.y * surface.getWidth())] = AutomapPlayer.toARGB();
 		}
 
 		auto &renderer = this->getGame().getRenderer();
@@ -193,111 +137,6 @@ AutomapPanel::AutomapPanel(Game &game, const Double2 &playerPosition,
 	}();
 }
 
-const Color &AutomapPanel::getPixelColor(const VoxelData &floorData, const VoxelData &wallData)
-{
-	const VoxelDataType floorDataType = floorData.dataType;
-	const VoxelDataType wallDataType = wallData.dataType;
-
-	if (floorDataType == VoxelDataType::Chasm)
-	{
-		const VoxelData::ChasmData::Type chasmType = floorData.chasm.type;
-
-		if (chasmType == VoxelData::ChasmData::Type::Dry)
-		{
-			// Dry chasms are a different color if a wall is over them.
-			return (wallDataType == VoxelDataType::Wall) ? AutomapRaised : AutomapDryChasm;
-		}
-		else if (chasmType == VoxelData::ChasmData::Type::Lava)
-		{
-			// Lava chasms ignore all but raised platforms.
-			return (wallDataType == VoxelDataType::Raised) ? AutomapRaised : AutomapLavaChasm;
-		}
-		else if (chasmType == VoxelData::ChasmData::Type::Wet)
-		{
-			// Water chasms ignore all but raised platforms.
-			return (wallDataType == VoxelDataType::Raised) ? AutomapRaised : AutomapWetChasm;
-		}
-		else
-		{
-			DebugWarning("Unrecognized chasm type \"" +
-				std::to_string(static_cast<int>(chasmType)) + "\".");
-			return AutomapNotImplemented;
-		}
-	}
-	else if (floorDataType == VoxelDataType::Floor)
-	{
-		// If nothing is over the floor, return transparent. Otherwise, choose from
-		// a number of cases.
-		if (wallDataType == VoxelDataType::None)
-		{
-			return AutomapFloor;
-		}
-		else if (wallDataType == VoxelDataType::Wall)
-		{
-			const VoxelData::WallData::Type wallType = wallData.wall.type;
-
-			if (wallType == VoxelData::WallData::Type::Solid)
-			{
-				return AutomapWall;
-			}
-			else if (wallType == VoxelData::WallData::Type::LevelUp)
-			{
-				return AutomapLevelUp;
-			}
-			else if (wallType == VoxelData::WallData::Type::LevelDown)
-			{
-				return AutomapLevelDown;
-			}
-			else if (wallType == VoxelData::WallData::Type::Menu)
-			{
-				// Menu blocks are the same color as doors.
-				return AutomapDoor;
-			}
-			else
-			{
-				DebugWarning("Unrecognized wall type \"" +
-					std::to_string(static_cast<int>(wallType)) + "\".");
-				return AutomapNotImplemented;
-			}
-		}
-		else if (wallDataType == VoxelDataType::Raised)
-		{
-			return AutomapRaised;
-		}
-		else if (wallDataType == VoxelDataType::Diagonal)
-		{
-			return AutomapFloor;
-		}
-		else if (wallDataType == VoxelDataType::Door)
-		{
-			return AutomapDoor;
-		}
-		else if (wallDataType == VoxelDataType::TransparentWall)
-		{
-			// Transparent walls with collision (hedges) are shown, while
-			// ones without collision (archways) are not.
-			const VoxelData::TransparentWallData &transparentWallData = wallData.transparentWall;
-			return transparentWallData.collider ? AutomapWall : AutomapFloor;
-		}
-		else if (wallDataType == VoxelDataType::Edge)
-		{
-			return AutomapWall;
-		}
-		else
-		{
-			DebugWarning("Unrecognized wall data type \"" +
-				std::to_string(static_cast<int>(wallDataType)) + "\".");
-			return AutomapNotImplemented;
-		}
-	}
-	else
-	{
-		DebugWarning("Unrecognized floor data type \"" +
-			std::to_string(static_cast<int>(floorDataType)) + "\".");
-		return AutomapNotImplemented;
-	}
-}
-
 std::pair<SDL_Texture*, CursorAlignment> AutomapPanel::getCurrentCursor() const
 {
 	auto &game = this->getGame();
@@ -373,20 +212,21 @@ void AutomapPanel::handleMouse(double dt)
 
 void AutomapPanel::drawTooltip(const std::string &text, Renderer &renderer)
 {
-	const Texture tooltip(Panel::createTooltip(
-		text, FontName::D, this->getGame().getFontManager(), renderer));
+	const TextBox tooltip = Panel::createTooltip(
+		text, FontName::D, this->getGame().getFontManager());
+	const Int2 tooltipDims = Panel::getTooltipDimensions(tooltip);
 
 	const auto &inputManager = this->getGame().getInputManager();
 	const Int2 mousePosition = inputManager.getMousePosition();
 	const Int2 originalPosition = renderer.nativeToOriginal(mousePosition);
 	const int mouseX = originalPosition.x;
 	const int mouseY = originalPosition.y;
-	const int x = ((mouseX + 8 + tooltip.getWidth()) < Renderer::ORIGINAL_WIDTH) ?
-		(mouseX + 8) : (mouseX - tooltip.getWidth());
-	const int y = ((mouseY + tooltip.getHeight()) < Renderer::ORIGINAL_HEIGHT) ?
-		(mouseY - 1) : (mouseY - tooltip.getHeight());
+	const int x = ((mouseX + 8 + tooltipDims.x) < Renderer::ORIGINAL_WIDTH) ?
+		(mouseX + 8) : (mouseX - tooltipDims.x);
+	const int y = ((mouseY + tooltipDims.y) < Renderer::ORIGINAL_HEIGHT) ?
+		(mouseY - 1) : (mouseY - tooltipDims.y);
 
-	renderer.drawOriginal(tooltip.get(), x, y);
+	Panel::drawTooltipBox(tooltip, x, y, renderer);
 }
 
 void AutomapPanel::tick(double dt)
@@ -417,17 +257,25 @@ void AutomapPanel::render(Renderer &renderer)
 	// the map texture is scaled by 3 (for the 3x3 player pixel).
 	const int offsetX = static_cast<int>(std::floor(this->automapOffset.y * 3.0));
 	const int offsetY = static_cast<int>(std::floor(this->automapOffset.x * 3.0));
+	auto &automap = this->getGame().getGameData().getWorldData().getActiveLevel().getAutomap();
+	const Texture &mapTexture = automap.getTexture(renderer);
 	const int mapX = (DrawingArea.getLeft() + (DrawingArea.getWidth() / 2)) - offsetX;
 	const int mapY = (DrawingArea.getTop() + (DrawingArea.getHeight() / 2)) + offsetY -
-		this->mapTexture.getHeight();
-	renderer.drawOriginal(this->mapTexture.get(), mapX, mapY);
+		mapTexture.getHeight();
+	renderer.drawOriginal(mapTexture.get(), mapX, mapY);
+
+	// Draw the player's arrow over their map pixel.
+	if (this->playerInMap)
+	{
+		renderer.drawOriginal(this->playerArrowTexture.get(),
+			mapX + this->playerArrowPosition.x, mapY + this->playerArrowPosition.y);
+	}
 
 	// Reset renderer clipping to normal.
 	renderer.setClipRect(nullptr);
 
 	// Draw text: title.
-	renderer.drawOriginal(this->locationTextBox->getTexture(),
-		this->locationTextBox->getX(), this->locationTextBox->getY());
+	this->locationTextBox->draw(renderer);
 
 	// Check if the mouse is over the compass directions for tooltips.
 	const auto &inputManager = this->getGame().getInputManager();
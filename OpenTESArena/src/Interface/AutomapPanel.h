@@ -8,23 +8,19 @@
 #include "../Math/Vector2.h"
 #include "../Rendering/Texture.h"
 
-class Color;
+class LevelData;
 class Renderer;
 class TextBox;
-class VoxelData;
-class VoxelGrid;
 
 class AutomapPanel : public Panel
 {
 private:
 	std::unique_ptr<TextBox> locationTextBox;
 	Button<Game&> backToGameButton;
-	Texture mapTexture;
+	Texture playerArrowTexture; // 3x3 arrow for the player's direction.
+	Int2 playerArrowPosition; // Top-left corner of the arrow in the automap image.
 	Double2 automapOffset; // Displayed XZ coordinate offset from (0, 0).
-
-	// Gets the display color for a pixel on the automap, given its associated floor
-	// and wall voxel data definitions.
-	static const Color &getPixelColor(const VoxelData &floorData, const VoxelData &wallData);
+	bool playerInMap;
 
 	// Listen for when the LMB is held on a compass direction.
 	void handleMouse(double dt);
@@ -32,7 +28,7 @@ private:
 	void drawTooltip(const std::string &text, Renderer &renderer);
 public:
 	AutomapPanel(Game &game, const Double2 &playerPosition, const Double2 &playerDirection,
-		const VoxelGrid &voxelGrid, const std::string &locationName);
+		LevelData &level, const std::string &locationName);
 	virtual ~AutomapPanel() = default;
 
 	virtual std::pair<SDL_Texture*, CursorAlignment> getCurrentCursor() const override;
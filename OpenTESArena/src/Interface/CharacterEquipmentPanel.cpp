@@ -42,7 +42,7 @@ CharacterEquipmentPanel::CharacterEquipmentPanel(Game &game)
 			TextAlignment::Left,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+		return std::make_unique<TextBox>(x, y, richText);
 	}();
 
 	this->playerRaceTextBox = [&game]()
@@ -61,7 +61,7 @@ CharacterEquipmentPanel::CharacterEquipmentPanel(Game &game)
 			TextAlignment::Left,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+		return std::make_unique<TextBox>(x, y, richText);
 	}();
 
 	this->playerClassTextBox = [&game]()
@@ -76,7 +76,7 @@ CharacterEquipmentPanel::CharacterEquipmentPanel(Game &game)
 			TextAlignment::Left,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+		return std::make_unique<TextBox>(x, y, richText);
 	}();
 
 	this->backToStatsButton = []()
@@ -256,10 +256,7 @@ void CharacterEquipmentPanel::render(Renderer &renderer)
 	renderer.drawOriginal(equipmentBackground.get());
 
 	// Draw text boxes: player name, race, class.
-	renderer.drawOriginal(this->playerNameTextBox->getTexture(),
-		this->playerNameTextBox->getX(), this->playerNameTextBox->getY());
-	renderer.drawOriginal(this->playerRaceTextBox->getTexture(),
-		this->playerRaceTextBox->getX(), this->playerRaceTextBox->getY());
-	renderer.drawOriginal(this->playerClassTextBox->getTexture(),
-		this->playerClassTextBox->getX(), this->playerClassTextBox->getY());
+	this->playerNameTextBox->draw(renderer);
+	this->playerRaceTextBox->draw(renderer);
+	this->playerClassTextBox->draw(renderer);
 }
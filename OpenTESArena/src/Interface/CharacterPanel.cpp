@@ -44,7 +44,7 @@ CharacterPanel::CharacterPanel(Game &game)
 			TextAlignment::Left,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+		return std::make_unique<TextBox>(x, y, richText);
 	}();
 
 	this->playerRaceTextBox = [&game]()
@@ -63,7 +63,7 @@ CharacterPanel::CharacterPanel(Game &game)
 			TextAlignment::Left,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+		return std::make_unique<TextBox>(x, y, richText);
 	}();
 
 	this->playerClassTextBox = [&game]()
@@ -78,7 +78,7 @@ CharacterPanel::CharacterPanel(Game &game)
 			TextAlignment::Left,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+		return std::make_unique<TextBox>(x, y, richText);
 	}();
 
 	this->doneButton = []()
@@ -118,6 +118,12 @@ CharacterPanel::CharacterPanel(Game &game)
 	}
 }
 
+bool CharacterPanel::tracksDirtyRegions() const
+{
+	// Nothing changes until another panel is opened.
+	return true;
+}
+
 std::pair<SDL_Texture*, CursorAlignment> CharacterPanel::getCurrentCursor() const
 {
 	auto &game = this->getGame();
@@ -210,10 +216,7 @@ void CharacterPanel::render(Renderer &renderer)
 	renderer.drawOriginal(nextPageTexture.get(), 108, 179);
 
 	// Draw text boxes: player name, race, class.
-	renderer.drawOriginal(this->playerNameTextBox->getTexture(),
-		this->playerNameTextBox->getX(), this->playerNameTextBox->getY());
-	renderer.drawOriginal(this->playerRaceTextBox->getTexture(),
-		this->playerRaceTextBox->getX(), this->playerRaceTextBox->getY());
-	renderer.drawOriginal(this->playerClassTextBox->getTexture(),
-		this->playerClassTextBox->getX(), this->playerClassTextBox->getY());
+	this->playerNameTextBox->draw(renderer);
+	this->playerRaceTextBox->draw(renderer);
+	this->playerClassTextBox->draw(renderer);
 }
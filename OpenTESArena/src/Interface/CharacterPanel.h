@@ -26,6 +26,7 @@ public:
 	CharacterPanel(Game &game);
 	virtual ~CharacterPanel() = default;
 
+	virtual bool tracksDirtyRegions() const override;
 	virtual std::pair<SDL_Texture*, CursorAlignment> getCurrentCursor() const override;
 	virtual void handleEvent(const SDL_Event &e) override;
 	virtual void render(Renderer &renderer) override;
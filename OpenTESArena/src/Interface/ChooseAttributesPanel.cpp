@@ -60,7 +60,7 @@ ChooseAttributesPanel::ChooseAttributesPanel(Game &game,
 			TextAlignment::Left,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+		return std::make_unique<TextBox>(x, y, richText);
 	}();
 
 	this->raceTextBox = [&game, raceID]()
@@ -78,7 +78,7 @@ ChooseAttributesPanel::ChooseAttributesPanel(Game &game,
 			TextAlignment::Left,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+		return std::make_unique<TextBox>(x, y, richText);
 	}();
 
 	this->classTextBox = [&game, &charClass]()
@@ -93,7 +93,7 @@ ChooseAttributesPanel::ChooseAttributesPanel(Game &game,
 			TextAlignment::Left,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+		return std::make_unique<TextBox>(x, y, richText);
 	}();
 
 	this->backToRaceButton = [&charClass, &name, gender]()
@@ -118,7 +118,7 @@ ChooseAttributesPanel::ChooseAttributesPanel(Game &game,
 			auto &renderer = game.getRenderer();
 
 			MessageBoxSubPanel::Title messageBoxTitle;
-			messageBoxTitle.textBox = [&game, raceID, &renderer]()
+			messageBoxTitle.textBox = [&game, raceID]()
 			{
 				const auto &exeData = game.getMiscAssets().getExeData();
 				const std::string &text = exeData.charCreation.chooseAttributes;
@@ -136,7 +136,7 @@ ChooseAttributesPanel::ChooseAttributesPanel(Game &game,
 					(Renderer::ORIGINAL_WIDTH / 2),
 					(Renderer::ORIGINAL_HEIGHT / 2) - 22);
 
-				return std::make_unique<TextBox>(center, richText, renderer);
+				return std::make_unique<TextBox>(center, richText);
 			}();
 
 			messageBoxTitle.texture = [&textureManager, &renderer, &messageBoxTitle]()
@@ -155,7 +155,7 @@ ChooseAttributesPanel::ChooseAttributesPanel(Game &game,
 			const Color buttonTextColor(190, 113, 0);
 
 			MessageBoxSubPanel::Element messageBoxSave;
-			messageBoxSave.textBox = [&game, &renderer, &buttonTextColor]()
+			messageBoxSave.textBox = [&game, &buttonTextColor]()
 			{
 				const auto &exeData = game.getMiscAssets().getExeData();
 				std::string text = exeData.charCreation.chooseAttributesSave;
@@ -175,7 +175,7 @@ ChooseAttributesPanel::ChooseAttributesPanel(Game &game,
 					(Renderer::ORIGINAL_WIDTH / 2) - 1,
 					(Renderer::ORIGINAL_HEIGHT / 2) + 2);
 
-				return std::make_unique<TextBox>(center, richText, renderer);
+				return std::make_unique<TextBox>(center, richText);
 			}();
 
 			messageBoxSave.texture = [&textureManager, &renderer, &messageBoxTitle]()
@@ -399,7 +399,7 @@ ChooseAttributesPanel::ChooseAttributesPanel(Game &game,
 				messageBoxTitle.texture.getHeight();
 
 			MessageBoxSubPanel::Element messageBoxReroll;
-			messageBoxReroll.textBox = [&game, &renderer, &buttonTextColor]()
+			messageBoxReroll.textBox = [&game, &buttonTextColor]()
 			{
 				const auto &exeData = game.getMiscAssets().getExeData();
 				std::string text = exeData.charCreation.chooseAttributesReroll;
@@ -419,7 +419,7 @@ ChooseAttributesPanel::ChooseAttributesPanel(Game &game,
 					(Renderer::ORIGINAL_WIDTH / 2) - 1,
 					(Renderer::ORIGINAL_HEIGHT / 2) + 26);
 
-				return std::make_unique<TextBox>(center, richText, renderer);
+				return std::make_unique<TextBox>(center, richText);
 			}();
 
 			messageBoxReroll.texture = [&textureManager, &renderer, &messageBoxSave]()
@@ -634,10 +634,7 @@ void ChooseAttributesPanel::render(Renderer &renderer)
 	renderer.drawOriginal(attributesBackground.get());
 
 	// Draw text boxes: player name, race, class.
-	renderer.drawOriginal(this->nameTextBox->getTexture(),
-		this->nameTextBox->getX(), this->nameTextBox->getY());
-	renderer.drawOriginal(this->raceTextBox->getTexture(),
-		this->raceTextBox->getX(), this->raceTextBox->getY());
-	renderer.drawOriginal(this->classTextBox->getTexture(),
-		this->classTextBox->getX(), this->classTextBox->getY());
+	this->nameTextBox->draw(renderer);
+	this->raceTextBox->draw(renderer);
+	this->classTextBox->draw(renderer);
 }
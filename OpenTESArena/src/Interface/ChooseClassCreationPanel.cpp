@@ -51,7 +51,7 @@ ChooseClassCreationPanel::ChooseClassCreationPanel(Game &game)
 			lineSpacing,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(center, richText, game.getRenderer());
+		return std::make_unique<TextBox>(center, richText);
 	}();
 
 	this->generateTextBox = [&game]()
@@ -68,7 +68,7 @@ ChooseClassCreationPanel::ChooseClassCreationPanel(Game &game)
 			TextAlignment::Center,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(center, richText, game.getRenderer());
+		return std::make_unique<TextBox>(center, richText);
 	}();
 
 	this->selectTextBox = [&game]()
@@ -85,7 +85,7 @@ ChooseClassCreationPanel::ChooseClassCreationPanel(Game &game)
 			TextAlignment::Center,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(center, richText, game.getRenderer());
+		return std::make_unique<TextBox>(center, richText);
 	}();
 
 	this->backToMainMenuButton = []()
@@ -161,20 +161,21 @@ void ChooseClassCreationPanel::handleEvent(const SDL_Event &e)
 
 void ChooseClassCreationPanel::drawTooltip(const std::string &text, Renderer &renderer)
 {
-	const Texture tooltip(Panel::createTooltip(
-		text, FontName::D, this->getGame().getFontManager(), renderer));
+	const TextBox tooltip = Panel::createTooltip(
+		text, FontName::D, this->getGame().getFontManager());
+	const Int2 tooltipDims = Panel::getTooltipDimensions(tooltip);
 
 	const auto &inputManager = this->getGame().getInputManager();
 	const Int2 mousePosition = inputManager.getMousePosition();
 	const Int2 originalPosition = renderer.nativeToOriginal(mousePosition);
 	const int mouseX = originalPosition.x;
 	const int mouseY = originalPosition.y;
-	const int x = ((mouseX + 8 + tooltip.getWidth()) < Renderer::ORIGINAL_WIDTH) ?
-		(mouseX + 8) : (mouseX - tooltip.getWidth());
-	const int y = ((mouseY + tooltip.getHeight()) < Renderer::ORIGINAL_HEIGHT) ?
-		(mouseY - 1) : (mouseY - tooltip.getHeight());
+	const int x = ((mouseX + 8 + tooltipDims.x) < Renderer::ORIGINAL_WIDTH) ?
+		(mouseX + 8) : (mouseX - tooltipDims.x);
+	const int y = ((mouseY + tooltipDims.y) < Renderer::ORIGINAL_HEIGHT) ?
+		(mouseY - 1) : (mouseY - tooltipDims.y);
 
-	renderer.drawOriginal(tooltip.get(), x, y);
+	Panel::drawTooltipBox(tooltip, x, y, renderer);
 }
 
 void ChooseClassCreationPanel::render(Renderer &renderer)
@@ -203,12 +204,9 @@ void ChooseClassCreationPanel::render(Renderer &renderer)
 	renderer.drawOriginal(this->parchment.get(), parchmentX, parchmentY + 60);
 
 	// Draw text: title, generate, select.
-	renderer.drawOriginal(this->titleTextBox->getTexture(),
-		this->titleTextBox->getX(), this->titleTextBox->getY());
-	renderer.drawOriginal(this->generateTextBox->getTexture(),
-		this->generateTextBox->getX(), this->generateTextBox->getY());
-	renderer.drawOriginal(this->selectTextBox->getTexture(),
-		this->selectTextBox->getX(), this->selectTextBox->getY());
+	this->titleTextBox->draw(renderer);
+	this->generateTextBox->draw(renderer);
+	this->selectTextBox->draw(renderer);
 
 	// Check if the mouse is hovered over one of the boxes for tooltips.
 	const auto &inputManager = this->getGame().getInputManager();
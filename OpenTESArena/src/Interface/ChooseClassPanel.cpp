@@ -64,7 +64,7 @@ ChooseClassPanel::ChooseClassPanel(Game &game)
 			TextAlignment::Left,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+		return std::make_unique<TextBox>(x, y, richText);
 	}();
 
 	this->classesListBox = [this, &game]()
@@ -90,8 +90,7 @@ ChooseClassPanel::ChooseClassPanel(Game &game)
 			elements,
 			FontName::A,
 			maxDisplayed,
-			game.getFontManager(),
-			game.getRenderer());
+			game.getFontManager());
 	}();
 
 	this->backToClassCreationButton = []()
@@ -153,9 +152,9 @@ ChooseClassPanel::ChooseClassPanel(Game &game)
 		return Button<Game&, const CharacterClass&>(function);
 	}();
 
-	// Leave the tooltip textures empty for now. Let them be created on demand. 
+	// Leave the tooltip text boxes empty for now. Let them be created on demand. 
 	// Generating them all at once here is too slow in debug mode.
-	assert(this->tooltipTextures.size() == 0);
+	assert(this->tooltipTextBoxes.size() == 0);
 }
 
 std::pair<SDL_Texture*, CursorAlignment> ChooseClassPanel::getCurrentCursor() const
@@ -391,8 +390,8 @@ Rect ChooseClassPanel::getClassListRect(const ExeData &exeData)
 void ChooseClassPanel::drawClassTooltip(int tooltipIndex, Renderer &renderer)
 {
 	// Make the tooltip if it doesn't already exist.
-	auto tooltipIter = this->tooltipTextures.find(tooltipIndex);
-	if (tooltipIter == this->tooltipTextures.end())
+	auto tooltipIter = this->tooltipTextBoxes.find(tooltipIndex);
+	if (tooltipIter == this->tooltipTextBoxes.end())
 	{
 		const auto &characterClass = this->charClasses.at(tooltipIndex);
 
@@ -404,26 +403,27 @@ void ChooseClassPanel::drawClassTooltip(int tooltipIndex, Renderer &renderer)
 			"Shields: " + this->getClassShields(characterClass) + "\n" +
 			"Weapons: " + this->getClassWeapons(characterClass);
 
-		Texture texture(Panel::createTooltip(
-			text, FontName::D, this->getGame().getFontManager(), renderer));
+		TextBox textBox = Panel::createTooltip(
+			text, FontName::D, this->getGame().getFontManager());
 
-		tooltipIter = this->tooltipTextures.emplace(std::make_pair(
-			tooltipIndex, std::move(texture))).first;
+		tooltipIter = this->tooltipTextBoxes.emplace(std::make_pair(
+			tooltipIndex, std::move(textBox))).first;
 	}
 
-	const Texture &tooltip = tooltipIter->second;
+	const TextBox &tooltip = tooltipIter->second;
+	const Int2 tooltipDims = Panel::getTooltipDimensions(tooltip);
 
 	const auto &inputManager = this->getGame().getInputManager();
 	const Int2 mousePosition = inputManager.getMousePosition();
 	const Int2 originalPosition = renderer.nativeToOriginal(mousePosition);
 	const int mouseX = originalPosition.x;
 	const int mouseY = originalPosition.y;
-	const int x = ((mouseX + 8 + tooltip.getWidth()) < Renderer::ORIGINAL_WIDTH) ?
-		(mouseX + 8) : (mouseX - tooltip.getWidth());
-	const int y = ((mouseY + tooltip.getHeight()) < Renderer::ORIGINAL_HEIGHT) ?
-		(mouseY - 1) : (mouseY - tooltip.getHeight());
+	const int x = ((mouseX + 8 + tooltipDims.x) < Renderer::ORIGINAL_WIDTH) ?
+		(mouseX + 8) : (mouseX - tooltipDims.x);
+	const int y = ((mouseY + tooltipDims.y) < Renderer::ORIGINAL_HEIGHT) ?
+		(mouseY - 1) : (mouseY - tooltipDims.y);
 
-	renderer.drawOriginal(tooltip.get(), x, y);
+	Panel::drawTooltipBox(tooltip, x, y, renderer);
 }
 
 void ChooseClassPanel::render(Renderer &renderer)
@@ -450,11 +450,8 @@ void ChooseClassPanel::render(Renderer &renderer)
 		listPopUp.getWidth(), listPopUp.getHeight());
 
 	// Draw text: title, list.
-	renderer.drawOriginal(this->titleTextBox->getTexture(),
-		this->titleTextBox->getX(), this->titleTextBox->getY());
-	renderer.drawOriginal(this->classesListBox->getTexture(),
-		this->classesListBox->getPoint().x,
-		this->classesListBox->getPoint().y);
+	this->titleTextBox->draw(renderer);
+	this->classesListBox->draw(renderer);
 
 	// Draw tooltip if over a valid element in the list box.
 	const auto &inputManager = game.getInputManager();
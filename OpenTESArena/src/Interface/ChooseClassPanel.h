@@ -7,8 +7,8 @@
 #include "Button.h"
 #include "ListBox.h"
 #include "Panel.h"
+#include "TextBox.h"
 #include "../Entities/CharacterClass.h"
-#include "../Rendering/Texture.h"
 
 // The original class list design in Arena is pretty bad. It's an alphabetical 
 // list that says nothing about the classes (thus requiring the manual for 
@@ -18,7 +18,6 @@ class ExeData;
 class Rect;
 class Renderer;
 class Surface;
-class TextBox;
 
 class ChooseClassPanel : public Panel
 {
@@ -30,7 +29,7 @@ private:
 	Button<Game&> backToClassCreationButton;
 	Button<ChooseClassPanel&> upButton, downButton;
 	Button<Game&, const CharacterClass&> acceptButton;
-	std::unordered_map<int, Texture> tooltipTextures;
+	std::unordered_map<int, TextBox> tooltipTextBoxes;
 	std::vector<CharacterClass> charClasses;
 
 	std::string getClassArmors(const CharacterClass &characterClass) const;
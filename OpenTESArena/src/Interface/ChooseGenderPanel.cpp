@@ -47,7 +47,7 @@ ChooseGenderPanel::ChooseGenderPanel(Game &game, const CharacterClass &charClass
 			TextAlignment::Center,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(center, richText, game.getRenderer());
+		return std::make_unique<TextBox>(center, richText);
 	}();
 
 	this->maleTextBox = [&game]()
@@ -64,7 +64,7 @@ ChooseGenderPanel::ChooseGenderPanel(Game &game, const CharacterClass &charClass
 			TextAlignment::Center,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(center, richText, game.getRenderer());
+		return std::make_unique<TextBox>(center, richText);
 	}();
 
 	this->femaleTextBox = [&game]()
@@ -81,7 +81,7 @@ ChooseGenderPanel::ChooseGenderPanel(Game &game, const CharacterClass &charClass
 			TextAlignment::Center,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(center, richText, game.getRenderer());
+		return std::make_unique<TextBox>(center, richText);
 	}();
 
 	this->backToNameButton = []()
@@ -183,10 +183,7 @@ void ChooseGenderPanel::render(Renderer &renderer)
 	renderer.drawOriginal(this->parchment.get(), parchmentX, parchmentY + 60);
 
 	// Draw text: title, male, and female.
-	renderer.drawOriginal(this->genderTextBox->getTexture(),
-		this->genderTextBox->getX(), this->genderTextBox->getY());
-	renderer.drawOriginal(this->maleTextBox->getTexture(),
-		this->maleTextBox->getX(), this->maleTextBox->getY());
-	renderer.drawOriginal(this->femaleTextBox->getTexture(),
-		this->femaleTextBox->getX(), this->femaleTextBox->getY());
+	this->genderTextBox->draw(renderer);
+	this->maleTextBox->draw(renderer);
+	this->femaleTextBox->draw(renderer);
 }
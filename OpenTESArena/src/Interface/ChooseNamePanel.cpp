@@ -52,7 +52,7 @@ ChooseNamePanel::ChooseNamePanel(Game &game, const CharacterClass &charClass)
 			TextAlignment::Left,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+		return std::make_unique<TextBox>(x, y, richText);
 	}();
 
 	this->nameTextBox = [&game]()
@@ -67,7 +67,7 @@ ChooseNamePanel::ChooseNamePanel(Game &game, const CharacterClass &charClass)
 			TextAlignment::Left,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+		return std::make_unique<TextBox>(x, y, richText);
 	}();
 
 	this->backToClassButton = []()
@@ -144,16 +144,12 @@ void ChooseNamePanel::handleEvent(const SDL_Event &e)
 				const int y = 101;
 
 				auto &game = this->getGame();
-				const RichTextString &oldRichText = this->nameTextBox->getRichText();
 
-				const RichTextString richText(
-					this->name,
-					oldRichText.getFontName(),
-					oldRichText.getColor(),
-					oldRichText.getAlignment(),
-					game.getFontManager());
+				// Only the edited end of the text needs laying out again.
+				RichTextString richText = this->nameTextBox->getRichText();
+				richText.setText(this->name, game.getFontManager());
 
-				return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+				return std::make_unique<TextBox>(x, y, richText);
 			}();
 		}
 	}
@@ -180,8 +176,6 @@ void ChooseNamePanel::render(Renderer &renderer)
 		(Renderer::ORIGINAL_HEIGHT / 2) - (this->parchment.getHeight() / 2));
 
 	// Draw text: title, name.
-	renderer.drawOriginal(this->titleTextBox->getTexture(),
-		this->titleTextBox->getX(), this->titleTextBox->getY());
-	renderer.drawOriginal(this->nameTextBox->getTexture(),
-		this->nameTextBox->getX(), this->nameTextBox->getY());
+	this->titleTextBox->draw(renderer);
+	this->nameTextBox->draw(renderer);
 }
@@ -58,7 +58,7 @@ ChooseRacePanel::ChooseRacePanel(Game &game, const CharacterClass &charClass,
 			const Color textColor(52, 24, 8);
 
 			MessageBoxSubPanel::Title messageBoxTitle;
-			messageBoxTitle.textBox = [&game, raceID, &renderer, &textColor]()
+			messageBoxTitle.textBox = [&game, raceID, &textColor]()
 			{
 				const auto &exeData = game.getMiscAssets().getExeData();
 				std::string text = exeData.charCreation.confirmRace;
@@ -89,7 +89,7 @@ ChooseRacePanel::ChooseRacePanel(Game &game, const CharacterClass &charClass,
 					(Renderer::ORIGINAL_WIDTH / 2),
 					(Renderer::ORIGINAL_HEIGHT / 2) - 22);
 
-				return std::make_unique<TextBox>(center, richText, renderer);
+				return std::make_unique<TextBox>(center, richText);
 			}();
 
 			messageBoxTitle.texture = [&textureManager, &renderer, &messageBoxTitle]()
@@ -106,7 +106,7 @@ ChooseRacePanel::ChooseRacePanel(Game &game, const CharacterClass &charClass,
 				(messageBoxTitle.texture.getHeight() / 2) - 21;
 
 			MessageBoxSubPanel::Element messageBoxYes;
-			messageBoxYes.textBox = [&game, &renderer, &textColor]()
+			messageBoxYes.textBox = [&game, &textColor]()
 			{
 				const RichTextString richText(
 					"Yes",
@@ -119,7 +119,7 @@ ChooseRacePanel::ChooseRacePanel(Game &game, const CharacterClass &charClass,
 					(Renderer::ORIGINAL_WIDTH / 2) - 1,
 					(Renderer::ORIGINAL_HEIGHT / 2) + 28);
 
-				return std::make_unique<TextBox>(center, richText, renderer);
+				return std::make_unique<TextBox>(center, richText);
 			}();
 
 			messageBoxYes.texture = [&textureManager, &renderer, &messageBoxTitle]()
@@ -365,7 +365,7 @@ ChooseRacePanel::ChooseRacePanel(Game &game, const CharacterClass &charClass,
 				messageBoxTitle.texture.getHeight();
 
 			MessageBoxSubPanel::Element messageBoxNo;
-			messageBoxNo.textBox = [&game, &renderer, &textColor]()
+			messageBoxNo.textBox = [&game, &textColor]()
 			{
 				const RichTextString richText(
 					"No",
@@ -378,7 +378,7 @@ ChooseRacePanel::ChooseRacePanel(Game &game, const CharacterClass &charClass,
 					(Renderer::ORIGINAL_WIDTH / 2) - 1,
 					(Renderer::ORIGINAL_HEIGHT / 2) + 68);
 
-				return std::make_unique<TextBox>(center, richText, renderer);
+				return std::make_unique<TextBox>(center, richText);
 			}();
 
 			messageBoxNo.texture = [&textureManager, &renderer, &messageBoxYes]()
@@ -557,20 +557,21 @@ void ChooseRacePanel::drawProvinceTooltip(int provinceID, Renderer &renderer)
 	const auto &exeData = this->getGame().getMiscAssets().getExeData();
 	const std::string &raceName = exeData.races.pluralNames.at(provinceID);
 
-	const Texture tooltip(Panel::createTooltip(
-		"Land of the " + raceName, FontName::D, this->getGame().getFontManager(), renderer));
+	const TextBox tooltip = Panel::createTooltip(
+		"Land of the " + raceName, FontName::D, this->getGame().getFontManager());
+	const Int2 tooltipDims = Panel::getTooltipDimensions(tooltip);
 
 	const auto &inputManager = this->getGame().getInputManager();
 	const Int2 mousePosition = inputManager.getMousePosition();
 	const Int2 originalPosition = renderer.nativeToOriginal(mousePosition);
 	const int mouseX = originalPosition.x;
 	const int mouseY = originalPosition.y;
-	const int x = ((mouseX + 8 + tooltip.getWidth()) < Renderer::ORIGINAL_WIDTH) ?
-		(mouseX + 8) : (mouseX - tooltip.getWidth());
-	const int y = ((mouseY + tooltip.getHeight()) < Renderer::ORIGINAL_HEIGHT) ?
-		mouseY : (mouseY - tooltip.getHeight());
+	const int x = ((mouseX + 8 + tooltipDims.x) < Renderer::ORIGINAL_WIDTH) ?
+		(mouseX + 8) : (mouseX - tooltipDims.x);
+	const int y = ((mouseY + tooltipDims.y) < Renderer::ORIGINAL_HEIGHT) ?
+		mouseY : (mouseY - tooltipDims.y);
 
-	renderer.drawOriginal(tooltip.get(), x, y);
+	Panel::drawTooltipBox(tooltip, x, y, renderer);
 }
 
 void ChooseRacePanel::render(Renderer &renderer)
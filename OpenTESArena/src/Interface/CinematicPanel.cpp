@@ -1,26 +1,29 @@
-#include <cassert>
+#include <algorithm>
 
 #include "SDL.h"
 
 #include "CinematicPanel.h"
 #include "../Game/Game.h"
-#include "../Media/TextureManager.h"
 #include "../Rendering/Renderer.h"
 #include "../Rendering/Texture.h"
 
-CinematicPanel::CinematicPanel(Game &game,
-	const std::string &paletteName, const std::string &sequenceName,
+CinematicPanel::CinematicPanel(Game &game, const std::string &sequenceName,
 	double secondsPerImage, const std::function<void(Game&)> &endingAction)
-	: Panel(game), paletteName(paletteName), sequenceName(sequenceName)
+	: Panel(game), stream(sequenceName)
 {
 	this->skipButton = [&endingAction]()
 	{
 		return Button<Game&>(endingAction);
 	}();
 
+	auto &renderer = game.getRenderer();
+	this->texture = Texture(renderer.createTexture(Renderer::DEFAULT_PIXELFORMAT,
+		SDL_TEXTUREACCESS_STREAMING, this->stream.getWidth(), this->stream.getHeight()));
+
 	this->secondsPerImage = secondsPerImage;
 	this->currentSeconds = 0.0;
 	this->imageIndex = 0;
+	this->uploadedIndex = -1;
 }
 
 void CinematicPanel::handleEvent(const SDL_Event &e)
@@ -50,18 +53,12 @@ void CinematicPanel::tick(double dt)
 		this->imageIndex++;
 	}
 
-	// Get a reference to all images in the sequence.
-	auto &game = this->getGame();
-	auto &renderer = game.getRenderer();
-	auto &textureManager = game.getTextureManager();
-	const auto &textures = textureManager.getTextures(
-		this->sequenceName, this->paletteName, renderer);
-
 	// If at the end, then prepare for the next panel.
-	if (this->imageIndex >= textures.size())
+	const int frameCount = this->stream.getFrameCount();
+	if (this->imageIndex >= frameCount)
 	{
-		this->imageIndex = static_cast<int>(textures.size() - 1);
-		this->skipButton.click(game);
+		this->imageIndex = std::max(frameCount - 1, 0);
+		this->skipButton.click(this->getGame());
 	}
 }
 
@@ -70,12 +67,20 @@ void CinematicPanel::render(Renderer &renderer)
 	// Clear full screen.
 	renderer.clear();
 
-	// Get a reference to all images in the sequence.
-	auto &textureManager = this->getGame().getTextureManager();
-	const auto &textures = textureManager.getTextures(
-		this->sequenceName, this->paletteName, renderer);
+	if (this->stream.getFrameCount() == 0)
+	{
+		return;
+	}
+
+	// Upload the current frame if it changed since the last render.
+	if (this->imageIndex != this->uploadedIndex)
+	{
+		const uint32_t *pixels = this->stream.getFrame(this->imageIndex);
+		SDL_UpdateTexture(this->texture.get(), nullptr, pixels,
+			this->stream.getWidth() * sizeof(*pixels));
+		this->uploadedIndex = this->imageIndex;
+	}
 
 	// Draw image.
-	const auto &texture = textures.at(this->imageIndex);
-	renderer.drawOriginal(texture.get());
+	renderer.drawOriginal(this->texture.get());
 }
@@ -6,9 +6,12 @@
 
 #include "Button.h"
 #include "Panel.h"
+#include "../Media/FLCStream.h"
+#include "../Rendering/Texture.h"
 
-// Designed for sets of images (i.e., videos) that play one after another and
-// eventually lead to another panel. Skipping is available, too.
+// Designed for videos (i.e., .FLC and .CEL files) that play from start to finish and
+// eventually lead to another panel. Skipping is available, too. Frames are decoded on
+// a background thread as the video plays and uploaded into one streaming texture.
 
 class Game;
 class Renderer;
@@ -17,13 +20,13 @@ class CinematicPanel : public Panel
 {
 private:
 	Button<Game&> skipButton;
-	std::string paletteName;
-	std::string sequenceName;
+	FLCStream stream;
+	Texture texture;
 	double secondsPerImage, currentSeconds;
 	int imageIndex;
+	int uploadedIndex; // Frame currently in the texture, or -1 if none.
 public:
-	CinematicPanel(Game &game, const std::string &paletteName,
-		const std::string &sequenceName, double secondsPerImage,
+	CinematicPanel(Game &game, const std::string &sequenceName, double secondsPerImage,
 		const std::function<void(Game&)> &endingAction);
 	virtual ~CinematicPanel() = default;
 
@@ -80,10 +80,9 @@ void ConsolePanel::render(Renderer &renderer)
 		TextAlignment::Center, // Left acts as Center too for me for no reason
 		game.getFontManager());
 
-	const auto inputBox = std::make_unique<TextBox>(center, richText, game.getRenderer());
+	const auto inputBox = std::make_unique<TextBox>(center, richText);
 
-	renderer.drawOriginal(inputBox->getTexture(),
-			inputBox->getX(), inputBox->getY());
+	inputBox->draw(renderer);
 
 	ConsoleManager consoleManager = game.getConsoleManager();
 
@@ -98,9 +97,8 @@ void ConsolePanel::render(Renderer &renderer)
 			TextAlignment::Left,
 			game.getFontManager());
 
-		const auto lineBox = std::make_unique<TextBox>(center2, richText2, game.getRenderer());
+		const auto lineBox = std::make_unique<TextBox>(center2, richText2);
 
-		renderer.drawOriginal(lineBox->getTexture(),
-				lineBox->getX(), lineBox->getY());
+		lineBox->draw(renderer);
 	}
 }
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <limits>
 
 #include "SDL.h"
 
@@ -100,6 +101,10 @@ namespace
 		CursorAlignment::Bottom,
 		CursorAlignment::Right
 	};
+
+	// Render threads listed one per line in the debug text. With more than this, their
+	// busy times are summarized so the text stays on screen.
+	const int MaxProfilerThreadLines = 4;
 }
 
 GameWorldPanel::GameWorldPanel(Game &game)
@@ -119,7 +124,7 @@ GameWorldPanel::GameWorldPanel(Game &game)
 			TextAlignment::Left,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+		return std::make_unique<TextBox>(x, y, richText);
 	}();
 
 	this->characterSheetButton = []()
@@ -386,8 +391,8 @@ GameWorldPanel::GameWorldPanel(Game &game)
 			{
 				auto &gameData = game.getGameData();
 				const auto &exeData = game.getMiscAssets().getExeData();
-				const auto &worldData = gameData.getWorldData();
-				const auto &level = worldData.getActiveLevel();
+				auto &worldData = gameData.getWorldData();
+				auto &level = worldData.getActiveLevel();
 				const auto &player = gameData.getPlayer();
 				const Location &location = gameData.getLocation();
 				const Double3 &position = player.getPosition();
@@ -419,7 +424,7 @@ GameWorldPanel::GameWorldPanel(Game &game)
 				}();
 
 				game.setPanel<AutomapPanel>(game, Double2(position.x, position.z), 
-					player.getGroundDirection(), level.getVoxelGrid(), automapLocationName);
+					player.getGroundDirection(), level, automapLocationName);
 			}
 			else
 			{
@@ -698,8 +703,7 @@ void GameWorldPanel::handleEvent(const SDL_Event &e)
 		auto textBox = std::make_unique<TextBox>(
 			Int2(0, 0),
 			richText,
-			&shadowData,
-			game.getRenderer());
+			&shadowData);
 
 		// Assign the text box and its duration to the action text.
 		auto &gameData = game.getGameData();
@@ -1530,8 +1534,7 @@ void GameWorldPanel::handleClickInWorld(const Int2 &nativePoint, bool primaryCli
 						auto textBox = std::make_unique<TextBox>(
 							Int2(0, 0),
 							richText,
-							&shadowData,
-							game.getRenderer());
+							&shadowData);
 
 						auto &actionText = gameData.getActionText();
 						const double duration = std::max(2.25,
@@ -1585,8 +1588,7 @@ void GameWorldPanel::handleTriggers(const Int2 &voxel)
 				auto textBox = std::make_unique<TextBox>(
 					Int2(0, 0),
 					richText,
-					&shadowData,
-					game.getRenderer());
+					&shadowData);
 
 				// Assign the text box and its duration to the triggered text member. It will 
 				// be displayed in the render method until the duration is no longer positive.
@@ -1979,15 +1981,16 @@ void GameWorldPanel::handleLevelTransition(const Int2 &playerVoxel, const Int2 &
 
 void GameWorldPanel::drawTooltip(const std::string &text, Renderer &renderer)
 {
-	const Texture tooltip(Panel::createTooltip(
-		text, FontName::D, this->getGame().getFontManager(), renderer));
+	const TextBox tooltip = Panel::createTooltip(
+		text, FontName::D, this->getGame().getFontManager());
+	const Int2 tooltipDims = Panel::getTooltipDimensions(tooltip);
 
 	auto &textureManager = this->getGame().getTextureManager();
 	const auto &gameInterface = textureManager.getTexture(
 		TextureFile::fromName(TextureName::GameWorldInterface), renderer);
 
-	renderer.drawOriginal(tooltip.get(), 0, Renderer::ORIGINAL_HEIGHT -
-		gameInterface.getHeight() - tooltip.getHeight());
+	Panel::drawTooltipBox(tooltip, 0, Renderer::ORIGINAL_HEIGHT -
+		gameInterface.getHeight() - tooltipDims.y, renderer);
 }
 
 void GameWorldPanel::drawCompass(const Double2 &direction, 
@@ -2104,10 +2107,11 @@ void GameWorldPanel::drawDebugText(Renderer &renderer)
 
 	const int x = 2;
 	const int y = 2;
-	const TextBox tempText(x, y, richText, renderer);
+	const TextBox tempText(x, y, richText);
 
-	// Create graph of frame times.
-	const Texture frameTimesGraph = [&renderer, &game, &fpsCounter, targetFps, minFps]()
+	// Create graph of frame times. It's kept until the next frame since the renderer
+	// draws it after this function returns.
+	this->frameTimesGraph = [&renderer, &game, &fpsCounter, targetFps, minFps]()
 	{
 		// Graph maximum is target FPS, minimum is MIN_FPS.
 		const int columnWidth = 1;
@@ -2172,8 +2176,96 @@ void GameWorldPanel::drawDebugText(Renderer &renderer)
 		return renderer.createTextureFromSurface(surface.get());
 	}();
 
-	renderer.drawOriginal(tempText.getTexture(), tempText.getX(), tempText.getY());
-	renderer.drawOriginal(frameTimesGraph.get(), tempText.getX(), 94);
+	// Rolling render phase timings, with per-thread busy time for spotting imbalance.
+	const RenderProfiler &renderProfiler = renderer.getRenderProfiler();
+	const SoftwareRenderer::DebugViewStats &debugViewStats = renderer.getDebugViewStats();
+	const DrawList::Stats &drawListStats = renderer.getDrawListStats();
+	const std::string profilerText = [&renderProfiler, &debugViewStats, &drawListStats]()
+	{
+		std::string text = "Render ms (avg/p99):\n";
+		for (int i = 0; i < RenderProfiler::PHASE_COUNT; i++)
+		{
+			const RenderProfiler::Phase phase = static_cast<RenderProfiler::Phase>(i);
+			const RenderProfiler::Summary summary = renderProfiler.getPhaseSummary(phase);
+			text += std::string(RenderProfiler::getPhaseName(phase)) + ": " +
+				String::fixedPrecision(summary.avg, 2) + "/" +
+				String::fixedPrecision(summary.p99, 2) + "\n";
+		}
+
+		const int threadCount = renderProfiler.getThreadCount();
+		if (threadCount <= MaxProfilerThreadLines)
+		{
+			for (int i = 0; i < threadCount; i++)
+			{
+				const RenderProfiler::Summary summary = renderProfiler.getThreadBusySummary(i);
+				text += "Thread " + std::to_string(i) + ": " +
+					String::fixedPrecision(summary.avg, 2) + "/" +
+					String::fixedPrecision(summary.p99, 2) + "\n";
+			}
+		}
+		else
+		{
+			// Range of the threads' average busy times, plus the slowest thread, which the
+			// others wait on.
+			double minAvg = std::numeric_limits<double>::infinity();
+			double maxAvg = -std::numeric_limits<double>::infinity();
+			int slowestIndex = 0;
+			RenderProfiler::Summary slowestSummary;
+			for (int i = 0; i < threadCount; i++)
+			{
+				const RenderProfiler::Summary summary = renderProfiler.getThreadBusySummary(i);
+				minAvg = std::min(minAvg, summary.avg);
+				if (summary.avg > maxAvg)
+				{
+					maxAvg = summary.avg;
+					slowestIndex = i;
+					slowestSummary = summary;
+				}
+			}
+
+			text += "Threads (" + std::to_string(threadCount) + ") avg: " +
+				String::fixedPrecision(minAvg, 2) + "-" +
+				String::fixedPrecision(maxAvg, 2) + "\n";
+			text += "Slowest (" + std::to_string(slowestIndex) + "): " +
+				String::fixedPrecision(slowestSummary.avg, 2) + "/" +
+				String::fixedPrecision(slowestSummary.p99, 2) + "\n";
+		}
+
+		// Debug view counters (avg/max), only when their view is on.
+		if (debugViewStats.maxOverdraw > 0)
+		{
+			text += "Overdraw: " + String::fixedPrecision(debugViewStats.avgOverdraw, 2) + "/" +
+				std::to_string(debugViewStats.maxOverdraw) + "\n";
+		}
+
+		if (debugViewStats.maxRaySteps > 0)
+		{
+			text += "Ray steps: " + String::fixedPrecision(debugViewStats.avgRaySteps, 1) + "/" +
+				std::to_string(debugViewStats.maxRaySteps) + "\n";
+		}
+
+		// UI draw list counters from the last presented frame.
+		text += "UI draws: " + std::to_string(drawListStats.drawCount) + " (" +
+			std::to_string(drawListStats.batchCount) + " batches, " +
+			std::to_string(drawListStats.textureSwitchCount) + " texture switches)\n";
+
+		return text;
+	}();
+
+	const RichTextString profilerRichText(
+		profilerText,
+		FontName::D,
+		Color::White,
+		TextAlignment::Left,
+		game.getFontManager());
+
+	const TextBox profilerTextBox(0, 0, profilerRichText);
+	const int profilerX = Renderer::ORIGINAL_WIDTH - profilerTextBox.getRect().getWidth() - 2;
+	const int profilerY = 2;
+
+	tempText.draw(renderer);
+	renderer.drawOriginal(this->frameTimesGraph.get(), tempText.getX(), 94);
+	profilerTextBox.draw(profilerX, profilerY, renderer);
 }
 
 void GameWorldPanel::tick(double dt)
@@ -2316,6 +2408,13 @@ void GameWorldPanel::tick(double dt)
 				(newPlayerVoxelXZ.y >= 0) && (newPlayerVoxelXZ.y < voxelGrid.getDepth());
 		}();
 
+		// Explore the automap around the new voxel.
+		if (inVoxelGrid)
+		{
+			auto &level = worldData.getActiveLevel();
+			level.getAutomap().reveal(newPlayerVoxelXZ, level.getVoxelGrid());
+		}
+
 		if (inVoxelGrid && (worldData.getActiveWorldType() == WorldType::Interior))
 		{
 			this->handleTriggers(newPlayerVoxelXZ);
@@ -2405,8 +2504,7 @@ void GameWorldPanel::render(Renderer &renderer)
 		}
 
 		// Draw text: player name.
-		renderer.drawOriginal(this->playerNameTextBox->getTexture(),
-			this->playerNameTextBox->getX(), this->playerNameTextBox->getY());
+		this->playerNameTextBox->draw(renderer);
 	}
 }
 
@@ -2506,25 +2604,25 @@ void GameWorldPanel::renderSecondary(Renderer &renderer)
 	{
 		const auto &triggerTextBox = *triggerText.textBox.get();
 		const int centerX = (Renderer::ORIGINAL_WIDTH / 2) -
-			(triggerTextBox.getSurface()->w / 2) - 1;
+			(triggerTextBox.getRect().getWidth() / 2) - 1;
 		const int centerY = [modernInterface, &gameInterface, &triggerTextBox]()
 		{
 			const int interfaceOffset = modernInterface ?
 				(gameInterface.getHeight() / 2) : gameInterface.getHeight();
 			return Renderer::ORIGINAL_HEIGHT - interfaceOffset -
-				triggerTextBox.getSurface()->h - 2;
+				triggerTextBox.getRect().getHeight() - 2;
 		}();
 
-		renderer.drawOriginal(triggerTextBox.getTexture(), centerX, centerY);
+		triggerTextBox.draw(centerX, centerY, renderer);
 	}
 
 	if (actionText.hasRemainingDuration())
 	{
 		const auto &actionTextBox = *actionText.textBox.get();
 		const int textX = (Renderer::ORIGINAL_WIDTH / 2) -
-			(actionTextBox.getSurface()->w / 2);
+			(actionTextBox.getRect().getWidth() / 2);
 		const int textY = 20;
-		renderer.drawOriginal(actionTextBox.getTexture(), textX, textY);
+		actionTextBox.draw(textX, textY, renderer);
 	}
 
 	// @todo: draw "effect text" (similar to trigger text).
@@ -9,6 +9,7 @@
 #include "TextBox.h"
 #include "../Game/Physics.h"
 #include "../Math/Rect.h"
+#include "../Rendering/Texture.h"
 #include "../World/VoxelData.h"
 
 // When the GameWorldPanel is active, the game world is ticking.
@@ -33,6 +34,7 @@ private:
 	Button<Game&, bool> mapButton;
 	std::array<Rect, 9> nativeCursorRegions;
 	std::vector<Int2> weaponOffsets;
+	Texture frameTimesGraph; // Remade each frame the debug text is shown.
 
 	// Modifies the values in the native cursor regions array so rectangles in
 	// the current window correctly represent regions for different arrow cursors.
@@ -1,8 +1,6 @@
 #include <algorithm>
 #include <cassert>
 
-#include "SDL.h"
-
 #include "ListBox.h"
 #include "RichTextString.h"
 #include "TextAlignment.h"
@@ -16,7 +14,7 @@
 #include "../Utilities/String.h"
 
 ListBox::ListBox(int x, int y, const Color &textColor, const std::vector<std::string> &elements,
-	FontName fontName, int maxDisplayed, FontManager &fontManager, Renderer &renderer)
+	FontName fontName, int maxDisplayed, FontManager &fontManager)
 	: textColor(textColor), point(x, y), fontName(fontName)
 {
 	assert(maxDisplayed > 0);
@@ -46,7 +44,7 @@ ListBox::ListBox(int x, int y, const Color &textColor, const std::vector<std::st
 			fontManager);
 
 		// Store the text box for later.
-		auto textBox = std::make_unique<TextBox>(textBoxX, textBoxY, richText, renderer);
+		auto textBox = std::make_unique<TextBox>(textBoxX, textBoxY, richText);
 		this->textBoxes.push_back(std::move(textBox));
 	}
 
@@ -56,8 +54,7 @@ ListBox::ListBox(int x, int y, const Color &textColor, const std::vector<std::st
 		int maxWidth = 0;
 		for (const auto &textBox : this->textBoxes)
 		{
-			int textBoxWidth;
-			SDL_QueryTexture(textBox->getTexture(), nullptr, nullptr, &textBoxWidth, nullptr);
+			const int textBoxWidth = textBox->getRect().getWidth();
 
 			if (textBoxWidth > maxWidth)
 			{
@@ -70,27 +67,8 @@ ListBox::ListBox(int x, int y, const Color &textColor, const std::vector<std::st
 
 	const int height = font.getCharacterHeight() * maxDisplayed;
 
-	// Create the clear surface. This exists because the text box surfaces can't
-	// currently have an arbitrary size (otherwise they could extend to the end of 
-	// each row), and because SDL_UpdateTexture requires pixels (so this avoids an 
-	// allocation each time the update method is called).
-	this->clearSurface = Surface::createWithFormat(width, height,
-		Renderer::DEFAULT_BPP, Renderer::DEFAULT_PIXELFORMAT);
-	SDL_FillRect(this->clearSurface.get(), nullptr, 
-		SDL_MapRGBA(this->clearSurface.get()->format, 0, 0, 0, 0));
-
-	// Create the visible texture. This will be updated when scrolling the list box.
-	this->texture = renderer.createTexture(Renderer::DEFAULT_PIXELFORMAT,
-		SDL_TEXTUREACCESS_STREAMING, width, height);
-	SDL_SetTextureBlendMode(this->texture, SDL_BLENDMODE_BLEND);
-
-	// Draw the text boxes to the texture.
-	this->updateDisplay();
-}
-
-ListBox::~ListBox()
-{
-	SDL_DestroyTexture(this->texture);
+	this->dimensions = Int2(width, height);
+	this->maxDisplayed = maxDisplayed;
 }
 
 int ListBox::getScrollIndex() const
@@ -105,10 +83,7 @@ int ListBox::getElementCount() const
 
 int ListBox::getMaxDisplayedCount() const
 {
-	int height;
-	SDL_QueryTexture(this->getTexture(), nullptr, nullptr, nullptr, &height);
-
-	return height / this->characterHeight;
+	return this->maxDisplayed;
 }
 
 const Int2 &ListBox::getPoint() const
@@ -116,21 +91,14 @@ const Int2 &ListBox::getPoint() const
 	return this->point;
 }
 
-SDL_Texture *ListBox::getTexture() const
-{
-	return this->texture;
-}
-
-Int2 ListBox::getDimensions() const
+const Int2 &ListBox::getDimensions() const
 {
-	int w, h;
-	SDL_QueryTexture(this->texture, nullptr, nullptr, &w, &h);
-	return Int2(w, h);
+	return this->dimensions;
 }
 
 bool ListBox::contains(const Int2 &point)
 {
-	const Int2 dims = this->getDimensions();
+	const Int2 &dims = this->getDimensions();
 	Rect rect(this->point.x, this->point.y, dims.x, dims.y);
 	return rect.contains(point);
 }
@@ -143,41 +111,27 @@ int ListBox::getClickedIndex(const Int2 &point) const
 	return index;
 }
 
-void ListBox::updateDisplay()
-{
-	// Clear the display texture. Otherwise, remnants of previous text might be left over.
-	SDL_UpdateTexture(this->texture, nullptr,
-		this->clearSurface.get()->pixels, this->clearSurface.get()->pitch);
-
-	// Prepare the range of text boxes that will be displayed.
-	const int totalElements = static_cast<int>(this->textBoxes.size());
-	const int maxDisplayed = this->getMaxDisplayedCount();
-	const int indexEnd = std::min(this->scrollIndex + maxDisplayed, totalElements);
-
-	// Draw the relevant text boxes according to scroll index.
-	for (int i = this->scrollIndex; i < indexEnd; i++)
-	{
-		const SDL_Surface *surface = this->textBoxes.at(i)->getSurface();
-
-		SDL_Rect rect;
-		rect.x = 0;
-		rect.y = (i - this->scrollIndex) * surface->h;
-		rect.w = surface->w;
-		rect.h = surface->h;
-
-		// Update the texture's pixels at the correct height offset.
-		SDL_UpdateTexture(this->texture, &rect, surface->pixels, surface->pitch);
-	}
-}
-
 void ListBox::scrollUp()
 {
 	this->scrollIndex -= 1;
-	this->updateDisplay();
 }
 
 void ListBox::scrollDown()
 {
 	this->scrollIndex += 1;
-	this->updateDisplay();
+}
+
+void ListBox::draw(Renderer &renderer) const
+{
+	// Prepare the range of text boxes that will be displayed.
+	const int totalElements = static_cast<int>(this->textBoxes.size());
+	const int indexStart = std::max(this->scrollIndex, 0);
+	const int indexEnd = std::min(this->scrollIndex + this->maxDisplayed, totalElements);
+
+	// Draw the relevant text boxes according to scroll index.
+	for (int i = indexStart; i < indexEnd; i++)
+	{
+		const int y = this->point.y + ((i - this->scrollIndex) * this->characterHeight);
+		this->textBoxes.at(i)->draw(this->point.x, y, renderer);
+	}
 }
@@ -7,7 +7,6 @@
 
 #include "../Math/Vector2.h"
 #include "../Media/Color.h"
-#include "../Rendering/Surface.h"
 
 // This class defines a list of displayed text boxes. The index of a clicked text 
 // box can be obtained, and the list can be scrolled up and down. A list box is
@@ -22,26 +21,20 @@ class TextBox;
 
 enum class FontName;
 
-struct SDL_Texture;
-
 class ListBox
 {
 private:
 	std::vector<std::unique_ptr<TextBox>> textBoxes;
 	Color textColor;
 	Int2 point;
+	Int2 dimensions;
 	FontName fontName;
-	Surface clearSurface; // For clearing the texture upon updating.
-	SDL_Texture *texture;
 	int scrollIndex;
+	int maxDisplayed;
 	int characterHeight;
-
-	// Updates the texture to show the currently visible text boxes.
-	void updateDisplay();
 public:
 	ListBox(int x, int y, const Color &textColor, const std::vector<std::string> &elements, 
-		FontName fontName, int maxDisplayed, FontManager &fontManager, Renderer &renderer);
-	~ListBox();
+		FontName fontName, int maxDisplayed, FontManager &fontManager);
 
 	// Gets the index of the top-most displayed element.
 	int getScrollIndex() const;
@@ -55,11 +48,8 @@ public:
 	// Gets the top left corner of the list box.
 	const Int2 &getPoint() const;
 
-	// Gets the texture for drawing to the screen.
-	SDL_Texture *getTexture() const;
-
 	// Gets the width and height of the list box.
-	Int2 getDimensions() const;
+	const Int2 &getDimensions() const;
 
 	// Returns whether the given point is within the bounds of the list box.
 	bool contains(const Int2 &point);
@@ -76,6 +66,9 @@ public:
 	// it can keep scrolling down for a really long time.
 	void scrollDown();
 
+	// Draws the currently visible text boxes at the list box's position.
+	void draw(Renderer &renderer) const;
+
 	// Instead of a remove() method, just recreate the list box.
 };
 
@@ -24,34 +24,25 @@
 #include "../Rendering/Texture.h"
 #include "../Utilities/Debug.h"
 #include "../Utilities/File.h"
-#include "../Utilities/Platform.h"
-#include "../Utilities/String.h"
 
 const int LoadSavePanel::SlotCount = 10;
 
 LoadSavePanel::LoadSavePanel(Game &game, LoadSavePanel::Type type)
 	: Panel(game)
 {
-	// Load each name in NAMES.DAT.
-	// - @todo: also check associated save files for each ".0x" index.
-	const std::string savesPath = [&game]()
-	{
-		const std::string &arenaSavesPath = game.getOptions().getMisc_ArenaSavesPath();
-		const bool savesPathIsRelative = File::pathIsRelative(arenaSavesPath);
-		const std::string path = (savesPathIsRelative ? Platform::getBasePath() : "") + arenaSavesPath;
-		return String::addTrailingSlashIfMissing(path);
-	}();
+	// Load each slot's name from NAMES.DAT. The slot records aren't read until one is loaded.
+	const std::string savesPath = game.getArenaSavesPath();
 
 	if (File::exists(savesPath + "NAMES.DAT"))
 	{
-		const auto names = ArenaSave::loadNAMES(savesPath);
+		const auto slotHeaders = ArenaSave::loadSlotHeaders(savesPath);
 		for (int i = 0; i < LoadSavePanel::SlotCount; i++)
 		{
-			const auto &entry = names->entries.at(i);
+			const ArenaSave::SlotHeader &slotHeader = slotHeaders.at(i);
 
 			const Int2 center(Renderer::ORIGINAL_WIDTH / 2, 8 + (i * 14));
 			const RichTextString richText(
-				std::string(entry.name.data()),
+				slotHeader.name,
 				FontName::Arena,
 				Color::White,
 				TextAlignment::Center,
@@ -59,7 +50,7 @@ LoadSavePanel::LoadSavePanel(Game &game, LoadSavePanel::Type type)
 
 			// Create text box from entry text.
 			this->saveTextBoxes.at(i) = std::make_unique<TextBox>(
-				center, richText, game.getRenderer());
+				center, richText);
 		}
 	}
 	else
@@ -146,6 +137,12 @@ int LoadSavePanel::getClickedIndex(const Int2 &point)
 	return -1;
 }
 
+bool LoadSavePanel::tracksDirtyRegions() const
+{
+	// Nothing changes until another panel is opened.
+	return true;
+}
+
 std::pair<SDL_Texture*, CursorAlignment> LoadSavePanel::getCurrentCursor() const
 {
 	auto &game = this->getGame();
@@ -203,8 +200,7 @@ void LoadSavePanel::render(Renderer &renderer)
 		if (textBox.get() != nullptr)
 		{
 			const Rect textBoxRect = textBox->getRect();
-			renderer.drawOriginal(textBox->getTexture(),
-				textBoxRect.getLeft(), textBoxRect.getTop());
+			textBox->draw(textBoxRect.getLeft(), textBoxRect.getTop(), renderer);
 		}
 	}
 }
@@ -28,6 +28,7 @@ public:
 	LoadSavePanel(Game &game, LoadSavePanel::Type type);
 	virtual ~LoadSavePanel() = default;
 
+	virtual bool tracksDirtyRegions() const override;
 	virtual std::pair<SDL_Texture*, CursorAlignment> getCurrentCursor() const override;
 	virtual void handleEvent(const SDL_Event &e) override;
 	virtual void render(Renderer &renderer) override;
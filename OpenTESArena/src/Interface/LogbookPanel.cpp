@@ -43,7 +43,7 @@ LogbookPanel::LogbookPanel(Game &game)
 			TextAlignment::Center,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(center, richText, game.getRenderer());
+		return std::make_unique<TextBox>(center, richText);
 	}();
 
 	this->backButton = []()
@@ -60,6 +60,12 @@ LogbookPanel::LogbookPanel(Game &game)
 	}();
 }
 
+bool LogbookPanel::tracksDirtyRegions() const
+{
+	// Nothing changes until another panel is opened.
+	return true;
+}
+
 std::pair<SDL_Texture*, CursorAlignment> LogbookPanel::getCurrentCursor() const
 {
 	auto &game = this->getGame();
@@ -113,6 +119,5 @@ void LogbookPanel::render(Renderer &renderer)
 	renderer.drawOriginal(logbookBackground.get());
 
 	// Draw text: title.
-	renderer.drawOriginal(this->titleTextBox->getTexture(),
-		this->titleTextBox->getX(), this->titleTextBox->getY());
+	this->titleTextBox->draw(renderer);
 }
@@ -211,7 +211,6 @@ MainMenuPanel::MainMenuPanel(Game &game)
 
 			game.setPanel<CinematicPanel>(
 				game,
-				PaletteFile::fromName(PaletteName::Default),
 				TextureFile::fromName(TextureSequenceName::OpeningScroll),
 				1.0 / 24.0,
 				changeToNewGameStory);
@@ -725,6 +724,12 @@ WorldType MainMenuPanel::getSelectedTestWorldType() const
 	}
 }
 
+bool MainMenuPanel::tracksDirtyRegions() const
+{
+	// Only the quick start test values change, and they invalidate their text.
+	return true;
+}
+
 std::pair<SDL_Texture*, CursorAlignment> MainMenuPanel::getCurrentCursor() const
 {
 	auto &game = this->getGame();
@@ -744,6 +749,12 @@ void MainMenuPanel::handleEvent(const SDL_Event &e)
 	bool ePressed = inputManager.keyPressed(e, SDLK_e);
 	bool fPressed = inputManager.keyPressed(e, SDLK_f);
 
+	// Remember the test values so their text can be redrawn if they change.
+	const int oldTestType = this->testType;
+	const int oldTestIndex = this->testIndex;
+	const int oldTestIndex2 = this->testIndex2;
+	const int oldTestWeather = this->testWeather;
+
 	if (lPressed)
 	{
 		this->loadButton.click(this->getGame());
@@ -852,6 +863,19 @@ void MainMenuPanel::handleEvent(const SDL_Event &e)
 			}
 		}
 	}
+
+	// The test text is right-aligned to its arrows and changes width, so redraw the
+	// strip at the bottom of the screen that it's in.
+	const bool testValuesChanged = (this->testType != oldTestType) ||
+		(this->testIndex != oldTestIndex) || (this->testIndex2 != oldTestIndex2) ||
+		(this->testWeather != oldTestWeather);
+
+	if (testValuesChanged)
+	{
+		const int testTextTop = this->testWeatherUpButton.getY();
+		this->invalidate(Rect(0, testTextTop, Renderer::ORIGINAL_WIDTH,
+			Renderer::ORIGINAL_HEIGHT - testTextTop));
+	}
 }
 
 void MainMenuPanel::render(Renderer &renderer)
@@ -889,12 +913,16 @@ void MainMenuPanel::render(Renderer &renderer)
 			this->testWeatherUpButton.getY());
 	}
 
-	const Texture testButton = Texture::generate(
-		Texture::PatternType::Custom1, TestButtonRect.getWidth(), 
-		TestButtonRect.getHeight(), textureManager, renderer);
-	renderer.drawOriginal(testButton.get(), 
+	if (this->testButtonTexture.get() == nullptr)
+	{
+		this->testButtonTexture = Texture::generate(
+			Texture::PatternType::Custom1, TestButtonRect.getWidth(), 
+			TestButtonRect.getHeight(), textureManager, renderer);
+	}
+
+	renderer.drawOriginal(this->testButtonTexture.get(), 
 		TestButtonRect.getLeft(), TestButtonRect.getTop(),
-		testButton.getWidth(), testButton.getHeight());
+		this->testButtonTexture.getWidth(), this->testButtonTexture.getHeight());
 
 	// Draw test text.
 	const RichTextString testButtonText(
@@ -907,10 +935,9 @@ void MainMenuPanel::render(Renderer &renderer)
 	const Int2 testButtonTextBoxPoint(
 		TestButtonRect.getLeft() + (TestButtonRect.getWidth() / 2),
 		TestButtonRect.getTop() + (TestButtonRect.getHeight() / 2));
-	const TextBox testButtonTextBox(testButtonTextBoxPoint, testButtonText, renderer);
+	const TextBox testButtonTextBox(testButtonTextBoxPoint, testButtonText);
 
-	renderer.drawOriginal(testButtonTextBox.getTexture(),
-		testButtonTextBox.getX(), testButtonTextBox.getY());
+	testButtonTextBox.draw(renderer);
 
 	const std::string testTypeName = [this]()
 	{
@@ -947,10 +974,9 @@ void MainMenuPanel::render(Renderer &renderer)
 		testTypeText.getDimensions().x - 2;
 	const int testTypeTextBoxY = this->testTypeUpButton.getY() +
 		(testTypeText.getDimensions().y / 2);
-	const TextBox testTypeTextBox(testTypeTextBoxX, testTypeTextBoxY, testTypeText, renderer);
+	const TextBox testTypeTextBox(testTypeTextBoxX, testTypeTextBoxY, testTypeText);
 
-	renderer.drawOriginal(testTypeTextBox.getTexture(),
-		testTypeTextBox.getX(), testTypeTextBox.getY());
+	testTypeTextBox.draw(renderer);
 
 	const RichTextString testNameText(
 		"Test location: " + this->getSelectedTestName(),
@@ -962,9 +988,8 @@ void MainMenuPanel::render(Renderer &renderer)
 		testNameText.getDimensions().x - 2;
 	const int testNameTextBoxY = this->testIndexUpButton.getY() +
 		(testNameText.getDimensions().y / 2);
-	const TextBox testNameTextBox(testNameTextBoxX, testNameTextBoxY, testNameText, renderer);
-	renderer.drawOriginal(testNameTextBox.getTexture(),
-		testNameTextBox.getX(), testNameTextBox.getY());
+	const TextBox testNameTextBox(testNameTextBoxX, testNameTextBoxY, testNameText);
+	testNameTextBox.draw(renderer);
 
 	// Draw weather text if applicable.
 	if ((this->testType == TestType_City) || (this->testType == TestType_Wilderness))
@@ -984,9 +1009,8 @@ void MainMenuPanel::render(Renderer &renderer)
 		const int testWeatherTextBoxY = this->testWeatherUpButton.getY() +
 			(testWeatherText.getDimensions().y / 2);
 		const TextBox testWeatherTextBox(
-			testWeatherTextBoxX, testWeatherTextBoxY, testWeatherText, renderer);
+			testWeatherTextBoxX, testWeatherTextBoxY, testWeatherText);
 
-		renderer.drawOriginal(testWeatherTextBox.getTexture(),
-			testWeatherTextBox.getX(), testWeatherTextBox.getY());
+		testWeatherTextBox.draw(renderer);
 	}
 }
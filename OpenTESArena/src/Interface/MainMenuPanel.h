@@ -5,6 +5,7 @@
 
 #include "Button.h"
 #include "Panel.h"
+#include "../Rendering/Texture.h"
 
 class Renderer;
 
@@ -20,6 +21,7 @@ private:
 	Button<MainMenuPanel&> testTypeUpButton, testTypeDownButton, testIndexUpButton,
 		testIndexDownButton, testIndex2UpButton, testIndex2DownButton, testWeatherUpButton,
 		testWeatherDownButton;
+	Texture testButtonTexture; // Generated on the first frame.
 	int testType, testIndex, testIndex2, testWeather; // Test values for quickstart.
 
 	std::string getSelectedTestName() const;
@@ -29,6 +31,7 @@ public:
 	MainMenuPanel(Game &game);
 	virtual ~MainMenuPanel() = default;
 
+	virtual bool tracksDirtyRegions() const override;
 	virtual std::pair<SDL_Texture*, CursorAlignment> getCurrentCursor() const override;
 	virtual void handleEvent(const SDL_Event &e) override;
 	virtual void render(Renderer &renderer) override;
@@ -52,7 +52,7 @@ MainQuestSplashPanel::MainQuestSplashPanel(Game &game, int provinceID)
 		
 		const int x = (Renderer::ORIGINAL_WIDTH / 2) - (richText.getDimensions().x / 2);
 		const int y = 133;
-		return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+		return std::make_unique<TextBox>(x, y, richText);
 	}();
 
 	this->exitButton = []()
@@ -127,6 +127,5 @@ void MainQuestSplashPanel::render(Renderer &renderer)
 	renderer.drawOriginal(splashImage.get());
 
 	// Draw text.
-	renderer.drawOriginal(this->textBox->getTexture(),
-		this->textBox->getX(), this->textBox->getY());
+	this->textBox->draw(renderer);
 }
@@ -74,15 +74,13 @@ void MessageBoxSubPanel::render(Renderer &renderer)
 	// Draw title.
 	renderer.drawOriginal(this->title.texture.get(),
 		this->title.textureX, this->title.textureY);
-	renderer.drawOriginal(this->title.textBox->getTexture(),
-		this->title.textBox->getX(), this->title.textBox->getY());
+	this->title.textBox->draw(renderer);
 
 	// Draw elements.
 	for (const auto &element : this->elements)
 	{
 		renderer.drawOriginal(element.texture.get(),
 			element.textureX, element.textureY);
-		renderer.drawOriginal(element.textBox->getTexture(),
-			element.textBox->getX(), element.textBox->getY());
+		element.textBox->draw(renderer);
 	}
 }
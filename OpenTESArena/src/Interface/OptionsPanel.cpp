@@ -262,7 +262,7 @@ OptionsPanel::OptionsPanel(Game &game)
 			TextAlignment::Center,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(center, richText, game.getRenderer());
+		return std::make_unique<TextBox>(center, richText);
 	}();
 
 	this->backToPauseMenuTextBox = [&game]()
@@ -278,7 +278,7 @@ OptionsPanel::OptionsPanel(Game &game)
 			TextAlignment::Center,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(center, richText, game.getRenderer());
+		return std::make_unique<TextBox>(center, richText);
 	}();
 
 	// Lambda for creating tab text boxes.
@@ -292,7 +292,7 @@ OptionsPanel::OptionsPanel(Game &game)
 			game.getFontManager());
 
 		return std::make_unique<TextBox>(
-			center, richText, game.getRenderer());
+			center, richText);
 	};
 
 	const Int2 initialTabCenter(
@@ -338,6 +338,7 @@ OptionsPanel::OptionsPanel(Game &game)
 			if (!tabsAreEqual)
 			{
 				panel.updateVisibleOptionTextBoxes();
+				panel.invalidate();
 			}
 		};
 
@@ -672,6 +673,7 @@ OptionsPanel::OptionsPanel(Game &game)
 
 	// Set initial tab.
 	this->tab = OptionsPanel::Tab::Graphics;
+	this->highlightedOptionIndex = -1;
 
 	// Initialize all option text boxes for the initial tab.
 	this->updateVisibleOptionTextBoxes();
@@ -706,6 +708,16 @@ std::vector<std::unique_ptr<OptionsPanel::Option>> &OptionsPanel::getVisibleOpti
 	}
 }
 
+Rect OptionsPanel::getOptionRect(int index) const
+{
+	const int optionTextBoxHeight = this->currentTabTextBoxes.at(index)->getRect().getHeight();
+	return Rect(
+		ListOrigin.x,
+		ListOrigin.y + (optionTextBoxHeight * index),
+		ListDimensions.x,
+		optionTextBoxHeight);
+}
+
 void OptionsPanel::updateOptionTextBox(int index)
 {
 	auto &game = this->getGame();
@@ -721,8 +733,7 @@ void OptionsPanel::updateOptionTextBox(int index)
 	this->currentTabTextBoxes.at(index) = std::make_unique<TextBox>(
 		ListOrigin.x,
 		ListOrigin.y + (richText.getDimensions().y * index),
-		richText,
-		game.getRenderer());
+		richText);
 }
 
 void OptionsPanel::updateVisibleOptionTextBoxes()
@@ -753,11 +764,15 @@ void OptionsPanel::drawDescription(const std::string &text, Renderer &renderer)
 	auto descriptionTextBox = std::make_unique<TextBox>(
 		DescriptionOrigin.x,
 		DescriptionOrigin.y,
-		richText,
-		game.getRenderer());
+		richText);
 
-	renderer.drawOriginal(descriptionTextBox->getTexture(),
-		descriptionTextBox->getX(), descriptionTextBox->getY());
+	descriptionTextBox->draw(renderer);
+}
+
+bool OptionsPanel::tracksDirtyRegions() const
+{
+	// Highlights and option changes invalidate what they affect.
+	return true;
 }
 
 std::pair<SDL_Texture*, CursorAlignment> OptionsPanel::getCurrentCursor() const
@@ -823,16 +838,8 @@ void OptionsPanel::handleEvent(const SDL_Event &e)
 
 		for (int i = 0; i < static_cast<int>(visibleOptions.size()); i++)
 		{
-			const auto &optionTextBox = this->currentTabTextBoxes.at(i);
-			const int optionTextBoxHeight = optionTextBox->getRect().getHeight();
-
-			const Rect optionRect(
-				ListOrigin.x,
-				ListOrigin.y + (optionTextBoxHeight * i),
-				ListDimensions.x,
-				optionTextBoxHeight);
-
 			// See if the option's rectangle contains the mouse click.
+			const Rect optionRect = this->getOptionRect(i);
 			if (optionRect.contains(originalPoint))
 			{
 				auto &option = visibleOptions.at(i);
@@ -907,14 +914,59 @@ void OptionsPanel::handleEvent(const SDL_Event &e)
 					tryDecrement();
 				}
 
-				// Update option text.
+				// Update option text. Some options (letterbox mode, etc.) affect the
+				// whole screen, so redraw all of it.
 				this->updateOptionTextBox(i);
+				this->invalidate();
 				break;
 			}
 		}
 	}
 }
 
+void OptionsPanel::tick(double dt)
+{
+	static_cast<void>(dt);
+
+	auto &game = this->getGame();
+	const Int2 mousePosition = game.getInputManager().getMousePosition();
+	const Int2 originalPosition = game.getRenderer().nativeToOriginal(mousePosition);
+
+	// Find the option under the mouse, if any.
+	int newHighlightedOptionIndex = -1;
+	const int visibleOptionCount = static_cast<int>(this->currentTabTextBoxes.size());
+	for (int i = 0; i < visibleOptionCount; i++)
+	{
+		if (this->getOptionRect(i).contains(originalPosition))
+		{
+			newHighlightedOptionIndex = i;
+			break;
+		}
+	}
+
+	// Redraw the highlights and description when moving to a different option.
+	if (newHighlightedOptionIndex != this->highlightedOptionIndex)
+	{
+		if (this->highlightedOptionIndex != -1)
+		{
+			this->invalidate(this->getOptionRect(this->highlightedOptionIndex));
+		}
+
+		if (newHighlightedOptionIndex != -1)
+		{
+			this->invalidate(this->getOptionRect(newHighlightedOptionIndex));
+		}
+
+		this->invalidate(Rect(
+			DescriptionOrigin.x,
+			DescriptionOrigin.y,
+			Renderer::ORIGINAL_WIDTH - DescriptionOrigin.x,
+			Renderer::ORIGINAL_HEIGHT - DescriptionOrigin.y));
+
+		this->highlightedOptionIndex = newHighlightedOptionIndex;
+	}
+}
+
 void OptionsPanel::render(Renderer &renderer)
 {
 	// Clear full screen.
@@ -929,77 +981,63 @@ void OptionsPanel::render(Renderer &renderer)
 	renderer.clearOriginal(backgroundColor);
 
 	// Draw return button and tabs.
-	Texture tabBackground = Texture::generate(Texture::PatternType::Custom1,
-		GraphicsTabRect.getWidth(), GraphicsTabRect.getHeight(), textureManager, renderer);
+	if (this->tabBackground.get() == nullptr)
+	{
+		this->tabBackground = Texture::generate(Texture::PatternType::Custom1,
+			GraphicsTabRect.getWidth(), GraphicsTabRect.getHeight(), textureManager, renderer);
+	}
+
 	for (int i = 0; i < 5; i++)
 	{
-		renderer.drawOriginal(tabBackground.get(),
+		renderer.drawOriginal(this->tabBackground.get(),
 			GraphicsTabRect.getLeft(),
-			GraphicsTabRect.getTop() + (tabBackground.getHeight() * i));
+			GraphicsTabRect.getTop() + (this->tabBackground.getHeight() * i));
 	}
 
-	Texture returnBackground = Texture::generate(Texture::PatternType::Custom1,
-		this->backToPauseMenuButton.getWidth(), this->backToPauseMenuButton.getHeight(),
-		textureManager, renderer);
-	renderer.drawOriginal(returnBackground.get(), this->backToPauseMenuButton.getX(),
+	if (this->returnBackground.get() == nullptr)
+	{
+		this->returnBackground = Texture::generate(Texture::PatternType::Custom1,
+			this->backToPauseMenuButton.getWidth(), this->backToPauseMenuButton.getHeight(),
+			textureManager, renderer);
+	}
+
+	renderer.drawOriginal(this->returnBackground.get(), this->backToPauseMenuButton.getX(),
 		this->backToPauseMenuButton.getY());
 
 	// Draw text.
-	renderer.drawOriginal(this->titleTextBox->getTexture(),
-		this->titleTextBox->getX(), this->titleTextBox->getY());
-	renderer.drawOriginal(this->backToPauseMenuTextBox->getTexture(),
-		this->backToPauseMenuTextBox->getX(), this->backToPauseMenuTextBox->getY());
-	renderer.drawOriginal(this->graphicsTextBox->getTexture(),
-		this->graphicsTextBox->getX(), this->graphicsTextBox->getY());
-	renderer.drawOriginal(this->audioTextBox->getTexture(),
-		this->audioTextBox->getX(), this->audioTextBox->getY());
-	renderer.drawOriginal(this->inputTextBox->getTexture(),
-		this->inputTextBox->getX(), this->inputTextBox->getY());
-	renderer.drawOriginal(this->miscTextBox->getTexture(),
-		this->miscTextBox->getX(), this->miscTextBox->getY());
-	renderer.drawOriginal(this->devTextBox->getTexture(),
-		this->devTextBox->getX(), this->devTextBox->getY());
-
-	const auto &inputManager = this->getGame().getInputManager();
-	const Int2 mousePosition = inputManager.getMousePosition();
-	const Int2 originalPosition = renderer.nativeToOriginal(mousePosition);
-
-	// Draw each option's text.
+	this->titleTextBox->draw(renderer);
+	this->backToPauseMenuTextBox->draw(renderer);
+	this->graphicsTextBox->draw(renderer);
+	this->audioTextBox->draw(renderer);
+	this->inputTextBox->draw(renderer);
+	this->miscTextBox->draw(renderer);
+	this->devTextBox->draw(renderer);
+
+	// Draw each option's text. The highlighted option is the one found under the mouse
+	// by the last tick.
 	const auto &visibleOptions = this->getVisibleOptions();
-	int highlightedOptionIndex = -1;
+	const bool hasHighlightedOption = (this->highlightedOptionIndex >= 0) &&
+		(this->highlightedOptionIndex < static_cast<int>(visibleOptions.size()));
 	for (int i = 0; i < static_cast<int>(visibleOptions.size()); i++)
 	{
-		const auto &optionTextBox = this->currentTabTextBoxes.at(i);
-		const int optionTextBoxHeight = optionTextBox->getRect().getHeight();
-		const Rect optionRect(
-			ListOrigin.x,
-			ListOrigin.y + (optionTextBoxHeight * i),
-			ListDimensions.x,
-			optionTextBoxHeight);
-
-		const bool optionRectContainsMouse = optionRect.contains(originalPosition);
-
-		// If the options rect contains the mouse cursor, highlight it before drawing text.
-		if (optionRectContainsMouse)
+		// If the mouse is over the option, highlight it before drawing text.
+		if (hasHighlightedOption && (i == this->highlightedOptionIndex))
 		{
+			const Rect optionRect = this->getOptionRect(i);
 			const Color highlightColor = backgroundColor + Color(20, 20, 20);
 			renderer.fillOriginalRect(highlightColor,
 				optionRect.getLeft(), optionRect.getTop(),
 				optionRect.getWidth(), optionRect.getHeight());
-
-			// Store the highlighted option index for tooltip drawing.
-			highlightedOptionIndex = i;
 		}
 
 		// Draw option text.
-		renderer.drawOriginal(optionTextBox->getTexture(),
-			optionTextBox->getX(), optionTextBox->getY());
+		this->currentTabTextBoxes.at(i)->draw(renderer);
 	}
 
 	// Draw description if hovering over an option with a non-empty tooltip.
-	if (highlightedOptionIndex != -1)
+	if (hasHighlightedOption)
 	{
-		const auto &visibleOption = visibleOptions.at(highlightedOptionIndex);
+		const auto &visibleOption = visibleOptions.at(this->highlightedOptionIndex);
 		const std::string &tooltip = visibleOption->getTooltip();
 
 		// Only draw if the tooltip has text.
@@ -8,7 +8,9 @@
 
 #include "Button.h"
 #include "Panel.h"
+#include "../Math/Rect.h"
 #include "../Math/Vector2.h"
+#include "../Rendering/Texture.h"
 
 class AudioManager;
 class Options;
@@ -171,11 +173,16 @@ private:
 	std::vector<std::unique_ptr<OptionsPanel::Option>> graphicsOptions, audioOptions,
 		inputOptions, miscOptions, devOptions;
 	std::vector<std::unique_ptr<TextBox>> currentTabTextBoxes;
+	Texture tabBackground, returnBackground; // Generated on the first frame.
 	OptionsPanel::Tab tab;
+	int highlightedOptionIndex; // Visible option under the mouse, or -1.
 
 	// Gets the visible options group based on the current tab.
 	std::vector<std::unique_ptr<OptionsPanel::Option>> &getVisibleOptions();
 
+	// Gets the clickable area of a visible option.
+	Rect getOptionRect(int index) const;
+
 	// Regenerates option text for one option.
 	void updateOptionTextBox(int index);
 
@@ -189,8 +196,10 @@ public:
 	OptionsPanel(Game &game);
 	virtual ~OptionsPanel() = default;
 
+	virtual bool tracksDirtyRegions() const override;
 	virtual std::pair<SDL_Texture*, CursorAlignment> getCurrentCursor() const override;
 	virtual void handleEvent(const SDL_Event &e) override;
+	virtual void tick(double dt) override;
 	virtual void render(Renderer &renderer) override;
 };
 
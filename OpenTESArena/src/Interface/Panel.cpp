@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <vector>
 
 #include "SDL.h"
@@ -28,14 +29,40 @@
 
 #include "components/vfs/manager.hpp"
 
+const int Panel::MAX_DIRTY_RECTS = 4;
+
 Panel::Panel(Game &game)
-	: game(game) { }
+	: game(game)
+{
+	// Nothing has been drawn yet.
+	this->allDirty = true;
+}
+
+namespace
+{
+	// Pixels between the edges of a tooltip's background and its text.
+	const int TooltipPadding = 4;
+
+	bool rectsOverlap(const Rect &a, const Rect &b)
+	{
+		return (a.getLeft() < b.getRight()) && (b.getLeft() < a.getRight()) &&
+			(a.getTop() < b.getBottom()) && (b.getTop() < a.getBottom());
+	}
 
-SDL_Texture *Panel::createTooltip(const std::string &text,
-	FontName fontName, FontManager &fontManager, Renderer &renderer)
+	Rect getRectUnion(const Rect &a, const Rect &b)
+	{
+		const int left = std::min(a.getLeft(), b.getLeft());
+		const int top = std::min(a.getTop(), b.getTop());
+		const int right = std::max(a.getRight(), b.getRight());
+		const int bottom = std::max(a.getBottom(), b.getBottom());
+		return Rect(left, top, right - left, bottom - top);
+	}
+}
+
+TextBox Panel::createTooltip(const std::string &text,
+	FontName fontName, FontManager &fontManager)
 {
 	const Color textColor(255, 255, 255, 255);
-	const Color backColor(32, 32, 32, 192);
 
 	const int x = 0;
 	const int y = 0;
@@ -47,34 +74,26 @@ SDL_Texture *Panel::createTooltip(const std::string &text,
 		TextAlignment::Left,
 		fontManager);
 
-	// Create text.
-	const TextBox textBox(x, y, richText, renderer);
+	return TextBox(x, y, richText);
+}
 
-	SDL_Surface *textSurface = textBox.getSurface();
+Int2 Panel::getTooltipDimensions(const TextBox &tooltip)
+{
+	const Rect rect = tooltip.getRect();
+	return Int2(rect.getWidth() + TooltipPadding, rect.getHeight() + TooltipPadding);
+}
 
-	// Create background. Make it a little bigger than the text box.
-	const int padding = 4;
-	Surface background = Surface::createWithFormat(
-		textSurface->w + padding, textSurface->h + padding,
-		Renderer::DEFAULT_BPP, Renderer::DEFAULT_PIXELFORMAT);
-	SDL_FillRect(background.get(), nullptr, SDL_MapRGBA(background.get()->format,
-		backColor.r, backColor.g, backColor.b, backColor.a));
+void Panel::drawTooltipBox(const TextBox &tooltip, int x, int y, Renderer &renderer)
+{
+	const Color backColor(32, 32, 32, 192);
+
+	// Draw background. Make it a little bigger than the text box.
+	const Int2 dimensions = Panel::getTooltipDimensions(tooltip);
+	renderer.blendOriginalRect(backColor, x, y, dimensions.x, dimensions.y);
 
 	// Offset the text from the top left corner by a bit so it isn't against the side 
 	// of the tooltip (for aesthetic purposes).
-	SDL_Rect rect;
-	rect.x = padding / 2;
-	rect.y = padding / 2;
-	rect.w = textSurface->w;
-	rect.h = textSurface->h;
-
-	// Draw the text onto the background.
-	SDL_BlitSurface(textSurface, nullptr, background.get(), &rect);
-
-	// Create a hardware texture for the tooltip.
-	SDL_Texture *tooltip = renderer.createTextureFromSurface(background.get());
-
-	return tooltip;
+	tooltip.draw(x + (TooltipPadding / 2), y + (TooltipPadding / 2), renderer);
 }
 
 std::unique_ptr<Panel> Panel::defaultPanel(Game &game)
@@ -119,7 +138,6 @@ std::unique_ptr<Panel> Panel::defaultPanel(Game &game)
 	{
 		game.setPanel<CinematicPanel>(
 			game,
-			PaletteFile::fromName(PaletteName::Default),
 			TextureFile::fromName(TextureSequenceName::OpeningScroll),
 			0.042,
 			changeToIntroStory);
@@ -157,7 +175,6 @@ std::unique_ptr<Panel> Panel::defaultPanel(Game &game)
 	{
 		auto introBook = std::make_unique<CinematicPanel>(
 			game,
-			PaletteFile::fromName(PaletteName::Default),
 			TextureFile::fromName(TextureSequenceName::IntroBook),
 			1.0 / 7.0, // 7 fps.
 			changeToTitle);
@@ -207,6 +224,74 @@ Game &Panel::getGame() const
 	return this->game;
 }
 
+bool Panel::tracksDirtyRegions() const
+{
+	// Redrawn every frame by default.
+	return false;
+}
+
+void Panel::invalidate(const Rect &rect)
+{
+	if (this->allDirty || (rect.getWidth() <= 0) || (rect.getHeight() <= 0))
+	{
+		return;
+	}
+
+	// Absorb any regions the new one overlaps so each pixel is only redrawn once. The
+	// union can reach regions it didn't overlap before, so start over after each merge.
+	Rect newRect = rect;
+	for (size_t i = 0; i < this->dirtyRects.size();)
+	{
+		if (rectsOverlap(newRect, this->dirtyRects[i]))
+		{
+			newRect = getRectUnion(newRect, this->dirtyRects[i]);
+			this->dirtyRects.erase(this->dirtyRects.begin() + i);
+			i = 0;
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	this->dirtyRects.push_back(newRect);
+
+	// Each region costs a redraw pass, so past a few it's cheaper to redraw their bounds.
+	if (this->dirtyRects.size() > static_cast<size_t>(Panel::MAX_DIRTY_RECTS))
+	{
+		Rect bounds = this->dirtyRects.front();
+		for (const Rect &dirtyRect : this->dirtyRects)
+		{
+			bounds = getRectUnion(bounds, dirtyRect);
+		}
+
+		this->dirtyRects.clear();
+		this->dirtyRects.push_back(bounds);
+	}
+}
+
+void Panel::invalidate()
+{
+	this->dirtyRects.clear();
+	this->allDirty = true;
+}
+
+bool Panel::isAllDirty() const
+{
+	return this->allDirty;
+}
+
+const std::vector<Rect> &Panel::getDirtyRegions() const
+{
+	return this->dirtyRects;
+}
+
+void Panel::clearDirtyRegions()
+{
+	this->dirtyRects.clear();
+	this->allDirty = false;
+}
+
 void Panel::tick(double dt)
 {
 	// Do nothing by default.
@@ -3,7 +3,9 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "../Math/Rect.h"
 #include "../Math/Vector2.h"
 
 // Each panel interprets user input and draws to the screen. There is only one panel 
@@ -18,6 +20,7 @@ class Color;
 class FontManager;
 class Game;
 class Renderer;
+class TextBox;
 
 enum class CursorAlignment;
 enum class FontName;
@@ -29,12 +32,23 @@ union SDL_Event;
 class Panel
 {
 private:
+	// Most dirty regions kept before they're merged into one.
+	static const int MAX_DIRTY_RECTS;
+
 	Game &game;
+	std::vector<Rect> dirtyRects; // Changed regions in original space, none overlapping.
+	bool allDirty; // Whether the whole screen has changed.
 protected:
-	// Generates a tooltip texture with the default white foreground and gray
-	// background with alpha blending.
-	static SDL_Texture *createTooltip(const std::string &text,
-		FontName fontName, FontManager &fontManager, Renderer &renderer);
+	// Generates a tooltip text box with the default white foreground. It is drawn over a
+	// gray background with alpha blending by Panel::drawTooltipBox().
+	static TextBox createTooltip(const std::string &text,
+		FontName fontName, FontManager &fontManager);
+
+	// Gets the size of a tooltip's background, which is a little bigger than its text.
+	static Int2 getTooltipDimensions(const TextBox &tooltip);
+
+	// Draws a tooltip's background and text with the top left corner at the given point.
+	static void drawTooltipBox(const TextBox &tooltip, int x, int y, Renderer &renderer);
 
 	Game &getGame() const;
 public:
@@ -43,6 +57,23 @@ public:
 
 	static std::unique_ptr<Panel> defaultPanel(Game &game);
 
+	// Whether the panel only needs redrawing in the regions it invalidates. Panels that
+	// don't keep track of their changes are redrawn every frame, which is the default.
+	virtual bool tracksDirtyRegions() const;
+
+	// Marks a region in original (320x200) space, or the whole screen, as changed since
+	// the last frame. Only useful for panels that track dirty regions.
+	void invalidate(const Rect &rect);
+	void invalidate();
+
+	// Gets whether the whole screen has changed, otherwise the regions that have, since
+	// the dirty regions were last cleared.
+	bool isAllDirty() const;
+	const std::vector<Rect> &getDirtyRegions() const;
+
+	// Called by the game once the panel's changes have been drawn.
+	void clearDirtyRegions();
+
 	// Gets the panel's active mouse cursor and alignment. Override this method if
 	// the panel has at least one cursor defined. The texture must be supplied by 
 	// the texture manager.
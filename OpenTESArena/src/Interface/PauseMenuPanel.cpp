@@ -49,7 +49,7 @@ PauseMenuPanel::PauseMenuPanel(Game &game)
 			TextAlignment::Left,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+		return std::make_unique<TextBox>(x, y, richText);
 	}();
 
 	this->musicTextBox = [&game]()
@@ -66,7 +66,7 @@ PauseMenuPanel::PauseMenuPanel(Game &game)
 			TextAlignment::Center,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(center, richText, game.getRenderer());
+		return std::make_unique<TextBox>(center, richText);
 	}();
 
 	this->soundTextBox = [&game]()
@@ -83,7 +83,7 @@ PauseMenuPanel::PauseMenuPanel(Game &game)
 			TextAlignment::Center,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(center, richText, game.getRenderer());
+		return std::make_unique<TextBox>(center, richText);
 	}();
 
 	this->optionsTextBox = [&game]()
@@ -100,7 +100,7 @@ PauseMenuPanel::PauseMenuPanel(Game &game)
 		const TextBox::ShadowData shadowData(Color(101, 77, 24), Int2(-1, 1));
 
 		return std::make_unique<TextBox>(
-			center, richText, &shadowData, game.getRenderer());
+			center, richText, &shadowData);
 	}();
 
 	this->loadButton = []()
@@ -275,7 +275,7 @@ void PauseMenuPanel::updateMusicText(double volume)
 			this->getGame().getFontManager());
 
 		return std::make_unique<TextBox>(
-			center, richText, this->getGame().getRenderer());
+			center, richText);
 	}();
 }
 
@@ -297,7 +297,7 @@ void PauseMenuPanel::updateSoundText(double volume)
 			this->getGame().getFontManager());
 
 		return std::make_unique<TextBox>(
-			center, richText, this->getGame().getRenderer());
+			center, richText);
 	}();
 }
 
@@ -418,19 +418,20 @@ void PauseMenuPanel::render(Renderer &renderer)
 	}
 
 	// Cover up the detail slider with a new options background.
-	Texture optionsBackground = Texture::generate(Texture::PatternType::Custom1,
-		this->optionsButton.getWidth(), this->optionsButton.getHeight(),
-		textureManager, renderer);
-	renderer.drawOriginal(optionsBackground.get(), this->optionsButton.getX(),
+	if (this->optionsBackground.get() == nullptr)
+	{
+		this->optionsBackground = Texture::generate(Texture::PatternType::Custom1,
+			this->optionsButton.getWidth(), this->optionsButton.getHeight(),
+			textureManager, renderer);
+	}
+
+	renderer.drawOriginal(this->optionsBackground.get(), this->optionsButton.getX(),
 		this->optionsButton.getY());
 
 	// Draw text: player's name, music volume, sound volume, options.
-	renderer.drawOriginal(this->playerNameTextBox->getTexture(),
-		this->playerNameTextBox->getX(), this->playerNameTextBox->getY());
-	renderer.drawOriginal(this->musicTextBox->getTexture(),
-		this->musicTextBox->getX(), this->musicTextBox->getY());
-	renderer.drawOriginal(this->soundTextBox->getTexture(),
-		this->soundTextBox->getX(), this->soundTextBox->getY());
-	renderer.drawOriginal(this->optionsTextBox->getTexture(),
-		this->optionsTextBox->getX() - 1, this->optionsTextBox->getY());
+	this->playerNameTextBox->draw(renderer);
+	this->musicTextBox->draw(renderer);
+	this->soundTextBox->draw(renderer);
+	this->optionsTextBox->draw(this->optionsTextBox->getX() - 1,
+		this->optionsTextBox->getY(), renderer);
 }
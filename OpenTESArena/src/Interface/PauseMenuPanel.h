@@ -5,6 +5,7 @@
 
 #include "Button.h"
 #include "Panel.h"
+#include "../Rendering/Texture.h"
 
 class AudioManager;
 class Options;
@@ -20,6 +21,7 @@ private:
 	Button<Game&> newButton, saveButton, resumeButton, optionsButton;
 	Button<Options&, AudioManager&, PauseMenuPanel&> musicUpButton,
 		musicDownButton, soundUpButton, soundDownButton;
+	Texture optionsBackground; // Generated on the first frame.
 
 	void updateMusicText(double volume);
 	void updateSoundText(double volume);
@@ -161,6 +161,8 @@ ProvinceMapPanel::ProvinceMapPanel(Game &game, int provinceID,
 		const std::string &cifName = TextureFile::fromName(TextureName::StaffDungeonIcons);
 		this->staffDungeonCif = std::make_unique<CIFFile>(cifName);
 	}
+
+	this->makeClosestLocationIDs();
 }
 
 void ProvinceMapPanel::trySelectLocation(int selectedLocationID)
@@ -219,13 +221,36 @@ void ProvinceMapPanel::trySelectLocation(int selectedLocationID)
 		const auto &cityData = gameData.getCityDataFile();
 		const Date &currentDate = gameData.getDate();
 
-		// Use a copy of the RNG so displaying the travel pop-up multiple times doesn't
-		// cause different day amounts.
-		ArenaRandom tempRandom = gameData.getRandom();
-		const int travelDays = cityData.getTravelDays(
-			currentLocationID, currentLocation.provinceID,
-			selectedLocationID, this->provinceID, currentDate.getMonth(),
-			gameData.getWeathersArray(), tempRandom, miscAssets);
+		const auto &travelCostRaster = gameData.getTravelCostRaster(miscAssets);
+
+		// Get the days to every visible location at once, each with a copy of the RNG so
+		// displaying the travel pop-up multiple times doesn't cause different day amounts.
+		if (this->locationTravelDays.empty())
+		{
+			const std::array<int, 48> travelDays = cityData.getTravelDays(
+				currentLocationID, currentLocation.provinceID, this->provinceID,
+				currentDate.getMonth(), travelCostRaster, gameData.getRandom(), miscAssets);
+			this->locationTravelDays = std::vector<int>(travelDays.begin(), travelDays.end());
+		}
+
+		const int travelDays = [this, &gameData, &cityData, &currentDate, &miscAssets,
+			&travelCostRaster, &currentLocation, currentLocationID, selectedLocationID]()
+		{
+			const int days = this->locationTravelDays.at(selectedLocationID);
+
+			// Hidden locations (i.e., from the search sub-panel) aren't in the batch.
+			if (days == 0)
+			{
+				ArenaRandom tempRandom = gameData.getRandom();
+				return cityData.getTravelDays(currentLocationID, currentLocation.provinceID,
+					selectedLocationID, this->provinceID, currentDate.getMonth(),
+					travelCostRaster, tempRandom, miscAssets);
+			}
+			else
+			{
+				return days;
+			}
+		}();
 
 		this->travelData = std::make_unique<TravelData>(
 			selectedLocationID, this->provinceID, travelDays);
@@ -332,6 +357,18 @@ std::string ProvinceMapPanel::getBackgroundFilename() const
 
 int ProvinceMapPanel::getClosestLocationID(const Int2 &originalPosition) const
 {
+	// Points on the screen are looked up. Points off of it (i.e., the mouse is outside
+	// the letterbox) are rare, so they're searched for instead.
+	const bool onScreen = (originalPosition.x >= 0) &&
+		(originalPosition.x < Renderer::ORIGINAL_WIDTH) &&
+		(originalPosition.y >= 0) && (originalPosition.y < Renderer::ORIGINAL_HEIGHT);
+
+	if (onScreen)
+	{
+		const int index = originalPosition.x + (originalPosition.y * Renderer::ORIGINAL_WIDTH);
+		return this->closestLocationIDs[index];
+	}
+
 	// Initialize the current closest position to something very far away (watch out for
 	// integer multiplication overflow with closest distance).
 	Int2 closestPosition(-1000, -1000);
@@ -371,6 +408,146 @@ int ProvinceMapPanel::getClosestLocationID(const Int2 &originalPosition) const
 	return closestID;
 }
 
+void ProvinceMapPanel::makeClosestLocationIDs()
+{
+	struct VisibleLocation
+	{
+		Int2 point;
+		int id;
+	};
+
+	// Gather visible locations in ID order, so ties go to the lowest ID like in the search.
+	std::vector<VisibleLocation> visibleLocations;
+	const auto &cityData = this->getGame().getGameData().getCityDataFile();
+	const auto &provinceData = cityData.getProvinceData(this->provinceID);
+	for (int i = 0; i < 48; i++)
+	{
+		const auto &locationData = provinceData.getLocationData(i);
+
+		if (locationData.isVisible())
+		{
+			visibleLocations.push_back(VisibleLocation{ Int2(locationData.x, locationData.y), i });
+		}
+	}
+
+	DebugAssertMsg(visibleLocations.size() > 0, "No visible locations.");
+
+	// Squared distances sort the same as distances, so they're compared directly.
+	this->closestLocationIDs.resize(Renderer::ORIGINAL_WIDTH * Renderer::ORIGINAL_HEIGHT);
+	for (int y = 0; y < Renderer::ORIGINAL_HEIGHT; y++)
+	{
+		for (int x = 0; x < Renderer::ORIGINAL_WIDTH; x++)
+		{
+			int closestID = -1;
+			int closestDistanceSqr = 0;
+			for (const VisibleLocation &location : visibleLocations)
+			{
+				const int dx = location.point.x - x;
+				const int dy = location.point.y - y;
+				const int distanceSqr = (dx * dx) + (dy * dy);
+
+				if ((closestID == -1) || (distanceSqr < closestDistanceSqr))
+				{
+					closestID = location.id;
+					closestDistanceSqr = distanceSqr;
+				}
+			}
+
+			const int index = x + (y * Renderer::ORIGINAL_WIDTH);
+			this->closestLocationIDs[index] = static_cast<uint8_t>(closestID);
+		}
+	}
+}
+
+const CityDataFile::ProvinceData::LocationData *ProvinceMapPanel::getHighlightedLocation(
+	const Location &location, int *outlineIndex) const
+{
+	const auto &cityData = this->getGame().getGameData().getCityDataFile();
+	const auto &province = cityData.getProvinceData(location.provinceID);
+
+	auto getCityLocation = [&province, &location, outlineIndex]()
+	{
+		const int localCityID = location.localCityID;
+
+		if (localCityID < 8)
+		{
+			// City.
+			*outlineIndex = 0;
+			return &province.cityStates.at(localCityID);
+		}
+		else if (localCityID < 16)
+		{
+			// Town.
+			*outlineIndex = 1;
+			return &province.towns.at(localCityID - 8);
+		}
+		else
+		{
+			// Village.
+			*outlineIndex = 2;
+			return &province.villages.at(localCityID - 16);
+		}
+	};
+
+	auto getDungeonLocation = [&province, &location, outlineIndex]()
+	{
+		const int localDungeonID = location.localDungeonID;
+
+		if (localDungeonID == 0)
+		{
+			// Staff dungeon.
+			*outlineIndex = -1;
+			return &province.secondDungeon;
+		}
+		else if (localDungeonID == 1)
+		{
+			// Staff map dungeon.
+			*outlineIndex = 3;
+			return &province.firstDungeon;
+		}
+		else
+		{
+			// Named dungeon.
+			*outlineIndex = 3;
+			return &province.randomDungeons.at(localDungeonID - 2);
+		}
+	};
+
+	// Decide how to highlight the location.
+	if (location.dataType == LocationDataType::City)
+	{
+		return getCityLocation();
+	}
+	else if (location.dataType == LocationDataType::Dungeon)
+	{
+		return getDungeonLocation();
+	}
+	else if (location.dataType == LocationDataType::SpecialCase)
+	{
+		if (location.specialCaseType == Location::SpecialCaseType::StartDungeon)
+		{
+			// The starting dungeon is not technically on the world map (and the original
+			// game doesn't allow the world map to open then, either).
+			return nullptr;
+		}
+		else if (location.specialCaseType == Location::SpecialCaseType::WildDungeon)
+		{
+			// Use the highlight for the city the wild dungeon is in.
+			return getCityLocation();
+		}
+		else
+		{
+			throw DebugException("Bad special location type \"" +
+				std::to_string(static_cast<int>(location.specialCaseType)) + "\".");
+		}
+	}
+	else
+	{
+		throw DebugException("Bad location data type \"" +
+			std::to_string(static_cast<int>(location.dataType)) + "\".");
+	}
+}
+
 std::string ProvinceMapPanel::makeTravelText(int currentLocationID,
 	const Location &currentLocation, int closestLocationID,
 	const ProvinceMapPanel::TravelData &travelData) const
@@ -638,223 +815,194 @@ void ProvinceMapPanel::handleFastTravel()
 	game.setPanel<WorldMapPanel>(game, std::move(this->travelData));
 }
 
-void ProvinceMapPanel::drawCenteredIcon(const Texture &texture,
-	const Int2 &point, Renderer &renderer)
+Surface ProvinceMapPanel::makeStaffDungeonHighlight(LocationHighlightType highlightType) const
 {
-	renderer.drawOriginal(texture.get(),
-		point.x - (texture.getWidth() / 2),
-		point.y - (texture.getHeight() / 2));
+	// Get the palette indices associated with the staff dungeon icon.
+	const CIFFile &iconCif = *this->staffDungeonCif.get();
+	const int cifWidth = iconCif.getWidth(this->provinceID);
+	const int cifHeight = iconCif.getHeight(this->provinceID);
+
+	// Make a copy of the staff dungeon icon with changes based on which
+	// pixels should be highlighted.
+	Surface surface = Surface::createWithFormat(cifWidth, cifHeight,
+		Renderer::DEFAULT_BPP, Renderer::DEFAULT_PIXELFORMAT);
+
+	auto getColorFromIndex = [this, &surface](int paletteIndex)
+	{
+		const Color &color = this->provinceMapPalette.get().at(paletteIndex);
+		return SDL_MapRGBA(surface.get()->format, color.r, color.g, color.b, color.a);
+	};
+
+	const uint32_t highlightColor = getColorFromIndex(
+		(highlightType == ProvinceMapPanel::LocationHighlightType::Current) ?
+		YellowPaletteIndex : RedPaletteIndex);
+
+	// Convert each palette index to its equivalent 32-bit color, changing 
+	// background indices to highlight indices as they are found.
+	const uint8_t *srcPixels = iconCif.getPixels(this->provinceID);
+	uint32_t *dstPixels = static_cast<uint32_t*>(surface.get()->pixels);
+	const int pixelCount = surface.getWidth() * surface.getHeight();
+	std::transform(srcPixels, srcPixels + pixelCount, dstPixels,
+		[&getColorFromIndex, highlightColor](uint8_t srcPixel)
+	{
+		return (srcPixel == BackgroundPaletteIndex) ?
+			highlightColor : getColorFromIndex(srcPixel);
+	});
+
+	return surface;
 }
 
-void ProvinceMapPanel::drawVisibleLocations(const std::string &backgroundFilename,
+void ProvinceMapPanel::makeMapTexture(const std::string &backgroundFilename,
 	TextureManager &textureManager, Renderer &renderer)
 {
+	// Start with a copy of the province map background.
+	const Surface &background = textureManager.getSurface(
+		backgroundFilename, PaletteFile::fromName(PaletteName::BuiltIn));
+	Surface surface = Surface::createWithFormat(background.getWidth(), background.getHeight(),
+		Renderer::DEFAULT_BPP, Renderer::DEFAULT_PIXELFORMAT);
+	SDL_BlitSurface(background.get(), nullptr, surface.get(), nullptr);
+
+	// Lambda for blending an icon onto the map, centered at the given point.
+	auto blitCenteredIcon = [&surface](const Surface &icon, const Int2 &point)
+	{
+		SDL_Rect rect;
+		rect.x = point.x - (icon.getWidth() / 2);
+		rect.y = point.y - (icon.getHeight() / 2);
+		rect.w = icon.getWidth();
+		rect.h = icon.getHeight();
+
+		SDL_BlitSurface(icon.get(), nullptr, surface.get(), &rect);
+	};
+
 	// Lambda for drawing a location icon if it's visible.
-	auto drawIconIfVisible = [this, &renderer](
-		const CityDataFile::ProvinceData::LocationData &location, const Texture &icon)
+	auto blitIconIfVisible = [&blitCenteredIcon](
+		const CityDataFile::ProvinceData::LocationData &location, const Surface &icon)
 	{
 		// Only draw visible locations.
 		if (location.isVisible())
 		{
 			const Int2 point(location.x, location.y);
-			this->drawCenteredIcon(icon, point, renderer);
+			blitCenteredIcon(icon, point);
 		}
 	};
 
-	const auto &cityStateIcon = textureManager.getTexture(
-		TextureFile::fromName(TextureName::CityStateIcon), backgroundFilename, renderer);
-	const auto &townIcon = textureManager.getTexture(
-		TextureFile::fromName(TextureName::TownIcon), backgroundFilename, renderer);
-	const auto &villageIcon = textureManager.getTexture(
-		TextureFile::fromName(TextureName::VillageIcon), backgroundFilename, renderer);
-	const auto &dungeonIcon = textureManager.getTexture(
-		TextureFile::fromName(TextureName::DungeonIcon), backgroundFilename, renderer);
+	const auto &cityStateIcon = textureManager.getSurface(
+		TextureFile::fromName(TextureName::CityStateIcon), backgroundFilename);
+	const auto &townIcon = textureManager.getSurface(
+		TextureFile::fromName(TextureName::TownIcon), backgroundFilename);
+	const auto &villageIcon = textureManager.getSurface(
+		TextureFile::fromName(TextureName::VillageIcon), backgroundFilename);
+	const auto &dungeonIcon = textureManager.getSurface(
+		TextureFile::fromName(TextureName::DungeonIcon), backgroundFilename);
 
-	const auto &cityData = this->getGame().getGameData().getCityDataFile();
+	auto &gameData = this->getGame().getGameData();
+	const auto &cityData = gameData.getCityDataFile();
 	const auto &province = cityData.getProvinceData(this->provinceID);
 
 	// Draw city-state icons.
 	for (const auto &cityState : province.cityStates)
 	{
-		drawIconIfVisible(cityState, cityStateIcon);
+		blitIconIfVisible(cityState, cityStateIcon);
 	}
 
 	// Draw town icons.
 	for (const auto &town : province.towns)
 	{
-		drawIconIfVisible(town, townIcon);
+		blitIconIfVisible(town, townIcon);
 	}
 
 	// Draw village icons.
 	for (const auto &village : province.villages)
 	{
-		drawIconIfVisible(village, villageIcon);
+		blitIconIfVisible(village, villageIcon);
 	}
 
 	// Draw dungeon icons.
-	drawIconIfVisible(province.firstDungeon, dungeonIcon);
+	blitIconIfVisible(province.firstDungeon, dungeonIcon);
 
 	if (this->provinceID != Location::CENTER_PROVINCE_ID)
 	{
 		// Only draw staff dungeon if not the center province.
-		const auto &staffDungeonIcon = textureManager.getTextures(
+		const auto &staffDungeonIcon = textureManager.getSurfaces(
 			TextureFile::fromName(TextureName::StaffDungeonIcons),
-			backgroundFilename, renderer).at(this->provinceID);
-		drawIconIfVisible(province.secondDungeon, staffDungeonIcon);
+			backgroundFilename).at(this->provinceID);
+		blitIconIfVisible(province.secondDungeon, staffDungeonIcon);
 	}
 
 	for (const auto &dungeon : province.randomDungeons)
 	{
-		drawIconIfVisible(dungeon, dungeonIcon);
+		blitIconIfVisible(dungeon, dungeonIcon);
 	}
-}
-
-void ProvinceMapPanel::drawLocationHighlight(const Location &location,
-	LocationHighlightType highlightType, const std::string &backgroundFilename,
-	TextureManager &textureManager, Renderer &renderer)
-{
-	auto drawHighlight = [this, &renderer](
-		const CityDataFile::ProvinceData::LocationData &location, const Texture &highlight)
-	{
-		const Int2 point(location.x, location.y);
-		this->drawCenteredIcon(highlight, point, renderer);
-	};
-
-	const auto &cityData = this->getGame().getGameData().getCityDataFile();
-	const auto &province = cityData.getProvinceData(location.provinceID);
-
-	// Generic highlights (city, town, village, and dungeon).
-	const std::string &outlinesFilename = TextureFile::fromName(
-		(highlightType == ProvinceMapPanel::LocationHighlightType::Current) ?
-		TextureName::MapIconOutlines : TextureName::MapIconOutlinesBlinking);
-	const auto &highlights = textureManager.getTextures(
-		outlinesFilename, backgroundFilename, renderer);
 
-	auto handleCityHighlight = [&renderer, &province, &location,
-		&drawHighlight, &highlights]()
+	// If the player is in this province, highlight their current location.
+	const auto &location = gameData.getLocation();
+	if (this->provinceID == location.provinceID)
 	{
-		const int localCityID = location.localCityID;
+		int outlineIndex;
+		const auto *locationData = this->getHighlightedLocation(location, &outlineIndex);
 
-		if (localCityID < 8)
-		{
-			// City.
-			const auto &highlight = highlights.front();
-			const auto &locationData = province.cityStates.at(localCityID);
-			drawHighlight(locationData, highlight);
-		}
-		else if (localCityID < 16)
-		{
-			// Town.
-			const auto &highlight = highlights.at(1);
-			const auto &locationData = province.towns.at(localCityID - 8);
-			drawHighlight(locationData, highlight);
-		}
-		else
+		if (locationData != nullptr)
 		{
-			// Village.
-			const auto &highlight = highlights.at(2);
-			const auto &locationData = province.villages.at(localCityID - 16);
-			drawHighlight(locationData, highlight);
-		}
-	};
-
-	auto handleDungeonHighlight = [this, &renderer, &textureManager, &backgroundFilename,
-		highlightType, &province, &location, &drawHighlight, &highlights]()
-	{
-		const int localDungeonID = location.localDungeonID;
+			const Int2 point(locationData->x, locationData->y);
 
-		if (localDungeonID == 0)
-		{
-			// Staff dungeon. It changes a value in the palette to give the icon's background
-			// its yellow color (since there are no highlight icons for staff dungeons).
-			const auto &locationData = province.secondDungeon;
-			const Texture highlight = [this, highlightType, &renderer]()
+			if (outlineIndex >= 0)
 			{
-				// Get the palette indices associated with the staff dungeon icon.
-				const CIFFile &iconCif = *this->staffDungeonCif.get();
-				const int cifWidth = iconCif.getWidth(this->provinceID);
-				const int cifHeight = iconCif.getHeight(this->provinceID);
-
-				// Make a copy of the staff dungeon icon with changes based on which
-				// pixels should be highlighted.
-				Surface surface = Surface::createWithFormat(cifWidth, cifHeight,
-					Renderer::DEFAULT_BPP, Renderer::DEFAULT_PIXELFORMAT);
+				const auto &outlines = textureManager.getSurfaces(
+					TextureFile::fromName(TextureName::MapIconOutlines), backgroundFilename);
+				blitCenteredIcon(outlines.at(outlineIndex), point);
+			}
+			else
+			{
+				const Surface highlight = this->makeStaffDungeonHighlight(
+					ProvinceMapPanel::LocationHighlightType::Current);
+				blitCenteredIcon(highlight, point);
+			}
+		}
+	}
 
-				auto getColorFromIndex = [this, highlightType, &surface](int paletteIndex)
-				{
-					const Color &color = this->provinceMapPalette.get().at(paletteIndex);
-					return SDL_MapRGBA(surface.get()->format, color.r, color.g, color.b, color.a);
-				};
-
-				const uint32_t highlightColor = getColorFromIndex(
-					(highlightType == ProvinceMapPanel::LocationHighlightType::Current) ?
-					YellowPaletteIndex : RedPaletteIndex);
-
-				// Convert each palette index to its equivalent 32-bit color, changing 
-				// background indices to highlight indices as they are found.
-				const uint8_t *srcPixels = iconCif.getPixels(this->provinceID);
-				uint32_t *dstPixels = static_cast<uint32_t*>(surface.get()->pixels);
-				const int pixelCount = surface.getWidth() * surface.getHeight();
-				std::transform(srcPixels, srcPixels + pixelCount, dstPixels,
-					[&getColorFromIndex, highlightColor](uint8_t srcPixel)
-				{
-					return (srcPixel == BackgroundPaletteIndex) ?
-						highlightColor : getColorFromIndex(srcPixel);
-				});
+	this->mapTexture = Texture(renderer.createTextureFromSurface(surface.get()));
+}
 
-				Texture texture(renderer.createTextureFromSurface(surface.get()));
-				return texture;
-			}();
+void ProvinceMapPanel::drawCenteredIcon(const Texture &texture,
+	const Int2 &point, Renderer &renderer)
+{
+	renderer.drawOriginal(texture.get(),
+		point.x - (texture.getWidth() / 2),
+		point.y - (texture.getHeight() / 2));
+}
 
-			drawHighlight(locationData, highlight);
-		}
-		else if (localDungeonID == 1)
-		{
-			// Staff map dungeon.
-			const auto &highlight = highlights.at(3);
-			const auto &locationData = province.firstDungeon;
-			drawHighlight(locationData, highlight);
-		}
-		else
-		{
-			// Named dungeon.
-			const auto &highlight = highlights.at(3);
-			const auto &locationData = province.randomDungeons.at(localDungeonID - 2);
-			drawHighlight(locationData, highlight);
-		}
-	};
+void ProvinceMapPanel::drawSelectedLocationHighlight(const Location &location,
+	const std::string &backgroundFilename, TextureManager &textureManager, Renderer &renderer)
+{
+	int outlineIndex;
+	const auto *locationData = this->getHighlightedLocation(location, &outlineIndex);
 
-	// Decide how to highlight the location.
-	if (location.dataType == LocationDataType::City)
+	if (locationData == nullptr)
 	{
-		handleCityHighlight();
+		return;
 	}
-	else if (location.dataType == LocationDataType::Dungeon)
+
+	const Int2 point(locationData->x, locationData->y);
+
+	if (outlineIndex >= 0)
 	{
-		handleDungeonHighlight();
+		const auto &outlines = textureManager.getTextures(
+			TextureFile::fromName(TextureName::MapIconOutlinesBlinking),
+			backgroundFilename, renderer);
+		this->drawCenteredIcon(outlines.at(outlineIndex), point, renderer);
 	}
-	else if (location.dataType == LocationDataType::SpecialCase)
+	else
 	{
-		if (location.specialCaseType == Location::SpecialCaseType::StartDungeon)
-		{
-			// The starting dungeon is not technically on the world map (and the original
-			// game doesn't allow the world map to open then, either).
-		}
-		else if (location.specialCaseType == Location::SpecialCaseType::WildDungeon)
+		// Only made the first time it's drawn, since it doesn't change.
+		if (this->staffDungeonHighlight.get() == nullptr)
 		{
-			// Draw the highlight for the city the wild dungeon is in.
-			handleCityHighlight();
-		}
-		else
-		{
-			throw DebugException("Bad special location type \"" +
-				std::to_string(static_cast<int>(location.specialCaseType)) + "\".");
+			const Surface surface = this->makeStaffDungeonHighlight(
+				ProvinceMapPanel::LocationHighlightType::Selected);
+			this->staffDungeonHighlight = Texture(
+				renderer.createTextureFromSurface(surface.get()));
 		}
-	}
-	else
-	{
-		throw DebugException("Bad location data type \"" +
-			std::to_string(static_cast<int>(location.dataType)) + "\".");
+
+		this->drawCenteredIcon(this->staffDungeonHighlight, point, renderer);
 	}
 }
 
@@ -874,35 +1022,36 @@ void ProvinceMapPanel::drawLocationName(int locationID, Renderer &renderer)
 		this->getGame().getFontManager());
 
 	const TextBox::ShadowData shadowData(Color(48, 48, 48), Int2(1, 0));
-	const TextBox textBox(center - Int2(0, 10), richText, &shadowData, renderer);
+	const TextBox textBox(center - Int2(0, 10), richText, &shadowData);
 
 	// Clamp to screen edges, with some extra space on the left and right.
 	const int x = std::clamp(textBox.getX(),
-		2, Renderer::ORIGINAL_WIDTH - textBox.getSurface()->w - 2);
+		2, Renderer::ORIGINAL_WIDTH - textBox.getRect().getWidth() - 2);
 	const int y = std::clamp(textBox.getY(),
-		2, Renderer::ORIGINAL_HEIGHT - textBox.getSurface()->h - 2);
+		2, Renderer::ORIGINAL_HEIGHT - textBox.getRect().getHeight() - 2);
 
-	renderer.drawOriginal(textBox.getTexture(), x, y);
+	textBox.draw(x, y, renderer);
 }
 
 void ProvinceMapPanel::drawButtonTooltip(ProvinceButtonName buttonName, Renderer &renderer)
 {
 	const std::string &text = ProvinceButtonTooltips.at(buttonName);
 
-	Texture tooltip(Panel::createTooltip(
-		text, FontName::D, this->getGame().getFontManager(), renderer));
+	const TextBox tooltip = Panel::createTooltip(
+		text, FontName::D, this->getGame().getFontManager());
+	const Int2 tooltipDims = Panel::getTooltipDimensions(tooltip);
 
 	const auto &inputManager = this->getGame().getInputManager();
 	const Int2 mousePosition = inputManager.getMousePosition();
 	const Int2 originalPosition = renderer.nativeToOriginal(mousePosition);
 	const int mouseX = originalPosition.x;
 	const int mouseY = originalPosition.y;
-	const int x = ((mouseX + 8 + tooltip.getWidth()) < Renderer::ORIGINAL_WIDTH) ?
-		(mouseX + 8) : (mouseX - tooltip.getWidth());
-	const int y = ((mouseY + tooltip.getHeight()) < Renderer::ORIGINAL_HEIGHT) ?
-		mouseY : (mouseY - tooltip.getHeight());
+	const int x = ((mouseX + 8 + tooltipDims.x) < Renderer::ORIGINAL_WIDTH) ?
+		(mouseX + 8) : (mouseX - tooltipDims.x);
+	const int y = ((mouseY + tooltipDims.y) < Renderer::ORIGINAL_HEIGHT) ?
+		mouseY : (mouseY - tooltipDims.y);
 
-	renderer.drawOriginal(tooltip.get(), x, y);
+	Panel::drawTooltipBox(tooltip, x, y, renderer);
 }
 
 void ProvinceMapPanel::render(Renderer &renderer)
@@ -916,25 +1065,15 @@ void ProvinceMapPanel::render(Renderer &renderer)
 	auto &textureManager = this->getGame().getTextureManager();
 	textureManager.setPalette(PaletteFile::fromName(PaletteName::Default));
 
-	// Draw province map background.
+	// Draw the province map with its location icons and current location highlight.
 	const std::string backgroundFilename = this->getBackgroundFilename();
-	const auto &mapBackground = textureManager.getTexture(
-		backgroundFilename, PaletteFile::fromName(PaletteName::BuiltIn), renderer);
-	renderer.drawOriginal(mapBackground.get());
-
-	// Draw visible location icons.
-	this->drawVisibleLocations(backgroundFilename, textureManager, renderer);
-
-	// If the player is in the current province, highlight their current location.
-	auto &gameData = this->getGame().getGameData();
-	const auto &location = gameData.getLocation();
-	if (this->provinceID == location.provinceID)
+	if (this->mapTexture.get() == nullptr)
 	{
-		const auto highlightType = ProvinceMapPanel::LocationHighlightType::Current;
-		this->drawLocationHighlight(location, highlightType, backgroundFilename,
-			textureManager, renderer);
+		this->makeMapTexture(backgroundFilename, textureManager, renderer);
 	}
 
+	renderer.drawOriginal(this->mapTexture.get());
+
 	// If there is a currently selected location in this province, draw its blinking highlight
 	// if within the "blink on" interval.
 	if ((this->travelData.get() != nullptr) && (this->travelData->provinceID == this->provinceID))
@@ -948,10 +1087,8 @@ void ProvinceMapPanel::render(Renderer &renderer)
 		{
 			const Location selectedLocation = Location::makeFromLocationID(
 				this->travelData->locationID, this->provinceID);
-
-			const auto highlightType = ProvinceMapPanel::LocationHighlightType::Selected;
-			this->drawLocationHighlight(selectedLocation, highlightType,
-				backgroundFilename, textureManager, renderer);
+			this->drawSelectedLocationHighlight(selectedLocation, backgroundFilename,
+				textureManager, renderer);
 		}
 	}
 }
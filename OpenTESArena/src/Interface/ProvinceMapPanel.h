@@ -1,17 +1,21 @@
 #ifndef PROVINCE_MAP_PANEL_H
 #define PROVINCE_MAP_PANEL_H
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "Button.h"
 #include "Panel.h"
 #include "../Assets/CIFFile.h"
+#include "../Assets/CityDataFile.h"
 #include "../Math/Vector2.h"
 #include "../Media/Palette.h"
+#include "../Rendering/Texture.h"
 
 class Location;
 class Renderer;
-class Texture;
+class Surface;
 class TextureManager;
 
 enum class ProvinceButtonName;
@@ -38,6 +42,10 @@ private:
 	Button<Game&, std::unique_ptr<ProvinceMapPanel::TravelData>> backToWorldMapButton;
 	std::unique_ptr<CIFFile> staffDungeonCif; // For obtaining palette indices.
 	std::unique_ptr<TravelData> travelData;
+	Texture mapTexture; // Background, location icons, and current location highlight.
+	Texture staffDungeonHighlight; // Blinking highlight, made the first time it's drawn.
+	std::vector<uint8_t> closestLocationIDs; // Closest visible location to each pixel.
+	std::vector<int> locationTravelDays; // Days to each visible location, made when first needed.
 	Palette provinceMapPalette;
 	double blinkTimer;
 	int provinceID;
@@ -48,6 +56,16 @@ private:
 	// Gets the location ID of the location closest to the mouse in 320x200 space.
 	int getClosestLocationID(const Int2 &originalPosition) const;
 
+	// Finds the closest visible location to every pixel in 320x200 space, so hovering
+	// and clicking don't need to search through all the locations.
+	void makeClosestLocationIDs();
+
+	// Gets the province map data of the location a highlight goes over, and the index of
+	// its outline in the highlight images. The staff dungeon has no outline image, so its
+	// index is -1. Returns null if the location isn't on the province map.
+	const CityDataFile::ProvinceData::LocationData *getHighlightedLocation(
+		const Location &location, int *outlineIndex) const;
+
 	// Generates the pop-up text for traveling to a given destination.
 	std::string makeTravelText(int currentLocationID, const Location &currentLocation,
 		int closestLocationID, const ProvinceMapPanel::TravelData &travelData) const;
@@ -62,16 +80,21 @@ private:
 	// and changing to the game world panel.
 	void handleFastTravel();
 
-	// Draws an icon (i.e., location or highlight) centered at the given point.
-	void drawCenteredIcon(const Texture &texture, const Int2 &point, Renderer &renderer);
+	// Makes a copy of the staff dungeon icon with its background in the highlight color
+	// (since there are no highlight icons for staff dungeons).
+	Surface makeStaffDungeonHighlight(LocationHighlightType highlightType) const;
 
-	// Draws the icons of all visible locations in the province.
-	void drawVisibleLocations(const std::string &backgroundFilename,
+	// Composites the map background, the icons of all visible locations, and the player's
+	// current location highlight (if in this province) into the map texture. None of them
+	// change while the panel is open, so this only happens once.
+	void makeMapTexture(const std::string &backgroundFilename,
 		TextureManager &textureManager, Renderer &renderer);
 
-	// Draws a highlight icon over the given location. Useful for either the player's
-	// current location or the currently selected location for fast travel.
-	void drawLocationHighlight(const Location &location, LocationHighlightType highlightType,
+	// Draws an icon (i.e., location or highlight) centered at the given point.
+	void drawCenteredIcon(const Texture &texture, const Int2 &point, Renderer &renderer);
+
+	// Draws the blinking highlight icon over the location selected for fast travel.
+	void drawSelectedLocationHighlight(const Location &location,
 		const std::string &backgroundFilename, TextureManager &textureManager, Renderer &renderer);
 
 	// Draws the name of a location in the current province. Intended for the location
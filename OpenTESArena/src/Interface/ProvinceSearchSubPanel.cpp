@@ -48,7 +48,7 @@ ProvinceSearchSubPanel::ProvinceSearchSubPanel(Game &game,
 			TextAlignment::Left,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+		return std::make_unique<TextBox>(x, y, richText);
 	}();
 
 	this->textEntryTextBox = [&game]()
@@ -63,7 +63,7 @@ ProvinceSearchSubPanel::ProvinceSearchSubPanel(Game &game,
 			TextAlignment::Left,
 			game.getFontManager());
 
-		return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+		return std::make_unique<TextBox>(x, y, richText);
 	}();
 
 	this->textAcceptButton = []()
@@ -298,8 +298,7 @@ void ProvinceSearchSubPanel::initLocationsListBox()
 			elements,
 			FontName::Arena,
 			maxDisplayed,
-			game.getFontManager(),
-			game.getRenderer());
+			game.getFontManager());
 	}();
 }
 
@@ -347,16 +346,11 @@ void ProvinceSearchSubPanel::handleTextEntryEvent(const SDL_Event &e)
 				const int x = ProvinceSearchSubPanel::DEFAULT_TEXT_CURSOR_POSITION.x;
 				const int y = ProvinceSearchSubPanel::DEFAULT_TEXT_CURSOR_POSITION.y;
 
-				const RichTextString &oldRichText = this->textEntryTextBox->getRichText();
-
-				const RichTextString richText(
-					this->locationName,
-					oldRichText.getFontName(),
-					oldRichText.getColor(),
-					oldRichText.getAlignment(),
-					game.getFontManager());
+				// Only the edited end of the text needs laying out again.
+				RichTextString richText = this->textEntryTextBox->getRichText();
+				richText.setText(this->locationName, game.getFontManager());
 
-				return std::make_unique<TextBox>(x, y, richText, game.getRenderer());
+				return std::make_unique<TextBox>(x, y, richText);
 			}();
 		}
 	}
@@ -458,10 +452,8 @@ void ProvinceSearchSubPanel::renderTextEntry(Renderer &renderer)
 		(Renderer::ORIGINAL_HEIGHT / 2) - (this->parchment.getHeight() / 2) - 1);
 
 	// Draw text: title, location name.
-	renderer.drawOriginal(this->textTitleTextBox->getTexture(),
-		this->textTitleTextBox->getX(), this->textTitleTextBox->getY());
-	renderer.drawOriginal(this->textEntryTextBox->getTexture(),
-		this->textEntryTextBox->getX(), this->textEntryTextBox->getY());
+	this->textTitleTextBox->draw(renderer);
+	this->textEntryTextBox->draw(renderer);
 
 	// @todo: draw blinking cursor.
 }
@@ -480,9 +472,7 @@ void ProvinceSearchSubPanel::renderList(Renderer &renderer)
 		listBackgroundX, listBackgroundY);
 
 	// Draw list box text.
-	renderer.drawOriginal(this->locationsListBox->getTexture(),
-		this->locationsListBox->getPoint().x,
-		this->locationsListBox->getPoint().y);
+	this->locationsListBox->draw(renderer);
 }
 
 void ProvinceSearchSubPanel::render(Renderer &renderer)
@@ -1,11 +1,13 @@
 #ifndef RICH_TEXT_STRING_H
 #define RICH_TEXT_STRING_H
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "../Math/Vector2.h"
 #include "../Media/Color.h"
+#include "../Media/TextLayout.h"
 
 // A formatted string for use with Arena's text boxes.
 
@@ -14,17 +16,13 @@ class FontManager;
 enum class FontName;
 enum class TextAlignment;
 
-struct SDL_Surface;
-
 class RichTextString
 {
 private:
-	std::vector<std::vector<const SDL_Surface*>> surfaceLists; // Surfaces for each line of text.
-	std::vector<int> lineWidths; // Width in pixels for each line of surfaces.
+	std::shared_ptr<const TextLayout> layout; // Shared with other strings of the same text.
 	std::string text;
 	FontName fontName;
 	Color color;
-	Int2 dimensions;
 	TextAlignment alignment;
 	int lineSpacing; // Pixel padding between lines.
 	int characterHeight;
@@ -34,7 +32,7 @@ public:
 	RichTextString(const std::string &text, FontName fontName, const Color &color,
 		TextAlignment alignment, FontManager &fontManager);
 
-	const std::vector<std::vector<const SDL_Surface*>> &getSurfaceLists() const;
+	const TextLayout &getLayout() const;
 	const std::vector<int> &getLineWidths() const;
 	const std::string &getText() const;
 	FontName getFontName() const;
@@ -43,6 +41,13 @@ public:
 	TextAlignment getAlignment() const;
 	int getLineSpacing() const;
 	int getCharacterHeight() const;
+
+	// Changes the text, only laying out again the part after the first changed character.
+	// Intended for text entry, where characters are appended or deleted one at a time.
+	void setText(const std::string &text, FontManager &fontManager);
+
+	// Changes the color. The layout is kept since color is applied when drawing.
+	void setColor(const Color &color);
 };
 
 #endif
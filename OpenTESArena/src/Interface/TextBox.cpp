@@ -1,169 +1,24 @@
 #include <algorithm>
+#include <cmath>
 
-#include "SDL.h"
-
-#include "TextAlignment.h"
 #include "TextBox.h"
 #include "../Math/Rect.h"
-#include "../Media/Font.h"
 #include "../Rendering/Renderer.h"
-#include "../Utilities/Debug.h"
-#include "../Utilities/String.h"
 
-TextBox::TextBox(int x, int y, const RichTextString &richText,
-	const ShadowData *shadow, Renderer &renderer)
+TextBox::TextBox(int x, int y, const RichTextString &richText, const ShadowData *shadow)
 	: richText(richText)
 {
 	this->x = x;
 	this->y = y;
 
-	// Get the width and height of the rich text.
-	const Int2 &dimensions = richText.getDimensions();
-
 	// Get the shadow data (if any).
-	const bool hasShadow = shadow != nullptr;
-	const Color shadowColor = hasShadow ? shadow->color : Color();
-	const Int2 shadowOffset = hasShadow ? shadow->offset : Int2();
-
-	// Create an intermediate surface for blitting each character surface onto
-	// before changing all non-transparent pixels to the desired text color.
-	Surface tempSurface = [&dimensions, &renderer]()
-	{
-		Surface surface = Surface::createWithFormat(dimensions.x, dimensions.y,
-			Renderer::DEFAULT_BPP, Renderer::DEFAULT_PIXELFORMAT);
-		SDL_FillRect(surface.get(), nullptr, SDL_MapRGBA(surface.get()->format, 0, 0, 0, 0));
-
-		return surface;
-	}();
-
-	// Lambda for drawing a surface onto another surface.
-	auto blitToSurface = [](const SDL_Surface *src, int x, int y, Surface &dst)
-	{
-		SDL_Rect rect;
-		rect.x = x;
-		rect.y = y;
-		rect.w = src->w;
-		rect.h = src->h;
-
-		SDL_BlitSurface(const_cast<SDL_Surface*>(src), nullptr, dst.get(), &rect);
-	};
-
-	// Lambda for setting all non-transparent pixels in the temp surface to some color.
-	auto setNonTransparentPixels = [&tempSurface](const Color &color)
-	{
-		uint32_t *pixels = static_cast<uint32_t*>(tempSurface.getPixels());
-		const int pixelCount = tempSurface.getWidth() * tempSurface.getHeight();
-		const uint32_t transparent = SDL_MapRGBA(tempSurface.get()->format, 0, 0, 0, 0);
-		const uint32_t desiredColor = SDL_MapRGBA(tempSurface.get()->format,
-			color.r, color.g, color.b, color.a);
-
-		std::for_each(pixels, pixels + pixelCount,
-			[transparent, desiredColor](uint32_t &pixel)
-		{
-			if (pixel != transparent)
-			{
-				pixel = desiredColor;
-			}
-		});
-	};
-
-	// Lambda for drawing the text to the temp surface with some color.
-	auto drawTempText = [&richText, &dimensions, &tempSurface, &blitToSurface,
-		&setNonTransparentPixels](const Color &color)
-	{
-		// The surface lists are a set of character surfaces for each line of text.
-		const auto &surfaceLists = richText.getSurfaceLists();
-		const TextAlignment alignment = richText.getAlignment();
-
-		// Draw each character's surface onto the intermediate surface based on alignment.
-		if (alignment == TextAlignment::Left)
-		{
-			int yOffset = 0;
-			for (const auto &surfaceList : surfaceLists)
-			{
-				int xOffset = 0;
-				for (auto *surface : surfaceList)
-				{
-					blitToSurface(surface, xOffset, yOffset, tempSurface);
-					xOffset += surface->w;
-				}
-
-				yOffset += richText.getCharacterHeight() + richText.getLineSpacing();
-			}
-		}
-		else if (alignment == TextAlignment::Center)
-		{
-			const std::vector<int> &lineWidths = richText.getLineWidths();
-
-			int yOffset = 0;
-			for (size_t i = 0; i < surfaceLists.size(); i++)
-			{
-				const auto &charSurfaces = surfaceLists.at(i);
-				const int lineWidth = lineWidths.at(i);
-				const int xStart = (dimensions.x / 2) - (lineWidth / 2);
-
-				int xOffset = 0;
-				for (auto *surface : charSurfaces)
-				{
-					blitToSurface(surface, xStart + xOffset, yOffset, tempSurface);
-					xOffset += surface->w;
-				}
-
-				yOffset += richText.getCharacterHeight() + richText.getLineSpacing();
-			}
-		}
-		else
-		{
-			DebugCrash("Alignment \"" +
-				std::to_string(static_cast<int>(alignment)) + "\" unrecognized.");
-		}
-
-		// Change all non-transparent pixels in the scratch surface to the desired 
-		// text colors.
-		setNonTransparentPixels(color);
-	};
-
-	// Create the text box surface itself with proper dimensions (i.e., accounting for
-	// any shadow offset).
-	this->surface = [&tempSurface, &shadowOffset]()
-	{
-		const Int2 surfaceDims(
-			tempSurface.getWidth() + std::abs(shadowOffset.x),
-			tempSurface.getHeight() + std::abs(shadowOffset.y));
-
-		Surface surface = Surface::createWithFormat(surfaceDims.x, surfaceDims.y,
-			Renderer::DEFAULT_BPP, Renderer::DEFAULT_PIXELFORMAT);
-		SDL_FillRect(surface.get(), nullptr, SDL_MapRGBA(surface.get()->format, 0, 0, 0, 0));
-
-		return surface;
-	}();
-
-	// Determine how to fill the text box surface, based on whether it has a shadow.
-	if (hasShadow)
-	{
-		drawTempText(shadowColor);
-		blitToSurface(tempSurface.get(), std::max(shadowOffset.x, 0),
-			std::max(shadowOffset.y, 0), this->surface);
-
-		// Set all shadow pixels in the temp surface to the main color.
-		setNonTransparentPixels(richText.getColor());
-
-		blitToSurface(tempSurface.get(), std::max(-shadowOffset.x, 0),
-			std::max(-shadowOffset.y, 0), this->surface);
-	}
-	else
-	{
-		drawTempText(richText.getColor());
-		blitToSurface(tempSurface.get(), 0, 0, this->surface);
-	}
-
-	// Create the destination SDL textures (keeping the surfaces' color keys).
-	this->texture = Texture(renderer.createTextureFromSurface(this->surface.get()));
+	this->hasShadow = shadow != nullptr;
+	this->shadowColor = this->hasShadow ? shadow->color : Color();
+	this->shadowOffset = this->hasShadow ? shadow->offset : Int2();
 }
 
-TextBox::TextBox(const Int2 &center, const RichTextString &richText,
-	const ShadowData *shadow, Renderer &renderer)
-	: TextBox(center.x, center.y, richText, shadow, renderer)
+TextBox::TextBox(const Int2 &center, const RichTextString &richText, const ShadowData *shadow)
+	: TextBox(center.x, center.y, richText, shadow)
 {
 	// Shift the resulting text box coordinates left and up to center it over
 	// the text (ignoring any shadow).
@@ -171,11 +26,11 @@ TextBox::TextBox(const Int2 &center, const RichTextString &richText,
 	this->y -= richText.getDimensions().y / 2;
 }
 
-TextBox::TextBox(int x, int y, const RichTextString &richText, Renderer &renderer)
-	: TextBox(x, y, richText, nullptr, renderer) { }
+TextBox::TextBox(int x, int y, const RichTextString &richText)
+	: TextBox(x, y, richText, nullptr) { }
 
-TextBox::TextBox(const Int2 &center, const RichTextString &richText, Renderer &renderer)
-	: TextBox(center, richText, nullptr, renderer) { }
+TextBox::TextBox(const Int2 &center, const RichTextString &richText)
+	: TextBox(center, richText, nullptr) { }
 
 int TextBox::getX() const
 {
@@ -194,15 +49,32 @@ const RichTextString &TextBox::getRichText() const
 
 Rect TextBox::getRect() const
 {
-	return Rect(this->x, this->y, this->surface.get()->w, this->surface.get()->h);
+	// The shadow offset extends the box in whichever direction it points.
+	const Int2 &dimensions = this->richText.getDimensions();
+	return Rect(this->x, this->y,
+		dimensions.x + std::abs(this->shadowOffset.x),
+		dimensions.y + std::abs(this->shadowOffset.y));
 }
 
-SDL_Surface *TextBox::getSurface() const
+void TextBox::draw(int x, int y, Renderer &renderer) const
 {
-	return this->surface.get();
+	const TextLayout &layout = this->richText.getLayout();
+
+	// The shadow goes underneath the text, and the text moves the other way for
+	// negative shadow offsets so the box stays in the top left corner.
+	if (this->hasShadow)
+	{
+		renderer.drawOriginalText(layout, this->shadowColor,
+			x + std::max(this->shadowOffset.x, 0),
+			y + std::max(this->shadowOffset.y, 0));
+	}
+
+	renderer.drawOriginalText(layout, this->richText.getColor(),
+		x + std::max(-this->shadowOffset.x, 0),
+		y + std::max(-this->shadowOffset.y, 0));
 }
 
-SDL_Texture *TextBox::getTexture() const
+void TextBox::draw(Renderer &renderer) const
 {
-	return this->texture.get();
+	this->draw(this->x, this->y, renderer);
 }
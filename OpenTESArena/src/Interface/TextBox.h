@@ -7,17 +7,15 @@
 #include "RichTextString.h"
 #include "../Math/Vector2.h"
 #include "../Media/Color.h"
-#include "../Rendering/Surface.h"
-#include "../Rendering/Texture.h"
 
 // Redesigned for use with the font system using Arena assets.
 
+// The text is drawn straight from the font manager's glyph atlas each frame, so changing
+// a text box's position or color doesn't need a new texture.
+
 class Rect;
 class Renderer;
 
-struct SDL_Surface;
-struct SDL_Texture;
-
 class TextBox
 {
 public:
@@ -32,30 +30,33 @@ public:
 	};
 private:
 	RichTextString richText;
-	Surface surface; // For ListBox compatibility. Identical to "texture".
-	Texture texture;
+	Color shadowColor;
+	Int2 shadowOffset;
 	int x, y;
+	bool hasShadow;
 public:
 	// Default number of characters per line before a newline occurs.
 	static const int DEFAULT_TEXT_WRAP = 60;
 
-	TextBox(int x, int y, const RichTextString &richText, const ShadowData *shadow,
-		Renderer &renderer);
-	TextBox(const Int2 &center, const RichTextString &richText, const ShadowData *shadow,
-		Renderer &renderer);
-	TextBox(int x, int y, const RichTextString &richText, Renderer &renderer);
-	TextBox(const Int2 &center, const RichTextString &richText, Renderer &renderer);
+	TextBox(int x, int y, const RichTextString &richText, const ShadowData *shadow);
+	TextBox(const Int2 &center, const RichTextString &richText, const ShadowData *shadow);
+	TextBox(int x, int y, const RichTextString &richText);
+	TextBox(const Int2 &center, const RichTextString &richText);
 
 	int getX() const;
 	int getY() const;
 	const RichTextString &getRichText() const;
 
-	// Gets the bounding box around the text box's content. Useful for tooltips when hovering
-	// over it with the mouse.
+	// Gets the bounding box around the text box's content (including any shadow). Useful
+	// for tooltips when hovering over it with the mouse.
 	Rect getRect() const;
 
-	SDL_Surface *getSurface() const;
-	SDL_Texture *getTexture() const;
+	// Draws the text (and its shadow) in original screen space with its top left corner
+	// at the given point.
+	void draw(int x, int y, Renderer &renderer) const;
+
+	// Draws the text at the text box's own position.
+	void draw(Renderer &renderer) const;
 };
 
 #endif
@@ -77,7 +77,7 @@ TextCinematicPanel::TextCinematicPanel(Game &game,
 				lineSpacing,
 				game.getFontManager());
 
-			auto textBox = std::make_unique<TextBox>(center, richText, game.getRenderer());
+			auto textBox = std::make_unique<TextBox>(center, richText);
 			textBoxes.push_back(std::move(textBox));
 		}
 
@@ -171,5 +171,5 @@ void TextCinematicPanel::render(Renderer &renderer)
 	const auto &textBox = this->textBoxes.at(this->textIndex);
 
 	// Draw text.
-	renderer.drawOriginal(textBox->getTexture(), textBox->getX(), textBox->getY());
+	textBox->draw(renderer);
 }
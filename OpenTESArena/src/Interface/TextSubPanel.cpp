@@ -20,7 +20,7 @@ TextSubPanel::TextSubPanel(Game &game, const Int2 &textCenter,
 	: Panel(game), endingAction(endingAction), texture(std::move(texture)),
 	textureCenter(textureCenter)
 {
-	this->textBox = std::make_unique<TextBox>(textCenter, richText, game.getRenderer());
+	this->textBox = std::make_unique<TextBox>(textCenter, richText);
 }
 
 TextSubPanel::TextSubPanel(Game &game, const Int2 &textCenter,
@@ -73,12 +73,6 @@ void TextSubPanel::render(Renderer &renderer)
 			nativeTextureRect.getHeight());
 	}
 
-	const Rect nativeTextBoxRect = renderer.originalToNative(this->textBox->getRect());
-
 	// Draw text.
-	renderer.draw(this->textBox->getTexture(),
-		nativeTextBoxRect.getLeft(),
-		nativeTextBoxRect.getTop(),
-		nativeTextBoxRect.getWidth(),
-		nativeTextBoxRect.getHeight());
+	this->textBox->draw(renderer);
 }
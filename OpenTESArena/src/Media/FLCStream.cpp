@@ -0,0 +1,172 @@
+#include <algorithm>
+
+#include "Color.h"
+#include "FLCStream.h"
+#include "../Utilities/Debug.h"
+
+FLCStream::FLCStream(const std::string &filename)
+	: decoder(filename)
+{
+	const int pixelCount = this->decoder.getWidth() * this->decoder.getHeight();
+	for (std::vector<uint32_t> &frame : this->ring)
+	{
+		frame = std::vector<uint32_t>(pixelCount);
+	}
+
+	this->frameIndex = 0;
+	this->decodedCount = 0;
+	this->finished = false;
+	this->stopping = false;
+	this->thread = std::thread([this]() { this->decodeLoop(); });
+}
+
+FLCStream::~FLCStream()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+
+	this->condition.notify_all();
+	this->thread.join();
+}
+
+bool FLCStream::decodeFrame(bool skipped)
+{
+	// Frames are delta-coded, so every one has to be decoded, but frames that were
+	// skipped over don't need their colors written.
+	if (!this->decoder.readFrame())
+	{
+		return false;
+	}
+
+	if (!skipped)
+	{
+		const int pixelCount = this->decoder.getWidth() * this->decoder.getHeight();
+		const int index = this->decoder.getFrameIndex();
+		std::vector<uint32_t> &frame = this->ring[index % FLCStream::RING_SIZE];
+
+		const auto &paletteColors = this->decoder.getPalette().get();
+		std::array<uint32_t, 256> colors;
+		std::transform(paletteColors.begin(), paletteColors.end(), colors.begin(),
+			[](const Color &color) { return color.toARGB(); });
+
+		const uint8_t *srcPixels = this->decoder.getPixels();
+		std::transform(srcPixels, srcPixels + pixelCount, frame.begin(),
+			[&colors](uint8_t pixel) { return colors[pixel]; });
+	}
+
+	return true;
+}
+
+void FLCStream::decodeLoop()
+{
+	while (true)
+	{
+		bool skipped;
+
+		{
+			// Wait for a free slot in the ring.
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->condition.wait(lock, [this]()
+			{
+				return this->stopping ||
+					(this->decodedCount < (this->frameIndex + FLCStream::RING_SIZE));
+			});
+
+			if (this->stopping)
+			{
+				return;
+			}
+
+			skipped = this->decodedCount < this->frameIndex;
+		}
+
+		// An exception can't leave this thread, so it's handed to the game thread to be
+		// rethrown by getFrame().
+		bool decoded = false;
+		std::exception_ptr error;
+		try
+		{
+			decoded = this->decodeFrame(skipped);
+		}
+		catch (...)
+		{
+			error = std::current_exception();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			if (decoded)
+			{
+				this->decodedCount++;
+			}
+			else
+			{
+				this->error = error;
+				this->finished = true;
+			}
+		}
+
+		this->condition.notify_all();
+
+		if (!decoded)
+		{
+			return;
+		}
+
+	}
+}
+
+int FLCStream::getFrameCount() const
+{
+	return this->decoder.getFrameCount();
+}
+
+double FLCStream::getFrameDuration() const
+{
+	return this->decoder.getFrameDuration();
+}
+
+int FLCStream::getWidth() const
+{
+	return this->decoder.getWidth();
+}
+
+int FLCStream::getHeight() const
+{
+	return this->decoder.getHeight();
+}
+
+const uint32_t *FLCStream::getFrame(int index)
+{
+	DebugAssertMsg((index >= 0) && (index < this->getFrameCount()),
+		"Frame index \"" + std::to_string(index) + "\" out of range.");
+
+	std::unique_lock<std::mutex> lock(this->mutex);
+	DebugAssertMsg(index >= this->frameIndex, "Frames must be requested in order.");
+
+	if (index != this->frameIndex)
+	{
+		// Moving forward frees up ring slots for the decoder.
+		this->frameIndex = index;
+		this->condition.notify_all();
+	}
+
+	this->condition.wait(lock, [this, index]()
+	{
+		return (this->decodedCount > index) || this->finished;
+	});
+
+	if (this->decodedCount <= index)
+	{
+		if (this->error != nullptr)
+		{
+			std::rethrow_exception(this->error);
+		}
+
+		throw DebugException("Movie ended before frame \"" + std::to_string(index) + "\".");
+	}
+
+	return this->ring[index % FLCStream::RING_SIZE].data();
+}
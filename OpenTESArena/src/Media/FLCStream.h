@@ -0,0 +1,64 @@
+#ifndef FLC_STREAM_H
+#define FLC_STREAM_H
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Assets/FLCDecoder.h"
+
+// Plays an FLC/CEL movie from start to finish without holding all of its frames. A
+// background thread decodes a few frames ahead of the current one and stores them as
+// 32-bit pixels in a small ring, ready to be uploaded to a streaming texture.
+
+class FLCStream
+{
+private:
+	// Number of frames kept in the ring, including the one being shown.
+	static const int RING_SIZE = 8;
+
+	FLCDecoder decoder;
+	std::array<std::vector<uint32_t>, RING_SIZE> ring;
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::thread thread;
+	int frameIndex; // Frame being shown. Its ring slot isn't written until it changes.
+	int decodedCount; // Number of frames decoded so far.
+	std::exception_ptr error; // Set if decoding threw, to be rethrown by getFrame().
+	bool finished; // Set when the decode thread has no more frames to give.
+	bool stopping;
+
+	// Decodes frames into the ring until the movie ends or the stream is destroyed.
+	void decodeLoop();
+
+	// Decodes the next frame into its ring slot. Returns false at the end of the movie.
+	bool decodeFrame(bool skipped);
+public:
+	FLCStream(const std::string &filename);
+	~FLCStream();
+
+	// Gets the number of frames.
+	int getFrameCount() const;
+
+	// Gets the duration of each frame in seconds.
+	double getFrameDuration() const;
+
+	// Gets the width of each frame.
+	int getWidth() const;
+
+	// Gets the height of each frame.
+	int getHeight() const;
+
+	// Gets the 32-bit pixels of the given frame, waiting for it to be decoded if
+	// necessary. Frames can only be requested in increasing order (skipping is fine), and
+	// the returned pointer is valid until the next call. Rethrows any error the decode
+	// thread ran into.
+	const uint32_t *getFrame(int index);
+};
+
+#endif
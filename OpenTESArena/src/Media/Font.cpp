@@ -38,14 +38,19 @@ Font::Font(FontName fontName)
 	this->characterHeight = elementHeight;
 
 	// There are 95 characters, plus space.
-	this->characters.resize(96);
+	this->characters.resize(Font::CHARACTER_COUNT);
 
 	// Create an SDL surface for each character image. Start with space (ASCII 32), 
 	// and end with delete (ASCII 127).
-	for (int i = 0; i < 96; i++)
+	for (int i = 0; i < Font::CHARACTER_COUNT; i++)
 	{
 		const char c = i + 32;
 		const int elementWidth = fontFile.getWidth(c);
+
+		// The atlas rectangle is set once the font manager has packed the characters.
+		Glyph &glyph = this->glyphs.at(i);
+		glyph.atlasRect = Rect();
+		glyph.width = elementWidth;
 		const uint32_t *elementPixels = fontFile.getPixels(c);
 
 		Surface surface = Surface::createWithFormat(elementWidth, elementHeight,
@@ -66,6 +71,7 @@ Font::Font(FontName fontName)
 Font::Font(Font &&font)
 {
 	this->characters = std::move(font.characters);
+	this->glyphs = font.glyphs;
 	this->characterHeight = font.characterHeight;
 	this->fontName = font.fontName;
 }
@@ -86,7 +92,7 @@ FontName Font::getFontName() const
 	return this->fontName;
 }
 
-SDL_Surface *Font::getSurface(char c) const
+int Font::getCharacterIndex(char c)
 {
 	// If an invalid character is requested, print a warning and return
 	// a default character.
@@ -94,10 +100,31 @@ SDL_Surface *Font::getSurface(char c) const
 	{
 		DebugWarning("Character value \"" + std::to_string(c) +
 			"\" out of range (must be ASCII 32-127).");
-		return this->characters.at(0).get();
+		return 0;
 	}
 
 	// Space (ASCII 32) is at index 0.
-	SDL_Surface *surface = this->characters.at(c - 32).get();
+	return c - 32;
+}
+
+const Font::Glyph &Font::getGlyph(char c) const
+{
+	return this->glyphs[Font::getCharacterIndex(c)];
+}
+
+SDL_Surface *Font::getSurface(char c) const
+{
+	SDL_Surface *surface = this->characters.at(Font::getCharacterIndex(c)).get();
 	return surface;
 }
+
+void Font::setAtlasRects(const std::vector<Rect> &atlasRects)
+{
+	DebugAssertMsg(atlasRects.size() == this->glyphs.size(),
+		"Atlas rectangle count must match character count.");
+
+	for (size_t i = 0; i < atlasRects.size(); i++)
+	{
+		this->glyphs[i].atlasRect = atlasRects[i];
+	}
+}
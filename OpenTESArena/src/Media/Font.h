@@ -1,9 +1,11 @@
 #ifndef FONT_H
 #define FONT_H
 
+#include <array>
 #include <string>
 #include <vector>
 
+#include "../Math/Rect.h"
 #include "../Rendering/Surface.h"
 
 // Redesigned for use with Arena assets.
@@ -14,11 +16,26 @@ struct SDL_Surface;
 
 class Font
 {
+public:
+	// Layout metrics for a character, kept in a flat table so text can be measured
+	// without touching the character surfaces.
+	struct Glyph
+	{
+		Rect atlasRect; // Where the character is in the font manager's atlas.
+		int width; // Width in pixels, including the column of spacing on its right.
+	};
 private:
+	// Number of characters in a font, from space (ASCII 32) to delete (ASCII 127).
+	static const int CHARACTER_COUNT = 96;
+
 	// ASCII character-indexed surfaces, where space (ASCII 32) is index 0.
 	std::vector<Surface> characters;
+	std::array<Glyph, CHARACTER_COUNT> glyphs; // Indexed the same as the surfaces.
 	FontName fontName;
 	int characterHeight;
+
+	// Gets the index of a character, or of space if it's out of range.
+	static int getCharacterIndex(char c);
 public:
 	// Constructs a group of characters using an image of bits from a font file.
 	Font(FontName fontName);
@@ -36,8 +53,15 @@ public:
 	// Gets the name of the selected font.
 	FontName getFontName() const;
 
+	// Gets the layout metrics for a given character. Blank characters like space aren't
+	// in the atlas and have an empty atlas rectangle.
+	const Glyph &getGlyph(char c) const;
+
 	// Gets the surface for a given character.
 	SDL_Surface *getSurface(char c) const;
+
+	// Sets where each character (space first) is in the font manager's atlas texture.
+	void setAtlasRects(const std::vector<Rect> &atlasRects);
 };
 
 #endif
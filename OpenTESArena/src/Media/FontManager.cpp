@@ -1,20 +1,326 @@
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "SDL.h"
+
 #include "FontManager.h"
 #include "FontName.h"
+#include "../Interface/TextAlignment.h"
+#include "../Rendering/Renderer.h"
+#include "../Utilities/Debug.h"
+#include "../Utilities/String.h"
+
+namespace
+{
+	const std::array<FontName, 9> FontNames =
+	{
+		FontName::A,
+		FontName::Arena,
+		FontName::B,
+		FontName::C,
+		FontName::Char,
+		FontName::D,
+		FontName::Four,
+		FontName::S,
+		FontName::Teeny
+	};
+
+	// Whether every pixel in a character surface is transparent.
+	bool isBlank(const SDL_Surface *surface)
+	{
+		const uint32_t *pixels = static_cast<const uint32_t*>(surface->pixels);
+		const int pixelCount = surface->w * surface->h;
+		return std::all_of(pixels, pixels + pixelCount,
+			[](uint32_t pixel) { return pixel == 0; });
+	}
+}
+
+const int FontManager::ATLAS_WIDTH = 512;
+const size_t FontManager::MAX_LAYOUT_COUNT = 1024;
+
+void FontManager::init(Renderer &renderer)
+{
+	DebugMention("Initializing.");
+
+	for (const FontName fontName : FontNames)
+	{
+		this->fonts.emplace(std::make_pair(fontName, Font(fontName)));
+	}
+
+	// Pack the non-blank characters into rows ("shelves") left to right, with a pixel of
+	// padding between them so scaled drawing doesn't bleed into neighbors.
+	const int padding = 1;
+	std::unordered_map<FontName, std::vector<Rect>> fontAtlasRects;
+	int shelfX = 0;
+	int shelfY = 0;
+	int shelfHeight = 0;
+
+	for (const FontName fontName : FontNames)
+	{
+		const Font &font = this->fonts.at(fontName);
+		std::vector<Rect> &atlasRects = fontAtlasRects[fontName];
+
+		for (int i = 0; i < 96; i++)
+		{
+			const SDL_Surface *surface = font.getSurface(static_cast<char>(i + 32));
+			if (isBlank(surface))
+			{
+				atlasRects.push_back(Rect());
+				continue;
+			}
+
+			if ((shelfX + surface->w) > FontManager::ATLAS_WIDTH)
+			{
+				shelfX = 0;
+				shelfY += shelfHeight + padding;
+				shelfHeight = 0;
+			}
+
+			atlasRects.push_back(Rect(shelfX, shelfY, surface->w, surface->h));
+			shelfX += surface->w + padding;
+			shelfHeight = std::max(shelfHeight, surface->h);
+		}
+	}
+
+	// Copy each character into the atlas, with non-blank pixels set to white so the
+	// text color can be applied with color modulation.
+	const int atlasHeight = shelfY + shelfHeight;
+	std::vector<uint32_t> atlasPixels(FontManager::ATLAS_WIDTH * atlasHeight, 0);
+
+	for (const FontName fontName : FontNames)
+	{
+		Font &font = this->fonts.at(fontName);
+		std::vector<Rect> &atlasRects = fontAtlasRects.at(fontName);
+
+		for (int i = 0; i < 96; i++)
+		{
+			const SDL_Surface *surface = font.getSurface(static_cast<char>(i + 32));
+			const Rect &rect = atlasRects.at(i);
+			const uint32_t *srcPixels = static_cast<const uint32_t*>(surface->pixels);
+
+			for (int y = 0; y < rect.getHeight(); y++)
+			{
+				for (int x = 0; x < rect.getWidth(); x++)
+				{
+					const uint32_t srcPixel = srcPixels[x + (y * surface->w)];
+					const int dstIndex = (rect.getLeft() + x) +
+						((rect.getTop() + y) * FontManager::ATLAS_WIDTH);
+					atlasPixels[dstIndex] = (srcPixel != 0) ? 0xFFFFFFFF : 0;
+				}
+			}
+		}
+
+		font.setAtlasRects(atlasRects);
+	}
+
+	SDL_Texture *texture = renderer.createTexture(Renderer::DEFAULT_PIXELFORMAT,
+		SDL_TEXTUREACCESS_STATIC, FontManager::ATLAS_WIDTH, atlasHeight);
+	SDL_UpdateTexture(texture, nullptr, atlasPixels.data(),
+		FontManager::ATLAS_WIDTH * sizeof(uint32_t));
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+	this->atlasTexture = Texture(texture);
+}
+
+const Font &FontManager::getFont(FontName fontName) const
+{
+	const auto fontIter = this->fonts.find(fontName);
+	DebugAssertMsg(fontIter != this->fonts.end(), "Font \"" +
+		std::to_string(static_cast<int>(fontName)) + "\" not loaded.");
+
+	return fontIter->second;
+}
+
+SDL_Texture *FontManager::getAtlasTexture() const
+{
+	return this->atlasTexture.get();
+}
+
+std::string FontManager::makeLayoutKey(const std::string &text, FontName fontName,
+	TextAlignment alignment, int lineSpacing)
+{
+	return std::to_string(static_cast<int>(fontName)) + ' ' +
+		std::to_string(static_cast<int>(alignment)) + ' ' +
+		std::to_string(lineSpacing) + ' ' + text;
+}
 
-const Font &FontManager::getFont(FontName fontName)
+std::shared_ptr<const TextLayout> FontManager::makeLayout(const std::string &text,
+	const Font &font, TextAlignment alignment, int lineSpacing, const std::string *oldText,
+	const TextLayout *oldLayout) const
 {
-	auto fontIter = this->fonts.find(fontName);
+	auto layout = std::make_shared<TextLayout>();
+	layout->atlasTexture = this->atlasTexture.get();
+
+	// Split the text on each newline. If the text is empty, then just add a space, 
+	// so there doesn't need to be any "zero-character" special case.
+	const std::string &layoutText = (text.size() > 0) ? text : std::string(" ");
+	const std::vector<std::string> textLines = String::split(layoutText, '\n');
+	const int lineCount = static_cast<int>(textLines.size());
+
+	// Find the first character that differs from the old text (if any). Everything
+	// before it keeps its width and position.
+	int editedLine = 0;
+	int editedColumn = 0;
+	if (oldLayout != nullptr)
+	{
+		const std::string &oldLayoutText = (oldText->size() > 0) ? *oldText : std::string(" ");
+		const auto mismatch = std::mismatch(layoutText.begin(), layoutText.end(),
+			oldLayoutText.begin(), oldLayoutText.end());
+		const size_t prefixLength = std::distance(layoutText.begin(), mismatch.first);
+		const size_t lineStart = (prefixLength > 0) ?
+			layoutText.rfind('\n', prefixLength - 1) : std::string::npos;
 
-	if (fontIter != this->fonts.end())
+		editedLine = static_cast<int>(std::count(layoutText.begin(),
+			layoutText.begin() + prefixLength, '\n'));
+		editedColumn = static_cast<int>(prefixLength -
+			((lineStart != std::string::npos) ? (lineStart + 1) : 0));
+	}
+
+	// Get the width of each line in pixels (for determining the longest line). Lines
+	// before the edited one are unchanged.
+	for (int i = 0; i < lineCount; i++)
 	{
-		return fontIter->second;
+		if (i < editedLine)
+		{
+			layout->lineWidths.push_back(oldLayout->lineWidths.at(i));
+			continue;
+		}
+
+		int lineWidth = 0;
+		for (const char c : textLines.at(i))
+		{
+			lineWidth += font.getGlyph(c).width;
+		}
+
+		layout->lineWidths.push_back(lineWidth);
 	}
-	else
+
+	const int maxWidth = *std::max_element(
+		layout->lineWidths.begin(), layout->lineWidths.end());
+	const int characterHeight = font.getCharacterHeight();
+	const int lineHeight = characterHeight + lineSpacing;
+	layout->dimensions = Int2(maxWidth,
+		(characterHeight * lineCount) + (lineSpacing * (lineCount - 1)));
+
+	auto getLineStart = [alignment, maxWidth](int lineWidth)
+	{
+		if (alignment == TextAlignment::Left)
+		{
+			return 0;
+		}
+		else if (alignment == TextAlignment::Center)
+		{
+			return (maxWidth / 2) - (lineWidth / 2);
+		}
+		else
+		{
+			DebugCrash("Alignment \"" +
+				std::to_string(static_cast<int>(alignment)) + "\" unrecognized.");
+			return 0;
+		}
+	};
+
+	// Reuse the old glyphs before the edit if they're still in the same place. Centered
+	// lines move whenever the longest line changes, and the edited line itself moves
+	// unless it's left-aligned.
+	int firstLine = 0;
+	int firstColumn = 0;
+	if ((oldLayout != nullptr) && ((alignment == TextAlignment::Left) ||
+		(oldLayout->dimensions.x == maxWidth)))
 	{
-		// Load the font object and insert it into the font manager map.
-		fontIter = this->fonts.emplace(std::make_pair(fontName, 
-			std::move(Font(fontName)))).first;
+		firstLine = editedLine;
+		firstColumn = (alignment == TextAlignment::Left) ? editedColumn : 0;
+
+		int columnX = 0;
+		for (int i = 0; i < firstColumn; i++)
+		{
+			columnX += font.getGlyph(textLines.at(firstLine).at(i)).width;
+		}
+
+		const int lineY = firstLine * lineHeight;
+		const auto glyphEnd = std::find_if(oldLayout->glyphs.begin(), oldLayout->glyphs.end(),
+			[lineY, columnX](const TextLayout::Glyph &glyph)
+		{
+			return (glyph.offset.y > lineY) ||
+				((glyph.offset.y == lineY) && (glyph.offset.x >= columnX));
+		});
 
-		return fontIter->second;
+		layout->glyphs.insert(layout->glyphs.end(), oldLayout->glyphs.begin(), glyphEnd);
 	}
+
+	// Position each remaining character based on alignment.
+	for (int i = firstLine; i < lineCount; i++)
+	{
+		const std::string &textLine = textLines.at(i);
+		const int yOffset = i * lineHeight;
+		int xOffset = getLineStart(layout->lineWidths.at(i));
+
+		const int startColumn = (i == firstLine) ? firstColumn : 0;
+		for (int j = 0; j < startColumn; j++)
+		{
+			xOffset += font.getGlyph(textLine.at(j)).width;
+		}
+
+		for (size_t j = startColumn; j < textLine.size(); j++)
+		{
+			const Font::Glyph &fontGlyph = font.getGlyph(textLine[j]);
+			if (fontGlyph.atlasRect.getWidth() > 0)
+			{
+				TextLayout::Glyph glyph;
+				glyph.atlasRect = fontGlyph.atlasRect;
+				glyph.offset = Int2(xOffset, yOffset);
+				layout->glyphs.push_back(glyph);
+			}
+
+			xOffset += fontGlyph.width;
+		}
+	}
+
+	return layout;
+}
+
+std::shared_ptr<const TextLayout> FontManager::getLayout(const std::string &text,
+	FontName fontName, TextAlignment alignment, int lineSpacing,
+	const std::string *oldText, const TextLayout *oldLayout)
+{
+	std::string key = FontManager::makeLayoutKey(text, fontName, alignment, lineSpacing);
+
+	const auto layoutIter = this->layouts.find(key);
+	if (layoutIter != this->layouts.end())
+	{
+		CachedLayout &cachedLayout = layoutIter->second;
+		this->layoutUses.splice(this->layoutUses.begin(), this->layoutUses,
+			cachedLayout.useIter);
+		return cachedLayout.layout;
+	}
+
+	// Layouts still held by text boxes stay alive after they're evicted.
+	if (this->layouts.size() >= FontManager::MAX_LAYOUT_COUNT)
+	{
+		this->layouts.erase(this->layoutUses.back());
+		this->layoutUses.pop_back();
+	}
+
+	CachedLayout cachedLayout;
+	cachedLayout.layout = this->makeLayout(text, this->getFont(fontName), alignment,
+		lineSpacing, oldText, oldLayout);
+	this->layoutUses.push_front(key);
+	cachedLayout.useIter = this->layoutUses.begin();
+
+	std::shared_ptr<const TextLayout> layout = cachedLayout.layout;
+	this->layouts.emplace(std::make_pair(std::move(key), std::move(cachedLayout)));
+	return layout;
+}
+
+std::shared_ptr<const TextLayout> FontManager::getLayout(const std::string &text,
+	FontName fontName, TextAlignment alignment, int lineSpacing)
+{
+	return this->getLayout(text, fontName, alignment, lineSpacing, nullptr, nullptr);
+}
+
+std::shared_ptr<const TextLayout> FontManager::getLayout(const std::string &text,
+	FontName fontName, TextAlignment alignment, int lineSpacing, const std::string &oldText,
+	const TextLayout &oldLayout)
+{
+	return this->getLayout(text, fontName, alignment, lineSpacing, &oldText, &oldLayout);
 }
@@ -1,22 +1,82 @@
 #ifndef FONT_MANAGER_H
 #define FONT_MANAGER_H
 
+#include <list>
+#include <memory>
+#include <string>
 #include <unordered_map>
 
 #include "Font.h"
+#include "TextLayout.h"
+#include "../Rendering/Texture.h"
 
 // This class manages access for each font object. This should be stored in the 
 // game state with the other managers.
 
+// Every font's characters are packed into one white atlas texture at startup, so text
+// is drawn as a batch of quads from the same texture with its color applied at draw
+// time. Laid-out strings are cached so identical text is only laid out once.
+
+class Renderer;
+
 enum class FontName;
+enum class TextAlignment;
 
 class FontManager
 {
 private:
+	// Width of the atlas texture. Its height depends on the fonts.
+	static const int ATLAS_WIDTH;
+
+	// A cached layout and its place in the usage order.
+	struct CachedLayout
+	{
+		std::shared_ptr<const TextLayout> layout;
+		std::list<std::string>::iterator useIter;
+	};
+
+	// Number of cached layouts allowed before the least recently used one is evicted.
+	static const size_t MAX_LAYOUT_COUNT;
+
 	std::unordered_map<FontName, Font> fonts;
+	std::unordered_map<std::string, CachedLayout> layouts;
+	std::list<std::string> layoutUses; // Layout keys, most recently used first.
+	Texture atlasTexture;
+
+	// Gets the layout cache key for some text and its formatting. Color isn't part of it
+	// since it's applied when drawing.
+	static std::string makeLayoutKey(const std::string &text, FontName fontName,
+		TextAlignment alignment, int lineSpacing);
+
+	// Splits the given text into lines and positions each character. If an old layout of
+	// the same font and formatting is given, only the text after the first difference
+	// from the old text is laid out again.
+	std::shared_ptr<const TextLayout> makeLayout(const std::string &text, const Font &font,
+		TextAlignment alignment, int lineSpacing, const std::string *oldText,
+		const TextLayout *oldLayout) const;
+
+	std::shared_ptr<const TextLayout> getLayout(const std::string &text, FontName fontName,
+		TextAlignment alignment, int lineSpacing, const std::string *oldText,
+		const TextLayout *oldLayout);
 public:
+	// Loads every font and packs their characters into the atlas texture.
+	void init(Renderer &renderer);
+
 	// Gets a font object using one of the Arena font assets.
-	const Font &getFont(FontName fontName);
+	const Font &getFont(FontName fontName) const;
+
+	// Gets the texture with every font's characters in it. Non-blank pixels are white.
+	SDL_Texture *getAtlasTexture() const;
+
+	// Gets the layout of the given text, laying it out first if it isn't cached.
+	std::shared_ptr<const TextLayout> getLayout(const std::string &text, FontName fontName,
+		TextAlignment alignment, int lineSpacing);
+
+	// Gets the layout of edited text, reusing the unchanged part of the old text's layout
+	// if it isn't cached. Meant for text that's typed in a character at a time.
+	std::shared_ptr<const TextLayout> getLayout(const std::string &text, FontName fontName,
+		TextAlignment alignment, int lineSpacing, const std::string &oldText,
+		const TextLayout &oldLayout);
 };
 
 #endif
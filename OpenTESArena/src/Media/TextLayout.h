@@ -0,0 +1,29 @@
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include <vector>
+
+#include "../Math/Rect.h"
+#include "../Math/Vector2.h"
+
+// Text split into lines and positioned character by character, ready to be drawn as a
+// batch of quads from the font atlas. The font manager lays out each unique string once,
+// and every rich text string with the same text and formatting shares the result.
+
+struct SDL_Texture;
+
+struct TextLayout
+{
+	struct Glyph
+	{
+		Rect atlasRect; // Where the character is in the font atlas.
+		Int2 offset; // Top left corner relative to the text's top left corner.
+	};
+
+	SDL_Texture *atlasTexture;
+	std::vector<Glyph> glyphs; // Blank characters like spaces are left out.
+	std::vector<int> lineWidths; // Width in pixels of each line.
+	Int2 dimensions; // Width of the longest line and height of all lines.
+};
+
+#endif
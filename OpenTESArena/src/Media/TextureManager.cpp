@@ -1,5 +1,9 @@
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <functional>
+#include <numeric>
+#include <unordered_map>
 
 #include "SDL.h"
 
@@ -18,11 +22,62 @@
 #include "../Math/Vector2.h"
 #include "../Rendering/Renderer.h"
 #include "../Utilities/Debug.h"
+#include "../Utilities/Platform.h"
 #include "../Utilities/String.h"
 #include "../Utilities/StringView.h"
 
 #include "components/vfs/manager.hpp"
 
+TextureManager::PinHandle::PinHandle(TextureManager &textureManager,
+	const std::string &filename)
+	: filename(filename)
+{
+	this->textureManager = &textureManager;
+	this->textureManager->pin(filename);
+}
+
+TextureManager::PinHandle::PinHandle(PinHandle &&pinHandle)
+	: filename(std::move(pinHandle.filename))
+{
+	this->textureManager = pinHandle.textureManager;
+	pinHandle.textureManager = nullptr;
+}
+
+TextureManager::PinHandle::~PinHandle()
+{
+	if (this->textureManager != nullptr)
+	{
+		this->textureManager->unpin(this->filename);
+	}
+}
+
+TextureManager::PinHandle &TextureManager::PinHandle::operator=(PinHandle &&pinHandle)
+{
+	if (this != &pinHandle)
+	{
+		if (this->textureManager != nullptr)
+		{
+			this->textureManager->unpin(this->filename);
+		}
+
+		this->textureManager = pinHandle.textureManager;
+		this->filename = std::move(pinHandle.filename);
+		pinHandle.textureManager = nullptr;
+	}
+
+	return *this;
+}
+
+TextureManager::TextureManager()
+{
+	this->byteCount = 0;
+	this->byteBudget = 0;
+	this->frame = 0;
+	this->hitCount = 0;
+	this->missCount = 0;
+	this->evictionCount = 0;
+}
+
 TextureManager::~TextureManager()
 {
 	
@@ -68,39 +123,94 @@ void TextureManager::loadPalette(const std::string &paletteName)
 	assert(this->palettes.find(paletteName) != this->palettes.end());
 }
 
-Surface TextureManager::make32BitFromPaletted(int width, int height,
-	const uint8_t *srcPixels, const Palette &palette)
+namespace
 {
-	Surface surface = Surface::createWithFormat(width, height,
-		Renderer::DEFAULT_BPP, Renderer::DEFAULT_PIXELFORMAT);
-	uint32_t *dstPixels = static_cast<uint32_t*>(surface.get()->pixels);
+	// A .COL palette shown as a 16x16 image of its colors.
+	struct COLImage
+	{
+		COLFile colFile;
+		std::array<uint8_t, 256> indices;
 
-	// Generate a 32-bit color from each palette index in the source image and
-	// write them to the destination image.
-	const int pixelCount = width * height;
-	std::transform(srcPixels, srcPixels + pixelCount, dstPixels,
-		[&palette](uint8_t pixel)
+		COLImage(const std::string &filename)
+			: colFile(filename)
+		{
+			std::iota(this->indices.begin(), this->indices.end(), 0);
+		}
+	};
+
+	size_t getByteCount(const Surface &surface)
 	{
-		return palette.get()[pixel].toARGB();
-	});
+		return static_cast<size_t>(surface.get()->pitch) * surface.getHeight();
+	}
 
-	return surface;
-}
+	size_t getByteCount(const Texture &texture)
+	{
+		return static_cast<size_t>(texture.getWidth()) * texture.getHeight() * sizeof(uint32_t);
+	}
 
-const Surface &TextureManager::getSurface(const std::string &filename,
-	const std::string &paletteName)
-{
-	// Use this name when interfacing with the surfaces map.
-	const std::string fullName = filename + paletteName;
+	template <typename T>
+	size_t getByteCount(const std::vector<T> &values)
+	{
+		size_t byteCount = 0;
+		for (const T &value : values)
+		{
+			byteCount += getByteCount(value);
+		}
 
-	// See if the image file has already been loaded with the palette.
-	auto surfaceIter = this->surfaces.find(fullName);
-	if (surfaceIter != this->surfaces.end())
+		return byteCount;
+	}
+
+	// An entry that trim() may evict.
+	struct EvictionCandidate
 	{
-		// The requested surface exists.
-		return surfaceIter->second;
+		uint64_t lastUsedFrame;
+		std::function<void()> erase;
+		size_t byteCount;
+	};
+
+	template <typename T>
+	void addEvictionCandidates(std::unordered_map<std::string, T> &cache, uint64_t frame,
+		std::vector<EvictionCandidate> &candidates)
+	{
+		for (const auto &pair : cache)
+		{
+			const T &entry = pair.second;
+			if (!entry.pinned && (entry.lastUsedFrame < frame))
+			{
+				const std::string &key = pair.first;
+				candidates.push_back(EvictionCandidate
+				{
+					entry.lastUsedFrame,
+					[&cache, key]() { cache.erase(key); },
+					entry.byteCount
+				});
+			}
+		}
 	}
 
+	// The 32-bit color of each palette index.
+	using ColorTable = std::array<uint32_t, 256>;
+
+	ColorTable makeColorTable(const Palette &palette)
+	{
+		ColorTable colors;
+		std::transform(palette.get().begin(), palette.get().end(), colors.begin(),
+			[](const Color &color) { return color.toARGB(); });
+		return colors;
+	}
+
+	// Writes the 32-bit color of each palette index.
+	void writePalettedPixels(const uint8_t *srcPixels, int pixelCount,
+		const ColorTable &colors, uint32_t *dstPixels)
+	{
+		std::transform(srcPixels, srcPixels + pixelCount, dstPixels,
+			[&colors](uint8_t pixel) { return colors[pixel]; });
+	}
+}
+
+const Palette *TextureManager::loadImagePalette(const std::string &filename,
+	const std::string &paletteName)
+{
 	// Attempt to use the image's built-in palette if requested.
 	const bool useBuiltInPalette = Palette::isBuiltIn(paletteName);
 
@@ -110,66 +220,288 @@ const Surface &TextureManager::getSurface(const std::string &filename,
 	if ((!useBuiltInPalette && !paletteIsLoaded) ||
 		(useBuiltInPalette && !imagePaletteIsLoaded))
 	{
-		// Use the image's filename if using the built-in palette. Otherwise, use the given
-		// palette name.
+		// Use the image's filename (i.e., TAMRIEL.IMG) if using the built-in palette.
+		// Otherwise, use the given palette name (i.e., PAL.COL).
 		this->loadPalette(useBuiltInPalette ? filename : paletteName);
 	}
 
-	// The image hasn't been loaded with the palette yet, so make a new entry.
+	return useBuiltInPalette ? nullptr : &this->palettes.at(paletteName);
+}
+
+const Palette &TextureManager::loadImageSetPalette(const std::string &paletteName)
+{
+	// Do not use a built-in palette for surface sets.
+	DebugAssertMsg(!Palette::isBuiltIn(paletteName),
+		"Image sets (i.e., .SET files) do not have built-in palettes.");
+
+	// See if the palette hasn't already been loaded.
+	if (this->palettes.find(paletteName) == this->palettes.end())
+	{
+		this->loadPalette(paletteName);
+	}
+
+	return this->palettes.at(paletteName);
+}
+
+bool TextureManager::isImageSet(const std::string &filename)
+{
+	const std::string_view extension = StringView::getExtension(filename);
+	return (extension == "CFA") || (extension == "CIF") || (extension == "CEL") ||
+		(extension == "DFA") || (extension == "FLC") || (extension == "RCI") ||
+		(extension == "SET");
+}
+
+TextureManager::PalettedFrames TextureManager::decodeImage(const std::string &filename,
+	const Palette *palette)
+{
 	// Check what kind of file extension the filename has.
 	const std::string_view extension = StringView::getExtension(filename);
 	const bool isCOL = extension == "COL";
 	const bool isIMG = extension == "IMG";
 	const bool isMNU = extension == "MNU";
 
-	Surface surface;
+	PalettedFrames frames;
 
 	if (isCOL)
 	{
-		// A palette was requested as the primary image. Convert it to a surface.
-		const COLFile colFile(filename);
-		const Palette &colPalette = colFile.getPalette();
+		// A palette was requested as the primary image. Show it as a grid of its colors.
+		auto colImage = std::make_shared<const COLImage>(filename);
+		frames.frames.push_back(PalettedFrames::Frame { 16, 16, colImage->indices.data(),
+			&colImage->colFile.getPalette() });
+		frames.owner = std::move(colImage);
+	}
+	else if (isIMG || isMNU)
+	{
+		auto img = std::make_shared<const IMGFile>(filename);
+
+		// Decide if the .IMG will use its own palette or not.
+		const Palette *imgPalette = (palette != nullptr) ? palette : img->getPalette();
+		DebugAssertMsg(imgPalette != nullptr, "\"" + filename + "\" has no built-in palette.");
+
+		frames.frames.push_back(PalettedFrames::Frame { img->getWidth(), img->getHeight(),
+			img->getPixels(), imgPalette });
+		frames.owner = std::move(img);
+	}
+	else
+	{
+		DebugCrash("Unrecognized surface format \"" + filename + "\".");
+	}
 
-		assert(colPalette.get().size() == 256);
-		surface = Surface::createWithFormat(16, 16, Renderer::DEFAULT_BPP,
-			Renderer::DEFAULT_PIXELFORMAT);
-		
-		uint32_t *pixels = static_cast<uint32_t*>(surface.get()->pixels);
-		for (size_t i = 0; i < colPalette.get().size(); i++)
+	return frames;
+}
+
+TextureManager::PalettedFrames TextureManager::decodeImageSet(const std::string &filename,
+	const Palette &palette)
+{
+	// This method deals with animations and movies, so it will check filenames 
+	// for ".CFA", ".CIF", ".DFA", ".FLC", ".SET", etc..
+	const std::string_view extension = StringView::getExtension(filename);
+	const bool isCFA = extension == "CFA";
+	const bool isCIF = extension == "CIF";
+	const bool isCEL = extension == "CEL";
+	const bool isDFA = extension == "DFA";
+	const bool isFLC = extension == "FLC";
+	const bool isRCI = extension == "RCI";
+	const bool isSET = extension == "SET";
+
+	PalettedFrames frames;
+	auto addFrame = [&frames](int width, int height, const uint8_t *pixels,
+		const Palette &framePalette)
+	{
+		frames.frames.push_back(PalettedFrames::Frame { width, height, pixels, &framePalette });
+	};
+
+	if (isCFA)
+	{
+		auto cfaFile = std::make_shared<const CFAFile>(filename);
+		for (int i = 0; i < cfaFile->getImageCount(); i++)
 		{
-			pixels[i] = colPalette.get()[i].toARGB();
+			addFrame(cfaFile->getWidth(), cfaFile->getHeight(), cfaFile->getPixels(i), palette);
 		}
+
+		frames.owner = std::move(cfaFile);
 	}
-	else if (isIMG || isMNU)
+	else if (isCIF)
 	{
-		const IMGFile img(filename);
+		auto cifFile = std::make_shared<const CIFFile>(filename);
+		for (int i = 0; i < cifFile->getImageCount(); i++)
+		{
+			addFrame(cifFile->getWidth(i), cifFile->getHeight(i), cifFile->getPixels(i), palette);
+		}
 
-		// Decide if the .IMG will use its own palette or not.
-		const Palette &palette = useBuiltInPalette ?
-			*img.getPalette() : this->palettes.at(paletteName);
-		
-		// Create a surface from the .IMG.
-		surface = Surface::createWithFormat(img.getWidth(), img.getHeight(),
-			Renderer::DEFAULT_BPP, Renderer::DEFAULT_PIXELFORMAT);
-
-		// Generate 32-bit colors from each palette index in the .IMG pixels and
-		// write them to the destination image.
-		const uint8_t *srcPixels = img.getPixels();
-		uint32_t *dstPixels = static_cast<uint32_t*>(surface.get()->pixels);
-		std::transform(srcPixels, srcPixels + (img.getWidth() * img.getHeight()), dstPixels,
-			[&palette](uint8_t srcPixel)
+		frames.owner = std::move(cifFile);
+	}
+	else if (isDFA)
+	{
+		auto dfaFile = std::make_shared<const DFAFile>(filename);
+		for (int i = 0; i < dfaFile->getImageCount(); i++)
 		{
-			return palette.get()[srcPixel].toARGB();
-		});
+			addFrame(dfaFile->getWidth(), dfaFile->getHeight(), dfaFile->getPixels(i), palette);
+		}
+
+		frames.owner = std::move(dfaFile);
+	}
+	else if (isFLC || isCEL)
+	{
+		// Each frame of a movie has its own palette.
+		auto flcFile = std::make_shared<const FLCFile>(filename);
+		for (int i = 0; i < flcFile->getFrameCount(); i++)
+		{
+			addFrame(flcFile->getWidth(), flcFile->getHeight(), flcFile->getPixels(i),
+				flcFile->getFramePalette(i));
+		}
+
+		frames.owner = std::move(flcFile);
+	}
+	else if (isRCI)
+	{
+		auto rciFile = std::make_shared<const RCIFile>(filename);
+		for (int i = 0; i < rciFile->getImageCount(); i++)
+		{
+			addFrame(RCIFile::WIDTH, RCIFile::HEIGHT, rciFile->getPixels(i), palette);
+		}
+
+		frames.owner = std::move(rciFile);
+	}
+	else if (isSET)
+	{
+		auto setFile = std::make_shared<const SETFile>(filename);
+		for (int i = 0; i < setFile->getImageCount(); i++)
+		{
+			addFrame(SETFile::CHUNK_WIDTH, SETFile::CHUNK_HEIGHT, setFile->getPixels(i), palette);
+		}
+
+		frames.owner = std::move(setFile);
 	}
 	else
 	{
-		DebugCrash("Unrecognized surface format \"" + filename + "\".");
+		DebugCrash("Unrecognized surface list \"" + filename + "\".");
+	}
+
+	return frames;
+}
+
+template <typename T>
+const T *TextureManager::findCached(std::unordered_map<std::string, CacheEntry<T>> &cache,
+	const std::string &fullName)
+{
+	auto iter = cache.find(fullName);
+	if (iter == cache.end())
+	{
+		return nullptr;
+	}
+
+	CacheEntry<T> &entry = iter->second;
+	entry.lastUsedFrame = this->frame;
+	this->hitCount++;
+	return &entry.value;
+}
+
+template <typename T>
+const T &TextureManager::addCached(std::unordered_map<std::string, CacheEntry<T>> &cache,
+	const std::string &fullName, const std::string &filename, T &&value)
+{
+	CacheEntry<T> entry;
+	entry.byteCount = getByteCount(value);
+	entry.value = std::move(value);
+	entry.filename = filename;
+	entry.lastUsedFrame = this->frame;
+	entry.pinned = this->pinCounts.find(filename) != this->pinCounts.end();
+
+	this->byteCount += entry.byteCount;
+	this->missCount++;
+
+	auto iter = cache.emplace(std::make_pair(fullName, std::move(entry))).first;
+	return iter->second.value;
+}
+
+std::vector<std::vector<Surface>> TextureManager::makeSurfaces(
+	const std::vector<const PalettedFrames*> &frameSets)
+{
+	std::vector<std::vector<Surface>> surfaceSets(frameSets.size());
+	for (size_t i = 0; i < frameSets.size(); i++)
+	{
+		for (const PalettedFrames::Frame &frame : frameSets[i]->frames)
+		{
+			surfaceSets[i].push_back(Surface::createWithFormat(frame.width, frame.height,
+				Renderer::DEFAULT_BPP, Renderer::DEFAULT_PIXELFORMAT));
+		}
+	}
+
+	// One job per frame, across every set. Frames usually share a palette, so its color
+	// table is made once here and read by all of their jobs (map nodes don't move).
+	struct FrameJob
+	{
+		const PalettedFrames::Frame *frame;
+		Surface *surface;
+		const ColorTable *colors;
+	};
+
+	std::unordered_map<const Palette*, ColorTable> colorTables;
+	std::vector<FrameJob> jobs;
+	for (size_t i = 0; i < frameSets.size(); i++)
+	{
+		for (size_t j = 0; j < surfaceSets[i].size(); j++)
+		{
+			const PalettedFrames::Frame &frame = frameSets[i]->frames[j];
+			auto tableIter = colorTables.find(frame.palette);
+			if (tableIter == colorTables.end())
+			{
+				tableIter = colorTables.emplace(std::make_pair(
+					frame.palette, makeColorTable(*frame.palette))).first;
+			}
+
+			jobs.push_back(FrameJob { &frame, &surfaceSets[i][j], &tableIter->second });
+		}
+	}
+
+	this->threadPool.run(static_cast<int>(jobs.size()), [&jobs](int index)
+	{
+		const FrameJob &job = jobs[index];
+		uint32_t *dstPixels = static_cast<uint32_t*>(job.surface->getPixels());
+		writePalettedPixels(job.frame->pixels, job.frame->width * job.frame->height,
+			*job.colors, dstPixels);
+	});
+
+	return surfaceSets;
+}
+
+Surface TextureManager::make32BitFromPaletted(int width, int height,
+	const uint8_t *srcPixels, const Palette &palette)
+{
+	Surface surface = Surface::createWithFormat(width, height,
+		Renderer::DEFAULT_BPP, Renderer::DEFAULT_PIXELFORMAT);
+	uint32_t *dstPixels = static_cast<uint32_t*>(surface.get()->pixels);
+
+	// Generate a 32-bit color from each palette index in the source image and
+	// write them to the destination image.
+	writePalettedPixels(srcPixels, width * height, makeColorTable(palette), dstPixels);
+
+	return surface;
+}
+
+const Surface &TextureManager::getSurface(const std::string &filename,
+	const std::string &paletteName)
+{
+	// Use this name when interfacing with the surfaces map.
+	const std::string fullName = filename + paletteName;
+
+	// See if the image file has already been loaded with the palette.
+	const Surface *cachedSurface = this->findCached(this->surfaces, fullName);
+	if (cachedSurface != nullptr)
+	{
+		// The requested surface exists.
+		return *cachedSurface;
 	}
 
+	// The image hasn't been loaded with the palette yet, so make a new entry.
+	const Palette *palette = this->loadImagePalette(filename, paletteName);
+	const PalettedFrames frames = TextureManager::decodeImage(filename, palette);
+	std::vector<std::vector<Surface>> surfaceSets = this->makeSurfaces({ &frames });
+
 	// Add the new surface and return it.
-	auto iter = this->surfaces.emplace(std::make_pair(fullName, std::move(surface))).first;
-	return iter->second;
+	return this->addCached(this->surfaces, fullName, filename,
+		std::move(surfaceSets.front().front()));
 }
 
 const Surface &TextureManager::getSurface(const std::string &filename)
@@ -184,24 +516,11 @@ const Texture &TextureManager::getTexture(const std::string &filename,
 	const std::string fullName = filename + paletteName;
 
 	// See if the image file has already been loaded with the palette.
-	auto textureIter = this->textures.find(fullName);
-	if (textureIter != this->textures.end())
+	const Texture *cachedTexture = this->findCached(this->textures, fullName);
+	if (cachedTexture != nullptr)
 	{
 		// The requested texture exists.
-		return textureIter->second;
-	}
-	// Attempt to use the image's built-in palette if requested.
-	const bool useBuiltInPalette = Palette::isBuiltIn(paletteName);
-
-	// See if the palette hasn't already been loaded.
-	const bool paletteIsLoaded = this->palettes.find(paletteName) != this->palettes.end();
-	const bool imagePaletteIsLoaded = this->palettes.find(filename) != this->palettes.end();
-	if ((!useBuiltInPalette && !paletteIsLoaded) || 
-		(useBuiltInPalette && !imagePaletteIsLoaded))
-	{
-		// Use the filename (i.e., TAMRIEL.IMG) if using the built-in palette.
-		// Otherwise, use the given palette name (i.e., PAL.COL).
-		this->loadPalette(useBuiltInPalette ? filename : paletteName);
+		return *cachedTexture;
 	}
 
 	// The image hasn't been loaded with the palette yet, so make a new entry.
@@ -214,33 +533,12 @@ const Texture &TextureManager::getTexture(const std::string &filename,
 
 	if (isIMG || isMNU)
 	{
-		Surface surface = [this, &filename, &paletteName, useBuiltInPalette]()
-		{
-			const IMGFile img(filename);
-
-			// Decide if the .IMG will use its own palette or not.
-			const Palette &palette = useBuiltInPalette ?
-				*img.getPalette() : this->palettes.at(paletteName);
-
-			// Create a surface from the .IMG.
-			Surface surface = Surface::createWithFormat(img.getWidth(), img.getHeight(),
-				Renderer::DEFAULT_BPP, Renderer::DEFAULT_PIXELFORMAT);
-
-			// Generate 32-bit colors from each palette index in the .IMG pixels and
-			// write them to the destination image.
-			const uint8_t *srcPixels = img.getPixels();
-			uint32_t *dstPixels = static_cast<uint32_t*>(surface.get()->pixels);
-			std::transform(srcPixels, srcPixels + (img.getWidth() * img.getHeight()), dstPixels,
-				[&palette](uint8_t srcPixel)
-			{
-				return palette.get()[srcPixel].toARGB();
-			});
-
-			return surface;
-		}();
+		const Palette *palette = this->loadImagePalette(filename, paletteName);
+		const PalettedFrames frames = TextureManager::decodeImage(filename, palette);
+		std::vector<std::vector<Surface>> surfaceSets = this->makeSurfaces({ &frames });
 
 		// Create a texture from the surface.
-		texture = renderer.createTextureFromSurface(surface.get());
+		texture = renderer.createTextureFromSurface(surfaceSets.front().front().get());
 
 		// Set alpha transparency on.
 		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
@@ -251,8 +549,7 @@ const Texture &TextureManager::getTexture(const std::string &filename,
 	}
 
 	// Add the new texture and return it.
-	auto iter = this->textures.emplace(std::make_pair(fullName, Texture(texture))).first;
-	return iter->second;
+	return this->addCached(this->textures, fullName, filename, Texture(texture));
 }
 
 const Texture &TextureManager::getTexture(const std::string &filename, Renderer &renderer)
@@ -263,280 +560,321 @@ const Texture &TextureManager::getTexture(const std::string &filename, Renderer
 const std::vector<Surface> &TextureManager::getSurfaces(
 	const std::string &filename, const std::string &paletteName)
 {
-	// This method deals with animations and movies, so it will check filenames 
-	// for ".CFA", ".CIF", ".DFA", ".FLC", ".SET", etc..
-
 	// Use this name when interfacing with the surface sets map.
 	const std::string fullName = filename + paletteName;
 
 	// See if the file has already been loaded with the palette.
-	auto setIter = this->surfaceSets.find(fullName);
-	if (setIter != this->surfaceSets.end())
+	const std::vector<Surface> *cachedSet = this->findCached(this->surfaceSets, fullName);
+	if (cachedSet != nullptr)
 	{
-		// The requested texture set exists.
-		return setIter->second;
+		// The requested surface set exists.
+		return *cachedSet;
 	}
 
-	// Do not use a built-in palette for surface sets.
-	DebugAssertMsg(!Palette::isBuiltIn(paletteName),
-		"Image sets (i.e., .SET files) do not have built-in palettes.");
+	// The file hasn't been loaded with the palette yet, so make a new entry.
+	const Palette &palette = this->loadImageSetPalette(paletteName);
+	const PalettedFrames frames = TextureManager::decodeImageSet(filename, palette);
+	std::vector<std::vector<Surface>> surfaceSets = this->makeSurfaces({ &frames });
 
-	// See if the palette hasn't already been loaded.
-	if (this->palettes.find(paletteName) == this->palettes.end())
+	return this->addCached(this->surfaceSets, fullName, filename,
+		std::move(surfaceSets.front()));
+}
+
+const std::vector<Surface> &TextureManager::getSurfaces(const std::string &filename)
+{
+	return this->getSurfaces(filename, this->activePalette);
+}
+
+const std::vector<Texture> &TextureManager::getTextures(
+	const std::string &filename, const std::string &paletteName, Renderer &renderer)
+{
+	// Use this name when interfacing with the texture sets map.
+	const std::string fullName = filename + paletteName;
+
+	// See if the file has already been loaded with the palette.
+	const std::vector<Texture> *cachedSet = this->findCached(this->textureSets, fullName);
+	if (cachedSet != nullptr)
 	{
-		this->loadPalette(paletteName);
+		// The requested texture set exists.
+		return *cachedSet;
 	}
 
 	// The file hasn't been loaded with the palette yet, so make a new entry.
-	const auto iter = this->surfaceSets.emplace(
-		std::make_pair(fullName, std::vector<Surface>())).first;
+	const Palette &palette = this->loadImageSetPalette(paletteName);
+	const PalettedFrames frames = TextureManager::decodeImageSet(filename, palette);
+	const std::vector<std::vector<Surface>> surfaceSets = this->makeSurfaces({ &frames });
 
-	std::vector<Surface> &surfaceSet = iter->second;
-	const Palette &palette = this->palettes.at(paletteName);
+	// Textures have to be created on this thread, in frame order.
+	std::vector<Texture> textureSet;
+	for (const Surface &surface : surfaceSets.front())
+	{
+		SDL_Texture *texture = renderer.createTextureFromSurface(surface.get());
 
-	const std::string_view extension = StringView::getExtension(filename);
-	const bool isCFA = extension == "CFA";
-	const bool isCIF = extension == "CIF";
-	const bool isCEL = extension == "CEL";
-	const bool isDFA = extension == "DFA";
-	const bool isFLC = extension == "FLC";
-	const bool isRCI = extension == "RCI";
-	const bool isSET = extension == "SET";
+		// Set alpha transparency on.
+		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+		textureSet.push_back(Texture(texture));
+	}
 
-	if (isCFA)
-	{
-		const CFAFile cfaFile(filename);
+	return this->addCached(this->textureSets, fullName, filename, std::move(textureSet));
+}
 
-		// Create a surface for each image in the .CFA.
-		for (int i = 0; i < cfaFile.getImageCount(); i++)
+const std::vector<Texture> &TextureManager::getTextures(const std::string &filename,
+	Renderer &renderer)
+{
+	return this->getTextures(filename, this->activePalette, renderer);
+}
+
+void TextureManager::preloadSurfaces(const std::vector<std::string> &filenames,
+	const std::string &paletteName)
+{
+	struct Request
+	{
+		const std::string *filename;
+		std::string fullName;
+		bool isSet;
+		const Palette *palette;
+		PalettedFrames frames;
+	};
+
+	// Palettes are loaded here since the palettes map isn't safe to change from workers.
+	std::vector<Request> requests;
+	for (const std::string &filename : filenames)
+	{
+		Request request;
+		request.filename = &filename;
+		request.fullName = filename + paletteName;
+		request.isSet = TextureManager::isImageSet(filename);
+
+		const bool isLoaded = request.isSet ?
+			(this->surfaceSets.find(request.fullName) != this->surfaceSets.end()) :
+			(this->surfaces.find(request.fullName) != this->surfaces.end());
+		const bool isRequested = std::any_of(requests.begin(), requests.end(),
+			[&request](const Request &other)
 		{
-			Surface surface = TextureManager::make32BitFromPaletted(
-				cfaFile.getWidth(), cfaFile.getHeight(), cfaFile.getPixels(i), palette);
-			surfaceSet.push_back(std::move(surface));
-		}
-	}
-	else if (isCIF)
-	{
-		const CIFFile cifFile(filename);
+			return (other.isSet == request.isSet) && (other.fullName == request.fullName);
+		});
 
-		// Create a surface for each image in the .CIF.
-		for (int i = 0; i < cifFile.getImageCount(); i++)
+		if (isLoaded || isRequested)
 		{
-			Surface surface = TextureManager::make32BitFromPaletted(
-				cifFile.getWidth(i), cifFile.getHeight(i), cifFile.getPixels(i), palette);
-			surfaceSet.push_back(std::move(surface));
+			continue;
 		}
+
+		request.palette = request.isSet ? &this->loadImageSetPalette(paletteName) :
+			this->loadImagePalette(filename, paletteName);
+		requests.push_back(std::move(request));
 	}
-	else if (isDFA)
+
+	// One file per job. Frame expansion inside a job would run serially, so it's done
+	// afterwards for all files at once.
+	this->threadPool.run(static_cast<int>(requests.size()), [&requests](int index)
 	{
-		const DFAFile dfaFile(filename);
+		Request &request = requests[index];
+		request.frames = request.isSet ?
+			TextureManager::decodeImageSet(*request.filename, *request.palette) :
+			TextureManager::decodeImage(*request.filename, request.palette);
+	});
 
-		// Create a surface for each image in the .DFA.
-		for (int i = 0; i < dfaFile.getImageCount(); i++)
-		{
-			Surface surface = TextureManager::make32BitFromPaletted(
-				dfaFile.getWidth(), dfaFile.getHeight(), dfaFile.getPixels(i), palette);
-			surfaceSet.push_back(std::move(surface));
-		}
-	}
-	else if (isFLC || isCEL)
+	std::vector<const PalettedFrames*> frameSets;
+	for (const Request &request : requests)
 	{
-		const FLCFile flcFile(filename);
+		frameSets.push_back(&request.frames);
+	}
 
-		// Create a surface for each frame in the .FLC.
-		for (int i = 0; i < flcFile.getFrameCount(); i++)
+	std::vector<std::vector<Surface>> surfaceSets = this->makeSurfaces(frameSets);
+	for (size_t i = 0; i < requests.size(); i++)
+	{
+		const Request &request = requests[i];
+		if (request.isSet)
+		{
+			this->addCached(this->surfaceSets, request.fullName, *request.filename,
+				std::move(surfaceSets[i]));
+		}
+		else
 		{
-			Surface surface = TextureManager::make32BitFromPaletted(
-				flcFile.getWidth(), flcFile.getHeight(), flcFile.getPixels(i),
-				flcFile.getFramePalette(i));
-			surfaceSet.push_back(std::move(surface));
+			this->addCached(this->surfaces, request.fullName, *request.filename,
+				std::move(surfaceSets[i].front()));
 		}
 	}
-	else if (isRCI)
+}
+
+void TextureManager::preloadSurfaces(const std::vector<std::string> &filenames)
+{
+	this->preloadSurfaces(filenames, this->activePalette);
+}
+
+void TextureManager::prefetchFiles(const std::vector<std::string> &filenames)
+{
+	VFS::Manager::get().prefetch(filenames,
+		[this](int count, const std::function<void(int)> &job)
 	{
-		const RCIFile rciFile(filename);
+		this->threadPool.run(count, job);
+	});
+}
 
-		// Create a surface for each image in the .RCI.
-		for (int i = 0; i < rciFile.getImageCount(); i++)
-		{
-			Surface surface = TextureManager::make32BitFromPaletted(
-				RCIFile::WIDTH, RCIFile::HEIGHT, rciFile.getPixels(i), palette);
-			surfaceSet.push_back(std::move(surface));
-		}
+std::vector<std::vector<TextureManager::PalettedImage>> TextureManager::getPalettedImages(
+	const std::vector<std::string> &filenames)
+{
+	// Palettes are loaded here since the palettes map isn't safe to change from workers.
+	// The indices don't depend on the palette, but decoding needs one.
+	std::vector<const Palette*> palettes;
+	for (const std::string &filename : filenames)
+	{
+		palettes.push_back(TextureManager::isImageSet(filename) ?
+			&this->loadImageSetPalette(this->activePalette) :
+			this->loadImagePalette(filename, this->activePalette));
 	}
-	else if (isSET)
+
+	std::vector<std::vector<PalettedImage>> images(filenames.size());
+	this->threadPool.run(static_cast<int>(filenames.size()),
+		[&filenames, &palettes, &images](int index)
 	{
-		const SETFile setFile(filename);
+		const std::string &filename = filenames[index];
+		const PalettedFrames frames = TextureManager::isImageSet(filename) ?
+			TextureManager::decodeImageSet(filename, *palettes[index]) :
+			TextureManager::decodeImage(filename, palettes[index]);
 
-		// Create a surface for each image in the .SET.
-		for (int i = 0; i < setFile.getImageCount(); i++)
+		std::vector<PalettedImage> &fileImages = images[index];
+		for (const PalettedFrames::Frame &frame : frames.frames)
 		{
-			Surface surface = TextureManager::make32BitFromPaletted(
-				SETFile::CHUNK_WIDTH, SETFile::CHUNK_HEIGHT, setFile.getPixels(i), palette);
-			surfaceSet.push_back(std::move(surface));
+			const int pixelCount = frame.width * frame.height;
+			fileImages.push_back(PalettedImage { frame.width, frame.height,
+				std::vector<uint8_t>(frame.pixels, frame.pixels + pixelCount) });
 		}
-	}
-	else
-	{
-		DebugCrash("Unrecognized surface list \"" + filename + "\".");
-	}
+	});
 
-	return surfaceSet;
+	return images;
 }
 
-const std::vector<Surface> &TextureManager::getSurfaces(const std::string &filename)
+void TextureManager::init()
 {
-	return this->getSurfaces(filename, this->activePalette);
+	DebugMention("Initializing.");
+
+	// The calling thread works on jobs too, so one fewer worker than hardware threads.
+	this->threadPool.init(Platform::getThreadCount() - 1);
+
+	// Load default palette.
+	this->setPalette(PaletteFile::fromName(PaletteName::Default));
 }
 
-const std::vector<Texture> &TextureManager::getTextures(
-	const std::string &filename, const std::string &paletteName, Renderer &renderer)
+void TextureManager::setPinned(const std::string &filename, bool pinned)
 {
-	// This method deals with animations and movies, so it will check filenames 
-	// for ".CFA", ".CIF", ".DFA", ".FLC", ".SET", etc..
+	auto setEntriesPinned = [&filename, pinned](auto &cache)
+	{
+		for (auto &pair : cache)
+		{
+			auto &entry = pair.second;
+			if (entry.filename == filename)
+			{
+				entry.pinned = pinned;
+			}
+		}
+	};
 
-	// Use this name when interfacing with the texture sets map.
-	const std::string fullName = filename + paletteName;
+	setEntriesPinned(this->surfaces);
+	setEntriesPinned(this->textures);
+	setEntriesPinned(this->surfaceSets);
+	setEntriesPinned(this->textureSets);
+}
 
-	// See if the file has already been loaded with the palette.
-	auto setIter = this->textureSets.find(fullName);
-	if (setIter != this->textureSets.end())
+void TextureManager::pin(const std::string &filename)
+{
+	int &pinCount = this->pinCounts[filename];
+	pinCount++;
+
+	if (pinCount == 1)
 	{
-		// The requested texture set exists.
-		return setIter->second;
+		this->setPinned(filename, true);
 	}
+}
 
-	// Do not use a built-in palette for texture sets.
-	DebugAssertMsg(!Palette::isBuiltIn(paletteName),
-		"Image sets (i.e., .SET files) do not have built-in palettes.");
+void TextureManager::unpin(const std::string &filename)
+{
+	auto iter = this->pinCounts.find(filename);
+	DebugAssertMsg(iter != this->pinCounts.end(), "\"" + filename + "\" is not pinned.");
 
-	// See if the palette hasn't already been loaded.
-	if (this->palettes.find(paletteName) == this->palettes.end())
+	iter->second--;
+	if (iter->second == 0)
 	{
-		this->loadPalette(paletteName);
+		// Now evictable like any other image, once it goes unused.
+		this->pinCounts.erase(iter);
+		this->setPinned(filename, false);
 	}
+}
 
-	// The file hasn't been loaded with the palette yet, so make a new entry.
-	const auto iter = this->textureSets.emplace(
-		std::make_pair(fullName, std::vector<Texture>())).first;
-
-	std::vector<Texture> &textureSet = iter->second;
-	const Palette &palette = this->palettes.at(paletteName);
-
-	const std::string_view extension = StringView::getExtension(filename);
-	const bool isCFA = extension == "CFA";
-	const bool isCIF = extension == "CIF";
-	const bool isCEL = extension == "CEL";
-	const bool isDFA = extension == "DFA";
-	const bool isFLC = extension == "FLC";
-	const bool isRCI = extension == "RCI";
-	const bool isSET = extension == "SET";
-
-	if (isCFA)
-	{
-		const CFAFile cfaFile(filename);
+void TextureManager::setCacheBudget(size_t byteCount)
+{
+	this->byteBudget = byteCount;
+}
 
-		// Create a texture for each image in the .CFA.
-		for (int i = 0; i < cfaFile.getImageCount(); i++)
-		{
-			Surface surface = TextureManager::make32BitFromPaletted(
-				cfaFile.getWidth(), cfaFile.getHeight(), cfaFile.getPixels(i), palette);
-			SDL_Texture *texture = renderer.createTextureFromSurface(surface.get());
-			textureSet.push_back(Texture(texture));
-		}
-	}
-	else if (isCIF)
+void TextureManager::trim()
+{
+	if ((this->byteBudget > 0) && (this->byteCount > this->byteBudget))
 	{
-		const CIFFile cifFile(filename);
+		std::vector<EvictionCandidate> candidates;
+		addEvictionCandidates(this->surfaces, this->frame, candidates);
+		addEvictionCandidates(this->textures, this->frame, candidates);
+		addEvictionCandidates(this->surfaceSets, this->frame, candidates);
+		addEvictionCandidates(this->textureSets, this->frame, candidates);
 
-		// Create a texture for each image in the .CIF.
-		for (int i = 0; i < cifFile.getImageCount(); i++)
+		// Least recently used first.
+		std::sort(candidates.begin(), candidates.end(),
+			[](const EvictionCandidate &a, const EvictionCandidate &b)
 		{
-			Surface surface = TextureManager::make32BitFromPaletted(
-				cifFile.getWidth(i), cifFile.getHeight(i), cifFile.getPixels(i), palette);
-			SDL_Texture *texture = renderer.createTextureFromSurface(surface.get());
-			textureSet.push_back(Texture(texture));
-		}
-	}
-	else if (isDFA)
-	{
-		const DFAFile dfaFile(filename);
+			return a.lastUsedFrame < b.lastUsedFrame;
+		});
 
-		// Create a texture for each image in the .DFA.
-		for (int i = 0; i < dfaFile.getImageCount(); i++)
+		for (const EvictionCandidate &candidate : candidates)
 		{
-			Surface surface = TextureManager::make32BitFromPaletted(
-				dfaFile.getWidth(), dfaFile.getHeight(), dfaFile.getPixels(i), palette);
-			SDL_Texture *texture = renderer.createTextureFromSurface(surface.get());
-			textureSet.push_back(Texture(texture));
-		}
-	}
-	else if (isFLC || isCEL)
-	{
-		const FLCFile flcFile(filename);
+			if (this->byteCount <= this->byteBudget)
+			{
+				break;
+			}
 
-		// Create a texture for each frame in the .FLC.
-		for (int i = 0; i < flcFile.getFrameCount(); i++)
-		{
-			Surface surface = TextureManager::make32BitFromPaletted(
-				flcFile.getWidth(), flcFile.getHeight(), flcFile.getPixels(i),
-				flcFile.getFramePalette(i));
-			SDL_Texture *texture = renderer.createTextureFromSurface(surface.get());
-			textureSet.push_back(Texture(texture));
+			candidate.erase();
+			this->byteCount -= candidate.byteCount;
+			this->evictionCount++;
 		}
 	}
-	else if (isRCI)
-	{
-		const RCIFile rciFile(filename);
 
-		// Create a texture for each image in the .RCI.
-		for (int i = 0; i < rciFile.getImageCount(); i++)
-		{
-			Surface surface = TextureManager::make32BitFromPaletted(
-				RCIFile::WIDTH, RCIFile::HEIGHT, rciFile.getPixels(i), palette);
-			SDL_Texture *texture = renderer.createTextureFromSurface(surface.get());
-			textureSet.push_back(Texture(texture));
-		}
-	}
-	else if (isSET)
-	{
-		const SETFile setFile(filename);
+	this->frame++;
+}
 
-		// Create a texture for each image in the .SET.
-		for (int i = 0; i < setFile.getImageCount(); i++)
+TextureManager::CacheStats TextureManager::getCacheStats() const
+{
+	CacheStats stats;
+	stats.surfaceCount = static_cast<int>(this->surfaces.size());
+	stats.textureCount = static_cast<int>(this->textures.size());
+	stats.surfaceSetCount = static_cast<int>(this->surfaceSets.size());
+	stats.textureSetCount = static_cast<int>(this->textureSets.size());
+	stats.byteCount = this->byteCount;
+	stats.byteBudget = this->byteBudget;
+	stats.hitCount = this->hitCount;
+	stats.missCount = this->missCount;
+	stats.evictionCount = this->evictionCount;
+
+	stats.pinnedByteCount = 0;
+	auto addPinnedBytes = [&stats](const auto &cache)
+	{
+		for (const auto &pair : cache)
 		{
-			Surface surface = TextureManager::make32BitFromPaletted(
-				SETFile::CHUNK_WIDTH, SETFile::CHUNK_HEIGHT, setFile.getPixels(i), palette);
-			SDL_Texture *texture = renderer.createTextureFromSurface(surface.get());
-			textureSet.push_back(Texture(texture));
+			if (pair.second.pinned)
+			{
+				stats.pinnedByteCount += pair.second.byteCount;
+			}
 		}
-	}
-	else
-	{
-		DebugCrash("Unrecognized texture list \"" + filename + "\".");
-	}
-
-	// Set alpha transparency on for each texture.
-	for (auto &texture : textureSet)
-	{
-		SDL_SetTextureBlendMode(texture.get(), SDL_BLENDMODE_BLEND);
-	}
+	};
 
-	return textureSet;
-}
+	addPinnedBytes(this->surfaces);
+	addPinnedBytes(this->textures);
+	addPinnedBytes(this->surfaceSets);
+	addPinnedBytes(this->textureSets);
 
-const std::vector<Texture> &TextureManager::getTextures(const std::string &filename,
-	Renderer &renderer)
-{
-	return this->getTextures(filename, this->activePalette, renderer);
+	return stats;
 }
 
-void TextureManager::init()
+const Palette &TextureManager::getPalette() const
 {
-	DebugMention("Initializing.");
-
-	// Load default palette.
-	this->setPalette(PaletteFile::fromName(PaletteName::Default));
+	return this->palettes.at(this->activePalette);
 }
 
 void TextureManager::setPalette(const std::string &paletteName)
@@ -1,6 +1,9 @@
 #ifndef TEXTURE_MANAGER_H
 #define TEXTURE_MANAGER_H
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -8,22 +11,93 @@
 #include "Palette.h"
 #include "../Rendering/Surface.h"
 #include "../Rendering/Texture.h"
+#include "../Utilities/ThreadPool.h"
 
 class Renderer;
 
 class TextureManager
 {
+public:
+	// Residency of the image caches and counters since startup.
+	struct CacheStats
+	{
+		int surfaceCount, textureCount, surfaceSetCount, textureSetCount;
+		size_t byteCount, pinnedByteCount, byteBudget;
+		uint64_t hitCount, missCount, evictionCount;
+	};
+
+	// Holds one pin on a file for as long as it exists, for owners like a level that need
+	// their images kept until they're destroyed. The texture manager must outlive it.
+	class PinHandle
+	{
+	private:
+		TextureManager *textureManager;
+		std::string filename;
+	public:
+		PinHandle(TextureManager &textureManager, const std::string &filename);
+		PinHandle(PinHandle &&pinHandle);
+		PinHandle(const PinHandle&) = delete;
+		~PinHandle();
+
+		PinHandle &operator=(PinHandle &&pinHandle);
+		PinHandle &operator=(const PinHandle&) = delete;
+	};
+
+	// One frame of an image file as 8-bit palette indices.
+	struct PalettedImage
+	{
+		int width, height;
+		std::vector<uint8_t> pixels;
+	};
 private:
+	// A cached image (or set of images) and what's needed to decide when to evict it.
+	template <typename T>
+	struct CacheEntry
+	{
+		T value;
+		std::string filename; // For matching pins, since the key includes the palette.
+		size_t byteCount;
+		uint64_t lastUsedFrame;
+		bool pinned;
+	};
+
+	// 8-bit frames decoded from an image file, waiting to be expanded to 32-bit surfaces.
+	// The owner keeps the decoded file (and with it the pixels and palettes) alive.
+	struct PalettedFrames
+	{
+		struct Frame
+		{
+			int width, height;
+			const uint8_t *pixels;
+			const Palette *palette;
+		};
+
+		std::shared_ptr<const void> owner;
+		std::vector<Frame> frames;
+	};
+
 	std::unordered_map<std::string, Palette> palettes;
 
 	// The filename and palette name are concatenated when mapping to avoid using two 
 	// maps. I.e., "EQUIPMEN.IMG" and "PAL.COL" become "EQUIPMEN.IMGPAL.COL".
-	std::unordered_map<std::string, Surface> surfaces;
-	std::unordered_map<std::string, Texture> textures;
-	std::unordered_map<std::string, std::vector<Surface>> surfaceSets;
-	std::unordered_map<std::string, std::vector<Texture>> textureSets;
+	std::unordered_map<std::string, CacheEntry<Surface>> surfaces;
+	std::unordered_map<std::string, CacheEntry<Texture>> textures;
+	std::unordered_map<std::string, CacheEntry<std::vector<Surface>>> surfaceSets;
+	std::unordered_map<std::string, CacheEntry<std::vector<Texture>>> textureSets;
 	std::string activePalette;
 
+	// Number of pins on each filename. Its images are never evicted while it has any,
+	// regardless of palette.
+	std::unordered_map<std::string, int> pinCounts;
+
+	size_t byteCount; // Pixel bytes held by all four caches.
+	size_t byteBudget; // Zero means no limit.
+	uint64_t frame; // Advanced by each trim() so images used since then can be told apart.
+	uint64_t hitCount, missCount, evictionCount;
+
+	// Decodes files and expands frames in parallel. Only used from the main thread.
+	ThreadPool threadPool;
+
 	// Specialty method for loading a COL file into the palettes map.
 	void loadCOLPalette(const std::string &colName);
 
@@ -32,7 +106,44 @@ private:
 
 	// Helper method for loading a palette file into the palettes map.
 	void loadPalette(const std::string &paletteName);
+
+	// Loads the palette an image will use if it isn't loaded yet. Returns null if the
+	// image uses its built-in palette.
+	const Palette *loadImagePalette(const std::string &filename, const std::string &paletteName);
+
+	// Loads the palette for an image set if it isn't loaded yet (sets have no built-in one).
+	const Palette &loadImageSetPalette(const std::string &paletteName);
+
+	// Returns whether the file holds a set of images (i.e., .CFA or .SET) instead of one.
+	static bool isImageSet(const std::string &filename);
+
+	// Decodes a single-image file (.COL, .IMG, .MNU). A null palette means the image's
+	// built-in one. These decode functions are safe to call from worker threads.
+	static PalettedFrames decodeImage(const std::string &filename, const Palette *palette);
+
+	// Decodes every frame of an image set (.CFA, .CIF, .DFA, .FLC, .RCI, .SET, etc.).
+	static PalettedFrames decodeImageSet(const std::string &filename, const Palette &palette);
+
+	// Returns the cached value for the given key and marks it as used, or null if it
+	// isn't cached.
+	template <typename T>
+	const T *findCached(std::unordered_map<std::string, CacheEntry<T>> &cache,
+		const std::string &fullName);
+
+	// Adds a newly loaded value to a cache and returns it.
+	template <typename T>
+	const T &addCached(std::unordered_map<std::string, CacheEntry<T>> &cache,
+		const std::string &fullName, const std::string &filename, T &&value);
+
+	// Marks or unmarks every cached image loaded from the given file as pinned.
+	void setPinned(const std::string &filename, bool pinned);
+
+	// Expands each frame set to 32-bit surfaces, in order. Surfaces are created on this
+	// thread and their pixels filled by the thread pool.
+	std::vector<std::vector<Surface>> makeSurfaces(
+		const std::vector<const PalettedFrames*> &frameSets);
 public:
+	TextureManager();
 	~TextureManager();
 
 	TextureManager &operator=(TextureManager &&textureManager) = delete;
@@ -63,6 +174,44 @@ public:
 		const std::string &paletteName, Renderer &renderer);
 	const std::vector<Texture> &getTextures(const std::string &filename, Renderer &renderer);
 
+	// Loads any of the given files not yet loaded with the palette, decoding them in
+	// parallel. Single images become surfaces and image sets become surface sets, so later
+	// getSurface() and getSurfaces() calls for them are lookups.
+	void preloadSurfaces(const std::vector<std::string> &filenames,
+		const std::string &paletteName);
+	void preloadSurfaces(const std::vector<std::string> &filenames);
+
+	// Decodes the compressed archive entries of the given files on the thread pool, so a
+	// batch of loads that aren't images (i.e., a level's map files) don't decode them one
+	// at a time.
+	void prefetchFiles(const std::vector<std::string> &filenames);
+
+	// Decodes the given files in parallel and returns the palette indices of each one's
+	// frames, in order, for callers that draw with indices instead of 32-bit color. The
+	// results aren't cached.
+	std::vector<std::vector<PalettedImage>> getPalettedImages(
+		const std::vector<std::string> &filenames);
+
+	// Keeps every image loaded from the given file in memory, for things like the
+	// interface and cursors that are needed all the time. Pins are counted, so a file
+	// pinned by several owners stays pinned until each of them calls unpin().
+	void pin(const std::string &filename);
+	void unpin(const std::string &filename);
+
+	// Sets how many bytes of pixels the caches may hold before trim() evicts anything.
+	// Zero means no limit.
+	void setCacheBudget(size_t byteCount);
+
+	// Evicts the least recently used images until the caches fit in the budget. Images
+	// used since the last call are never evicted, so references handed out during a
+	// frame stay valid until the end of it. Called once per frame.
+	void trim();
+
+	CacheStats getCacheStats() const;
+
+	// Gets the palette that subsequent images are loaded with.
+	const Palette &getPalette() const;
+
 	void init();
 
 	// Sets the palette to use for subsequent images. The source of the palette can be
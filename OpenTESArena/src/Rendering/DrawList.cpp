@@ -0,0 +1,179 @@
+#include <algorithm>
+
+#include "SDL.h"
+
+#include "DrawList.h"
+
+namespace
+{
+	bool rectsOverlap(const SDL_Rect &a, const SDL_Rect &b)
+	{
+		return (a.x < (b.x + b.w)) && (b.x < (a.x + a.w)) &&
+			(a.y < (b.y + b.h)) && (b.y < (a.y + a.h));
+	}
+
+	bool rectsEqual(const SDL_Rect &a, const SDL_Rect &b)
+	{
+		return (a.x == b.x) && (a.y == b.y) && (a.w == b.w) && (a.h == b.h);
+	}
+
+	Rect getUnion(const Rect &a, const Rect &b)
+	{
+		const int left = std::min(a.getLeft(), b.getLeft());
+		const int top = std::min(a.getTop(), b.getTop());
+		const int right = std::max(a.getLeft() + a.getWidth(), b.getLeft() + b.getWidth());
+		const int bottom = std::max(a.getTop() + a.getHeight(), b.getTop() + b.getHeight());
+		return Rect(left, top, right - left, bottom - top);
+	}
+}
+
+const int DrawList::MAX_LOOKBACK = 16;
+
+DrawList::Stats::Stats()
+{
+	this->drawCount = 0;
+	this->batchCount = 0;
+	this->textureSwitchCount = 0;
+}
+
+DrawList::DrawList()
+{
+	this->batchCount = 0;
+	this->hasClipRect = false;
+}
+
+void DrawList::add(SDL_Texture *texture, const Rect *srcRect, const Rect &dstRect,
+	const Color &color, bool blend)
+{
+	Command command;
+	command.srcRect = (srcRect != nullptr) ? *srcRect : Rect();
+	command.dstRect = dstRect;
+	command.hasSrcRect = srcRect != nullptr;
+
+	// Look for a batch with the same state that the draw can be moved into without
+	// passing over anything it overlaps.
+	const int lastIndex = std::max(this->batchCount - DrawList::MAX_LOOKBACK, 0);
+	for (int i = this->batchCount - 1; i >= lastIndex; i--)
+	{
+		Batch &batch = this->batches[i];
+		const bool sameClip = (batch.hasClipRect == this->hasClipRect) &&
+			(!this->hasClipRect || rectsEqual(batch.clipRect.getRect(), this->clipRect.getRect()));
+
+		if ((batch.texture == texture) && (batch.color == color) && (batch.blend == blend) &&
+			sameClip)
+		{
+			batch.commands.push_back(command);
+			batch.bounds = getUnion(batch.bounds, dstRect);
+			return;
+		}
+
+		if (rectsOverlap(batch.bounds.getRect(), dstRect.getRect()))
+		{
+			break;
+		}
+	}
+
+	// Start a new batch, reusing old storage if there is any.
+	if (this->batchCount == static_cast<int>(this->batches.size()))
+	{
+		this->batches.push_back(Batch());
+	}
+
+	Batch &batch = this->batches[this->batchCount];
+	batch.commands.clear();
+	batch.commands.push_back(command);
+	batch.texture = texture;
+	batch.color = color;
+	batch.clipRect = this->clipRect;
+	batch.bounds = dstRect;
+	batch.hasClipRect = this->hasClipRect;
+	batch.blend = blend;
+	this->batchCount++;
+}
+
+void DrawList::setClipRect(const SDL_Rect *rect)
+{
+	this->hasClipRect = rect != nullptr;
+	this->clipRect = (rect != nullptr) ? Rect(rect->x, rect->y, rect->w, rect->h) : Rect();
+}
+
+void DrawList::addCopy(SDL_Texture *texture, const Rect *srcRect, const Rect &dstRect,
+	const Color &color)
+{
+	this->add(texture, srcRect, dstRect, color, false);
+}
+
+void DrawList::addFill(const Color &color, const Rect &dstRect, bool blend)
+{
+	this->add(nullptr, nullptr, dstRect, color, blend);
+}
+
+void DrawList::flush(SDL_Renderer *renderer)
+{
+	if (this->batchCount == 0)
+	{
+		return;
+	}
+
+	const SDL_Texture *prevTexture = nullptr;
+	for (int i = 0; i < this->batchCount; i++)
+	{
+		const Batch &batch = this->batches[i];
+		const bool clipChanged = (i == 0) ||
+			(batch.hasClipRect != this->batches[i - 1].hasClipRect) ||
+			(batch.hasClipRect && !rectsEqual(batch.clipRect.getRect(),
+				this->batches[i - 1].clipRect.getRect()));
+
+		if (clipChanged)
+		{
+			SDL_RenderSetClipRect(renderer, batch.hasClipRect ? &batch.clipRect.getRect() : nullptr);
+		}
+
+		if (batch.texture != nullptr)
+		{
+			SDL_SetTextureColorMod(batch.texture, batch.color.r, batch.color.g, batch.color.b);
+			SDL_SetTextureAlphaMod(batch.texture, batch.color.a);
+
+			for (const Command &command : batch.commands)
+			{
+				SDL_RenderCopy(renderer, batch.texture,
+					command.hasSrcRect ? &command.srcRect.getRect() : nullptr,
+					&command.dstRect.getRect());
+			}
+		}
+		else
+		{
+			SDL_SetRenderDrawColor(renderer, batch.color.r, batch.color.g,
+				batch.color.b, batch.color.a);
+			SDL_SetRenderDrawBlendMode(renderer,
+				batch.blend ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+
+			for (const Command &command : batch.commands)
+			{
+				SDL_RenderFillRect(renderer, &command.dstRect.getRect());
+			}
+
+			SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+		}
+
+		this->stats.drawCount += static_cast<int>(batch.commands.size());
+		this->stats.textureSwitchCount += (batch.texture != prevTexture) ? 1 : 0;
+		prevTexture = batch.texture;
+	}
+
+	this->stats.batchCount += this->batchCount;
+	this->batchCount = 0;
+
+	SDL_RenderSetClipRect(renderer, this->hasClipRect ? &this->clipRect.getRect() : nullptr);
+}
+
+void DrawList::endFrame()
+{
+	this->frameStats = this->stats;
+	this->stats = Stats();
+}
+
+const DrawList::Stats &DrawList::getFrameStats() const
+{
+	return this->frameStats;
+}
@@ -0,0 +1,86 @@
+#ifndef DRAW_LIST_H
+#define DRAW_LIST_H
+
+#include <vector>
+
+#include "../Math/Rect.h"
+#include "../Media/Color.h"
+
+// Records a frame's texture copies and color fills in native screen space, then
+// submits them in batches that share a texture, color and clip rectangle. A draw only
+// joins an earlier batch if it doesn't overlap anything drawn after that batch, so the
+// result is the same as drawing everything in the order it was recorded.
+
+// Textures given to the draw list must stay alive until it's flushed.
+
+struct SDL_Renderer;
+struct SDL_Texture;
+
+class DrawList
+{
+public:
+	// Counters for one frame's worth of flushes.
+	struct Stats
+	{
+		int drawCount; // Texture copies and fills submitted.
+		int batchCount; // Runs of draws sharing the same state.
+		int textureSwitchCount; // Batches whose texture differs from the previous one.
+
+		Stats();
+	};
+private:
+	struct Command
+	{
+		Rect srcRect, dstRect;
+		bool hasSrcRect;
+	};
+
+	struct Batch
+	{
+		std::vector<Command> commands;
+		SDL_Texture *texture; // Null for solid color fills.
+		Color color; // Texture color and alpha modulation, or the fill color.
+		Rect clipRect, bounds; // Bounds is the union of all destinations.
+		bool hasClipRect;
+		bool blend; // Whether fills are blended with what's underneath.
+	};
+
+	// Number of batches searched back through for one a draw can join.
+	static const int MAX_LOOKBACK;
+
+	std::vector<Batch> batches; // Storage is kept between flushes.
+	Stats stats, frameStats;
+	Rect clipRect;
+	int batchCount; // Number of batches in use.
+	bool hasClipRect;
+
+	// Adds a draw to the latest compatible batch it can be moved into, or a new batch.
+	void add(SDL_Texture *texture, const Rect *srcRect, const Rect &dstRect, const Color &color,
+		bool blend);
+public:
+	DrawList();
+
+	// Sets the clip rectangle for draws recorded from now on. Null disables clipping.
+	void setClipRect(const SDL_Rect *rect);
+
+	// Records a copy of a texture (or part of it) to a destination rectangle, modulated
+	// by the given color.
+	void addCopy(SDL_Texture *texture, const Rect *srcRect, const Rect &dstRect,
+		const Color &color);
+
+	// Records a fill of a rectangle with a color. If blending, translucent colors are mixed
+	// with what's underneath, otherwise the color replaces it.
+	void addFill(const Color &color, const Rect &dstRect, bool blend);
+
+	// Submits all recorded draws to the renderer's current target and clears the list.
+	// The renderer's clip rectangle is left as the one last set on the draw list.
+	void flush(SDL_Renderer *renderer);
+
+	// Makes the counters since the last call available from getFrameStats().
+	void endFrame();
+
+	// Gets the counters of the most recently finished frame.
+	const Stats &getFrameStats() const;
+};
+
+#endif
@@ -8,6 +8,9 @@ namespace RenderParams
 {
 	constexpr uint32_t PostProcessing = 0b1;
 	constexpr uint32_t Bloom = 0b10; 
+	constexpr uint32_t IndexedColor = 0b100;
+	constexpr uint32_t DebugOverdraw = 0b1000; // False color writes per pixel.
+	constexpr uint32_t DebugRaySteps = 0b10000; // False color DDA steps per column.
 }
 
 #endif
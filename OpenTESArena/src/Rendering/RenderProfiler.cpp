@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
+
+#include "RenderProfiler.h"
+#include "../Utilities/Debug.h"
+
+RenderProfiler::Summary::Summary()
+{
+	this->min = 0.0;
+	this->avg = 0.0;
+	this->p99 = 0.0;
+}
+
+RenderProfiler::RenderProfiler()
+{
+	this->clear();
+}
+
+RenderProfiler::Summary RenderProfiler::makeSummary(const Window &window, int count)
+{
+	Summary summary;
+	if (count == 0)
+	{
+		return summary;
+	}
+
+	// Sort a copy so the window keeps its insertion order.
+	std::array<double, WINDOW_SIZE> sorted;
+	std::copy(window.begin(), window.begin() + count, sorted.begin());
+	std::sort(sorted.begin(), sorted.begin() + count);
+
+	const int p99Index = std::min(count - 1,
+		static_cast<int>(std::ceil(static_cast<double>(count) * 0.99)) - 1);
+
+	summary.min = sorted.front();
+	summary.avg = std::accumulate(sorted.begin(), sorted.begin() + count, 0.0) /
+		static_cast<double>(count);
+	summary.p99 = sorted.at(std::max(p99Index, 0));
+	return summary;
+}
+
+const char *RenderProfiler::getPhaseName(Phase phase)
+{
+	switch (phase)
+	{
+	case Phase::SkyGradient:
+		return "Sky gradient";
+	case Phase::DistantVisibility:
+		return "Distant vis";
+	case Phase::DistantSky:
+		return "Distant sky";
+	case Phase::Voxels:
+		return "Voxels";
+	case Phase::Planes:
+		return "Planes";
+	case Phase::FlatVisibility:
+		return "Flat vis/sort";
+	case Phase::Flats:
+		return "Flats";
+	case Phase::PaletteResolve:
+		return "Palette";
+	case Phase::PostProcessing:
+		return "Post-process";
+	case Phase::TextureUpload:
+		return "Upload";
+	case Phase::Total:
+		return "Total";
+	default:
+		throw DebugException("Invalid render phase \"" +
+			std::to_string(static_cast<int>(phase)) + "\".");
+	}
+}
+
+int RenderProfiler::getFrameCount() const
+{
+	return this->frameCount;
+}
+
+int RenderProfiler::getThreadCount() const
+{
+	return static_cast<int>(this->threadBusyTimes.size());
+}
+
+RenderProfiler::Summary RenderProfiler::getPhaseSummary(Phase phase) const
+{
+	const Window &window = this->phaseTimes.at(static_cast<int>(phase));
+	return RenderProfiler::makeSummary(window, this->frameCount);
+}
+
+RenderProfiler::Summary RenderProfiler::getThreadBusySummary(int threadIndex) const
+{
+	const Window &window = this->threadBusyTimes.at(threadIndex);
+	return RenderProfiler::makeSummary(window, this->frameCount);
+}
+
+void RenderProfiler::addFrame(const SoftwareRenderer::FrameTimings &timings,
+	double textureUploadTime)
+{
+	// Restart the window if the render thread count changed (i.e., a thread mode change)
+	// so old and new per-thread times aren't mixed.
+	const int threadCount = static_cast<int>(timings.threads.size());
+	if (threadCount != this->getThreadCount())
+	{
+		this->clear();
+		this->threadBusyTimes = std::vector<Window>(threadCount);
+	}
+
+	auto setPhase = [this](Phase phase, double time)
+	{
+		this->phaseTimes.at(static_cast<int>(phase)).at(this->nextIndex) = time;
+	};
+
+	setPhase(Phase::SkyGradient, timings.skyGradient);
+	setPhase(Phase::DistantVisibility, timings.distantVisibility);
+	setPhase(Phase::DistantSky, timings.distantSky);
+	setPhase(Phase::Voxels, timings.voxels);
+	setPhase(Phase::Planes, timings.planes);
+	setPhase(Phase::FlatVisibility, timings.flatVisibility);
+	setPhase(Phase::Flats, timings.flats);
+	setPhase(Phase::PaletteResolve, timings.paletteResolve);
+	setPhase(Phase::PostProcessing, timings.postProcessing);
+	setPhase(Phase::TextureUpload, textureUploadTime);
+	setPhase(Phase::Total, timings.total + textureUploadTime);
+
+	for (int i = 0; i < threadCount; i++)
+	{
+		this->threadBusyTimes.at(i).at(this->nextIndex) = timings.threads.at(i).getTotal();
+	}
+
+	this->nextIndex = (this->nextIndex + 1) % WINDOW_SIZE;
+	this->frameCount = std::min(this->frameCount + 1, WINDOW_SIZE);
+}
+
+void RenderProfiler::clear()
+{
+	for (Window &window : this->phaseTimes)
+	{
+		window.fill(0.0);
+	}
+
+	for (Window &window : this->threadBusyTimes)
+	{
+		window.fill(0.0);
+	}
+
+	this->frameCount = 0;
+	this->nextIndex = 0;
+}
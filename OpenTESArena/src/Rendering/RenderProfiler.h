@@ -0,0 +1,77 @@
+#ifndef RENDER_PROFILER_H
+#define RENDER_PROFILER_H
+
+#include <array>
+#include <vector>
+
+#include "SoftwareRenderer.h"
+
+// Keeps a rolling window of per-phase game world render timings so spikes and
+// thread imbalance can be seen in-game without an external profiler.
+
+class RenderProfiler
+{
+public:
+	enum class Phase
+	{
+		SkyGradient,
+		DistantVisibility,
+		DistantSky,
+		Voxels,
+		Planes,
+		FlatVisibility,
+		Flats,
+		PaletteResolve,
+		PostProcessing,
+		TextureUpload,
+		Total
+	};
+
+	static constexpr int PHASE_COUNT = static_cast<int>(Phase::Total) + 1;
+
+	// Number of frames kept in the rolling window.
+	static constexpr int WINDOW_SIZE = 120;
+
+	// Statistics in milliseconds over the frames currently in the window.
+	struct Summary
+	{
+		double min, avg, p99;
+
+		Summary();
+	};
+private:
+	typedef std::array<double, WINDOW_SIZE> Window;
+
+	std::array<Window, PHASE_COUNT> phaseTimes;
+	std::vector<Window> threadBusyTimes; // Work time per render thread, excluding waits.
+	int frameCount; // Number of valid entries in each window (saturates at WINDOW_SIZE).
+	int nextIndex; // Index the next frame is written to.
+
+	static Summary makeSummary(const Window &window, int count);
+public:
+	RenderProfiler();
+
+	// Gets the display name of a phase.
+	static const char *getPhaseName(Phase phase);
+
+	// Gets the number of frames currently in the window.
+	int getFrameCount() const;
+
+	// Gets the number of render threads being tracked.
+	int getThreadCount() const;
+
+	// Gets min/avg/p99 of a phase over the window.
+	Summary getPhaseSummary(Phase phase) const;
+
+	// Gets min/avg/p99 of a render thread's busy time over the window.
+	Summary getThreadBusySummary(int threadIndex) const;
+
+	// Adds the most recent frame's timings to the window. This should be called once
+	// per rendered game world frame.
+	void addFrame(const SoftwareRenderer::FrameTimings &timings, double textureUploadTime);
+
+	// Empties the window.
+	void clear();
+};
+
+#endif
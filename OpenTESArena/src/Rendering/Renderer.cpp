@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 
 #include "SDL.h"
@@ -10,6 +11,7 @@
 #include "../Math/Constants.h"
 #include "../Math/Rect.h"
 #include "../Media/Color.h"
+#include "../Media/TextLayout.h"
 #include "../Utilities/Debug.h"
 #include "../World/VoxelGrid.h"
 
@@ -33,6 +35,9 @@ Renderer::Renderer()
 	this->renderer = nullptr;
 	this->nativeTexture = nullptr;
 	this->gameWorldTexture = nullptr;
+	this->cursorTexture = nullptr;
+	this->hasClipRect = false;
+	this->hasRepaintRect = false;
 	this->letterboxMode = 0;
 	this->fullGameWindow = false;
 }
@@ -208,6 +213,21 @@ Surface Renderer::getScreenshot() const
 	return screenshot;
 }
 
+const DrawList::Stats &Renderer::getDrawListStats() const
+{
+	return this->drawList.getFrameStats();
+}
+
+const RenderProfiler &Renderer::getRenderProfiler() const
+{
+	return this->renderProfiler;
+}
+
+const SoftwareRenderer::DebugViewStats &Renderer::getDebugViewStats() const
+{
+	return this->softwareRenderer.getDebugViewStats();
+}
+
 Int2 Renderer::nativeToOriginal(const Int2 &nativePoint) const
 {
 	// From native point to letterbox point.
@@ -436,7 +456,66 @@ void Renderer::warpMouse(int x, int y)
 
 void Renderer::setClipRect(const SDL_Rect *rect)
 {
-	SDL_RenderSetClipRect(this->renderer, rect);
+	this->hasClipRect = rect != nullptr;
+	if (this->hasClipRect)
+	{
+		this->clipRect = Rect(rect->x, rect->y, rect->w, rect->h);
+	}
+
+	this->applyClipRect();
+}
+
+void Renderer::setRepaintRect(const Rect *originalRect)
+{
+	this->hasRepaintRect = originalRect != nullptr;
+	if (this->hasRepaintRect)
+	{
+		// Grow the region by a native pixel on each side in case scaling rounded away
+		// part of an edge. Redrawing a little extra is harmless.
+		const Rect nativeRect = this->originalToNative(*originalRect);
+		this->repaintRect = Rect(nativeRect.getLeft() - 1, nativeRect.getTop() - 1,
+			nativeRect.getWidth() + 2, nativeRect.getHeight() + 2);
+	}
+
+	this->applyClipRect();
+}
+
+void Renderer::applyClipRect()
+{
+	SDL_Rect rect;
+	const SDL_Rect *rectPtr = nullptr;
+	if (this->hasClipRect && this->hasRepaintRect)
+	{
+		if (!SDL_IntersectRect(&this->clipRect.getRect(), &this->repaintRect.getRect(), &rect))
+		{
+			// An empty clip rectangle disables clipping, so use one off the frame buffer.
+			rect.x = -1;
+			rect.y = -1;
+			rect.w = 1;
+			rect.h = 1;
+		}
+
+		rectPtr = &rect;
+	}
+	else if (this->hasClipRect)
+	{
+		rectPtr = &this->clipRect.getRect();
+	}
+	else if (this->hasRepaintRect)
+	{
+		rectPtr = &this->repaintRect.getRect();
+	}
+
+	// Recorded draws keep the clip rectangle they were made with.
+	this->drawList.setClipRect(rectPtr);
+	SDL_SetRenderTarget(this->renderer, this->nativeTexture);
+	SDL_RenderSetClipRect(this->renderer, rectPtr);
+}
+
+void Renderer::flushDrawList()
+{
+	SDL_SetRenderTarget(this->renderer, this->nativeTexture);
+	this->drawList.flush(this->renderer);
 }
 
 void Renderer::initializeWorldRendering(double resolutionScale, bool fullGameWindow,
@@ -522,10 +601,11 @@ void Renderer::setFogDistance(double fogDistance)
 	this->softwareRenderer.setFogDistance(fogDistance);
 }
 
-void Renderer::setVoxelTexture(int id, const uint32_t *srcTexels)
+void Renderer::setVoxelTexture(int id, const uint32_t *srcTexels,
+	const uint8_t *srcPaletteIndices)
 {
 	assert(this->softwareRenderer.isInited());
-	this->softwareRenderer.setVoxelTexture(id, srcTexels);
+	this->softwareRenderer.setVoxelTexture(id, srcTexels, srcPaletteIndices);
 }
 
 void Renderer::setFlatTexture(int id, const uint32_t *srcTexels, int width, int height)
@@ -546,6 +626,12 @@ void Renderer::setSkyPalette(const uint32_t *colors, int count)
 	this->softwareRenderer.setSkyPalette(colors, count);
 }
 
+void Renderer::setVoxelPalette(const uint32_t *colors, int count)
+{
+	assert(this->softwareRenderer.isInited());
+	this->softwareRenderer.setVoxelPalette(colors, count);
+}
+
 void Renderer::setNightLightsActive(bool active)
 {
 	assert(this->softwareRenderer.isInited());
@@ -578,9 +664,20 @@ void Renderer::clearDistantSky()
 
 void Renderer::clear(const Color &color)
 {
-	SDL_SetRenderTarget(this->renderer, this->nativeTexture);
+	this->flushDrawList();
 	SDL_SetRenderDrawColor(this->renderer, color.r, color.g, color.b, color.a);
-	SDL_RenderClear(this->renderer);
+
+	if (this->hasRepaintRect)
+	{
+		// Clearing ignores the clip rectangle, so only fill the region being redrawn.
+		SDL_RenderSetClipRect(this->renderer, nullptr);
+		SDL_RenderFillRect(this->renderer, &this->repaintRect.getRect());
+		this->applyClipRect();
+	}
+	else
+	{
+		SDL_RenderClear(this->renderer);
+	}
 }
 
 void Renderer::clear()
@@ -590,7 +687,7 @@ void Renderer::clear()
 
 void Renderer::clearOriginal(const Color &color)
 {
-	SDL_SetRenderTarget(this->renderer, this->nativeTexture);
+	this->flushDrawList();
 	SDL_SetRenderDrawColor(this->renderer, color.r, color.g, color.b, color.a);
 
 	const SDL_Rect rect = this->getLetterboxDimensions();
@@ -604,21 +701,21 @@ void Renderer::clearOriginal()
 
 void Renderer::drawPixel(const Color &color, int x, int y)
 {
-	SDL_SetRenderTarget(this->renderer, this->nativeTexture);
+	this->flushDrawList();
 	SDL_SetRenderDrawColor(this->renderer, color.r, color.g, color.b, color.a);
 	SDL_RenderDrawPoint(this->renderer, x, y);
 }
 
 void Renderer::drawLine(const Color &color, int x1, int y1, int x2, int y2)
 {
-	SDL_SetRenderTarget(this->renderer, this->nativeTexture);
+	this->flushDrawList();
 	SDL_SetRenderDrawColor(this->renderer, color.r, color.g, color.b, color.a);
 	SDL_RenderDrawLine(this->renderer, x1, y1, x2, y2);
 }
 
 void Renderer::drawRect(const Color &color, int x, int y, int w, int h)
 {
-	SDL_SetRenderTarget(this->renderer, this->nativeTexture);
+	this->flushDrawList();
 	SDL_SetRenderDrawColor(this->renderer, color.r, color.g, color.b, color.a);
 
 	SDL_Rect rect;
@@ -632,7 +729,7 @@ void Renderer::drawRect(const Color &color, int x, int y, int w, int h)
 
 void Renderer::fillRect(const Color &color, int x, int y, int w, int h)
 {
-	SDL_SetRenderTarget(this->renderer, this->nativeTexture);
+	this->flushDrawList();
 	SDL_SetRenderDrawColor(this->renderer, color.r, color.g, color.b, color.a);
 
 	SDL_Rect rect;
@@ -646,11 +743,14 @@ void Renderer::fillRect(const Color &color, int x, int y, int w, int h)
 
 void Renderer::fillOriginalRect(const Color &color, int x, int y, int w, int h)
 {
-	SDL_SetRenderTarget(this->renderer, this->nativeTexture);
-	SDL_SetRenderDrawColor(this->renderer, color.r, color.g, color.b, color.a);
+	const Rect rect = this->originalToNative(Rect(x, y, w, h));
+	this->drawList.addFill(color, rect, false);
+}
 
+void Renderer::blendOriginalRect(const Color &color, int x, int y, int w, int h)
+{
 	const Rect rect = this->originalToNative(Rect(x, y, w, h));
-	SDL_RenderFillRect(this->renderer, &rect.getRect());
+	this->drawList.addFill(color, rect, true);
 }
 
 void Renderer::renderWorld(const Double3 &eye, const Double3 &forward, double fovY,
@@ -675,12 +775,20 @@ void Renderer::renderWorld(const Double3 &eye, const Double3 &forward, double fo
 		parallaxSky, ceilingHeight, openDoors, voxelGrid, gameWorldPixels);
 
 	// Update the game world texture with the new ARGB8888 pixels.
+	const auto uploadStart = std::chrono::high_resolution_clock::now();
 	SDL_UnlockTexture(this->gameWorldTexture);
 
-	// Now copy to the native frame buffer (stretching if needed).
+	// Now copy to the native frame buffer (stretching if needed). The copy is flushed right
+	// away instead of with the interface so the upload time includes it.
 	const int screenWidth = this->getWindowDimensions().x;
 	const int viewHeight = this->getViewHeight();
 	this->draw(this->gameWorldTexture, 0, 0, screenWidth, viewHeight);
+	this->flushDrawList();
+
+	const auto uploadEnd = std::chrono::high_resolution_clock::now();
+	const double uploadTime = std::chrono::duration<double, std::milli>(
+		uploadEnd - uploadStart).count();
+	this->renderProfiler.addFrame(this->softwareRenderer.getFrameTimings(), uploadTime);
 }
 
 void Renderer::drawCursor(SDL_Texture *cursor, CursorAlignment alignment,
@@ -741,7 +849,8 @@ void Renderer::drawCursor(SDL_Texture *cursor, CursorAlignment alignment,
 		return Int2(xOffset, yOffset);
 	}();
 
-	this->draw(cursor,
+	this->cursorTexture = cursor;
+	this->cursorRect = Rect(
 		mousePosition.x - cursorOffset.x,
 		mousePosition.y - cursorOffset.y,
 		scaledWidth,
@@ -750,15 +859,7 @@ void Renderer::drawCursor(SDL_Texture *cursor, CursorAlignment alignment,
 
 void Renderer::draw(SDL_Texture *texture, int x, int y, int w, int h)
 {
-	SDL_SetRenderTarget(this->renderer, this->nativeTexture);
-
-	SDL_Rect rect;
-	rect.x = x;
-	rect.y = y;
-	rect.w = w;
-	rect.h = h;
-
-	SDL_RenderCopy(this->renderer, texture, nullptr, &rect);
+	this->drawList.addCopy(texture, nullptr, Rect(x, y, w, h), Color::White);
 }
 
 void Renderer::draw(SDL_Texture *texture, int x, int y)
@@ -776,8 +877,7 @@ void Renderer::draw(SDL_Texture *texture)
 
 void Renderer::drawClipped(SDL_Texture *texture, const Rect &srcRect, const Rect &dstRect)
 {
-	SDL_SetRenderTarget(this->renderer, this->nativeTexture);
-	SDL_RenderCopy(this->renderer, texture, &srcRect.getRect(), &dstRect.getRect());
+	this->drawList.addCopy(texture, &srcRect, dstRect, Color::White);
 }
 
 void Renderer::drawClipped(SDL_Texture *texture, const Rect &srcRect, int x, int y)
@@ -787,13 +887,11 @@ void Renderer::drawClipped(SDL_Texture *texture, const Rect &srcRect, int x, int
 
 void Renderer::drawOriginal(SDL_Texture *texture, int x, int y, int w, int h)
 {
-	SDL_SetRenderTarget(this->renderer, this->nativeTexture);
-	
 	// The given coordinates and dimensions are in 320x200 space, so transform them
 	// to native space.
 	const Rect rect = this->originalToNative(Rect(x, y, w, h));
 
-	SDL_RenderCopy(this->renderer, texture, nullptr, &rect.getRect());
+	this->drawList.addCopy(texture, nullptr, rect, Color::White);
 }
 
 void Renderer::drawOriginal(SDL_Texture *texture, int x, int y)
@@ -809,15 +907,27 @@ void Renderer::drawOriginal(SDL_Texture *texture)
 	this->drawOriginal(texture, 0, 0);
 }
 
-void Renderer::drawOriginalClipped(SDL_Texture *texture, const Rect &srcRect, const Rect &dstRect)
+void Renderer::drawOriginalText(const TextLayout &layout, const Color &color, int x, int y)
 {
-	SDL_SetRenderTarget(this->renderer, this->nativeTexture);
+	// The atlas is white, so modulating it gives the text color. Text of the same color
+	// ends up in the same batch unless something overlaps it in between.
+	for (const TextLayout::Glyph &glyph : layout.glyphs)
+	{
+		const Rect &srcRect = glyph.atlasRect;
+		const Rect dstRect = this->originalToNative(Rect(x + glyph.offset.x,
+			y + glyph.offset.y, srcRect.getWidth(), srcRect.getHeight()));
 
+		this->drawList.addCopy(layout.atlasTexture, &srcRect, dstRect, color);
+	}
+}
+
+void Renderer::drawOriginalClipped(SDL_Texture *texture, const Rect &srcRect, const Rect &dstRect)
+{
 	// The destination coordinates and dimensions are in 320x200 space, so transform 
 	// them to native space.
 	const Rect rect = this->originalToNative(dstRect);
 
-	SDL_RenderCopy(this->renderer, texture, &srcRect.getRect(), &rect.getRect());
+	this->drawList.addCopy(texture, &srcRect, rect, Color::White);
 }
 
 void Renderer::drawOriginalClipped(SDL_Texture *texture, const Rect &srcRect, int x, int y)
@@ -828,13 +938,33 @@ void Renderer::drawOriginalClipped(SDL_Texture *texture, const Rect &srcRect, in
 
 void Renderer::fill(SDL_Texture *texture)
 {
-	SDL_SetRenderTarget(this->renderer, this->nativeTexture);
-	SDL_RenderCopy(this->renderer, texture, nullptr, nullptr);
+	int width, height;
+	SDL_QueryTexture(this->nativeTexture, nullptr, nullptr, &width, &height);
+
+	this->drawList.addCopy(texture, nullptr, Rect(width, height), Color::White);
 }
 
-void Renderer::present()
+void Renderer::drawFrame()
 {
+	this->flushDrawList();
+	this->drawList.endFrame();
+
 	SDL_SetRenderTarget(this->renderer, nullptr);
 	SDL_RenderCopy(this->renderer, this->nativeTexture, nullptr, nullptr);
+
+	// The cursor goes on top of the copy so the native frame buffer can be presented
+	// again next frame if nothing in it has changed.
+	if (this->cursorTexture != nullptr)
+	{
+		SDL_SetTextureColorMod(this->cursorTexture, 255, 255, 255);
+		SDL_SetTextureAlphaMod(this->cursorTexture, 255);
+		SDL_RenderCopy(this->renderer, this->cursorTexture, nullptr,
+			&this->cursorRect.getRect());
+		this->cursorTexture = nullptr;
+	}
+}
+
+void Renderer::present()
+{
 	SDL_RenderPresent(this->renderer);
 }
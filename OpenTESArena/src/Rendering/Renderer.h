@@ -6,7 +6,10 @@
 #include <string>
 #include <vector>
 
+#include "DrawList.h"
+#include "RenderProfiler.h"
 #include "SoftwareRenderer.h"
+#include "../Math/Rect.h"
 #include "../Math/Vector2.h"
 #include "../Math/Vector3.h"
 #include "../World/LevelData.h"
@@ -17,10 +20,11 @@
 
 class Color;
 class DistantSky;
-class Rect;
 class Surface;
 class VoxelGrid;
 
+struct TextLayout;
+
 enum class CursorAlignment;
 
 struct SDL_Rect;
@@ -46,7 +50,13 @@ private:
 	SDL_Window *window;
 	SDL_Renderer *renderer;
 	SDL_Texture *nativeTexture, *gameWorldTexture; // Frame buffers.
+	SDL_Texture *cursorTexture; // Drawn over the native frame buffer when presenting.
+	Rect cursorRect;
+	Rect clipRect, repaintRect; // Clip rectangle set by the caller, and region being redrawn.
+	bool hasClipRect, hasRepaintRect;
 	SoftwareRenderer softwareRenderer; // Game world renderer.
+	DrawList drawList; // Texture copies and fills waiting to be drawn to the native frame buffer.
+	RenderProfiler renderProfiler; // Rolling game world render timings.
 	int letterboxMode; // Determines aspect ratio of the original UI (16:10, 4:3, etc.).
 	bool fullGameWindow; // Determines height of 3D frame buffer.
 	uint32_t renderParams; // Render parameters (flags)
@@ -56,6 +66,14 @@ private:
 
 	// For use with window dimensions, etc.. No longer used for rendering.
 	SDL_Surface *getWindowSurface() const;
+
+	// Submits the recorded draws to the native frame buffer. Called before anything that
+	// draws to it directly, so draws still land in the order they were made.
+	void flushDrawList();
+
+	// Sets the renderer's clip rectangle to the intersection of the caller's clip
+	// rectangle and the repaint rectangle, whichever are active.
+	void applyClipRect();
 public:
 	// Only defined so members are initialized for Game ctor exception handling.
 	Renderer();
@@ -89,9 +107,20 @@ public:
 	// using the given letterbox aspect.
 	SDL_Rect getLetterboxDimensions() const;
 
-	// Gets a screenshot of the current window.
+	// Gets a screenshot of the window, including the cursor. Only valid between
+	// drawFrame() and present(), since the window is redrawn from the native frame
+	// buffer each frame.
 	Surface getScreenshot() const;
 
+	// Gets the rolling per-phase timings of recent game world frames.
+	const RenderProfiler &getRenderProfiler() const;
+
+	// Gets the counters from the most recent game world frame's debug views.
+	const SoftwareRenderer::DebugViewStats &getDebugViewStats() const;
+
+	// Gets the draw and texture switch counts of the most recently presented frame.
+	const DrawList::Stats &getDrawListStats() const;
+
 	// Transforms a native window (i.e., 1920x1080) point or rectangle to an original 
 	// (320x200) point or rectangle. Points outside the letterbox will either be negative 
 	// or outside the 320x200 limit when returned.
@@ -133,6 +162,11 @@ public:
 	// will not be rendered. If rect is null, then clipping is disabled.
 	void setClipRect(const SDL_Rect *rect);
 
+	// Limits drawing to a region in original space until called again with null, so a
+	// panel that has only changed in places can redraw just those places. Clearing only
+	// clears this region, and the native frame buffer keeps everything outside of it.
+	void setRepaintRect(const Rect *originalRect);
+
 	// Initialize the renderer for the game world. The "fullGameWindow" argument 
 	// determines whether to render a "fullscreen" 3D image or just the part above 
 	// the game interface. If there is an existing renderer in memory, it will be 
@@ -159,10 +193,11 @@ public:
 	void updateLight(int id, const Double3 *point, const Double3 *color,
 		const double *intensity);
 	void setFogDistance(double fogDistance);
-	void setVoxelTexture(int id, const uint32_t *srcTexels);
+	void setVoxelTexture(int id, const uint32_t *srcTexels, const uint8_t *srcPaletteIndices);
 	void setFlatTexture(int id, const uint32_t *srcTexels, int width, int height);
 	void setDistantSky(const DistantSky &distantSky);
 	void setSkyPalette(const uint32_t *colors, int count);
+	void setVoxelPalette(const uint32_t *colors, int count);
 	void setNightLightsActive(bool active);
 	void removeFlat(int id);
 	void removeLight(int id);
@@ -184,6 +219,10 @@ public:
 	void fillRect(const Color &color, int x, int y, int w, int h);
 	void fillOriginalRect(const Color &color, int x, int y, int w, int h);
 
+	// Fills a rectangle in original screen space, blending translucent colors (i.e., tooltip
+	// backgrounds) with what's underneath.
+	void blendOriginalRect(const Color &color, int x, int y, int w, int h);
+
 	// Runs the 3D renderer which draws the world onto the native frame buffer.
 	// If the renderer is uninitialized, this causes a crash.
 	void renderWorld(const Double3 &eye, const Double3 &forward, double fovY, 
@@ -191,12 +230,14 @@ public:
 		double ceilingHeight, const std::vector<LevelData::DoorState> &openDoors,
 		const VoxelGrid &voxelGrid);
 
-	// Draws the given cursor texture to the native frame buffer. The exact position 
-	// of the cursor is modified by the cursor alignment.
+	// Sets the cursor texture to draw over the next presented frame. It isn't drawn to
+	// the native frame buffer, so that buffer stays reusable when only the mouse moves.
+	// The exact position of the cursor is modified by the cursor alignment.
 	void drawCursor(SDL_Texture *texture, CursorAlignment alignment, 
 		const Int2 &mousePosition, double scale);
 
-	// Draw methods for the native and original frame buffers.
+	// Draw methods for the native and original frame buffers. These are recorded and
+	// submitted in batches by present(), so the textures must stay alive until then.
 	void draw(SDL_Texture *texture, int x, int y, int w, int h);
 	void draw(SDL_Texture *texture, int x, int y);
 	void draw(SDL_Texture *texture);
@@ -208,10 +249,18 @@ public:
 	void drawOriginalClipped(SDL_Texture *texture, const Rect &srcRect, const Rect &dstRect);
 	void drawOriginalClipped(SDL_Texture *texture, const Rect &srcRect, int x, int y);
 
+	// Draws laid-out text in original space as one quad per character from its font atlas,
+	// tinted with the given color.
+	void drawOriginalText(const TextLayout &layout, const Color &color, int x, int y);
+
 	// Stretches a texture over the entire native frame buffer.
 	void fill(SDL_Texture *texture);
 
-	// Refreshes the displayed frame buffer.
+	// Submits the frame's draws and copies the native frame buffer and the cursor to the
+	// window.
+	void drawFrame();
+
+	// Refreshes the displayed frame buffer. Called after drawFrame().
 	void present();
 };
 
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <limits>
 
@@ -21,6 +22,7 @@ SoftwareRenderer::VoxelTexel::VoxelTexel()
 	this->b = 0.0;
 	this->emission = 0.0;
 	this->transparent = false;
+	this->paletteIndex = 0;
 }
 
 SoftwareRenderer::FlatTexel::FlatTexel()
@@ -39,6 +41,11 @@ SoftwareRenderer::SkyTexel::SkyTexel()
 	this->transparent = false;
 }
 
+SoftwareRenderer::VoxelTexture::VoxelTexture()
+{
+	this->hasPaletteIndices = false;
+}
+
 SoftwareRenderer::FlatTexture::FlatTexture()
 {
 	this->width = 0;
@@ -291,11 +298,24 @@ const Double3 &SoftwareRenderer::ShadingInfo::getFogColor() const
 }
 
 SoftwareRenderer::FrameView::FrameView(uint32_t *colorBuffer, uint32_t *emissionBuffer, double *depthBuffer, 
-	int width, int height)
+	uint32_t *planeBuffer, const double *planeRowScales, const Double2 *columnRayDirs,
+	const double *columnDepthScales, uint8_t *indexBuffer, uint8_t *indexCoverage,
+	const uint8_t *colormaps, const uint32_t *palette, uint8_t *overdrawBuffer,
+	uint16_t *rayStepCounts, int width, int height)
 {
 	this->colorBuffer = colorBuffer;
 	this->emissionBuffer = emissionBuffer;
 	this->depthBuffer = depthBuffer;
+	this->planeBuffer = planeBuffer;
+	this->planeRowScales = planeRowScales;
+	this->columnRayDirs = columnRayDirs;
+	this->columnDepthScales = columnDepthScales;
+	this->indexBuffer = indexBuffer;
+	this->indexCoverage = indexCoverage;
+	this->colormaps = colormaps;
+	this->palette = palette;
+	this->overdrawBuffer = overdrawBuffer;
+	this->rayStepCounts = rayStepCounts;
 	this->width = width;
 	this->height = height;
 	this->widthReal = static_cast<double>(width);
@@ -570,6 +590,16 @@ void SoftwareRenderer::RenderThreadData::Voxels::init(double ceilingHeight,
 	this->occlusion = &occlusion;
 }
 
+void SoftwareRenderer::RenderThreadData::Planes::init()
+{
+	this->threadsDone = 0;
+}
+
+void SoftwareRenderer::RenderThreadData::PaletteResolve::init()
+{
+	this->threadsDone = 0;
+}
+
 void SoftwareRenderer::RenderThreadData::Flats::init(const Double3 &flatNormal,
 	const std::vector<VisibleFlat> &visibleFlats, const std::vector<FlatTexture> &flatTextures)
 {
@@ -580,6 +610,44 @@ void SoftwareRenderer::RenderThreadData::Flats::init(const Double3 &flatNormal,
 	this->doneSorting = false;
 }
 
+SoftwareRenderer::FrameTimings::ThreadTimings::ThreadTimings()
+{
+	this->skyGradient = 0.0;
+	this->distantSky = 0.0;
+	this->voxels = 0.0;
+	this->planes = 0.0;
+	this->flats = 0.0;
+	this->paletteResolve = 0.0;
+}
+
+double SoftwareRenderer::FrameTimings::ThreadTimings::getTotal() const
+{
+	return this->skyGradient + this->distantSky + this->voxels + this->planes +
+		this->flats + this->paletteResolve;
+}
+
+SoftwareRenderer::FrameTimings::FrameTimings()
+{
+	this->skyGradient = 0.0;
+	this->distantVisibility = 0.0;
+	this->distantSky = 0.0;
+	this->voxels = 0.0;
+	this->planes = 0.0;
+	this->flatVisibility = 0.0;
+	this->flats = 0.0;
+	this->paletteResolve = 0.0;
+	this->postProcessing = 0.0;
+	this->total = 0.0;
+}
+
+SoftwareRenderer::DebugViewStats::DebugViewStats()
+{
+	this->avgOverdraw = 0.0;
+	this->avgRaySteps = 0.0;
+	this->maxOverdraw = 0;
+	this->maxRaySteps = 0;
+}
+
 SoftwareRenderer::RenderThreadData::RenderThreadData()
 {
 	// Make sure 'go' is initialized to false.
@@ -589,15 +657,18 @@ SoftwareRenderer::RenderThreadData::RenderThreadData()
 	this->camera = nullptr;
 	this->shadingInfo = nullptr;
 	this->frame = nullptr;
+	this->timings = nullptr;
 }
 
 void SoftwareRenderer::RenderThreadData::init(int totalThreads, const Camera &camera,
-	const ShadingInfo &shadingInfo, const FrameView &frame)
+	const ShadingInfo &shadingInfo, const FrameView &frame, FrameTimings &timings)
 {
 	this->totalThreads = totalThreads;
 	this->camera = &camera;
 	this->shadingInfo = &shadingInfo;
 	this->frame = &frame;
+	this->timings = &timings;
+	this->stageStart = std::chrono::high_resolution_clock::now();
 	this->go = false;
 	this->isDestructing = false;
 }
@@ -608,6 +679,10 @@ const double SoftwareRenderer::CHASM_FILL_DEPTH = 0.25;
 const int SoftwareRenderer::DEFAULT_VOXEL_TEXTURE_COUNT = 64;
 const int SoftwareRenderer::DEFAULT_FLAT_TEXTURE_COUNT = 256;
 const double SoftwareRenderer::DOOR_MIN_VISIBLE = 0.10;
+const int SoftwareRenderer::COLORMAP_LIGHT_LEVELS = 32;
+const int SoftwareRenderer::COLORMAP_FOG_LEVELS = 16;
+const int SoftwareRenderer::OVERDRAW_HEATMAP_MAX = 8;
+const int SoftwareRenderer::RAY_STEPS_HEATMAP_MAX = 128;
 const double SoftwareRenderer::SKY_GRADIENT_ANGLE = 30.0;
 const double SoftwareRenderer::DISTANT_CLOUDS_MAX_ANGLE = 25.0;
 const double SoftwareRenderer::TALL_PIXEL_RATIO = 1.20;
@@ -684,6 +759,28 @@ void SoftwareRenderer::init(int width, int height, int renderThreadsMode, uint32
 	this->depthBuffer = std::vector<double>(pixelCount,
 		std::numeric_limits<double>::infinity());
 
+	// Initialize floor and ceiling plane buffers. The plane buffer is left empty by the row
+	// pass at the end of every frame, so it only needs clearing here.
+	this->planeBuffer = std::vector<uint32_t>(pixelCount, 0);
+	this->planeRowScales = std::vector<double>(height, 0.0);
+
+	// Initialize per-column ray tables. They are filled in on the first frame.
+	this->columnRayDirs = std::vector<Double2>(width, Double2::Zero);
+	this->columnDepthScales = std::vector<double>(width, 0.0);
+	this->columnRaysFovY = 0.0;
+
+	// Initialize indexed color buffers. The sky gradient clears coverage each frame when
+	// they're used.
+	this->indexBuffer = std::vector<uint8_t>(pixelCount, 0);
+	this->indexCoverage = std::vector<uint8_t>(pixelCount, 0);
+	this->colormaps.clear();
+	this->colormapsFogColor = 0;
+
+	// Initialize debug view buffers. The sky gradient resets overdraw counts each frame, and
+	// every column writes its ray step count.
+	this->overdrawBuffer = std::vector<uint8_t>(pixelCount, 0);
+	this->rayStepCounts = std::vector<uint16_t>(width, 0);
+
 	// Initialize occlusion columns.
 	this->occlusion = std::vector<OcclusionData>(width, OcclusionData(0, height));
 
@@ -722,6 +819,16 @@ void SoftwareRenderer::setRenderParams(uint32_t renderParams)
 	this->renderParams = renderParams;
 }
 
+const SoftwareRenderer::FrameTimings &SoftwareRenderer::getFrameTimings() const
+{
+	return this->frameTimings;
+}
+
+const SoftwareRenderer::DebugViewStats &SoftwareRenderer::getDebugViewStats() const
+{
+	return this->debugViewStats;
+}
+
 void SoftwareRenderer::addFlat(int id, const Double3 &position, double width, 
 	double height, int textureID)
 {
@@ -746,12 +853,75 @@ void SoftwareRenderer::addLight(int id, const Double3 &point, const Double3 &col
 	DebugNotImplemented();
 }
 
-void SoftwareRenderer::setVoxelTexture(int id, const uint32_t *srcTexels)
+void SoftwareRenderer::setVoxelPalette(const uint32_t *colors, int count)
+{
+	DebugAssertMsg(count <= 256, "Too many voxel palette colors (" +
+		std::to_string(count) + ").");
+
+	// Keep only the RGB part so resolved pixels match the rest of the frame buffer.
+	std::vector<uint32_t> palette(256, 0);
+	for (int i = 0; i < count; i++)
+	{
+		palette[i] = colors[i] & 0x00FFFFFF;
+	}
+
+	if (palette == this->voxelPalette)
+	{
+		return;
+	}
+
+	this->voxelPalette = std::move(palette);
+
+	// Map every 15-bit color to its nearest palette color. This is only for colors made by
+	// the renderer (colormap entries and night lights); texels keep their source indices.
+	this->voxelPaletteLookup = std::vector<uint8_t>(1 << 15);
+	for (int i = 0; i < static_cast<int>(this->voxelPaletteLookup.size()); i++)
+	{
+		const int r = (((i >> 10) & 0x1F) << 3) + 4;
+		const int g = (((i >> 5) & 0x1F) << 3) + 4;
+		const int b = ((i & 0x1F) << 3) + 4;
+
+		int nearestIndex = 0;
+		int nearestDistSqr = std::numeric_limits<int>::max();
+		for (int j = 0; j < static_cast<int>(this->voxelPalette.size()); j++)
+		{
+			const uint32_t color = this->voxelPalette[j];
+			const int dr = static_cast<int>((color >> 16) & 0xFF) - r;
+			const int dg = static_cast<int>((color >> 8) & 0xFF) - g;
+			const int db = static_cast<int>(color & 0xFF) - b;
+			const int distSqr = (dr * dr) + (dg * dg) + (db * db);
+
+			if (distSqr < nearestDistSqr)
+			{
+				nearestIndex = j;
+				nearestDistSqr = distSqr;
+			}
+		}
+
+		this->voxelPaletteLookup[i] = static_cast<uint8_t>(nearestIndex);
+	}
+
+	// Re-index night light texels for the new palette and force the colormaps to be rebuilt.
+	for (auto &texture : this->voxelTextures)
+	{
+		for (const Int2 &lightTexel : texture.lightTexels)
+		{
+			VoxelTexel &texel = texture.texels[lightTexel.x + (lightTexel.y * VoxelTexture::WIDTH)];
+			texel.paletteIndex = this->getVoxelPaletteIndex(Double3(texel.r, texel.g, texel.b));
+		}
+	}
+
+	this->colormaps.clear();
+}
+
+void SoftwareRenderer::setVoxelTexture(int id, const uint32_t *srcTexels,
+	const uint8_t *srcPaletteIndices)
 {
 	// Clear the selected texture.
 	VoxelTexture &texture = this->voxelTextures.at(id);
 	std::fill(texture.texels.begin(), texture.texels.end(), VoxelTexel());
 	texture.lightTexels.clear();
+	texture.hasPaletteIndices = srcPaletteIndices != nullptr;
 
 	for (int y = 0; y < VoxelTexture::HEIGHT; y++)
 	{
@@ -772,6 +942,11 @@ void SoftwareRenderer::setVoxelTexture(int id, const uint32_t *srcTexels)
 			dstTexel.b = srcTexel.z;
 			dstTexel.transparent = srcTexel.w == 0.0;
 
+			if (srcPaletteIndices != nullptr)
+			{
+				dstTexel.paletteIndex = srcPaletteIndices[index];
+			}
+
 			// If it's a white texel, it's used with night lights (i.e., yellow at night).
 			const bool isWhite = (srcTexel.x == 1.0) && (srcTexel.y == 1.0) && (srcTexel.z == 1.0);
 
@@ -894,6 +1069,8 @@ void SoftwareRenderer::setNightLightsActive(bool active)
 			texel.b = texelColor.z;
 			texel.transparent = texelColor.w == 0.0;
 			texel.emission = texelEmission;
+			texel.paletteIndex = this->getVoxelPaletteIndex(
+				Double3(texelColor.x, texelColor.y, texelColor.z));
 		}
 	}
 }
@@ -919,6 +1096,7 @@ void SoftwareRenderer::clearTextures()
 	{
 		std::fill(texture.texels.begin(), texture.texels.end(), VoxelTexel());
 		texture.lightTexels.clear();
+		texture.hasPaletteIndices = false;
 	}
 
 	for (auto &texture : this->flatTextures)
@@ -945,6 +1123,22 @@ void SoftwareRenderer::resize(int width, int height)
 	std::fill(this->depthBuffer.begin(), this->depthBuffer.end(), 
 		std::numeric_limits<double>::infinity());
 
+	this->planeBuffer.resize(pixelCount);
+	std::fill(this->planeBuffer.begin(), this->planeBuffer.end(), 0);
+
+	this->planeRowScales.resize(height);
+
+	// Column ray tables depend on the aspect ratio, so they are rebuilt on the next frame.
+	this->columnRayDirs.resize(width);
+	this->columnDepthScales.resize(width);
+	this->columnRaysFovY = 0.0;
+
+	this->indexBuffer.resize(pixelCount);
+	this->indexCoverage.resize(pixelCount);
+
+	this->overdrawBuffer.resize(pixelCount);
+	this->rayStepCounts.resize(width);
+
 	this->occlusion.resize(width);
 	std::fill(this->occlusion.begin(), this->occlusion.end(), OcclusionData(0, height));
 
@@ -959,6 +1153,179 @@ void SoftwareRenderer::resize(int width, int height)
 	this->initRenderThreads(width, height, threadCount);
 }
 
+uint8_t SoftwareRenderer::getVoxelPaletteIndex(const Double3 &color) const
+{
+	if (this->voxelPaletteLookup.size() == 0)
+	{
+		return 0;
+	}
+
+	const uint32_t rgb = color.clamped(0.0, 1.0).toRGB();
+	const int lookupIndex = (((rgb >> 19) & 0x1F) << 10) | (((rgb >> 11) & 0x1F) << 5) |
+		((rgb >> 3) & 0x1F);
+	return this->voxelPaletteLookup[lookupIndex];
+}
+
+void SoftwareRenderer::updateColormaps(const Double3 &fogColor)
+{
+	const int paletteSize = static_cast<int>(this->voxelPalette.size());
+	this->colormaps.resize(SoftwareRenderer::COLORMAP_LIGHT_LEVELS *
+		SoftwareRenderer::COLORMAP_FOG_LEVELS * paletteSize);
+
+	for (int lightLevel = 0; lightLevel < SoftwareRenderer::COLORMAP_LIGHT_LEVELS; lightLevel++)
+	{
+		const double lightPercent = static_cast<double>(lightLevel) /
+			static_cast<double>(SoftwareRenderer::COLORMAP_LIGHT_LEVELS - 1);
+
+		for (int fogLevel = 0; fogLevel < SoftwareRenderer::COLORMAP_FOG_LEVELS; fogLevel++)
+		{
+			const double fogPercent = static_cast<double>(fogLevel) /
+				static_cast<double>(SoftwareRenderer::COLORMAP_FOG_LEVELS - 1);
+			uint8_t *colormap = this->colormaps.data() + (((lightLevel *
+				SoftwareRenderer::COLORMAP_FOG_LEVELS) + fogLevel) * paletteSize);
+
+			for (int i = 0; i < paletteSize; i++)
+			{
+				const Double3 litColor = Double3::fromRGB(this->voxelPalette[i]) * lightPercent;
+				const Double3 color = litColor + ((fogColor - litColor) * fogPercent);
+				colormap[i] = this->getVoxelPaletteIndex(color);
+			}
+		}
+	}
+
+	this->colormapsFogColor = fogColor.toRGB();
+}
+
+const uint8_t *SoftwareRenderer::getColormap(const Double3 &shading, double fogPercent,
+	const FrameView &frame)
+{
+	// Colormaps only have one light value, so colored light is averaged.
+	const double lightPercent = (shading.x + shading.y + shading.z) / 3.0;
+	const int lightLevel = std::clamp(static_cast<int>((lightPercent *
+		static_cast<double>(SoftwareRenderer::COLORMAP_LIGHT_LEVELS - 1)) + 0.50),
+		0, SoftwareRenderer::COLORMAP_LIGHT_LEVELS - 1);
+	const int fogLevel = std::clamp(static_cast<int>((fogPercent *
+		static_cast<double>(SoftwareRenderer::COLORMAP_FOG_LEVELS - 1)) + 0.50),
+		0, SoftwareRenderer::COLORMAP_FOG_LEVELS - 1);
+
+	return frame.colormaps +
+		(((lightLevel * SoftwareRenderer::COLORMAP_FOG_LEVELS) + fogLevel) * 256);
+}
+
+void SoftwareRenderer::addOverdraw(int index, const FrameView &frame)
+{
+	if (frame.overdrawBuffer != nullptr)
+	{
+		// Saturate instead of wrapping so pathological pixels stay hot.
+		uint8_t &count = frame.overdrawBuffer[index];
+		count += (count < std::numeric_limits<uint8_t>::max()) ? 1 : 0;
+	}
+}
+
+uint32_t SoftwareRenderer::getHeatmapColor(double percent)
+{
+	// Black -> blue -> green -> yellow -> red -> white.
+	const std::array<Double3, 6> colors =
+	{
+		Double3(0.0, 0.0, 0.0),
+		Double3(0.0, 0.0, 1.0),
+		Double3(0.0, 1.0, 0.0),
+		Double3(1.0, 1.0, 0.0),
+		Double3(1.0, 0.0, 0.0),
+		Double3(1.0, 1.0, 1.0)
+	};
+
+	const double scaledPercent = std::clamp(percent, 0.0, 1.0) *
+		static_cast<double>(colors.size() - 1);
+	const int index = std::min(static_cast<int>(scaledPercent),
+		static_cast<int>(colors.size()) - 2);
+	const double blend = scaledPercent - static_cast<double>(index);
+
+	const Double3 &start = colors.at(index);
+	const Double3 &end = colors.at(index + 1);
+	return (start + ((end - start) * blend)).toRGB();
+}
+
+void SoftwareRenderer::drawDebugViews(const FrameView &frame)
+{
+	this->debugViewStats = DebugViewStats();
+
+	const int pixelCount = frame.width * frame.height;
+
+	if (frame.rayStepCounts != nullptr)
+	{
+		int totalSteps = 0;
+		for (int x = 0; x < frame.width; x++)
+		{
+			const int steps = frame.rayStepCounts[x];
+			totalSteps += steps;
+			this->debugViewStats.maxRaySteps = std::max(this->debugViewStats.maxRaySteps, steps);
+		}
+
+		this->debugViewStats.avgRaySteps = static_cast<double>(totalSteps) / frame.widthReal;
+
+		// Tint each column by its step count, keeping some of the scene's brightness so
+		// the layout that caused it is still recognizable.
+		for (int y = 0; y < frame.height; y++)
+		{
+			for (int x = 0; x < frame.width; x++)
+			{
+				const int index = x + (y * frame.width);
+				const double stepPercent = static_cast<double>(frame.rayStepCounts[x]) /
+					static_cast<double>(SoftwareRenderer::RAY_STEPS_HEATMAP_MAX);
+				const Double3 heat = Double3::fromRGB(SoftwareRenderer::getHeatmapColor(stepPercent));
+				const Double3 scene = Double3::fromRGB(frame.colorBuffer[index]);
+				const double luminance = (scene.x + scene.y + scene.z) / 3.0;
+				frame.colorBuffer[index] = (heat * (0.35 + (0.65 * luminance))).toRGB();
+			}
+		}
+	}
+
+	// Overdraw is drawn last so it takes priority if both views are on.
+	if (frame.overdrawBuffer != nullptr)
+	{
+		int totalWrites = 0;
+		for (int i = 0; i < pixelCount; i++)
+		{
+			const int writes = frame.overdrawBuffer[i];
+			totalWrites += writes;
+			this->debugViewStats.maxOverdraw = std::max(this->debugViewStats.maxOverdraw, writes);
+
+			// One write (the sky gradient) is the minimum, so it's shown as cold.
+			const double overdrawPercent = static_cast<double>(writes - 1) /
+				static_cast<double>(SoftwareRenderer::OVERDRAW_HEATMAP_MAX - 1);
+			frame.colorBuffer[i] = SoftwareRenderer::getHeatmapColor(overdrawPercent);
+		}
+
+		this->debugViewStats.avgOverdraw = static_cast<double>(totalWrites) /
+			static_cast<double>(pixelCount);
+	}
+}
+
+void SoftwareRenderer::updateColumnRays(const Camera &camera)
+{
+	const double widthReal = static_cast<double>(this->width);
+
+	for (int x = 0; x < this->width; x++)
+	{
+		// X percent across the screen, mapped to the camera's right vector.
+		const double xPercent = (static_cast<double>(x) + 0.50) / widthReal;
+		const double rightPercent = (2.0 * xPercent) - 1.0;
+
+		// Camera-space ray through the column. The right component is scaled by aspect and
+		// the forward component by zoom, matching the frustum edges.
+		// - If un-normalized, it uses the Z distance, but the insides of voxels
+		//   don't look right then.
+		const Double2 direction = Double2(
+			camera.aspect * rightPercent, camera.zoom).normalized();
+
+		this->columnRayDirs[x] = direction;
+		this->columnDepthScales[x] = 1.0 / direction.y;
+	}
+
+	this->columnRaysFovY = camera.fovY;
+}
+
 void SoftwareRenderer::initRenderThreads(int width, int height, int threadCount)
 {
 	// If there are existing threads, reset them.
@@ -973,6 +1340,8 @@ void SoftwareRenderer::initRenderThreads(int width, int height, int threadCount)
 		this->renderThreads.resize(threadCount);
 	}
 
+	this->frameTimings.threads = std::vector<FrameTimings::ThreadTimings>(threadCount);
+
 	// Block width and height are the approximate number of columns and rows per thread,
 	// respectively.
 	const double blockWidth = static_cast<double>(width) / static_cast<double>(threadCount);
@@ -3114,6 +3483,10 @@ void SoftwareRenderer::drawPixels(int x, const DrawRange &drawRange, double dept
 		shadingInfo.ambient + sunComponent.y,
 		shadingInfo.ambient + sunComponent.z);
 
+	// Colormap to use instead of shading when indexed color is on.
+	const uint8_t *colormap = ((frame.colormaps != nullptr) && texture.hasPaletteIndices) ?
+		SoftwareRenderer::getColormap(shading, fogPercent, frame) : nullptr;
+
 	// Clip the Y start and end coordinates as needed, and refresh the occlusion buffer.
 	occlusion.clipRange(&yStart, &yEnd);
 	occlusion.update(yStart, yEnd);
@@ -3142,26 +3515,43 @@ void SoftwareRenderer::drawPixels(int x, const DrawRange &drawRange, double dept
 			const int textureIndex = textureX + (textureY * VoxelTexture::WIDTH);
 			const VoxelTexel &texel = texture.texels[textureIndex];
 
-			// Texture color with shading.
-			const Double4 pixelScreen = material.shadedPixelScreen(Double3(texel.r, texel.g, texel.b),
-										Double3(texel.r, texel.g, texel.b) * texel.emission,
-										Double2(u, v),
-										Double3(0.0, 0.0, 0.0), // @todo: add world position
-										normal,
-										shading,
-										frames);
-
-			const uint32_t colorRGB = (Double3(pixelScreen.x, pixelScreen.y, pixelScreen.z) + (fogColor - Double3(pixelScreen.x, pixelScreen.y, pixelScreen.z)) * fogPercent).toRGB();
-			const uint32_t emission = material.shadedPixelEmission(Double3(texel.r, texel.g, texel.b),
-										Double3(texel.r, texel.g, texel.b) * texel.emission,
-										Double2(u, v),
-										Double3(0.0, 0.0, 0.0),
-										normal,
-										frames).toARGB();
+			if (colormap != nullptr)
+			{
+				// Indexed color; the palette is resolved at the end of the frame.
+				frame.indexBuffer[index] = colormap[texel.paletteIndex];
+				frame.indexCoverage[index] = 1;
+			}
+			else
+			{
+				// Texture color with shading.
+				const Double4 pixelScreen = material.shadedPixelScreen(Double3(texel.r, texel.g, texel.b),
+											Double3(texel.r, texel.g, texel.b) * texel.emission,
+											Double2(u, v),
+											Double3(0.0, 0.0, 0.0), // @todo: add world position
+											normal,
+											shading,
+											frames);
+
+				const uint32_t colorRGB = (Double3(pixelScreen.x, pixelScreen.y, pixelScreen.z) + (fogColor - Double3(pixelScreen.x, pixelScreen.y, pixelScreen.z)) * fogPercent).toRGB();
+				const uint32_t emission = material.shadedPixelEmission(Double3(texel.r, texel.g, texel.b),
+											Double3(texel.r, texel.g, texel.b) * texel.emission,
+											Double2(u, v),
+											Double3(0.0, 0.0, 0.0),
+											normal,
+											frames).toARGB();
 	
-			frame.colorBuffer[index] = colorRGB;
+				frame.colorBuffer[index] = colorRGB;
+				frame.emissionBuffer[index] = emission;
+
+				if (frame.indexCoverage != nullptr)
+				{
+					frame.indexCoverage[index] = 0;
+				}
+			}
+
 			frame.depthBuffer[index] = depth;
-			frame.emissionBuffer[index] = emission;
+			frame.planeBuffer[index] = 0;
+			SoftwareRenderer::addOverdraw(index, frame);
 		}
 	}
 }
@@ -3195,75 +3585,181 @@ void SoftwareRenderer::drawPerspectivePixels(int x, const DrawRange &drawRange,
 	// Values for perspective-correct interpolation.
 	const double depthStartRecip = 1.0 / depthStart;
 	const double depthEndRecip = 1.0 / depthEnd;
+	const double depthRecipDiff = depthEndRecip - depthStartRecip;
 	const Double2 startPointDiv = startPoint * depthStartRecip;
 	const Double2 endPointDiv = endPoint * depthEndRecip;
 	const Double2 pointDivDiff = endPointDiv - startPointDiv;
+
+	// Percent stepped from beginning to end on the column, per pixel.
+	const double yPercentStep = 1.0 / (yProjEnd - yProjStart);
+
+	// Gets the perspective-correct depth and point on the surface at the center of a row.
+	// Reciprocal depth and point/depth are linear in screen space. Only rows that are drawn
+	// are passed in, so this never extrapolates past the projected ends.
+	auto getExactPoint = [yProjStart, yPercentStep, depthStartRecip, depthRecipDiff,
+		&startPointDiv, &pointDivDiff](int y, double *depth, Double2 *point)
+	{
+		const double yPercent = ((static_cast<double>(y) + 0.50) - yProjStart) * yPercentStep;
+		*depth = 1.0 / (depthStartRecip + (depthRecipDiff * yPercent));
+		*point = (startPointDiv + (pointDivDiff * yPercent)) * (*depth);
+	};
 	
 	// Clip the Y start and end coordinates as needed, and refresh the occlusion buffer.
 	occlusion.clipRange(&yStart, &yEnd);
 	occlusion.update(yStart, yEnd);
 
-	// Draw the column to the output buffer.
-	for (int y = yStart; y < yEnd; y++)
+	if (yStart >= yEnd)
 	{
-		const int index = x + (y * frame.width);
+		return;
+	}
 
-		// Percent stepped from beginning to end on the column.
-		const double yPercent = 
-			((static_cast<double>(y) + 0.50) - yProjStart) / (yProjEnd - yProjStart);
+	// Draw the column to the output buffer in spans of PERSPECTIVE_SPAN_LENGTH pixels. Depth
+	// and the surface point are only divided out exactly at the first row of each span (and
+	// the column's last row), and stepped linearly with additions in between.
+	double spanStartDepth;
+	Double2 spanStartPoint;
+	getExactPoint(yStart, &spanStartDepth, &spanStartPoint);
 
-		// Interpolate between the near and far depth.
-		const double depth = 1.0 / 
-			(depthStartRecip + ((depthEndRecip - depthStartRecip) * yPercent));
+	for (int spanStart = yStart; spanStart < yEnd; spanStart += PERSPECTIVE_SPAN_LENGTH)
+	{
+		const int spanEnd = std::min(spanStart + PERSPECTIVE_SPAN_LENGTH, yEnd);
 
-		// Check depth of the pixel before rendering.
-		// - @todo: implement occlusion culling and back-to-front transparent rendering so
-		//   this depth check isn't needed.
-		if (depth <= frame.depthBuffer[index])
+		// Row the stepped values land on exactly: the next span's first row, or the last row
+		// of the column.
+		const int spanEndRow = (spanEnd < yEnd) ? spanEnd : (yEnd - 1);
+		const int spanSteps = spanEndRow - spanStart;
+
+		double spanEndDepth = spanStartDepth;
+		Double2 spanEndPoint = spanStartPoint;
+		double spanStepsRecip = 0.0;
+		if (spanSteps > 0)
 		{
-			// Linearly interpolated fog.
-			const double fogPercent = std::min(depth / shadingInfo.fogDistance, 1.0);
+			getExactPoint(spanEndRow, &spanEndDepth, &spanEndPoint);
+			spanStepsRecip = 1.0 / static_cast<double>(spanSteps);
+		}
 
-			// Interpolate between start and end points.
-			const double currentPointX = (startPointDiv.x + (pointDivDiff.x * yPercent)) * depth;
-			const double currentPointY = (startPointDiv.y + (pointDivDiff.y * yPercent)) * depth;
+		const double depthStep = (spanEndDepth - spanStartDepth) * spanStepsRecip;
+		const double pointStepX = (spanEndPoint.x - spanStartPoint.x) * spanStepsRecip;
+		const double pointStepY = (spanEndPoint.y - spanStartPoint.y) * spanStepsRecip;
 
-			// Texture coordinates.
-			const double u = std::clamp(
-				Constants::JustBelowOne - (currentPointX - std::floor(currentPointX)),
-				0.0, Constants::JustBelowOne);
-			const double v = std::clamp(
-				Constants::JustBelowOne - (currentPointY - std::floor(currentPointY)),
-				0.0, Constants::JustBelowOne);
+		double depth = spanStartDepth;
+		double currentPointX = spanStartPoint.x;
+		double currentPointY = spanStartPoint.y;
 
-			// Offsets in texture.
-			const int textureX = static_cast<int>(u * static_cast<double>(VoxelTexture::WIDTH));
-			const int textureY = static_cast<int>(v * static_cast<double>(VoxelTexture::HEIGHT));
+		for (int y = spanStart; y < spanEnd; y++)
+		{
+			const int index = x + (y * frame.width);
 
-			// Alpha is ignored in this loop, so transparent texels will appear black.
-			const int textureIndex = textureX + (textureY * VoxelTexture::WIDTH);
-			const VoxelTexel &texel = texture.texels[textureIndex];
+			// Check depth of the pixel before rendering.
+			// - @todo: implement occlusion culling and back-to-front transparent rendering so
+			//   this depth check isn't needed.
+			if (depth <= frame.depthBuffer[index])
+			{
+				// Linearly interpolated fog.
+				const double fogPercent = std::min(depth / shadingInfo.fogDistance, 1.0);
 
-			// Texture color with shading.
-			const Double4 pixelScreen = material.shadedPixelScreen(Double3(texel.r, texel.g, texel.b),
-										Double3(texel.r, texel.g, texel.b) * texel.emission,
-										Double2(u, v),
-										Double3(0.0, 0.0, 0.0), // @todo: add world position
-										normal,
-										shading,
-										frames);
-
-			const uint32_t colorRGB = (Double3(pixelScreen.x, pixelScreen.y, pixelScreen.z) + (fogColor - Double3(pixelScreen.x, pixelScreen.y, pixelScreen.z)) * fogPercent).toRGB();
-			const uint32_t emission = material.shadedPixelEmission(Double3(texel.r, texel.g, texel.b),
-										Double3(texel.r, texel.g, texel.b) * texel.emission,
-										Double2(u, v),
-										Double3(0.0, 0.0, 0.0),
-										normal,	
-										frames).toARGB();
+				// Colormap to use instead of shading when indexed color is on.
+				const uint8_t *colormap = ((frame.colormaps != nullptr) && texture.hasPaletteIndices) ?
+					SoftwareRenderer::getColormap(shading, fogPercent, frame) : nullptr;
 
-			frame.colorBuffer[index] = colorRGB;
+				// Texture coordinates.
+				const double u = std::clamp(
+					Constants::JustBelowOne - (currentPointX - std::floor(currentPointX)),
+					0.0, Constants::JustBelowOne);
+				const double v = std::clamp(
+					Constants::JustBelowOne - (currentPointY - std::floor(currentPointY)),
+					0.0, Constants::JustBelowOne);
+
+				// Offsets in texture.
+				const int textureX = static_cast<int>(u * static_cast<double>(VoxelTexture::WIDTH));
+				const int textureY = static_cast<int>(v * static_cast<double>(VoxelTexture::HEIGHT));
+
+				// Alpha is ignored in this loop, so transparent texels will appear black.
+				const int textureIndex = textureX + (textureY * VoxelTexture::WIDTH);
+				const VoxelTexel &texel = texture.texels[textureIndex];
+
+				if (colormap != nullptr)
+				{
+					// Indexed color; the palette is resolved at the end of the frame.
+					frame.indexBuffer[index] = colormap[texel.paletteIndex];
+					frame.indexCoverage[index] = 1;
+				}
+				else
+				{
+					// Texture color with shading.
+					const Double4 pixelScreen = material.shadedPixelScreen(Double3(texel.r, texel.g, texel.b),
+												Double3(texel.r, texel.g, texel.b) * texel.emission,
+												Double2(u, v),
+												Double3(0.0, 0.0, 0.0), // @todo: add world position
+												normal,
+												shading,
+												frames);
+
+					const uint32_t colorRGB = (Double3(pixelScreen.x, pixelScreen.y, pixelScreen.z) + (fogColor - Double3(pixelScreen.x, pixelScreen.y, pixelScreen.z)) * fogPercent).toRGB();
+					const uint32_t emission = material.shadedPixelEmission(Double3(texel.r, texel.g, texel.b),
+												Double3(texel.r, texel.g, texel.b) * texel.emission,
+												Double2(u, v),
+												Double3(0.0, 0.0, 0.0),
+												normal,	
+												frames).toARGB();
+
+					frame.colorBuffer[index] = colorRGB;
+					frame.emissionBuffer[index] = emission;
+
+					if (frame.indexCoverage != nullptr)
+					{
+						frame.indexCoverage[index] = 0;
+					}
+				}
+
+				frame.depthBuffer[index] = depth;
+				frame.planeBuffer[index] = 0;
+				SoftwareRenderer::addOverdraw(index, frame);
+			}
+
+			depth += depthStep;
+			currentPointX += pointStepX;
+			currentPointY += pointStepY;
+		}
+
+		// Start the next span from the exact values instead of the stepped ones.
+		spanStartDepth = spanEndDepth;
+		spanStartPoint = spanEndPoint;
+	}
+}
+
+void SoftwareRenderer::deferPlanePixels(int x, const DrawRange &drawRange, int planeIndex,
+	int textureID, double ceilingHeight, const Camera &camera, OcclusionData &occlusion,
+	const FrameView &frame)
+{
+	int yStart = drawRange.yStart;
+	int yEnd = drawRange.yEnd;
+
+	// Distance of the plane above or below the eye, scaled so that multiplying by a row's
+	// projection scale gives the distance along this column's ray (the same XZ depth that
+	// drawPerspectivePixels() interpolates).
+	const double planeY = static_cast<double>(planeIndex) * ceilingHeight;
+	const double depthScale = camera.zoom * SoftwareRenderer::TALL_PIXEL_RATIO *
+		std::abs(planeY - camera.eye.y) * frame.columnDepthScales[x];
+
+	// Plane index is offset by one so zero can mean "no plane". Both halves are range checked
+	// once per frame in render().
+	const uint32_t planeTag = (static_cast<uint32_t>(planeIndex + 1) << 16) |
+		static_cast<uint32_t>(textureID);
+
+	// Clip the Y start and end coordinates as needed, and refresh the occlusion buffer.
+	occlusion.clipRange(&yStart, &yEnd);
+	occlusion.update(yStart, yEnd);
+
+	for (int y = yStart; y < yEnd; y++)
+	{
+		const int index = x + (y * frame.width);
+		const double depth = depthScale * frame.planeRowScales[y];
+
+		if (depth <= frame.depthBuffer[index])
+		{
 			frame.depthBuffer[index] = depth;
-			frame.emissionBuffer[index] = emission;
+			frame.planeBuffer[index] = planeTag;
 		}
 	}
 }
@@ -3297,6 +3793,10 @@ void SoftwareRenderer::drawTransparentPixels(int x, const DrawRange &drawRange,
 		shadingInfo.ambient + sunComponent.y,
 		shadingInfo.ambient + sunComponent.z);
 
+	// Colormap to use instead of shading when indexed color is on.
+	const uint8_t *colormap = ((frame.colormaps != nullptr) && texture.hasPaletteIndices) ?
+		SoftwareRenderer::getColormap(shading, fogPercent, frame) : nullptr;
+
 	// Clip the Y start and end coordinates as needed, but do not refresh the occlusion buffer,
 	// because transparent ranges do not occlude as simply as opaque ranges.
 	occlusion.clipRange(&yStart, &yEnd);
@@ -3325,25 +3825,42 @@ void SoftwareRenderer::drawTransparentPixels(int x, const DrawRange &drawRange,
 			
 			if (!texel.transparent)
 			{
-				// Texture color with shading.
-				const Double4 pixelScreen = material.shadedPixelScreen(Double3(texel.r, texel.g, texel.b),
-										Double3(texel.r, texel.g, texel.b) * texel.emission,
-										Double2(u, v),
-										Double3(0.0, 0.0, 0.0), // @todo: add world position
-										normal,
-										shading,
-										frames);
-
-				const uint32_t colorRGB =  (Double3(pixelScreen.x, pixelScreen.y, pixelScreen.z) + (fogColor - Double3(pixelScreen.x, pixelScreen.y, pixelScreen.z)) * fogPercent).toRGB();
-				const uint32_t emission = material.shadedPixelEmission(Double3(texel.r, texel.g, texel.b),
+				if (colormap != nullptr)
+				{
+					// Indexed color; the palette is resolved at the end of the frame.
+					frame.indexBuffer[index] = colormap[texel.paletteIndex];
+					frame.indexCoverage[index] = 1;
+				}
+				else
+				{
+					// Texture color with shading.
+					const Double4 pixelScreen = material.shadedPixelScreen(Double3(texel.r, texel.g, texel.b),
 											Double3(texel.r, texel.g, texel.b) * texel.emission,
 											Double2(u, v),
-											Double3(0.0, 0.0, 0.0),
+											Double3(0.0, 0.0, 0.0), // @todo: add world position
 											normal,
-											frames).toARGB();
-				frame.colorBuffer[index] = colorRGB;
+											shading,
+											frames);
+
+					const uint32_t colorRGB =  (Double3(pixelScreen.x, pixelScreen.y, pixelScreen.z) + (fogColor - Double3(pixelScreen.x, pixelScreen.y, pixelScreen.z)) * fogPercent).toRGB();
+					const uint32_t emission = material.shadedPixelEmission(Double3(texel.r, texel.g, texel.b),
+												Double3(texel.r, texel.g, texel.b) * texel.emission,
+												Double2(u, v),
+												Double3(0.0, 0.0, 0.0),
+												normal,
+												frames).toARGB();
+					frame.colorBuffer[index] = colorRGB;
+					frame.emissionBuffer[index] = emission;
+
+					if (frame.indexCoverage != nullptr)
+					{
+						frame.indexCoverage[index] = 0;
+					}
+				}
+
 				frame.depthBuffer[index] = depth;
-				frame.emissionBuffer[index] = emission;
+				frame.planeBuffer[index] = 0;
+				SoftwareRenderer::addOverdraw(index, frame);
 			}
 		}
 	}
@@ -3397,6 +3914,7 @@ void SoftwareRenderer::drawDistantPixels(int x, const DrawRange &drawRange, doub
 										frames).toARGB() & 0x00ffffff;
 
 			frame.colorBuffer[index] = colorRGB;
+			SoftwareRenderer::addOverdraw(index, frame);
 		}
 	}
 }
@@ -3473,6 +3991,7 @@ void SoftwareRenderer::drawMoonPixels(int x, const DrawRange &drawRange, double
 										frames).toARGB() & 0x00ffffff;
 
 			frame.colorBuffer[index] = colorRGB;
+			SoftwareRenderer::addOverdraw(index, frame);
 		}
 	}
 }
@@ -3547,6 +4066,7 @@ void SoftwareRenderer::drawStarPixels(int x, const DrawRange &drawRange, double
 											frames).toARGB() & 0x00ffffff;
 
 				frame.colorBuffer[index] = colorRGB;
+				SoftwareRenderer::addOverdraw(index, frame);
 			}
 		}
 	}
@@ -3630,9 +4150,8 @@ void SoftwareRenderer::drawInitialVoxelColumn(int x, int voxelX, int voxelZ, con
 				nearCeilingPoint, farCeilingPoint, farFloorPoint, nearFloorPoint, camera, frame);
 
 			// Ceiling.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(0), nearPoint, farPoint,
-				nearZ, farZ, -Double3::UnitY, textures.at(wallData.ceilingID),shadingInfo, defaultMaterial,
-				occlusion, frame);
+			SoftwareRenderer::deferPlanePixels(x, drawRanges.at(0), voxelY + 1, wallData.ceilingID,
+				ceilingHeight, camera, occlusion, frame);
 
 			// Wall.
 			SoftwareRenderer::drawPixels(x, drawRanges.at(1), farZ, wallU, 0.0,
@@ -3640,9 +4159,8 @@ void SoftwareRenderer::drawInitialVoxelColumn(int x, int voxelX, int voxelZ, con
 				occlusion, frame);
 
 			// Floor.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(2), farPoint, nearPoint,
-				farZ, nearZ, Double3::UnitY, textures.at(wallData.floorID),shadingInfo, defaultMaterial,
-				occlusion, frame);
+			SoftwareRenderer::deferPlanePixels(x, drawRanges.at(2), voxelY, wallData.floorID,
+				ceilingHeight, camera, occlusion, frame);
 		}
 		else if (voxelData.dataType == VoxelDataType::Floor)
 		{
@@ -3667,9 +4185,8 @@ void SoftwareRenderer::drawInitialVoxelColumn(int x, int voxelX, int voxelZ, con
 				const auto drawRange = SoftwareRenderer::makeDrawRange(
 					nearFloorPoint, farFloorPoint, camera, frame);
 
-				SoftwareRenderer::drawPerspectivePixels(x, drawRange, nearPoint, farPoint,
-					nearZ, farZ, -Double3::UnitY, textures.at(ceilingData.id),shadingInfo, defaultMaterial,
-					occlusion, frame);
+				SoftwareRenderer::deferPlanePixels(x, drawRange, voxelY, ceilingData.id,
+					ceilingHeight, camera, occlusion, frame);
 			}
 		}
 		else if (voxelData.dataType == VoxelDataType::Raised)
@@ -3993,9 +4510,8 @@ void SoftwareRenderer::drawInitialVoxelColumn(int x, int voxelX, int voxelZ, con
 				farCeilingPoint, nearCeilingPoint, camera, frame);
 
 			// Ceiling.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRange, farPoint, nearPoint, farZ,
-				nearZ, Double3::UnitY, textures.at(wallData.ceilingID),shadingInfo, defaultMaterial,
-				occlusion, frame);
+			SoftwareRenderer::deferPlanePixels(x, drawRange, voxelY + 1, wallData.ceilingID,
+				ceilingHeight, camera, occlusion, frame);
 		}
 		else if (voxelData.dataType == VoxelDataType::Floor)
 		{
@@ -4015,9 +4531,8 @@ void SoftwareRenderer::drawInitialVoxelColumn(int x, int voxelX, int voxelZ, con
 				farCeilingPoint, nearCeilingPoint, camera, frame);
 
 			// Ceiling.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRange, farPoint, nearPoint, farZ,
-				nearZ, Double3::UnitY, textures.at(floorData.id),shadingInfo, defaultMaterial,
-				occlusion, frame);
+			SoftwareRenderer::deferPlanePixels(x, drawRange, voxelY + 1, floorData.id,
+				ceilingHeight, camera, occlusion, frame);
 		}
 		else if (voxelData.dataType == VoxelDataType::Ceiling)
 		{
@@ -4377,9 +4892,8 @@ void SoftwareRenderer::drawInitialVoxelColumn(int x, int voxelX, int voxelZ, con
 				nearFloorPoint, farFloorPoint, camera, frame);
 
 			// Floor.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRange, nearPoint, farPoint, nearZ,
-				farZ, -Double3::UnitY, textures.at(wallData.floorID),shadingInfo, defaultMaterial,
-				occlusion, frame);
+			SoftwareRenderer::deferPlanePixels(x, drawRange, voxelY, wallData.floorID,
+				ceilingHeight, camera, occlusion, frame);
 		}
 		else if (voxelData.dataType == VoxelDataType::Floor)
 		{
@@ -4402,9 +4916,8 @@ void SoftwareRenderer::drawInitialVoxelColumn(int x, int voxelX, int voxelZ, con
 			const auto drawRange = SoftwareRenderer::makeDrawRange(
 				nearFloorPoint, farFloorPoint, camera, frame);
 
-			SoftwareRenderer::drawPerspectivePixels(x, drawRange, nearPoint, farPoint, nearZ,
-				farZ, -Double3::UnitY, textures.at(ceilingData.id),shadingInfo, defaultMaterial,
-				occlusion, frame);
+			SoftwareRenderer::deferPlanePixels(x, drawRange, voxelY, ceilingData.id,
+				ceilingHeight, camera, occlusion, frame);
 		}
 		else if (voxelData.dataType == VoxelDataType::Raised)
 		{
@@ -4768,9 +5281,8 @@ void SoftwareRenderer::drawVoxelColumn(int x, int voxelX, int voxelZ, const Came
 				const auto drawRange = SoftwareRenderer::makeDrawRange(
 					nearFloorPoint, farFloorPoint, camera, frame);
 
-				SoftwareRenderer::drawPerspectivePixels(x, drawRange, nearPoint, farPoint, nearZ,
-					farZ, -Double3::UnitY, textures.at(ceilingData.id),shadingInfo, defaultMaterial,
-					occlusion, frame);
+				SoftwareRenderer::deferPlanePixels(x, drawRange, voxelY, ceilingData.id,
+					ceilingHeight, camera, occlusion, frame);
 			}
 		}
 		else if (voxelData.dataType == VoxelDataType::Raised)
@@ -5133,9 +5645,8 @@ void SoftwareRenderer::drawVoxelColumn(int x, int voxelX, int voxelZ, const Came
 				farCeilingPoint, nearCeilingPoint, nearFloorPoint, camera, frame);
 
 			// Ceiling.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(0), farPoint, nearPoint, farZ,
-				nearZ, Double3::UnitY, textures.at(wallData.ceilingID),shadingInfo, defaultMaterial,
-				occlusion, frame);
+			SoftwareRenderer::deferPlanePixels(x, drawRanges.at(0), voxelY + 1, wallData.ceilingID,
+				ceilingHeight, camera, occlusion, frame);
 
 			// Wall.
 			SoftwareRenderer::drawPixels(x, drawRanges.at(1), nearZ, wallU, 0.0,
@@ -5159,9 +5670,8 @@ void SoftwareRenderer::drawVoxelColumn(int x, int voxelX, int voxelZ, const Came
 			const auto drawRange = SoftwareRenderer::makeDrawRange(
 				farCeilingPoint, nearCeilingPoint, camera, frame);
 
-			SoftwareRenderer::drawPerspectivePixels(x, drawRange, farPoint, nearPoint, farZ,
-				nearZ, Double3::UnitY, textures.at(floorData.id),shadingInfo, defaultMaterial, 
-				occlusion, frame);
+			SoftwareRenderer::deferPlanePixels(x, drawRange, voxelY + 1, floorData.id,
+				ceilingHeight, camera, occlusion, frame);
 		}
 		else if (voxelData.dataType == VoxelDataType::Ceiling)
 		{
@@ -5563,9 +6073,8 @@ void SoftwareRenderer::drawVoxelColumn(int x, int voxelX, int voxelZ, const Came
 				defaultMaterial, occlusion, frame);
 
 			// Floor.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(1), nearPoint, farPoint,
-				nearZ, farZ, -Double3::UnitY, textures.at(wallData.floorID),shadingInfo, defaultMaterial,
-				occlusion, frame);
+			SoftwareRenderer::deferPlanePixels(x, drawRanges.at(1), voxelY, wallData.floorID,
+				ceilingHeight, camera, occlusion, frame);
 		}
 		else if (voxelData.dataType == VoxelDataType::Floor)
 		{
@@ -5588,9 +6097,8 @@ void SoftwareRenderer::drawVoxelColumn(int x, int voxelX, int voxelZ, const Came
 			const auto drawRange = SoftwareRenderer::makeDrawRange(
 				nearFloorPoint, farFloorPoint, camera, frame);
 
-			SoftwareRenderer::drawPerspectivePixels(x, drawRange, nearPoint, farPoint, nearZ,
-				farZ, -Double3::UnitY, textures.at(ceilingData.id),shadingInfo, defaultMaterial,
-				occlusion, frame);
+			SoftwareRenderer::deferPlanePixels(x, drawRange, voxelY, ceilingData.id,
+				ceilingHeight, camera, occlusion, frame);
 		}
 		else if (voxelData.dataType == VoxelDataType::Raised)
 		{
@@ -5897,9 +6405,10 @@ void SoftwareRenderer::drawFlat(int startX, int endX, const Flat::Frame &flatFra
 	const double endFlatPercent = (clampedEndXPercent - flatFrame.startX) /
 		(flatFrame.endX - flatFrame.startX);
 
-	// Points interpolated between for per-column depth calculations in the XZ plane.
-	const Double3 startTopPoint = flatFrame.topStart.lerp(flatFrame.topEnd, startFlatPercent);
-	const Double3 endTopPoint = flatFrame.topStart.lerp(flatFrame.topEnd, endFlatPercent);
+	// Flats face the camera, so every point on one is the same distance along the camera's
+	// forward axis (the opposite of the flat's normal).
+	const double flatForwardDepth = -(Double2(flatFrame.topStart.x, flatFrame.topStart.z) - eye)
+		.dot(Double2(normal.x, normal.z));
 
 	// Horizontal texture coordinates in the flat. Although the flat percent can be
 	// equal to 1.0, the texture coordinate needs to be less than 1.0.
@@ -5940,10 +6449,8 @@ void SoftwareRenderer::drawFlat(int startX, int endX, const Flat::Frame &flatFra
 			(flipped ? (Constants::JustBelowOne - u) : u) *
 			static_cast<double>(texture.width));
 
-		const Double3 topPoint = startTopPoint.lerp(endTopPoint, xPercent);
-
-		// Get the true XZ distance for the depth.
-		const double depth = (Double2(topPoint.x, topPoint.z) - eye).length();
+		// Get the true XZ distance for the depth from the column's ray.
+		const double depth = flatForwardDepth * frame.columnDepthScales[x];
 
 		// Linearly interpolated fog.
 		const Double3 &fogColor = shadingInfo.getFogColor();
@@ -5986,6 +6493,13 @@ void SoftwareRenderer::drawFlat(int startX, int endX, const Flat::Frame &flatFra
 					
 					frame.colorBuffer[index] = colorRGB;
 					frame.depthBuffer[index] = depth;
+
+					if (frame.indexCoverage != nullptr)
+					{
+						frame.indexCoverage[index] = 0;
+					}
+
+					SoftwareRenderer::addOverdraw(index, frame);
 				}
 			}
 		}
@@ -6008,11 +6522,10 @@ void SoftwareRenderer::rayCast2D(int x, const Camera &camera, const Ray &ray,
 	// -> (int)floor(-0.8) == -1
 	// -> (int)ceil(-0.8) == 0
 
-	const double dirXSquared = ray.dirX * ray.dirX;
-	const double dirZSquared = ray.dirZ * ray.dirZ;
-
-	const double deltaDistX = std::sqrt(1.0 + (dirZSquared / dirXSquared));
-	const double deltaDistZ = std::sqrt(1.0 + (dirXSquared / dirZSquared));
+	// Distance along the ray between X and Z grid lines. Since the ray is normalized, this
+	// simplifies from sqrt(1 + (dirZ^2 / dirX^2)) to 1 / |dirX| (and likewise for Z).
+	const double deltaDistX = 1.0 / std::abs(ray.dirX);
+	const double deltaDistZ = 1.0 / std::abs(ray.dirZ);
 
 	const bool nonNegativeDirX = ray.dirX >= 0.0;
 	const bool nonNegativeDirZ = ray.dirZ >= 0.0;
@@ -6097,10 +6610,15 @@ void SoftwareRenderer::rayCast2D(int x, const Camera &camera, const Ray &ray,
 
 	// Lambda for stepping to the next XZ coordinate in the grid and updating the Z
 	// distance for the current edge point.
+	// Number of DDA steps taken by this column, for the ray step debug view.
+	int stepCount = 0;
+
 	auto doDDAStep = [&camera, &ray, &voxelGrid, &sideDistX, &sideDistZ, &cell,
-		&facing, &voxelIsValid, &zDistance, deltaDistX, deltaDistZ, stepX, stepZ,
+		&facing, &voxelIsValid, &zDistance, &stepCount, deltaDistX, deltaDistZ, stepX, stepZ,
 		nonNegativeDirX, nonNegativeDirZ]()
 	{
+		stepCount++;
+
 		if (sideDistX < sideDistZ)
 		{
 			sideDistX += deltaDistX;
@@ -6167,6 +6685,12 @@ void SoftwareRenderer::rayCast2D(int x, const Camera &camera, const Ray &ray,
 			nearPoint, farPoint, wallDistance, zDistance,shadingInfo, defaultMaterial, ceilingHeight, 
 			openDoors, voxelGrid, textures, occlusion, frame);
 	}
+
+	if (frame.rayStepCounts != nullptr)
+	{
+		frame.rayStepCounts[x] = static_cast<uint16_t>(std::min(stepCount,
+			static_cast<int>(std::numeric_limits<uint16_t>::max())));
+	}
 }
 
 void SoftwareRenderer::drawSkyGradient(int startY, int endY, double gradientProjYTop,
@@ -6189,6 +6713,18 @@ void SoftwareRenderer::drawSkyGradient(int startY, int endY, double gradientProj
 			colorPtr[i] = colorValue;
 			depthPtr[i] = depthValue;
 		}
+
+		// Clear the index coverage so this row keeps the gradient color.
+		if (frame.indexCoverage != nullptr)
+		{
+			std::fill(frame.indexCoverage + startIndex, frame.indexCoverage + endIndex, 0);
+		}
+
+		// The sky gradient is the first write to every pixel, so it restarts overdraw counts.
+		if (frame.overdrawBuffer != nullptr)
+		{
+			std::fill(frame.overdrawBuffer + startIndex, frame.overdrawBuffer + endIndex, 1);
+		}
 	};
 
 	// While drawing the sky gradient, determine if it is dark enough for stars to be visible.
@@ -6351,22 +6887,19 @@ void SoftwareRenderer::drawVoxels(int startX, int stride, const Camera &camera,
 	const VoxelGrid &voxelGrid, const std::vector<VoxelTexture> &voxelTextures,
 	std::vector<OcclusionData> &occlusion, const ShadingInfo &shadingInfo, const FrameView &frame)
 {
-	const Double2 forwardZoomed(camera.forwardZoomedX, camera.forwardZoomedZ);
-	const Double2 rightAspected(camera.rightAspectedX, camera.rightAspectedZ);
+	const Double2 forward(camera.forwardX, camera.forwardZ);
+	const Double2 right(camera.rightX, camera.rightZ);
 
 	// Draw pixel columns with spacing determined by the number of render threads.
+	// - @todo: adjacent columns usually hit the same voxel faces, but each one still does its
+	//   own face setup. Most of that setup is projecting the column's own near and far points,
+	//   which can't be shared; the per-face part (voxel lookups, normals, shading) is only a
+	//   few percent of voxel drawing, so a per-thread face cache isn't worth it yet.
 	for (int x = startX; x < frame.width; x += stride)
 	{
-		// X percent across the screen.
-		const double xPercent = (static_cast<double>(x) + 0.50) / frame.widthReal;
-
-		// "Right" component of the ray direction, based on current screen X.
-		const Double2 rightComp = rightAspected * ((2.0 * xPercent) - 1.0);
-
-		// Calculate the ray direction through the pixel.
-		// - If un-normalized, it uses the Z distance, but the insides of voxels
-		//   don't look right then.
-		const Double2 direction = (forwardZoomed + rightComp).normalized();
+		// Rotate the column's camera-space ray into the world. It's already normalized.
+		const Double2 &columnDir = frame.columnRayDirs[x];
+		const Double2 direction = (right * columnDir.x) + (forward * columnDir.y);
 		const Ray ray(direction.x, direction.y);
 
 		// Cast the 2D ray and fill in the column's pixels with color.
@@ -6375,6 +6908,156 @@ void SoftwareRenderer::drawVoxels(int startX, int stride, const Camera &camera,
 	}
 }
 
+void SoftwareRenderer::drawPlaneRows(int startY, int endY, const Camera &camera,
+	double ceilingHeight, const std::vector<VoxelTexture> &textures,
+	const ShadingInfo &shadingInfo, const FrameView &frame)
+{
+	// Fog color to interpolate with.
+	const Double3 &fogColor = shadingInfo.getFogColor();
+
+	// Shading for floors (seen from above) and ceilings (seen from below).
+	auto getPlaneShading = [&shadingInfo](const Double3 &normal)
+	{
+		// Contribution from the sun.
+		const double lightNormalDot = std::max(0.0, shadingInfo.sunDirection.dot(normal));
+		const Double3 sunComponent = (shadingInfo.sunColor * lightNormalDot).clamped(
+			0.0, 1.0 - shadingInfo.ambient);
+
+		// - @todo: contribution from lights.
+		return Double3(
+			shadingInfo.ambient + sunComponent.x,
+			shadingInfo.ambient + sunComponent.y,
+			shadingInfo.ambient + sunComponent.z);
+	};
+
+	const Double3 floorNormal = Double3::UnitY;
+	const Double3 ceilingNormal = -Double3::UnitY;
+	const Double3 floorShading = getPlaneShading(floorNormal);
+	const Double3 ceilingShading = getPlaneShading(ceilingNormal);
+
+	// Change in the camera's right-vector percent per column.
+	const double columnStep = 2.0 / frame.widthReal;
+
+	for (int y = startY; y < endY; y++)
+	{
+		const int rowIndex = y * frame.width;
+		const double rowScale = frame.planeRowScales[y];
+
+		int x = 0;
+		while (x < frame.width)
+		{
+			const uint32_t planeTag = frame.planeBuffer[rowIndex + x];
+			if (planeTag == 0)
+			{
+				x++;
+				continue;
+			}
+
+			// Find the end of this run of pixels on the same plane. Texture IDs may differ
+			// within a run since the world point is the same for any texture.
+			const int planeBits = static_cast<int>(planeTag >> 16);
+			int spanEnd = x + 1;
+			while ((spanEnd < frame.width) &&
+				(static_cast<int>(frame.planeBuffer[rowIndex + spanEnd] >> 16) == planeBits))
+			{
+				spanEnd++;
+			}
+
+			const double planeY = static_cast<double>(planeBits - 1) * ceilingHeight;
+			const bool isFloor = planeY <= camera.eye.y;
+			const Double3 &normal = isFloor ? floorNormal : ceilingNormal;
+			const Double3 &shading = isFloor ? floorShading : ceilingShading;
+
+			// Distance along the forward axis to this row of the plane, in units of the
+			// camera's zoomed forward vector.
+			const double forwardScale = SoftwareRenderer::TALL_PIXEL_RATIO *
+				std::abs(planeY - camera.eye.y) * rowScale;
+
+			// World point of the first pixel in the run, and the step between pixels.
+			const double rightPercent = ((static_cast<double>(x) + 0.50) * columnStep) - 1.0;
+			double currentPointX = camera.eye.x + ((camera.forwardZoomedX +
+				(camera.rightAspectedX * rightPercent)) * forwardScale);
+			double currentPointZ = camera.eye.z + ((camera.forwardZoomedZ +
+				(camera.rightAspectedZ * rightPercent)) * forwardScale);
+			const double pointStepX = camera.rightAspectedX * columnStep * forwardScale;
+			const double pointStepZ = camera.rightAspectedZ * columnStep * forwardScale;
+
+			for (; x < spanEnd; x++)
+			{
+				const int index = rowIndex + x;
+				const VoxelTexture &texture = textures[frame.planeBuffer[index] & SoftwareRenderer::PLANE_TAG_MAX];
+
+				// Depth was written by the voxel pass.
+				const double depth = frame.depthBuffer[index];
+
+				// Linearly interpolated fog.
+				const double fogPercent = std::min(depth / shadingInfo.fogDistance, 1.0);
+
+				// Colormap to use instead of shading when indexed color is on.
+				const uint8_t *colormap = ((frame.colormaps != nullptr) && texture.hasPaletteIndices) ?
+					SoftwareRenderer::getColormap(shading, fogPercent, frame) : nullptr;
+
+				// Texture coordinates.
+				const double u = std::clamp(
+					Constants::JustBelowOne - (currentPointX - std::floor(currentPointX)),
+					0.0, Constants::JustBelowOne);
+				const double v = std::clamp(
+					Constants::JustBelowOne - (currentPointZ - std::floor(currentPointZ)),
+					0.0, Constants::JustBelowOne);
+
+				// Offsets in texture.
+				const int textureX = static_cast<int>(u * static_cast<double>(VoxelTexture::WIDTH));
+				const int textureY = static_cast<int>(v * static_cast<double>(VoxelTexture::HEIGHT));
+
+				// Alpha is ignored in this loop, so transparent texels will appear black.
+				const int textureIndex = textureX + (textureY * VoxelTexture::WIDTH);
+				const VoxelTexel &texel = texture.texels[textureIndex];
+
+				if (colormap != nullptr)
+				{
+					// Indexed color; the palette is resolved at the end of the frame.
+					frame.indexBuffer[index] = colormap[texel.paletteIndex];
+					frame.indexCoverage[index] = 1;
+				}
+				else
+				{
+					// Texture color with shading.
+					const Double4 pixelScreen = defaultMaterial.shadedPixelScreen(Double3(texel.r, texel.g, texel.b),
+												Double3(texel.r, texel.g, texel.b) * texel.emission,
+												Double2(u, v),
+												Double3(0.0, 0.0, 0.0), // @todo: add world position
+												normal,
+												shading,
+												frames);
+
+					const uint32_t colorRGB = (Double3(pixelScreen.x, pixelScreen.y, pixelScreen.z) + (fogColor - Double3(pixelScreen.x, pixelScreen.y, pixelScreen.z)) * fogPercent).toRGB();
+					const uint32_t emission = defaultMaterial.shadedPixelEmission(Double3(texel.r, texel.g, texel.b),
+												Double3(texel.r, texel.g, texel.b) * texel.emission,
+												Double2(u, v),
+												Double3(0.0, 0.0, 0.0),
+												normal,
+												frames).toARGB();
+
+					frame.colorBuffer[index] = colorRGB;
+					frame.emissionBuffer[index] = emission;
+
+					if (frame.indexCoverage != nullptr)
+					{
+						frame.indexCoverage[index] = 0;
+					}
+				}
+
+				// Leave the plane buffer empty for the next frame.
+				frame.planeBuffer[index] = 0;
+				SoftwareRenderer::addOverdraw(index, frame);
+
+				currentPointX += pointStepX;
+				currentPointZ += pointStepZ;
+			}
+		}
+	}
+}
+
 void SoftwareRenderer::drawFlats(int startX, int endX, const Camera &camera,
 	const Double3 &flatNormal, const std::vector<VisibleFlat> &visibleFlats,
 	const std::vector<FlatTexture> &flatTextures, const ShadingInfo &shadingInfo,
@@ -6398,6 +7081,25 @@ void SoftwareRenderer::drawFlats(int startX, int endX, const Camera &camera,
 	}
 }
 
+void SoftwareRenderer::resolvePalette(int startY, int endY, const FrameView &frame)
+{
+	if (frame.indexBuffer == nullptr)
+	{
+		return;
+	}
+
+	// Pixels without coverage were last written in true color by a non-indexed pass.
+	const int startIndex = startY * frame.width;
+	const int endIndex = endY * frame.width;
+	for (int i = startIndex; i < endIndex; i++)
+	{
+		if (frame.indexCoverage[i] != 0)
+		{
+			frame.colorBuffer[i] = frame.palette[frame.indexBuffer[i]];
+		}
+	}
+}
+
 void SoftwareRenderer::renderThreadLoop(RenderThreadData &threadData, int threadIndex, int startX,
 	int endX, int startY, int endY)
 {
@@ -6417,8 +7119,8 @@ void SoftwareRenderer::renderThreadLoop(RenderThreadData &threadData, int thread
 		}
 
 		// Lambda for making a thread wait until others are finished rendering something. The last
-		// thread to call this calls notify on all others.
-		auto threadBarrier = [&threadData, &lk](auto &data)
+		// thread to call this records how long the stage took and calls notify on all others.
+		auto threadBarrier = [&threadData, &lk](auto &data, double &stageTime)
 		{
 			lk.lock();
 			data.threadsDone++;
@@ -6426,6 +7128,11 @@ void SoftwareRenderer::renderThreadLoop(RenderThreadData &threadData, int thread
 			// If this was the last thread, notify all to continue.
 			if (data.threadsDone == threadData.totalThreads)
 			{
+				const auto stageEnd = std::chrono::high_resolution_clock::now();
+				stageTime = std::chrono::duration<double, std::milli>(
+					stageEnd - threadData.stageStart).count();
+				threadData.stageStart = stageEnd;
+
 				lk.unlock();
 				threadData.condVar.notify_all();
 			}
@@ -6442,14 +7149,24 @@ void SoftwareRenderer::renderThreadLoop(RenderThreadData &threadData, int thread
 			}
 		};
 
+		// Time this thread spends working on each stage, for spotting load imbalance.
+		FrameTimings::ThreadTimings &threadTimings = threadData.timings->threads.at(threadIndex);
+		auto workStart = std::chrono::high_resolution_clock::now();
+		auto getWorkTime = [&workStart]()
+		{
+			const auto workEnd = std::chrono::high_resolution_clock::now();
+			return std::chrono::duration<double, std::milli>(workEnd - workStart).count();
+		};
+
 		// Draw this thread's portion of the sky gradient.
 		RenderThreadData::SkyGradient &skyGradient = threadData.skyGradient;
 		SoftwareRenderer::drawSkyGradient(startY, endY, skyGradient.projectedYTop,
 			skyGradient.projectedYBottom, *skyGradient.rowCache, skyGradient.shouldDrawStars,
 			*threadData.shadingInfo, *threadData.frame);
+		threadTimings.skyGradient = getWorkTime();
 
 		// Wait for other threads to finish the sky gradient.
-		threadBarrier(skyGradient);
+		threadBarrier(skyGradient, threadData.timings->skyGradient);
 
 		// Wait for the visible distant object testing to finish.
 		RenderThreadData::DistantSky &distantSky = threadData.distantSky;
@@ -6458,12 +7175,14 @@ void SoftwareRenderer::renderThreadLoop(RenderThreadData &threadData, int thread
 		lk.unlock();
 
 		// Draw this thread's portion of distant sky objects.
+		workStart = std::chrono::high_resolution_clock::now();
 		SoftwareRenderer::drawDistantSky(startX, endX, distantSky.parallaxSky,
 			*distantSky.visDistantObjs, *distantSky.skyTextures, *skyGradient.rowCache,
 			skyGradient.shouldDrawStars, *threadData.shadingInfo, *threadData.frame);
+		threadTimings.distantSky = getWorkTime();
 
 		// Wait for other threads to finish distant sky objects.
-		threadBarrier(distantSky);
+		threadBarrier(distantSky, threadData.timings->distantSky);
 
 		// Number of columns to skip per ray cast (for interleaved ray casting as a means of
 		// load-balancing).
@@ -6471,12 +7190,24 @@ void SoftwareRenderer::renderThreadLoop(RenderThreadData &threadData, int thread
 
 		// Draw this thread's portion of voxels.
 		RenderThreadData::Voxels &voxels = threadData.voxels;
+		workStart = std::chrono::high_resolution_clock::now();
 		SoftwareRenderer::drawVoxels(threadIndex, strideX, *threadData.camera,
 			voxels.ceilingHeight, *voxels.openDoors, *voxels.voxelGrid, *voxels.voxelTextures,
 			*voxels.occlusion, *threadData.shadingInfo, *threadData.frame);
+		threadTimings.voxels = getWorkTime();
 
 		// Wait for other threads to finish voxels.
-		threadBarrier(voxels);
+		threadBarrier(voxels, threadData.timings->voxels);
+
+		// Draw this thread's portion of floor and ceiling rows marked by the voxel pass.
+		RenderThreadData::Planes &planes = threadData.planes;
+		workStart = std::chrono::high_resolution_clock::now();
+		SoftwareRenderer::drawPlaneRows(startY, endY, *threadData.camera, voxels.ceilingHeight,
+			*voxels.voxelTextures, *threadData.shadingInfo, *threadData.frame);
+		threadTimings.planes = getWorkTime();
+
+		// Wait for other threads to finish floor and ceiling rows.
+		threadBarrier(planes, threadData.timings->planes);
 
 		// Wait for the visible flat sorting to finish.
 		RenderThreadData::Flats &flats = threadData.flats;
@@ -6485,11 +7216,22 @@ void SoftwareRenderer::renderThreadLoop(RenderThreadData &threadData, int thread
 		lk.unlock();
 
 		// Draw this thread's portion of flats.
+		workStart = std::chrono::high_resolution_clock::now();
 		SoftwareRenderer::drawFlats(startX, endX, *threadData.camera, *flats.flatNormal,
 			*flats.visibleFlats, *flats.flatTextures, *threadData.shadingInfo, *threadData.frame);
+		threadTimings.flats = getWorkTime();
 
 		// Wait for other threads to finish flats.
-		threadBarrier(flats);
+		threadBarrier(flats, threadData.timings->flats);
+
+		// Convert this thread's portion of palette-indexed pixels to true color.
+		workStart = std::chrono::high_resolution_clock::now();
+		SoftwareRenderer::resolvePalette(startY, endY, *threadData.frame);
+		threadTimings.paletteResolve = getWorkTime();
+
+		// Wait for other threads to finish resolving palette indices.
+		threadBarrier(threadData.paletteResolve,
+			threadData.timings->paletteResolve);
 	}
 }
 
@@ -6498,6 +7240,8 @@ void SoftwareRenderer::render(const Double3 &eye, const Double3 &direction, doub
 	const std::vector<LevelData::DoorState> &openDoors, const VoxelGrid &voxelGrid,
 	uint32_t *colorBuffer)
 {
+	const auto frameStart = std::chrono::high_resolution_clock::now();
+
 	// Constants for screen dimensions.
 	const double widthReal = static_cast<double>(this->width);
 	const double heightReal = static_cast<double>(this->height);
@@ -6512,11 +7256,63 @@ void SoftwareRenderer::render(const Double3 &eye, const Double3 &direction, doub
 	// Normal of all flats (always facing the camera).
 	const Double3 flatNormal = Double3(-camera.forwardX, 0.0, -camera.forwardZ).normalized();
 
+	// Plane buffer tags hold a voxel texture ID and a plane index (at most the grid height)
+	// in 16 bits each. Anything bigger would alias another plane's pixels.
+	DebugAssertMsg(this->voxelTextures.size() <=
+		static_cast<size_t>(SoftwareRenderer::PLANE_TAG_MAX + 1),
+		"Too many voxel textures (" + std::to_string(this->voxelTextures.size()) + ").");
+	DebugAssertMsg(voxelGrid.getHeight() < SoftwareRenderer::PLANE_TAG_MAX,
+		"Voxel grid too tall (" + std::to_string(voxelGrid.getHeight()) + ").");
+
 	// Calculate shading information for this frame. Create some helper structs to keep similar
 	// values together.
 	const ShadingInfo shadingInfo(this->skyPalette, daytimePercent, latitude,
 		ambient, this->fogDistance);
-	const FrameView frame(colorBuffer, this->emissionBuffer.data(), this->depthBuffer.data(), this->width, this->height);
+	// Rebuild the per-column ray tables if the field of view changed.
+	if (fovY != this->columnRaysFovY)
+	{
+		this->updateColumnRays(camera);
+	}
+
+	// Voxels are drawn as palette indices through colormaps when indexed color is enabled
+	// and the level has given a palette. The colormaps have fog baked in, so they're rebuilt
+	// whenever the fog color changes.
+	const bool indexedColor = ((this->renderParams & RenderParams::IndexedColor) != 0) &&
+		!this->voxelPalette.empty();
+	if (indexedColor)
+	{
+		const Double3 &fogColor = shadingInfo.getFogColor();
+		if (this->colormaps.empty() || (fogColor.toRGB() != this->colormapsFogColor))
+		{
+			this->updateColormaps(fogColor);
+		}
+	}
+
+	// Debug views count pixel writes and DDA steps while drawing, and replace the frame with
+	// false color at the end.
+	const bool overdrawView = (this->renderParams & RenderParams::DebugOverdraw) != 0;
+	const bool rayStepsView = (this->renderParams & RenderParams::DebugRaySteps) != 0;
+
+	const FrameView frame(colorBuffer, this->emissionBuffer.data(), this->depthBuffer.data(),
+		this->planeBuffer.data(), this->planeRowScales.data(), this->columnRayDirs.data(),
+		this->columnDepthScales.data(), indexedColor ? this->indexBuffer.data() : nullptr,
+		indexedColor ? this->indexCoverage.data() : nullptr,
+		indexedColor ? this->colormaps.data() : nullptr,
+		indexedColor ? this->voxelPalette.data() : nullptr,
+		overdrawView ? this->overdrawBuffer.data() : nullptr,
+		rayStepsView ? this->rayStepCounts.data() : nullptr, this->width, this->height);
+
+	// Projection scale of each row for floor and ceiling depth. A plane's camera-space depth
+	// on a row is its distance above or below the eye times this value (and the projection
+	// terms), so the voxel pass doesn't need a division per pixel. Rows are kept at least half
+	// a row away from the horizon so the scale stays finite there.
+	const double minHorizonDistance = 0.50 / heightReal;
+	for (int y = 0; y < this->height; y++)
+	{
+		const double yPercent = (static_cast<double>(y) + 0.50) / heightReal;
+		const double horizonDistance = std::abs((0.50 + camera.yShear) - yPercent);
+		this->planeRowScales[y] = 0.50 / std::max(horizonDistance, minHorizonDistance);
+	}
 
 	// Projected Y range of the sky gradient.
 	double gradientProjYTop, gradientProjYBottom;
@@ -6527,13 +7323,15 @@ void SoftwareRenderer::render(const Double3 &eye, const Double3 &direction, doub
 
 	// Set all the render-thread-specific shared data for this frame.
 	this->threadData.init(static_cast<int>(this->renderThreads.size()),
-		camera,shadingInfo, frame);
+		camera, shadingInfo, frame, this->frameTimings);
 	this->threadData.skyGradient.init(gradientProjYTop, gradientProjYBottom,
 		this->skyGradientRowCache);
 	this->threadData.distantSky.init(parallaxSky, this->visDistantObjs, this->skyTextures);
 	this->threadData.voxels.init(ceilingHeight, openDoors, voxelGrid,
 		this->voxelTextures, this->occlusion);
+	this->threadData.planes.init();
 	this->threadData.flats.init(flatNormal, this->visibleFlats, this->flatTextures);
+	this->threadData.paletteResolve.init();
 
 	// Give the render threads the go signal. They can work on the sky and voxels while this thread
 	// does things like resetting occlusion and doing visible flat determination.
@@ -6548,7 +7346,10 @@ void SoftwareRenderer::render(const Double3 &eye, const Double3 &direction, doub
 	std::fill(this->occlusion.begin(), this->occlusion.end(), OcclusionData(0, this->height));
 
 	// Refresh the visible distant objects.
+	const auto distantVisStart = std::chrono::high_resolution_clock::now();
 	this->updateVisibleDistantObjects(parallaxSky, shadingInfo, camera, frame);
+	this->frameTimings.distantVisibility = std::chrono::duration<double, std::milli>(
+		std::chrono::high_resolution_clock::now() - distantVisStart).count();
 
 	lk.lock();
 	this->threadData.condVar.wait(lk, [this]()
@@ -6567,7 +7368,10 @@ void SoftwareRenderer::render(const Double3 &eye, const Double3 &direction, doub
 
 	// Refresh the visible flats. This should erase the old list, calculate a new list, and sort
 	// it by depth.
+	const auto flatVisStart = std::chrono::high_resolution_clock::now();
 	this->updateVisibleFlats(camera);
+	this->frameTimings.flatVisibility = std::chrono::duration<double, std::milli>(
+		std::chrono::high_resolution_clock::now() - flatVisStart).count();
 
 	lk.lock();
 	this->threadData.condVar.wait(lk, [this]()
@@ -6581,17 +7385,20 @@ void SoftwareRenderer::render(const Double3 &eye, const Double3 &direction, doub
 	lk.unlock();
 	this->threadData.condVar.notify_all();
 
-	// Wait until render threads are done drawing flats.
+	// Wait until render threads are done drawing flats and resolving palette indices.
 	lk.lock();
 	this->threadData.condVar.wait(lk, [this]()
 	{
-		return this->threadData.flats.threadsDone == this->threadData.totalThreads;
+		return this->threadData.paletteResolve.threadsDone == this->threadData.totalThreads;
 	});
 
 	// Apply post processing effects
+	const auto postProcessingStart = std::chrono::high_resolution_clock::now();
 	if ((this->renderParams & RenderParams::PostProcessing) != 0)
 	{
-		if ((this->renderParams & RenderParams::Bloom) != 0)
+		// Colormaps have no emission, so indexed pixels leave the emission buffer stale and bloom
+		// is skipped in indexed color.
+		if (((this->renderParams & RenderParams::Bloom) != 0) && !indexedColor)
 		{ // Bloom. Performance is terrible, acts more like a proof of concept
 			const double bloomStrength = 0.1;
 			const int blendPixels = 10;
@@ -6621,4 +7428,13 @@ void SoftwareRenderer::render(const Double3 &eye, const Double3 &direction, doub
 			}
 		}
 	}
+
+	// Replace the frame with any enabled debug views.
+	this->drawDebugViews(frame);
+
+	const auto frameEnd = std::chrono::high_resolution_clock::now();
+	this->frameTimings.postProcessing = std::chrono::duration<double, std::milli>(
+		frameEnd - postProcessingStart).count();
+	this->frameTimings.total = std::chrono::duration<double, std::milli>(
+		frameEnd - frameStart).count();
 }
@@ -3,6 +3,7 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
 #include <mutex>
@@ -25,11 +26,44 @@ class VoxelGrid;
 
 class SoftwareRenderer
 {
+public:
+	// Milliseconds spent in each stage of the most recent frame. Render thread stages are
+	// measured from the end of one stage's barrier to the next, so they include any waiting
+	// on the main thread.
+	struct FrameTimings
+	{
+		// Milliseconds one render thread spent working on each stage, not counting time
+		// waiting at barriers.
+		struct ThreadTimings
+		{
+			double skyGradient, distantSky, voxels, planes, flats, paletteResolve;
+
+			ThreadTimings();
+
+			double getTotal() const;
+		};
+
+		double skyGradient, distantVisibility, distantSky, voxels, planes, flatVisibility,
+			flats, paletteResolve, postProcessing, total;
+		std::vector<ThreadTimings> threads; // One per render thread.
+
+		FrameTimings();
+	};
+
+	// Per-frame counters from the debug views. Values are zero for views that are off.
+	struct DebugViewStats
+	{
+		double avgOverdraw, avgRaySteps; // Color writes per pixel and DDA steps per column.
+		int maxOverdraw, maxRaySteps;
+
+		DebugViewStats();
+	};
 private:
 	struct VoxelTexel
 	{
 		double r, g, b, emission;
 		bool transparent; // Voxel texels only support alpha testing, not alpha blending.
+		uint8_t paletteIndex; // Voxel palette index from the source image, for indexed color.
 
 		VoxelTexel();
 	};
@@ -58,6 +92,9 @@ private:
 
 		std::array<VoxelTexel, VoxelTexture::TEXEL_COUNT> texels;
 		std::vector<Int2> lightTexels; // Black during the day, yellow at night.
+		bool hasPaletteIndices; // Whether texels have palette indices. Drawn in true color if not.
+
+		VoxelTexture();
 	};
 
 	struct FlatTexture
@@ -196,10 +233,24 @@ private:
 		uint32_t *colorBuffer;
 		uint32_t *emissionBuffer;
 		double *depthBuffer;
+		uint32_t *planeBuffer;
+		const double *planeRowScales;
+		const Double2 *columnRayDirs;
+		const double *columnDepthScales;
+		uint8_t *indexBuffer; // Null unless indexed color is on.
+		uint8_t *indexCoverage; // Null unless indexed color is on. Non-zero where indexBuffer is the color.
+		const uint8_t *colormaps; // Null unless indexed color is on.
+		const uint32_t *palette; // Null unless indexed color is on.
+		uint8_t *overdrawBuffer; // Null unless the overdraw debug view is on.
+		uint16_t *rayStepCounts; // Null unless the ray step debug view is on.
 		int width, height;
 		double widthReal, heightReal;
 
-		FrameView(uint32_t *colorBuffer, uint32_t *emissionBuffer, double *depthBuffer, int width, int height);
+		FrameView(uint32_t *colorBuffer, uint32_t *emissionBuffer, double *depthBuffer,
+			uint32_t *planeBuffer, const double *planeRowScales, const Double2 *columnRayDirs,
+			const double *columnDepthScales, uint8_t *indexBuffer, uint8_t *indexCoverage,
+			const uint8_t *colormaps, const uint32_t *palette, uint8_t *overdrawBuffer, uint16_t *rayStepCounts,
+			int width, int height);
 	};
 
 	// A flat is a 2D surface always facing perpendicular to the Y axis, and opposite to
@@ -356,6 +407,13 @@ private:
 				std::vector<OcclusionData> &occlusion);
 		};
 
+		struct Planes
+		{
+			int threadsDone;
+
+			void init();
+		};
+
 		struct Flats
 		{
 			int threadsDone;
@@ -368,13 +426,24 @@ private:
 				const std::vector<FlatTexture> &flatTextures);
 		};
 
+		struct PaletteResolve
+		{
+			int threadsDone;
+
+			void init();
+		};
+
 		SkyGradient skyGradient;
 		DistantSky distantSky;
 		Voxels voxels;
+		Planes planes;
 		Flats flats;
+		PaletteResolve paletteResolve;
 		const Camera *camera;
 		const ShadingInfo *shadingInfo;
 		const FrameView *frame;
+		FrameTimings *timings;
+		std::chrono::high_resolution_clock::time_point stageStart; // End of the last barrier.
 
 		std::condition_variable condVar;
 		std::mutex mutex;
@@ -385,7 +454,7 @@ private:
 		RenderThreadData();
 
 		void init(int totalThreads, const Camera &camera, const ShadingInfo &shadingInfo,
-			const FrameView &frame);
+			const FrameView &frame, FrameTimings &timings);
 	};
 
 	// Clipping planes for Z coordinates.
@@ -399,9 +468,26 @@ private:
 	static const int DEFAULT_VOXEL_TEXTURE_COUNT;
 	static const int DEFAULT_FLAT_TEXTURE_COUNT;
 
+	// Number of light and fog levels in indexed color mode's colormaps. Each colormap maps
+	// a voxel palette index to the palette index closest to its lit and fogged color.
+	static const int COLORMAP_LIGHT_LEVELS;
+	static const int COLORMAP_FOG_LEVELS;
+
+	// Values shown as the hottest color in the overdraw and ray step debug views.
+	static const int OVERDRAW_HEATMAP_MAX;
+	static const int RAY_STEPS_HEATMAP_MAX;
+
 	// Amount of a sliding/raising door that is visible when fully open.
 	static const double DOOR_MIN_VISIBLE;
 
+	// Largest texture ID and plane index (plus one) that fit in a plane buffer tag, which
+	// packs them into its low and high 16 bits.
+	static constexpr int PLANE_TAG_MAX = 0xFFFF;
+
+	// Number of pixels in a perspective-correct column between exact perspective divisions.
+	// Depth and texture coordinates are interpolated linearly in between.
+	static constexpr int PERSPECTIVE_SPAN_LENGTH = 8;
+
 	// Angle of the sky gradient above the horizon, in degrees.
 	static const double SKY_GRADIENT_ANGLE;
 
@@ -418,6 +504,20 @@ private:
 
 	std::vector<uint32_t> emissionBuffer; // 2D buffer, contains emission overlay
 	std::vector<double> depthBuffer; // 2D buffer, mostly consists of depth in the XZ plane.
+	std::vector<uint32_t> planeBuffer; // 2D buffer, floor/ceiling pixels waiting for the row pass.
+	std::vector<double> planeRowScales; // Per-row projection scale for floor/ceiling depth.
+	std::vector<Double2> columnRayDirs; // Normalized camera-space ray (right, forward) per column.
+	std::vector<double> columnDepthScales; // XZ distance per unit of forward distance per column.
+	double columnRaysFovY; // Field of view the column ray tables were built for.
+	std::vector<uint8_t> indexBuffer; // 2D buffer, voxel palette indices in indexed color mode.
+	std::vector<uint8_t> indexCoverage; // 2D buffer, whether each pixel's color is in indexBuffer.
+	std::vector<uint32_t> voxelPalette; // Colors the voxel textures were made from.
+	std::vector<uint8_t> voxelPaletteLookup; // 15-bit RGB to nearest voxel palette index.
+	std::vector<uint8_t> colormaps; // Light level x fog level tables of voxel palette indices.
+	uint32_t colormapsFogColor; // Fog color the colormaps were built for.
+	std::vector<uint8_t> overdrawBuffer; // 2D buffer, color writes per pixel for the overdraw view.
+	std::vector<uint16_t> rayStepCounts; // DDA steps per column for the ray step view.
+	DebugViewStats debugViewStats; // Counters from the most recent frame's debug views.
 	std::vector<OcclusionData> occlusion; // Min and max Y for each column.
 	std::unordered_map<int, Flat> flats; // All flats in world.
 	std::vector<VisibleFlat> visibleFlats; // Flats to be drawn.
@@ -430,13 +530,36 @@ private:
 	std::vector<Double3> skyGradientRowCache; // Contains row colors of most recent sky gradient.
 	std::vector<std::thread> renderThreads; // Threads used for rendering the world.
 	RenderThreadData threadData; // Managed by main thread, used by render threads.
+	FrameTimings frameTimings; // Stage timings of the most recent frame.
 	double fogDistance; // Distance at which fog is maximum.
 	int width, height; // Dimensions of frame buffer.
 	int renderThreadsMode; // Determines number of threads to use for rendering.
 	uint32_t renderParams; // render parameters. 32 parameters is enough for everyone!
 
-	// Gets the number of render threads to use based on the given mode.
-	static int getRenderThreadsFromMode(int mode);
+	// Gets the voxel palette index with the color nearest to the given one, for colors that
+	// don't come from a texture's own indices (colormap entries and night light texels).
+	uint8_t getVoxelPaletteIndex(const Double3 &color) const;
+
+	// Rebuilds the indexed color colormaps for the given fog color.
+	void updateColormaps(const Double3 &fogColor);
+
+	// Gets the colormap for the given shading and fog percent in indexed color mode.
+	static const uint8_t *getColormap(const Double3 &shading, double fogPercent,
+		const FrameView &frame);
+
+	// Counts a color write to a pixel for the overdraw debug view, if it's on.
+	static void addOverdraw(int index, const FrameView &frame);
+
+	// Gets the false color for a heatmap value from 0 (cold) to 1 (hot).
+	static uint32_t getHeatmapColor(double percent);
+
+	// Replaces the finished frame with false color from the enabled debug views and
+	// updates their per-frame counters.
+	void drawDebugViews(const FrameView &frame);
+
+	// Rebuilds the per-column ray tables. They only depend on the field of view and the frame
+	// buffer dimensions, so they're rotated by the camera each frame instead.
+	void updateColumnRays(const Camera &camera);
 
 	// Initializes render threads that run in the background for the duration of the renderer's
 	// lifetime. This can also be used to reset threads after a screen resize.
@@ -573,6 +696,13 @@ private:
 		const VoxelTexture &texture, const ShadingInfo &shadingInfo, const RenderMaterial &material,
 		OcclusionData &occlusion, const FrameView &frame);
 
+	// Marks a column of pixels as belonging to a horizontal floor or ceiling plane instead of
+	// texturing them here. Depth comes from the row's projection scale, so the column only
+	// does the depth test; the texturing is done afterwards row by row in drawPlaneRows().
+	static void deferPlanePixels(int x, const DrawRange &drawRange, int planeIndex,
+		int textureID, double ceilingHeight, const Camera &camera, OcclusionData &occlusion,
+		const FrameView &frame);
+
 	// Draws a column of pixels with transparency but no perspective.
 	static void drawTransparentPixels(int x, const DrawRange &drawRange, double depth, double u,
 		double vStart, double vEnd, const Double3 &normal, const VoxelTexture &texture,
@@ -652,6 +782,17 @@ private:
 		const std::vector<VoxelTexture> &voxelTextures, std::vector<OcclusionData> &occlusion,
 		const ShadingInfo &shadingInfo, const FrameView &frame);
 
+	// Textures the floor and ceiling pixels marked by deferPlanePixels() in the given rows.
+	// Each horizontal run on the same plane is stepped linearly in world space, so there is
+	// no per-pixel division. The end Y value is exclusive.
+	static void drawPlaneRows(int startY, int endY, const Camera &camera, double ceilingHeight,
+		const std::vector<VoxelTexture> &textures, const ShadingInfo &shadingInfo,
+		const FrameView &frame);
+
+	// Converts the indexed pixels in the given rows to colors with the voxel palette. Does
+	// nothing unless indexed color is on. The end Y value is exclusive.
+	static void resolvePalette(int startY, int endY, const FrameView &frame);
+
 	// Handles drawing all flats for the current frame.
 	static void drawFlats(int startX, int endX, const Camera &camera, const Double3 &flatNormal,
 		const std::vector<VisibleFlat> &visibleFlats, const std::vector<FlatTexture> &flatTextures,
@@ -672,6 +813,9 @@ public:
 	// Height ratio between normal pixels and tall pixels.
 	static const double TALL_PIXEL_RATIO;
 
+	// Gets the number of render threads to use based on the given mode.
+	static int getRenderThreadsFromMode(int mode);
+
 	bool isInited() const;
 
 	// Sets the render threads mode to use (low, medium, high, etc.).
@@ -680,6 +824,12 @@ public:
 	// Sets render params int
 	void setRenderParams(uint32_t renderParams);
 
+	// Gets how long each stage of the most recent frame took.
+	const FrameTimings &getFrameTimings() const;
+
+	// Gets the counters from the most recent frame's debug views.
+	const DebugViewStats &getDebugViewStats() const;
+
 	// Adds a flat. Causes an error if the ID exists.
 	void addFlat(int id, const Double3 &position, double width, double height, int textureID);
 
@@ -706,8 +856,13 @@ public:
 	// For dungeons, this would probably just be one black pixel.
 	void setSkyPalette(const uint32_t *colors, int count);
 
-	// Overwrites the selected voxel texture's data with the given 64x64 set of texels.
-	void setVoxelTexture(int id, const uint32_t *srcTexels);
+	// Sets the palette that voxel texture palette indices refer to, for indexed color mode.
+	void setVoxelPalette(const uint32_t *colors, int count);
+
+	// Overwrites the selected voxel texture's data with the given 64x64 set of texels. The
+	// palette indices the texels were expanded from are optional; without them the texture
+	// is drawn in true color even when indexed color is on.
+	void setVoxelTexture(int id, const uint32_t *srcTexels, const uint8_t *srcPaletteIndices);
 
 	// Overwrites the selected flat texture's data with the given texels and dimensions.
 	void setFlatTexture(int id, const uint32_t *srcTexels, int width, int height);
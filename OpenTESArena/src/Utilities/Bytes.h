@@ -16,6 +16,9 @@ public:
 	static uint32_t getLE24(const uint8_t *buf);
 	static uint32_t getLE32(const uint8_t *buf);
 
+	static void setLE16(uint8_t *buf, uint16_t value);
+	static void setLE32(uint8_t *buf, uint32_t value);
+
 	// Circular rotation of an integer to the right.
 	template <typename T>
 	static T ror(T value, unsigned int count)
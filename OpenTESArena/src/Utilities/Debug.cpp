@@ -1,5 +1,7 @@
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -7,7 +9,6 @@
 
 #include "Debug.h"
 #include "String.h"
-#include "../Game/ConsoleManager.h"
 
 namespace
 {
@@ -17,10 +18,39 @@ namespace
 		{ Debug::MessageType::Warning, "Warning: " },
 		{ Debug::MessageType::Error, "Error: " },
 	};
+
+	// Messages for the output listener written from other threads.
+	std::mutex QueuedOutputMutex;
+	std::vector<std::string> QueuedOutput;
+	std::thread::id OutputListenerThreadID;
 }
 
 const std::string Debug::LOG_FILENAME = "log.txt";
-ConsoleManager *Debug::consoleManager = nullptr;
+std::function<void(const std::string&)> Debug::outputListener;
+
+void Debug::setOutputListener(std::function<void(const std::string&)> listener)
+{
+	outputListener = std::move(listener);
+	OutputListenerThreadID = std::this_thread::get_id();
+}
+
+void Debug::flushOutput()
+{
+	std::vector<std::string> output;
+
+	{
+		std::lock_guard<std::mutex> lock(QueuedOutputMutex);
+		output.swap(QueuedOutput);
+	}
+
+	if (outputListener)
+	{
+		for (const std::string &str : output)
+		{
+			outputListener(str);
+		}
+	}
+}
 
 std::string Debug::getShorterPath(const char *__file__)
 {
@@ -50,7 +80,21 @@ void Debug::write(Debug::MessageType type, const std::string &filePath,
 		messageType + message + "\n";
 
 	std::cerr << output;
-	if (consoleManager != nullptr) consoleManager->putString(output);
+
+	if (outputListener)
+	{
+		if (std::this_thread::get_id() == OutputListenerThreadID)
+		{
+			// Keep messages from other threads in order with this one.
+			Debug::flushOutput();
+			outputListener(output);
+		}
+		else
+		{
+			std::lock_guard<std::mutex> lock(QueuedOutputMutex);
+			QueuedOutput.push_back(output);
+		}
+	}
 }
 
 void Debug::mention(const char *__file__, int lineNumber, const std::string &message)
@@ -1,6 +1,7 @@
 #ifndef DEBUG_H
 #define DEBUG_H
 
+#include <functional>
 #include <stdexcept>
 #include <string>
 
@@ -8,8 +9,6 @@
 // that should be accompanied with messages and logging. Plain old asserts like 
 // "assert(width > 0)" are for sanity checks and don't need to use these heavier methods.
 
-class ConsoleManager;
-
 class Debug
 {
 public:
@@ -20,10 +19,13 @@ public:
 		Error
 	};
 
-	static ConsoleManager *consoleManager;
 private:
 	static const std::string LOG_FILENAME;
 
+	// Optional receiver for every written message, like the in-game console. Debug doesn't
+	// depend on the game, so tools and benchmarks can use it on its own.
+	static std::function<void(const std::string&)> outputListener;
+
 	Debug() = delete;
 	~Debug() = delete;
 
@@ -34,6 +36,12 @@ public:
 	// Shortens the __FILE__ macro so it only includes a couple parent folders.
 	static std::string getShorterPath(const char *__file__);
 
+	// Sets the receiver for written messages. It's only called on the thread that set it;
+	// messages written on other threads (i.e., background loading) are held until that
+	// thread calls flushOutput().
+	static void setOutputListener(std::function<void(const std::string&)> listener);
+	static void flushOutput();
+
 	// Use DebugMention() instead. Helper method for mentioning something about program state.
 	static void mention(const char *__file__, int lineNumber, const std::string &message);
 
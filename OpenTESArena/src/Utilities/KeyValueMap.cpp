@@ -81,7 +81,7 @@ KeyValueMap::KeyValueMap(const std::string &filename)
 		else if (filteredLine.size() < 3)
 		{
 			// Not long enough to be a section or key-value pair.
-			DebugCrash("Syntax error \"" + std::string(filteredLine) + "\" (line " +
+			throw DebugException("Syntax error \"" + std::string(filteredLine) + "\" (line " +
 				std::to_string(lineNumber) + ") in " + filename + ".");
 		}
 
@@ -115,13 +115,13 @@ KeyValueMap::KeyValueMap(const std::string &filename)
 				}
 				else
 				{
-					DebugCrash("Section \"" + sectionNameStr + "\" (line " +
+					throw DebugException("Section \"" + sectionNameStr + "\" (line " +
 						std::to_string(lineNumber) + ") already defined in " + filename + ".");
 				}
 			}
 			else
 			{
-				DebugCrash("Invalid section \"" + std::string(filteredLine) + "\" (line " +
+				throw DebugException("Invalid section \"" + std::string(filteredLine) + "\" (line " +
 					std::to_string(lineNumber) + ") in " + filename + ".");
 			}
 		}
@@ -133,7 +133,7 @@ KeyValueMap::KeyValueMap(const std::string &filename)
 
 			if (tokens.size() != 2)
 			{
-				DebugCrash("Invalid pair \"" + std::string(filteredLine) + "\" (line " +
+				throw DebugException("Invalid pair \"" + std::string(filteredLine) + "\" (line " +
 					std::to_string(lineNumber) + ") in " + filename + ".");
 			}
 
@@ -143,7 +143,7 @@ KeyValueMap::KeyValueMap(const std::string &filename)
 
 			if (key.size() == 0)
 			{
-				DebugCrash("Empty key in \"" + std::string(filteredLine) + "\" (line " +
+				throw DebugException("Empty key in \"" + std::string(filteredLine) + "\" (line " +
 					std::to_string(lineNumber) + ") in " + filename + ".");
 			}
 
@@ -163,7 +163,7 @@ KeyValueMap::KeyValueMap(const std::string &filename)
 		else
 		{
 			// Filtered line is not a section or key-value pair.
-			DebugCrash("Invalid line \"" + line + "\" (line " +
+			throw DebugException("Invalid line \"" + line + "\" (line " +
 				std::to_string(lineNumber) + ") in " + filename + ".");
 		}
 	}
@@ -199,8 +199,11 @@ bool KeyValueMap::getBoolean(const std::string &section, const std::string &key)
 {
 	const std::string &value = this->getValue(section, key);
 	const auto iter = BooleanStrings.find(value);
-	DebugAssertMsg(iter != BooleanStrings.end(), "\"" + key + "\" value \"" +
-		value + "\" in " + this->filename + " must be true or false.");
+	if (iter == BooleanStrings.end())
+	{
+		throw DebugException("\"" + key + "\" value \"" + value + "\" in " +
+			this->filename + " must be true or false.");
+	}
 
 	return iter->second;
 }
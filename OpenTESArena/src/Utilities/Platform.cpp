@@ -11,8 +11,10 @@
 #elif defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
 #include <cerrno>
 #include <cstring>
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 #endif
 
 const std::string Platform::XDGDataHome = "XDG_DATA_HOME";
@@ -115,6 +117,24 @@ std::string Platform::getScreenshotPath()
 	return String::replace(screenshotPathString, '\\', '/');
 }
 
+std::string Platform::getCachePath()
+{
+	// SDL_GetPrefPath() creates the desired folder if it doesn't exist.
+	char *cachePathPtr = SDL_GetPrefPath("OpenTESArena", "cache");
+
+	if (cachePathPtr == nullptr)
+	{
+		DebugWarning("SDL_GetPrefPath() not available on this platform.");
+		cachePathPtr = SDL_strdup("cache/");
+	}
+
+	const std::string cachePathString(cachePathPtr);
+	SDL_free(cachePathPtr);
+
+	// Convert Windows backslashes to forward slashes.
+	return String::replace(cachePathString, '\\', '/');
+}
+
 std::string Platform::getLogPath()
 {
 	// Unfortunately there's no SDL_GetLogPath(), so we need to make our own.
@@ -263,3 +283,98 @@ void Platform::createDirectoryRecursively(std::string path)
 		}
 	} while (index != std::string::npos);
 }
+
+void Platform::writeFileDurably(const std::string &filename, const uint8_t *data, size_t size)
+{
+#if defined(_WIN32)
+	const HANDLE file = CreateFileA(filename.c_str(), GENERIC_WRITE, 0, nullptr,
+		CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		throw DebugException("CreateFileA(): \"" + filename + "\" error " +
+			std::to_string(GetLastError()) + ".");
+	}
+
+	DWORD bytesWritten = 0;
+	const BOOL success = WriteFile(file, data, static_cast<DWORD>(size), &bytesWritten, nullptr) &&
+		(bytesWritten == size) && FlushFileBuffers(file);
+	const DWORD lastError = GetLastError();
+	CloseHandle(file);
+
+	if (!success)
+	{
+		throw DebugException("WriteFile(): \"" + filename + "\" error " +
+			std::to_string(lastError) + ".");
+	}
+#elif defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+	const int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	if (fd == -1)
+	{
+		throw DebugException("open(): \"" + filename + "\" " +
+			std::string(strerror(errno)) + ".");
+	}
+
+	// Writes can be partial, so keep going until everything is written.
+	size_t offset = 0;
+	while (offset < size)
+	{
+		const ssize_t count = write(fd, data + offset, size - offset);
+		if (count == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			const std::string message = strerror(errno);
+			close(fd);
+			throw DebugException("write(): \"" + filename + "\" " + message + ".");
+		}
+
+		offset += static_cast<size_t>(count);
+	}
+
+	if (fsync(fd) == -1)
+	{
+		const std::string message = strerror(errno);
+		close(fd);
+		throw DebugException("fsync(): \"" + filename + "\" " + message + ".");
+	}
+
+	close(fd);
+#else
+#error Unknown platform.
+#endif
+}
+
+void Platform::replaceFile(const std::string &srcFilename, const std::string &dstFilename)
+{
+#if defined(_WIN32)
+	const BOOL success = MoveFileExA(srcFilename.c_str(), dstFilename.c_str(),
+		MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+	if (success == 0)
+	{
+		throw DebugException("MoveFileExA(): \"" + srcFilename + "\" error " +
+			std::to_string(GetLastError()) + ".");
+	}
+#elif defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+	if (rename(srcFilename.c_str(), dstFilename.c_str()) == -1)
+	{
+		throw DebugException("rename(): \"" + srcFilename + "\" " +
+			std::string(strerror(errno)) + ".");
+	}
+
+	// Sync the directory too so the rename itself survives a crash.
+	const size_t slashIndex = dstFilename.find_last_of('/');
+	const std::string dirPath = (slashIndex != std::string::npos) ?
+		dstFilename.substr(0, slashIndex + 1) : std::string(".");
+	const int dirFd = open(dirPath.c_str(), O_RDONLY);
+	if (dirFd != -1)
+	{
+		fsync(dirFd);
+		close(dirFd);
+	}
+#else
+#error Unknown platform.
+#endif
+}
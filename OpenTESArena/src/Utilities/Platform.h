@@ -1,6 +1,8 @@
 #ifndef PLATFORM_H
 #define PLATFORM_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 // Static class for various platform-specific functions.
@@ -42,6 +44,9 @@ public:
 	// Gets the screenshot folder path via SDL_GetPrefPath().
 	static std::string getScreenshotPath();
 
+	// Gets the cache folder path for data derived from the game files via SDL_GetPrefPath().
+	static std::string getCachePath();
+
 	// Gets the log folder path for logging program messages.
 	static std::string getLogPath();
 
@@ -53,6 +58,13 @@ public:
 
 	// Creates a directory and all intermediate directories from the given path.
 	static void createDirectoryRecursively(std::string path);
+
+	// Writes bytes to a file and waits until they're on disk, not just in the OS cache.
+	static void writeFileDurably(const std::string &filename, const uint8_t *data, size_t size);
+
+	// Renames a file over another one in a single step, so the destination is always either
+	// the old or the new file, even after a crash.
+	static void replaceFile(const std::string &srcFilename, const std::string &dstFilename);
 };
 
 #endif
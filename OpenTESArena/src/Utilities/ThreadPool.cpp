@@ -0,0 +1,148 @@
+#include "Debug.h"
+#include "ThreadPool.h"
+
+namespace
+{
+	// Set while a thread is running a pool job, so nested run() calls don't wait on workers
+	// that may all be busy with the outer batch.
+	thread_local bool insideJob = false;
+}
+
+ThreadPool::ThreadPool()
+{
+	this->job = nullptr;
+	this->jobCount = 0;
+	this->nextJob = 0;
+	this->unfinishedJobs = 0;
+	this->generation = 0;
+	this->stopping = false;
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+
+	this->workCondition.notify_all();
+
+	for (std::thread &thread : this->threads)
+	{
+		thread.join();
+	}
+}
+
+void ThreadPool::init(int threadCount)
+{
+	DebugAssertMsg(this->threads.empty(), "Thread pool already initialized.");
+	DebugAssertMsg(threadCount >= 0, "Invalid thread count \"" +
+		std::to_string(threadCount) + "\".");
+
+	for (int i = 0; i < threadCount; i++)
+	{
+		this->threads.push_back(std::thread([this]() { this->workerLoop(); }));
+	}
+}
+
+int ThreadPool::getThreadCount() const
+{
+	return static_cast<int>(this->threads.size());
+}
+
+void ThreadPool::runJobs(std::unique_lock<std::mutex> &lock)
+{
+	while (this->nextJob < this->jobCount)
+	{
+		const int index = this->nextJob;
+		this->nextJob++;
+
+		lock.unlock();
+		insideJob = true;
+
+		try
+		{
+			(*this->job)(index);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> exceptionLock(this->mutex);
+			if (this->exception == nullptr)
+			{
+				this->exception = std::current_exception();
+			}
+		}
+
+		insideJob = false;
+		lock.lock();
+
+		this->unfinishedJobs--;
+		if (this->unfinishedJobs == 0)
+		{
+			this->doneCondition.notify_all();
+		}
+	}
+}
+
+void ThreadPool::workerLoop()
+{
+	uint64_t seenGeneration = 0;
+	std::unique_lock<std::mutex> lock(this->mutex);
+	while (true)
+	{
+		this->workCondition.wait(lock, [this, seenGeneration]()
+		{
+			return this->stopping || (this->generation != seenGeneration);
+		});
+
+		if (this->stopping)
+		{
+			return;
+		}
+
+		seenGeneration = this->generation;
+		this->runJobs(lock);
+	}
+}
+
+void ThreadPool::run(int count, const std::function<void(int)> &job)
+{
+	std::unique_lock<std::mutex> runLock(this->runMutex, std::defer_lock);
+	const bool runSerially = (count <= 1) || this->threads.empty() || insideJob ||
+		!runLock.try_lock();
+
+	if (runSerially)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			job(i);
+		}
+
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->job = &job;
+	this->jobCount = count;
+	this->nextJob = 0;
+	this->unfinishedJobs = count;
+	this->exception = nullptr;
+	this->generation++;
+	this->workCondition.notify_all();
+
+	this->runJobs(lock);
+	this->doneCondition.wait(lock, [this]() { return this->unfinishedJobs == 0; });
+
+	this->job = nullptr;
+	this->jobCount = 0;
+	this->nextJob = 0;
+
+	std::exception_ptr exception = this->exception;
+	this->exception = nullptr;
+	lock.unlock();
+
+	if (exception != nullptr)
+	{
+		std::rethrow_exception(exception);
+	}
+}
@@ -0,0 +1,48 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads for splitting up independent jobs, like decoding the frames
+// of an animation. The calling thread works on the jobs too, and run() only returns once
+// they are all done, so results can be written straight into caller-owned slots.
+
+class ThreadPool
+{
+private:
+	std::vector<std::thread> threads;
+	std::mutex mutex, runMutex;
+	std::condition_variable workCondition, doneCondition;
+	const std::function<void(int)> *job;
+	int jobCount, nextJob, unfinishedJobs;
+	uint64_t generation; // Incremented for each run() so workers notice new work.
+	bool stopping;
+	std::exception_ptr exception; // First exception thrown by a job, if any.
+
+	// Runs jobs from the current batch until there are none left to start.
+	void runJobs(std::unique_lock<std::mutex> &lock);
+
+	void workerLoop();
+public:
+	ThreadPool();
+	~ThreadPool();
+
+	// Starts the given number of worker threads (zero is valid; everything then runs on
+	// the calling thread).
+	void init(int threadCount);
+
+	int getThreadCount() const;
+
+	// Calls job(i) for every i in [0, count) across the workers and the calling thread,
+	// returning when all calls have finished. Rethrows the first exception a job threw.
+	// Calls from inside a job, or while another thread is using the pool, run serially.
+	void run(int count, const std::function<void(int)> &job);
+};
+
+#endif
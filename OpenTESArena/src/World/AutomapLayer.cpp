@@ -0,0 +1,272 @@
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#include "AutomapLayer.h"
+#include "VoxelData.h"
+#include "VoxelDataType.h"
+#include "VoxelGrid.h"
+#include "../Media/Color.h"
+#include "../Rendering/Renderer.h"
+#include "../Utilities/Debug.h"
+
+namespace
+{
+	// Distance in voxels around the player that counts as explored.
+	const int RevealRadius = 5;
+
+	// Colors for automap pixels. Ground pixels (y == 0) are transparent.
+	const Color AutomapFloor(0, 0, 0, 0);
+	const Color AutomapWall(130, 89, 48);
+	const Color AutomapRaised(97, 85, 60);
+	const Color AutomapDoor(146, 0, 0);
+	const Color AutomapLevelUp(0, 105, 0);
+	const Color AutomapLevelDown(0, 0, 255);
+	const Color AutomapDryChasm(20, 40, 40);
+	const Color AutomapWetChasm(109, 138, 174);
+	const Color AutomapLavaChasm(255, 0, 0);
+	const Color AutomapNotImplemented(255, 0, 255);
+}
+
+AutomapLayer::AutomapLayer(int width, int depth)
+	: lastRevealVoxel(-1, -1)
+{
+	this->surface = Surface::createWithFormat(depth * 3, width * 3,
+		Renderer::DEFAULT_BPP, Renderer::DEFAULT_PIXELFORMAT);
+
+	// Fill with transparent color first (used by floor voxels and unexplored columns).
+	SDL_FillRect(this->surface.get(), nullptr, AutomapFloor.toARGB());
+
+	this->explored = std::vector<bool>(width * depth, false);
+	this->dirtyRect = SDL_Rect();
+	this->width = width;
+	this->depth = depth;
+	this->hasDirtyRect = false;
+}
+
+const Color &AutomapLayer::getPixelColor(const VoxelData &floorData, const VoxelData &wallData)
+{
+	const VoxelDataType floorDataType = floorData.dataType;
+	const VoxelDataType wallDataType = wallData.dataType;
+
+	if (floorDataType == VoxelDataType::Chasm)
+	{
+		const VoxelData::ChasmData::Type chasmType = floorData.chasm.type;
+
+		if (chasmType == VoxelData::ChasmData::Type::Dry)
+		{
+			// Dry chasms are a different color if a wall is over them.
+			return (wallDataType == VoxelDataType::Wall) ? AutomapRaised : AutomapDryChasm;
+		}
+		else if (chasmType == VoxelData::ChasmData::Type::Lava)
+		{
+			// Lava chasms ignore all but raised platforms.
+			return (wallDataType == VoxelDataType::Raised) ? AutomapRaised : AutomapLavaChasm;
+		}
+		else if (chasmType == VoxelData::ChasmData::Type::Wet)
+		{
+			// Water chasms ignore all but raised platforms.
+			return (wallDataType == VoxelDataType::Raised) ? AutomapRaised : AutomapWetChasm;
+		}
+		else
+		{
+			DebugWarning("Unrecognized chasm type \"" +
+				std::to_string(static_cast<int>(chasmType)) + "\".");
+			return AutomapNotImplemented;
+		}
+	}
+	else if (floorDataType == VoxelDataType::Floor)
+	{
+		// If nothing is over the floor, return transparent. Otherwise, choose from
+		// a number of cases.
+		if (wallDataType == VoxelDataType::None)
+		{
+			return AutomapFloor;
+		}
+		else if (wallDataType == VoxelDataType::Wall)
+		{
+			const VoxelData::WallData::Type wallType = wallData.wall.type;
+
+			if (wallType == VoxelData::WallData::Type::Solid)
+			{
+				return AutomapWall;
+			}
+			else if (wallType == VoxelData::WallData::Type::LevelUp)
+			{
+				return AutomapLevelUp;
+			}
+			else if (wallType == VoxelData::WallData::Type::LevelDown)
+			{
+				return AutomapLevelDown;
+			}
+			else if (wallType == VoxelData::WallData::Type::Menu)
+			{
+				// Menu blocks are the same color as doors.
+				return AutomapDoor;
+			}
+			else
+			{
+				DebugWarning("Unrecognized wall type \"" +
+					std::to_string(static_cast<int>(wallType)) + "\".");
+				return AutomapNotImplemented;
+			}
+		}
+		else if (wallDataType == VoxelDataType::Raised)
+		{
+			return AutomapRaised;
+		}
+		else if (wallDataType == VoxelDataType::Diagonal)
+		{
+			return AutomapFloor;
+		}
+		else if (wallDataType == VoxelDataType::Door)
+		{
+			return AutomapDoor;
+		}
+		else if (wallDataType == VoxelDataType::TransparentWall)
+		{
+			// Transparent walls with collision (hedges) are shown, while
+			// ones without collision (archways) are not.
+			const VoxelData::TransparentWallData &transparentWallData = wallData.transparentWall;
+			return transparentWallData.collider ? AutomapWall : AutomapFloor;
+		}
+		else if (wallDataType == VoxelDataType::Edge)
+		{
+			return AutomapWall;
+		}
+		else
+		{
+			DebugWarning("Unrecognized wall data type \"" +
+				std::to_string(static_cast<int>(wallDataType)) + "\".");
+			return AutomapNotImplemented;
+		}
+	}
+	else
+	{
+		DebugWarning("Unrecognized floor data type \"" +
+			std::to_string(static_cast<int>(floorDataType)) + "\".");
+		return AutomapNotImplemented;
+	}
+}
+
+SDL_Rect AutomapLayer::getColumnRect(int x, int z) const
+{
+	const Int2 position = this->getColumnPosition(x, z);
+
+	SDL_Rect rect;
+	rect.x = position.x;
+	rect.y = position.y;
+	rect.w = 3;
+	rect.h = 3;
+	return rect;
+}
+
+void AutomapLayer::paintColumn(int x, int z, const VoxelGrid &voxelGrid)
+{
+	auto getVoxelData = [&voxelGrid](int x, int y, int z) -> const VoxelData&
+	{
+		const uint16_t voxelID = voxelGrid.getVoxel(x, y, z);
+		return voxelGrid.getVoxelData(voxelID);
+	};
+
+	// The color depends on a couple factors, like whether the voxel is a wall, a door,
+	// water, etc., and some context-sensitive cases like whether a dry chasm has a wall
+	// over it.
+	const VoxelData &floorData = getVoxelData(x, 0, z);
+	const VoxelData &wallData = getVoxelData(x, 1, z);
+	const Color &color = AutomapLayer::getPixelColor(floorData, wallData);
+
+	const SDL_Rect rect = this->getColumnRect(x, z);
+	SDL_FillRect(this->surface.get(), &rect, color.toARGB());
+
+	if (this->hasDirtyRect)
+	{
+		SDL_UnionRect(&this->dirtyRect, &rect, &this->dirtyRect);
+	}
+	else
+	{
+		this->dirtyRect = rect;
+		this->hasDirtyRect = true;
+	}
+}
+
+int AutomapLayer::getWidth() const
+{
+	return this->surface.getWidth();
+}
+
+int AutomapLayer::getHeight() const
+{
+	return this->surface.getHeight();
+}
+
+Int2 AutomapLayer::getColumnPosition(int x, int z) const
+{
+	return Int2(z * 3, this->surface.getHeight() - 3 - (x * 3));
+}
+
+void AutomapLayer::reveal(const Int2 &voxel, const VoxelGrid &voxelGrid)
+{
+	// Nothing new can be explored without moving to another voxel.
+	if (voxel == this->lastRevealVoxel)
+	{
+		return;
+	}
+
+	this->lastRevealVoxel = voxel;
+
+	const int minX = std::max(voxel.x - RevealRadius, 0);
+	const int maxX = std::min(voxel.x + RevealRadius, this->width - 1);
+	const int minZ = std::max(voxel.y - RevealRadius, 0);
+	const int maxZ = std::min(voxel.y + RevealRadius, this->depth - 1);
+
+	for (int x = minX; x <= maxX; x++)
+	{
+		for (int z = minZ; z <= maxZ; z++)
+		{
+			const int dx = x - voxel.x;
+			const int dz = z - voxel.y;
+			const bool inRadius = ((dx * dx) + (dz * dz)) <= (RevealRadius * RevealRadius);
+
+			const int index = x + (z * this->width);
+			if (inRadius && !this->explored[index])
+			{
+				this->explored[index] = true;
+				this->paintColumn(x, z, voxelGrid);
+			}
+		}
+	}
+}
+
+void AutomapLayer::refresh(int x, int z, const VoxelGrid &voxelGrid)
+{
+	if (this->explored[x + (z * this->width)])
+	{
+		this->paintColumn(x, z, voxelGrid);
+	}
+}
+
+const Texture &AutomapLayer::getTexture(Renderer &renderer)
+{
+	if (this->texture.get() == nullptr)
+	{
+		// Upload the whole surface the first time.
+		SDL_Texture *texture = renderer.createTexture(Renderer::DEFAULT_PIXELFORMAT,
+			SDL_TEXTUREACCESS_STATIC, this->surface.getWidth(), this->surface.getHeight());
+		SDL_UpdateTexture(texture, nullptr, this->surface.getPixels(),
+			this->surface.get()->pitch);
+		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+		this->texture = Texture(texture);
+	}
+	else if (this->hasDirtyRect)
+	{
+		// Only upload the columns painted since last time.
+		const SDL_Surface *surface = this->surface.get();
+		const uint8_t *pixels = static_cast<const uint8_t*>(surface->pixels) +
+			(this->dirtyRect.y * surface->pitch) + (this->dirtyRect.x * sizeof(uint32_t));
+		SDL_UpdateTexture(this->texture.get(), &this->dirtyRect, pixels, surface->pitch);
+	}
+
+	this->hasDirtyRect = false;
+	return this->texture;
+}
@@ -0,0 +1,65 @@
+#ifndef AUTOMAP_LAYER_H
+#define AUTOMAP_LAYER_H
+
+#include <vector>
+
+#include "SDL.h"
+
+#include "../Math/Vector2.h"
+#include "../Rendering/Surface.h"
+#include "../Rendering/Texture.h"
+
+// The automap image of a level, kept for as long as the level exists. Voxel columns are
+// classified and painted when the player first comes near them (or when they change
+// afterwards), and only the painted part is uploaded when the automap is opened.
+
+// For the purposes of the automap, the bottom left corner is (0, 0), left to right is
+// the Z axis, and up and down is the X axis, because north is +X in-game. It is scaled
+// by 3 so that all directions of the player's arrow are representable.
+
+class Color;
+class Renderer;
+class VoxelData;
+class VoxelGrid;
+
+class AutomapLayer
+{
+private:
+	Surface surface;
+	Texture texture; // Created the first time it's requested.
+	std::vector<bool> explored; // One per XZ column.
+	SDL_Rect dirtyRect; // Part of the surface painted since the last upload.
+	Int2 lastRevealVoxel;
+	int width, depth; // Voxel grid dimensions in the XZ plane.
+	bool hasDirtyRect;
+
+	// Gets the display color for a pixel on the automap, given its associated floor
+	// and wall voxel data definitions.
+	static const Color &getPixelColor(const VoxelData &floorData, const VoxelData &wallData);
+
+	// Gets the surface rectangle of a voxel column.
+	SDL_Rect getColumnRect(int x, int z) const;
+
+	// Classifies the given column and fills in its square.
+	void paintColumn(int x, int z, const VoxelGrid &voxelGrid);
+public:
+	AutomapLayer(int width, int depth);
+
+	// Gets the width and height of the automap image in pixels.
+	int getWidth() const;
+	int getHeight() const;
+
+	// Gets the top-left corner of a voxel column in the automap image.
+	Int2 getColumnPosition(int x, int z) const;
+
+	// Explores the columns around the given voxel, painting the ones not seen before.
+	void reveal(const Int2 &voxel, const VoxelGrid &voxelGrid);
+
+	// Repaints a column after one of its voxels changed, if it has been explored.
+	void refresh(int x, int z, const VoxelGrid &voxelGrid);
+
+	// Gets the automap texture, uploading whatever was painted since the last call.
+	const Texture &getTexture(Renderer &renderer);
+};
+
+#endif
@@ -325,6 +325,32 @@ int DistantSky::getStarCountFromDensity(int starDensity)
 void DistantSky::init(int localCityID, int provinceID, WeatherType weatherType,
 	int currentDay, int starCount, const MiscAssets &miscAssets, TextureManager &textureManager)
 {
+	// Sky objects keep pointers to their images, and the renderer reads them again each
+	// time the level becomes active, so they are pinned in the texture manager for as
+	// long as this sky exists.
+	auto pinFile = [this, &textureManager](const std::string &filename)
+	{
+		if (this->pins.find(filename) == this->pins.end())
+		{
+			this->pins.emplace(std::make_pair(filename,
+				TextureManager::PinHandle(textureManager, filename)));
+		}
+	};
+
+	auto getPinnedSurface = [&textureManager, &pinFile](const std::string &filename)
+		-> const Surface&
+	{
+		pinFile(filename);
+		return textureManager.getSurface(filename);
+	};
+
+	auto getPinnedSurfaces = [&textureManager, &pinFile](const std::string &filename)
+		-> const std::vector<Surface>&
+	{
+		pinFile(filename);
+		return textureManager.getSurfaces(filename);
+	};
+
 	// Add mountains and clouds first. Get the climate type of the city.
 	const ClimateType climateType = Location::getCityClimateType(
 		localCityID, provinceID, miscAssets);
@@ -365,7 +391,7 @@ void DistantSky::init(int localCityID, int provinceID, WeatherType weatherType,
 	};
 
 	// Lambda for creating images with certain sky parameters.
-	auto placeStaticObjects = [this, &textureManager, &random, &arenaAngleToRadians](int count,
+	auto placeStaticObjects = [this, &getPinnedSurface, &random, &arenaAngleToRadians](int count,
 		const std::string &baseFilename, int pos, int var, int maxDigits, bool randomHeight)
 	{
 		for (int i = 0; i < count; i++)
@@ -396,7 +422,7 @@ void DistantSky::init(int localCityID, int provinceID, WeatherType weatherType,
 				return String::toUppercase(name);
 			}();
 
-			const Surface &surface = textureManager.getSurface(filename);
+			const Surface &surface = getPinnedSurface(filename);
 
 			// The yPos parameter is optional, and is assigned depending on whether the object
 			// is in the air.
@@ -490,7 +516,7 @@ void DistantSky::init(int localCityID, int provinceID, WeatherType weatherType,
 		// Determine which frames the animation will have.
 		if (hasMultipleFrames)
 		{
-			const auto &animSurfaces = textureManager.getSurfaces(animFilename);
+			const auto &animSurfaces = getPinnedSurfaces(animFilename);
 			for (auto &surface : animSurfaces)
 			{
 				animLandObj.addSurface(surface);
@@ -498,7 +524,7 @@ void DistantSky::init(int localCityID, int provinceID, WeatherType weatherType,
 		}
 		else
 		{
-			const auto &surface = textureManager.getSurface(animFilename);
+			const auto &surface = getPinnedSurface(animFilename);
 			animLandObj.addSurface(surface);
 		}
 
@@ -511,7 +537,7 @@ void DistantSky::init(int localCityID, int provinceID, WeatherType weatherType,
 	if (hasSpaceObjects)
 	{
 		// Initialize moons.
-		auto makeMoon = [currentDay, &textureManager, &exeData](MoonObject::Type type)
+		auto makeMoon = [currentDay, &getPinnedSurfaces, &exeData](MoonObject::Type type)
 		{
 			const int phaseCount = 32;
 			const int phaseIndex = [currentDay, type, phaseCount]()
@@ -534,7 +560,7 @@ void DistantSky::init(int localCityID, int provinceID, WeatherType weatherType,
 			const int moonIndex = static_cast<int>(type);
 			const std::string filename = String::toUppercase(
 				exeData.locations.moonFilenames.at(moonIndex));
-			const auto &surfaces = textureManager.getSurfaces(filename);
+			const auto &surfaces = getPinnedSurfaces(filename);
 			const auto &surface = surfaces.at(phaseIndex);
 			const double phasePercent = static_cast<double>(phaseIndex) /
 				static_cast<double>(phaseCount);
@@ -690,17 +716,47 @@ void DistantSky::init(int localCityID, int provinceID, WeatherType weatherType,
 					return String::toUppercase(filename);
 				}();
 
-				const Surface &surface = textureManager.getSurface(starFilename);
+				const Surface &surface = getPinnedSurface(starFilename);
 				this->starObjects.push_back(StarObject::makeLarge(surface, direction));
 			}
 		}
 
 		// Initialize sun texture.
 		const std::string &sunFilename = exeData.locations.sunFilename;
-		this->sunSurface = &textureManager.getSurface(String::toUppercase(sunFilename));
+		this->sunSurface = &getPinnedSurface(String::toUppercase(sunFilename));
 	}
 }
 
+void DistantSky::addLandObject(const LandObject &landObject)
+{
+	this->landObjects.push_back(landObject);
+}
+
+void DistantSky::addAnimatedLandObject(AnimatedLandObject &&animLandObject)
+{
+	this->animLandObjects.push_back(std::move(animLandObject));
+}
+
+void DistantSky::addAirObject(const AirObject &airObject)
+{
+	this->airObjects.push_back(airObject);
+}
+
+void DistantSky::addMoonObject(const MoonObject &moonObject)
+{
+	this->moonObjects.push_back(moonObject);
+}
+
+void DistantSky::addStarObject(const StarObject &starObject)
+{
+	this->starObjects.push_back(starObject);
+}
+
+void DistantSky::setSunSurface(const Surface &surface)
+{
+	this->sunSurface = &surface;
+}
+
 void DistantSky::tick(double dt)
 {
 	// Only animated distant land needs updating.
@@ -2,16 +2,19 @@
 #define DISTANT_SKY_H
 
 #include <cstdint>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "../Math/Vector3.h"
+#include "../Media/TextureManager.h"
 
 // Contains data for distant objects (mountains, clouds, stars). Each distant object's image
-// is owned by the texture manager.
+// is owned by the texture manager, and stays pinned there until the distant sky (and with
+// it the level) is destroyed.
 
 class MiscAssets;
 class Surface;
-class TextureManager;
 
 enum class WeatherType;
 
@@ -137,6 +140,9 @@ private:
 
 	// The sun's position is a function of time of day.
 	const Surface *sunSurface;
+
+	// One pin on each image file the objects above use.
+	std::unordered_map<std::string, TextureManager::PinHandle> pins;
 public:
 	// The size of textures in world space is based on 320px being 1 unit, and a 320px
 	// wide texture spans a screen's worth of horizontal FOV in the original game.
@@ -165,6 +171,15 @@ public:
 	void init(int localCityID, int provinceID, WeatherType weatherType, int currentDay,
 		int starCount, const MiscAssets &miscAssets, TextureManager &textureManager);
 
+	// Adds objects directly, for building a sky without the original game data. Surfaces
+	// must outlive the distant sky.
+	void addLandObject(const LandObject &landObject);
+	void addAnimatedLandObject(AnimatedLandObject &&animLandObject);
+	void addAirObject(const AirObject &airObject);
+	void addMoonObject(const MoonObject &moonObject);
+	void addStarObject(const StarObject &starObject);
+	void setSunSurface(const Surface &surface);
+
 	void tick(double dt);
 };
 
@@ -691,6 +691,17 @@ ExteriorLevelData ExteriorLevelData::loadWilderness(int rmdTR, int rmdTL, int rm
 	WeatherType weatherType, int currentDay, int starCount, const std::string &infName,
 	const MiscAssets &miscAssets, TextureManager &textureManager)
 {
+	auto getRMDName = [](int rmdID)
+	{
+		std::stringstream ss;
+		ss << std::setw(3) << std::setfill('0') << rmdID;
+		return "WILD" + ss.str() + ".RMD";
+	};
+
+	// Decode the level's archive entries together instead of one by one below.
+	textureManager.prefetchFiles({ "WILD.MIF", infName, getRMDName(rmdTR),
+		getRMDName(rmdTL), getRMDName(rmdBR), getRMDName(rmdBL) });
+
 	// Load WILD.MIF (blank slate, to be filled in by four .RMD files).
 	const MIFFile mif("WILD.MIF");
 	const MIFFile::Level &level = mif.getLevels().front();
@@ -706,17 +717,10 @@ ExteriorLevelData ExteriorLevelData::loadWilderness(int rmdTR, int rmdTL, int rm
 	std::copy(level.map1.begin(), level.map1.end(), tempMap1.begin());
 	std::copy(level.map2.begin(), level.map2.end(), tempMap2.begin());
 
-	auto writeRMD = [gridDepth, &tempFlor, &tempMap1, &tempMap2](
+	auto writeRMD = [gridDepth, &tempFlor, &tempMap1, &tempMap2, &getRMDName](
 		int rmdID, int xOffset, int zOffset)
 	{
-		const std::string rmdName = [rmdID]()
-		{
-			std::stringstream ss;
-			ss << std::setw(3) << std::setfill('0') << rmdID;
-			return "WILD" + ss.str() + ".RMD";
-		}();
-
-		const RMDFile rmd(rmdName);
+		const RMDFile rmd(getRMDName(rmdID));
 
 		// Copy .RMD voxel data to temp buffers.
 		for (int z = 0; z < RMDFile::DEPTH; z++)
@@ -1,5 +1,9 @@
 #include <algorithm>
+#include <array>
 #include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "LevelData.h"
 #include "VoxelData.h"
@@ -122,7 +126,8 @@ void LevelData::DoorState::update(double dt)
 
 LevelData::LevelData(int gridWidth, int gridHeight, int gridDepth, const std::string &infName,
 	const std::string &name)
-	: voxelGrid(gridWidth, gridHeight, gridDepth), inf(infName), name(name) { }
+	: voxelGrid(gridWidth, gridHeight, gridDepth), automap(gridWidth, gridDepth),
+	inf(infName), name(name) { }
 
 LevelData::~LevelData()
 {
@@ -164,6 +169,11 @@ const VoxelGrid &LevelData::getVoxelGrid() const
 	return this->voxelGrid;
 }
 
+AutomapLayer &LevelData::getAutomap()
+{
+	return this->automap;
+}
+
 const LevelData::Lock *LevelData::getLock(const Int2 &voxel) const
 {
 	const auto lockIter = this->locks.find(voxel);
@@ -173,6 +183,12 @@ const LevelData::Lock *LevelData::getLock(const Int2 &voxel) const
 void LevelData::setVoxel(int x, int y, int z, uint16_t id)
 {
 	this->voxelGrid.setVoxel(x, y, z, id);
+
+	// Only the floor and wall voxels are shown on the automap.
+	if (y <= 1)
+	{
+		this->automap.refresh(x, z, this->voxelGrid);
+	}
 }
 
 void LevelData::readFLOR(const uint16_t *flor, const INFFile &inf, int gridWidth, int gridDepth)
@@ -840,6 +856,45 @@ void LevelData::setActive(TextureManager &textureManager, Renderer &renderer)
 	renderer.clearTextures();
 	renderer.clearDistantSky();
 
+	// Give the renderer the palette the voxel textures are made from so it can draw them
+	// as palette indices.
+	const auto &paletteColors = textureManager.getPalette().get();
+	std::array<uint32_t, 256> voxelPalette;
+	std::transform(paletteColors.begin(), paletteColors.end(), voxelPalette.begin(),
+		[](const Color &color) { return color.toARGB(); });
+	renderer.setVoxelPalette(voxelPalette.data(), static_cast<int>(voxelPalette.size()));
+
+	// Decode all of the level's voxel texture files at once so they can be spread across
+	// threads instead of being loaded one by one below. The renderer gets their palette
+	// indices along with the 32-bit texels for drawing in indexed color.
+	std::vector<std::string> voxelTextureNames;
+	std::unordered_map<std::string, int> voxelTextureFileIndices;
+	for (const auto &textureData : this->inf.getVoxelTextures())
+	{
+		std::string textureName = String::toUppercase(textureData.filename);
+		const std::string extension = String::getExtension(textureName);
+		const bool isLoadable = (extension == "IMG") || (extension == "SET");
+		if (isLoadable &&
+			(voxelTextureFileIndices.find(textureName) == voxelTextureFileIndices.end()))
+		{
+			voxelTextureFileIndices.emplace(std::make_pair(textureName,
+				static_cast<int>(voxelTextureNames.size())));
+			voxelTextureNames.push_back(std::move(textureName));
+		}
+	}
+
+	const std::vector<std::vector<TextureManager::PalettedImage>> voxelTextureImages =
+		textureManager.getPalettedImages(voxelTextureNames);
+
+	auto setVoxelTexture = [&textureManager, &renderer](int id,
+		const TextureManager::PalettedImage &image)
+	{
+		const Surface surface = TextureManager::make32BitFromPaletted(image.width,
+			image.height, image.pixels.data(), textureManager.getPalette());
+		renderer.setVoxelTexture(id, static_cast<const uint32_t*>(surface.getPixels()),
+			image.pixels.data());
+	};
+
 	// Load .INF voxel textures into the renderer.
 	const int voxelTextureCount = static_cast<int>(this->inf.getVoxelTextures().size());
 	for (int i = 0; i < voxelTextureCount; i++)
@@ -855,15 +910,14 @@ void LevelData::setActive(TextureManager &textureManager, Renderer &renderer)
 
 		if (isSET)
 		{
-			// Use the texture data's .SET index to obtain the correct surface.
-			const auto &surfaces = textureManager.getSurfaces(textureName);
-			const Surface &surface = surfaces.at(textureData.setIndex.value());
-			renderer.setVoxelTexture(i, static_cast<const uint32_t*>(surface.getPixels()));
+			// Use the texture data's .SET index to obtain the correct image.
+			const auto &images = voxelTextureImages.at(voxelTextureFileIndices.at(textureName));
+			setVoxelTexture(i, images.at(textureData.setIndex.value()));
 		}
 		else if (isIMG)
 		{
-			const Surface &surface = textureManager.getSurface(textureName);
-			renderer.setVoxelTexture(i, static_cast<const uint32_t*>(surface.getPixels()));
+			const auto &images = voxelTextureImages.at(voxelTextureFileIndices.at(textureName));
+			setVoxelTexture(i, images.front());
 		}
 		else if (noExtension)
 		{
@@ -880,6 +934,9 @@ void LevelData::setActive(TextureManager &textureManager, Renderer &renderer)
 	// Load .INF flat textures into the renderer.
 	// - @todo: maybe turn this into a while loop, so the index variable can be incremented
 	//   by the size of each .DFA. It's incorrect as-is.
+	// - @todo: these would be decoded one file at a time. When this is enabled again, give
+	//   the .DFA and .IMG names to textureManager.preloadSurfaces() first, like the voxel
+	//   textures above, so they're decoded in parallel.
 	/*const int flatTextureCount = static_cast<int>(inf.getFlatTextures().size());
 	for (int i = 0; i < flatTextureCount; i++)
 	{
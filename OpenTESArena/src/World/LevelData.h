@@ -8,6 +8,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "AutomapLayer.h"
 #include "VoxelGrid.h"
 #include "../Assets/ArenaTypes.h"
 #include "../Assets/INFFile.h"
@@ -123,6 +124,7 @@ private:
 	std::unordered_map<std::pair<uint16_t, std::array<bool, 4>>, int> chasmDataMappings;
 
 	VoxelGrid voxelGrid;
+	AutomapLayer automap;
 	INFFile inf;
 	std::vector<DoorState> openDoors;
 	std::string name;
@@ -149,6 +151,7 @@ public:
 	const INFFile &getInfFile() const;
 	VoxelGrid &getVoxelGrid();
 	const VoxelGrid &getVoxelGrid() const;
+	AutomapLayer &getAutomap();
 
 	// Returns a pointer to some lock if the given voxel has a lock, or null if it doesn't.
 	const Lock *getLock(const Int2 &voxel) const;
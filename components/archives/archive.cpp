@@ -81,4 +81,45 @@ ConstrainedFileStreamBuf::pos_type ConstrainedFileStreamBuf::seekpos(pos_type po
 }
 
 
+MemoryStreamBuf::MemoryStreamBuf(const char *data, size_t size)
+{
+    // The get area is never written through, so dropping const is safe.
+    char *begin = const_cast<char*>(data);
+    setg(begin, begin, begin+size);
+}
+
+MemoryStreamBuf::pos_type MemoryStreamBuf::seekoff(off_type offset, std::ios_base::seekdir whence, std::ios_base::openmode mode)
+{
+    if((mode&std::ios_base::out) || !(mode&std::ios_base::in))
+        return traits_type::eof();
+
+    off_type newPos;
+    switch(whence)
+    {
+        case std::ios_base::beg:
+            newPos = offset;
+            break;
+        case std::ios_base::cur:
+            newPos = offset + (gptr()-eback());
+            break;
+        case std::ios_base::end:
+            newPos = offset + (egptr()-eback());
+            break;
+        default:
+            return traits_type::eof();
+    }
+
+    if(newPos < 0 || newPos > (egptr()-eback()))
+        return traits_type::eof();
+
+    setg(eback(), eback()+newPos, egptr());
+    return newPos;
+}
+
+MemoryStreamBuf::pos_type MemoryStreamBuf::seekpos(pos_type pos, std::ios_base::openmode mode)
+{
+    return seekoff(off_type(pos), std::ios_base::beg, mode);
+}
+
+
 } // namespace Archives
@@ -62,6 +62,39 @@ public:
 };
 
 
+// Stream over bytes already in memory (i.e., a memory-mapped archive entry). Nothing is
+// copied; the bytes must outlive the stream.
+class MemoryStreamBuf : public std::streambuf {
+public:
+    MemoryStreamBuf(const char *data, size_t size);
+
+    virtual pos_type seekoff(off_type offset, std::ios_base::seekdir whence, std::ios_base::openmode mode);
+    virtual pos_type seekpos(pos_type pos, std::ios_base::openmode mode);
+};
+
+class MemoryStream : public std::istream {
+public:
+    MemoryStream(const char *data, size_t size)
+        : std::istream(new MemoryStreamBuf(data, size))
+    {
+    }
+
+    ~MemoryStream()
+    {
+        delete rdbuf();
+    }
+};
+
+
+// Read-only bytes of an archive entry. mData is null if there is no such entry. mOwner keeps
+// the bytes alive when they aren't part of the archive itself (i.e., a decoded entry).
+struct EntryView {
+    const char *mData;
+    size_t mSize;
+    std::shared_ptr<const void> mOwner;
+};
+
+
 class Archive {
 public:
     virtual ~Archive() { }
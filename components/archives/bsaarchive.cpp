@@ -2,13 +2,35 @@
 #include "bsaarchive.hpp"
 
 #include <algorithm>
+#include <cstring>
 #include <sstream>
 #include <fstream>
 
+#include "lzcodec.hpp"
+
 
 namespace Archives
 {
 
+namespace
+{
+    // Stream over a decoded entry that keeps the bytes alive, since the archive may evict them.
+    class DecodedStream : public MemoryStream {
+        std::shared_ptr<const std::vector<char>> mBytes;
+
+    public:
+        DecodedStream(std::shared_ptr<const std::vector<char>> bytes)
+            : MemoryStream(bytes->data(), bytes->size()), mBytes(std::move(bytes))
+        {
+        }
+    };
+}
+
+BsaArchive::BsaArchive()
+    : mDecodedSize(0), mDecodeClock(0), mDecodedCacheSize(DefaultDecodedCacheSize)
+{
+}
+
 void BsaArchive::loadNamed(size_t count, std::istream& stream)
 {
     std::vector<std::string> names; names.reserve(count);
@@ -26,31 +48,39 @@ void BsaArchive::loadNamed(size_t count, std::istream& stream)
         std::replace(name.begin(), name.end(), '\\', '/');
         names.push_back(std::string(name.data()));
 
-        const bool isCompressed = read_le16(stream) != 0;
-        if(isCompressed)
+        const uint16_t compression = read_le16(stream);
+        if(compression != 0 && compression != LZCompressionFlag)
             throw std::runtime_error("Compressed entries not supported");
 
         Entry entry;
         entry.mStart = ((i == 0) ? base : entries[i-1].mEnd);
         entry.mEnd = entry.mStart + read_le32(stream);
-        entries.push_back(entry);
+        entry.mCompressed = compression == LZCompressionFlag;
+        entries.push_back(std::move(entry));
     }
 
     if(!stream.good())
         throw std::runtime_error("Failed reading archive footer");
 
-    for(const std::string &name : names)
-    {
-        auto iter = std::lower_bound(mLookupName.begin(), mLookupName.end(), name);
-        if(iter == mLookupName.end() || *iter != name)
-            mLookupName.insert(iter, name);
-    }
+    // Sort footer indices by name. The sort is stable, so for duplicate names the last one
+    // in the footer comes last and is the one kept.
+    std::vector<size_t> order(count);
+    for(size_t i = 0;i < count;++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+        [&names](size_t a, size_t b) { return names[a] < names[b]; });
 
-    mEntries.resize(mLookupName.size());
+    mLookupName.reserve(count);
+    mEntries.reserve(count);
     for(size_t i = 0;i < count;++i)
     {
-        auto iter = std::find(mLookupName.cbegin(), mLookupName.cend(), names[i]);
-        mEntries[std::distance(mLookupName.cbegin(), iter)] = entries[i];
+        const size_t index = order[i];
+        const bool isLastOfName = (i+1 == count) || (names[order[i+1]] != names[index]);
+        if(isLastOfName)
+        {
+            mLookupName.push_back(std::move(names[index]));
+            mEntries.push_back(std::move(entries[index]));
+        }
     }
 }
 
@@ -58,6 +88,12 @@ void BsaArchive::load(const std::string &fname)
 {
     mFilename = fname;
 
+    {
+        std::lock_guard<std::mutex> lock(mDecodeMutex);
+        mDecoded.clear();
+        mDecodedSize = 0;
+    }
+
     std::ifstream stream(mFilename, std::ios::binary);
     if(!stream.is_open())
         throw std::runtime_error("Failed to open "+mFilename);
@@ -66,22 +102,192 @@ void BsaArchive::load(const std::string &fname)
 
     mEntries.reserve(count);
     loadNamed(count, stream);
+
+    // Map the archive so entries don't each need a file handle and a copy. Not fatal if
+    // it fails; entries are streamed from the file instead.
+    if(mMappedFile.open(mFilename))
+    {
+        const std::streamsize mappedSize = static_cast<std::streamsize>(mMappedFile.size());
+        const bool entriesInRange = std::all_of(mEntries.begin(), mEntries.end(),
+            [mappedSize](const Entry &entry) { return entry.mEnd <= mappedSize; });
+        if(!entriesInRange)
+            throw std::runtime_error("Archive entries extend past the end of "+mFilename);
+    }
+}
+
+std::shared_ptr<const std::vector<char>> BsaArchive::decode(const Entry &entry) const
+{
+    const std::string &name = mLookupName[&entry - mEntries.data()];
+    const size_t packedSize = static_cast<size_t>(entry.mEnd - entry.mStart);
+    if(packedSize < 4)
+        throw std::runtime_error("Bad compressed entry \""+name+"\" in "+mFilename);
+
+    std::vector<char> packedCopy;
+    const char *packed = nullptr;
+    if(mMappedFile.isOpen())
+        packed = mMappedFile.data() + entry.mStart;
+    else
+    {
+        std::ifstream stream(mFilename, std::ios::binary);
+        packedCopy.resize(packedSize);
+        if(!stream.seekg(entry.mStart) || !stream.read(packedCopy.data(), packedSize))
+            throw std::runtime_error("Failed to read \""+name+"\" from "+mFilename);
+        packed = packedCopy.data();
+    }
+
+    // Compressed layout: [u32 LE decoded size][LZ block].
+    const uint8_t *header = reinterpret_cast<const uint8_t*>(packed);
+    const size_t decodedSize = size_t(header[0]) | (size_t(header[1]) << 8) |
+        (size_t(header[2]) << 16) | (size_t(header[3]) << 24);
+
+    std::shared_ptr<std::vector<char>> decoded = std::make_shared<std::vector<char>>(decodedSize);
+    if(!LZ::decompress(header + 4, packedSize - 4,
+        reinterpret_cast<uint8_t*>(decoded->data()), decodedSize))
+        throw std::runtime_error("Failed to decompress \""+name+"\" in "+mFilename);
+
+    return decoded;
+}
+
+void BsaArchive::trimDecoded(size_t size) const
+{
+    // Evicting doesn't free bytes still held by views or streams, but they're no longer
+    // counted since the cache won't hand them out again.
+    while(mDecodedSize > size)
+    {
+        auto oldest = std::min_element(mDecoded.begin(), mDecoded.end(),
+            [](const auto &a, const auto &b) { return a.second.mLastUsed < b.second.mLastUsed; });
+        mDecodedSize -= oldest->second.mBytes->size();
+        mDecoded.erase(oldest);
+    }
+}
+
+void BsaArchive::addDecoded(size_t index, std::shared_ptr<const std::vector<char>> bytes) const
+{
+    if(bytes->size() > mDecodedCacheSize || mDecoded.find(index) != mDecoded.end())
+        return;
+
+    trimDecoded(mDecodedCacheSize - bytes->size());
+    mDecodedSize += bytes->size();
+    mDecoded.emplace(index, DecodedEntry { std::move(bytes), ++mDecodeClock });
+}
+
+std::shared_ptr<const std::vector<char>> BsaArchive::decompress(const Entry &entry) const
+{
+    const size_t index = static_cast<size_t>(&entry - mEntries.data());
+    {
+        std::lock_guard<std::mutex> lock(mDecodeMutex);
+        auto iter = mDecoded.find(index);
+        if(iter != mDecoded.end())
+        {
+            iter->second.mLastUsed = ++mDecodeClock;
+            return iter->second.mBytes;
+        }
+    }
+
+    // Decode outside the lock so other entries can be decoded at the same time. If two
+    // threads race on the same entry, the first one to finish is cached.
+    std::shared_ptr<const std::vector<char>> decoded = decode(entry);
+
+    std::lock_guard<std::mutex> lock(mDecodeMutex);
+    addDecoded(index, decoded);
+    return decoded;
+}
+
+void BsaArchive::prefetch(const std::vector<size_t> &indices, const ParallelFor &parallelFor) const
+{
+    std::vector<size_t> pending;
+    {
+        std::lock_guard<std::mutex> lock(mDecodeMutex);
+        for(size_t index : indices)
+        {
+            const bool isPending = std::find(pending.begin(), pending.end(), index) != pending.end();
+            if(mEntries.at(index).mCompressed && mDecoded.find(index) == mDecoded.end() && !isPending)
+                pending.push_back(index);
+        }
+    }
+
+    std::vector<std::shared_ptr<const std::vector<char>>> decoded(pending.size());
+    parallelFor(static_cast<int>(pending.size()), [this, &pending, &decoded](int i)
+    {
+        decoded[i] = decode(mEntries[pending[i]]);
+    });
+
+    std::lock_guard<std::mutex> lock(mDecodeMutex);
+    for(size_t i = 0;i < pending.size();++i)
+        addDecoded(pending[i], std::move(decoded[i]));
+}
+
+void BsaArchive::setDecodedCacheSize(size_t size)
+{
+    std::lock_guard<std::mutex> lock(mDecodeMutex);
+    mDecodedCacheSize = size;
+    trimDecoded(mDecodedCacheSize);
+}
+
+const BsaArchive::Entry *BsaArchive::find(const char *name) const
+{
+    auto iter = std::lower_bound(mLookupName.begin(), mLookupName.end(), name);
+    if(iter == mLookupName.end() || *iter != name)
+        return nullptr;
+    return &mEntries[std::distance(mLookupName.begin(), iter)];
 }
 
 IStreamPtr BsaArchive::open(const Entry &entry)
 {
+    if(entry.mCompressed)
+        return IStreamPtr(new DecodedStream(decompress(entry)));
+
+    if(mMappedFile.isOpen())
+    {
+        return IStreamPtr(new MemoryStream(mMappedFile.data() + entry.mStart,
+            static_cast<size_t>(entry.mEnd - entry.mStart)));
+    }
+
     std::unique_ptr<std::istream> stream(new std::ifstream(mFilename, std::ios::binary));
     if(!stream->seekg(entry.mStart))
         return IStreamPtr(nullptr);
     return IStreamPtr(new ConstrainedFileStream(std::move(stream), entry.mStart, entry.mEnd));
 }
 
+EntryView BsaArchive::view(const Entry &entry) const
+{
+    if(entry.mCompressed)
+    {
+        std::shared_ptr<const std::vector<char>> decoded = decompress(entry);
+        const char *data = decoded->data();
+        const size_t size = decoded->size();
+        return EntryView { data, size, std::move(decoded) };
+    }
+    if(!mMappedFile.isOpen())
+        return EntryView { nullptr, 0 };
+    return EntryView { mMappedFile.data() + entry.mStart,
+        static_cast<size_t>(entry.mEnd - entry.mStart) };
+}
+
+EntryView BsaArchive::openView(const char *name) const
+{
+    const Entry *entry = find(name);
+    if(entry == nullptr)
+        return EntryView { nullptr, 0 };
+    return view(*entry);
+}
+
+IStreamPtr BsaArchive::openEntry(size_t index)
+{
+    return open(mEntries.at(index));
+}
+
+EntryView BsaArchive::openEntryView(size_t index) const
+{
+    return view(mEntries.at(index));
+}
+
 IStreamPtr BsaArchive::open(const char *name)
 {
-    auto iter = std::lower_bound(mLookupName.begin(), mLookupName.end(), name);
-    if(iter == mLookupName.end() || *iter != name)
+    const Entry *entry = find(name);
+    if(entry == nullptr)
         return IStreamPtr(nullptr);
-    return open(mEntries[std::distance(mLookupName.begin(), iter)]);
+    return open(*entry);
 }
 
 bool BsaArchive::exists(const char *name) const
@@ -1,35 +1,111 @@
 #ifndef COMPONENTS_ARCHIVES_BSAARCHIVE_HPP
 #define COMPONENTS_ARCHIVES_BSAARCHIVE_HPP
 
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <set>
 
 #include "archive.hpp"
+#include "mappedfile.hpp"
 
 
 namespace Archives
 {
 
 class BsaArchive : public Archive {
+public:
+    // Footer flag value for entries stored as [u32 LE decoded size][LZ block] (see lzcodec.hpp).
+    // Arena's own archive never sets the flag; any other non-zero value is rejected.
+    static const uint16_t LZCompressionFlag = 0x4C5A;
+
+    // Default limit on the bytes of decoded entries kept for reuse.
+    static const size_t DefaultDecodedCacheSize = 16 * 1024 * 1024;
+
+    // Calls job(i) for every i in [0, count), possibly in parallel, and returns when all
+    // calls are done (i.e., a thread pool's run()).
+    typedef std::function<void(int, const std::function<void(int)>&)> ParallelFor;
+
+private:
     std::vector<std::string> mLookupName;
 
     struct Entry {
         std::streamsize mStart;
         std::streamsize mEnd;
+        bool mCompressed; // Decoded when opened or prefetched.
     };
     std::vector<Entry> mEntries;
 
+    // Recently decoded entries by index. Views and streams share ownership of the bytes, so
+    // an entry evicted while in use stays valid until they're gone.
+    struct DecodedEntry {
+        std::shared_ptr<const std::vector<char>> mBytes;
+        uint64_t mLastUsed;
+    };
+    mutable std::unordered_map<size_t, DecodedEntry> mDecoded;
+    mutable size_t mDecodedSize; // Bytes held by mDecoded.
+    mutable uint64_t mDecodeClock; // Advanced by each use of a decoded entry.
+    size_t mDecodedCacheSize;
+
     std::string mFilename;
 
+    // The whole archive, mapped once at load. Entries are read straight out of it; if the
+    // mapping fails, each open() falls back to its own file stream.
+    MappedFile mMappedFile;
+
+    // Guards the decoded entry cache, since entries may be opened from several threads at once.
+    mutable std::mutex mDecodeMutex;
+
     void loadNamed(size_t count, std::istream &stream);
 
+    // Decodes a compressed entry. Throws if the entry is malformed.
+    std::shared_ptr<const std::vector<char>> decode(const Entry &entry) const;
+
+    // Evicts the least recently used decoded entries until the cache holds at most the given
+    // number of bytes. Expects the decode mutex to be locked.
+    void trimDecoded(size_t size) const;
+
+    // Adds decoded bytes to the cache, evicting the least recently used entries past the
+    // cache size. Expects the decode mutex to be locked.
+    void addDecoded(size_t index, std::shared_ptr<const std::vector<char>> bytes) const;
+
+    // Gets the decoded bytes of a compressed entry from the cache, or decodes them.
+    std::shared_ptr<const std::vector<char>> decompress(const Entry &entry) const;
+
+    const Entry *find(const char *name) const;
+
     IStreamPtr open(const Entry &entry);
+    EntryView view(const Entry &entry) const;
 
 public:
+    BsaArchive();
+
     void load(const std::string &fname);
 
+    // Sets how many bytes of decoded entries are kept for reuse. Zero keeps none.
+    void setDecodedCacheSize(size_t size);
+
+    // Decodes the given entries that are compressed and not cached yet, spread across the
+    // given parallel-for, so later opens of them are lookups. Entries past the cache size are
+    // evicted as usual. Throws if any entry is malformed.
+    void prefetch(const std::vector<size_t> &indices, const ParallelFor &parallelFor) const;
+
+    bool isMapped() const { return mMappedFile.isOpen(); }
+
+    // Gets an entry's bytes without copying. Only available when the archive is mapped or the
+    // entry was compressed; returns an empty view otherwise or if the entry doesn't exist.
+    EntryView openView(const char *name) const;
+
+    // Same as the name-based methods, for an index into list(). Lets callers that keep their
+    // own index of names skip the name search.
+    IStreamPtr openEntry(size_t index);
+    EntryView openEntryView(size_t index) const;
+
     virtual IStreamPtr open(const char *name) override;
     virtual bool exists(const char *name) const override;
     virtual const std::vector<std::string> &list() const override final { return mLookupName; }
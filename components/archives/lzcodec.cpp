@@ -0,0 +1,210 @@
+
+#include "lzcodec.hpp"
+
+#include <cstring>
+#include <vector>
+
+
+namespace
+{
+    // Format limits. The last match has to start at least MFLIMIT bytes before the end of
+    // the block, and the last LASTLITERALS bytes are always literals.
+    const size_t MINMATCH = 4;
+    const size_t MFLIMIT = 12;
+    const size_t LASTLITERALS = 5;
+    const size_t MAX_OFFSET = 65535;
+
+    const int HASH_BITS = 14;
+
+    uint32_t read32(const uint8_t *ptr)
+    {
+        uint32_t value;
+        std::memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    uint32_t hash(uint32_t sequence)
+    {
+        return (sequence * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    // Writes a length in the token's "15 means more bytes follow" continuation form.
+    uint8_t *writeLength(uint8_t *op, size_t length)
+    {
+        while(length >= 255)
+        {
+            *op++ = 255;
+            length -= 255;
+        }
+        *op++ = static_cast<uint8_t>(length);
+        return op;
+    }
+
+    uint8_t *writeSequence(uint8_t *op, const uint8_t *literals, size_t literalCount,
+        size_t offset, size_t matchLength)
+    {
+        uint8_t *token = op++;
+        const size_t matchCode = matchLength - MINMATCH;
+        *token = static_cast<uint8_t>(((literalCount < 15) ? literalCount : 15) << 4);
+        if(literalCount >= 15)
+            op = writeLength(op, literalCount - 15);
+
+        std::memcpy(op, literals, literalCount);
+        op += literalCount;
+
+        *op++ = static_cast<uint8_t>(offset & 0xFF);
+        *op++ = static_cast<uint8_t>(offset >> 8);
+
+        *token |= static_cast<uint8_t>((matchCode < 15) ? matchCode : 15);
+        if(matchCode >= 15)
+            op = writeLength(op, matchCode - 15);
+
+        return op;
+    }
+
+    uint8_t *writeLastLiterals(uint8_t *op, const uint8_t *literals, size_t literalCount)
+    {
+        *op++ = static_cast<uint8_t>(((literalCount < 15) ? literalCount : 15) << 4);
+        if(literalCount >= 15)
+            op = writeLength(op, literalCount - 15);
+
+        if(literalCount > 0)
+            std::memcpy(op, literals, literalCount);
+        return op + literalCount;
+    }
+
+    // Reads a continued length. Returns false if the input runs out.
+    bool readLength(const uint8_t *&ip, const uint8_t *end, size_t &length)
+    {
+        uint8_t value;
+        do
+        {
+            if(ip == end)
+                return false;
+            value = *ip++;
+            length += value;
+        } while(value == 255);
+        return true;
+    }
+}
+
+namespace Archives
+{
+
+namespace LZ
+{
+
+size_t compressBound(size_t srcSize)
+{
+    return srcSize + (srcSize / 255) + 16;
+}
+
+size_t compress(const uint8_t *src, size_t srcSize, uint8_t *dst)
+{
+    uint8_t *op = dst;
+    size_t anchor = 0;
+
+    if(srcSize > MFLIMIT)
+    {
+        // Most recent position (plus one, so zero is empty) of each hashed 4-byte sequence.
+        std::vector<uint32_t> table(size_t(1) << HASH_BITS, 0);
+
+        const size_t matchStartLimit = srcSize - MFLIMIT;
+        const size_t matchEndLimit = srcSize - LASTLITERALS;
+
+        size_t ip = 0;
+        while(ip < matchStartLimit)
+        {
+            const uint32_t sequence = read32(src + ip);
+            uint32_t &slot = table[hash(sequence)];
+            const size_t candidate = slot;
+            slot = static_cast<uint32_t>(ip + 1);
+
+            if(candidate == 0 || (ip - (candidate - 1)) > MAX_OFFSET ||
+               read32(src + candidate - 1) != sequence)
+            {
+                ip++;
+                continue;
+            }
+
+            const size_t ref = candidate - 1;
+            size_t matchLength = MINMATCH;
+            while((ip + matchLength) < matchEndLimit && src[ref + matchLength] == src[ip + matchLength])
+                matchLength++;
+
+            op = writeSequence(op, src + anchor, ip - anchor, ip - ref, matchLength);
+            ip += matchLength;
+            anchor = ip;
+        }
+    }
+
+    op = writeLastLiterals(op, src + anchor, srcSize - anchor);
+    return static_cast<size_t>(op - dst);
+}
+
+bool decompress(const uint8_t *src, size_t srcSize, uint8_t *dst, size_t dstSize)
+{
+    const uint8_t *ip = src;
+    const uint8_t *const ipEnd = src + srcSize;
+    uint8_t *op = dst;
+    uint8_t *const opEnd = dst + dstSize;
+
+    while(true)
+    {
+        if(ip == ipEnd)
+            return false;
+
+        const uint8_t token = *ip++;
+
+        size_t literalCount = token >> 4;
+        if(literalCount == 15 && !readLength(ip, ipEnd, literalCount))
+            return false;
+
+        if(literalCount > size_t(ipEnd - ip) || literalCount > size_t(opEnd - op))
+            return false;
+
+        if(literalCount > 0)
+            std::memcpy(op, ip, literalCount);
+        ip += literalCount;
+        op += literalCount;
+
+        // The last sequence has no match.
+        if(ip == ipEnd)
+            break;
+
+        if(ipEnd - ip < 2)
+            return false;
+
+        const size_t offset = size_t(ip[0]) | (size_t(ip[1]) << 8);
+        ip += 2;
+        if(offset == 0 || offset > size_t(op - dst))
+            return false;
+
+        size_t matchLength = token & 0x0F;
+        if(matchLength == 15 && !readLength(ip, ipEnd, matchLength))
+            return false;
+        matchLength += MINMATCH;
+
+        if(matchLength > size_t(opEnd - op))
+            return false;
+
+        const uint8_t *match = op - offset;
+        if(offset >= matchLength)
+        {
+            std::memcpy(op, match, matchLength);
+            op += matchLength;
+        }
+        else
+        {
+            // Overlapping copy repeats the last 'offset' bytes.
+            for(size_t i = 0;i < matchLength;++i)
+                *op++ = *match++;
+        }
+    }
+
+    return op == opEnd;
+}
+
+} // namespace LZ
+
+} // namespace Archives
@@ -0,0 +1,30 @@
+#ifndef COMPONENTS_ARCHIVES_LZCODEC_HPP
+#define COMPONENTS_ARCHIVES_LZCODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace Archives
+{
+
+// Small LZ77 codec using the LZ4 block format (token byte, literals, 16-bit offset, match
+// length). It favors decode speed over ratio, which suits archives that are read far more
+// often than they're written.
+namespace LZ
+{
+    // Gets the largest size compress() can produce for the given input size.
+    size_t compressBound(size_t srcSize);
+
+    // Compresses a block into dst, which must hold at least compressBound(srcSize) bytes.
+    // Returns the compressed size.
+    size_t compress(const uint8_t *src, size_t srcSize, uint8_t *dst);
+
+    // Decompresses a block. Returns false if the data is malformed or doesn't decode to
+    // exactly dstSize bytes. Never reads or writes out of bounds, even for bad input.
+    bool decompress(const uint8_t *src, size_t srcSize, uint8_t *dst, size_t dstSize);
+}
+
+} // namespace Archives
+
+#endif /* COMPONENTS_ARCHIVES_LZCODEC_HPP */
@@ -0,0 +1,133 @@
+
+#include "mappedfile.hpp"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace Archives
+{
+
+MappedFile::MappedFile()
+  : mData(nullptr), mSize(0)
+#ifdef _WIN32
+  , mFileHandle(nullptr), mMappingHandle(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string &fname)
+{
+    close();
+
+    HANDLE file = CreateFileA(fname.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if(file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(mapping == nullptr)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(view == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    mData = static_cast<const char*>(view);
+    mSize = static_cast<size_t>(fileSize.QuadPart);
+    mFileHandle = file;
+    mMappingHandle = mapping;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if(mData != nullptr)
+        UnmapViewOfFile(mData);
+    if(mMappingHandle != nullptr)
+        CloseHandle(static_cast<HANDLE>(mMappingHandle));
+    if(mFileHandle != nullptr)
+        CloseHandle(static_cast<HANDLE>(mFileHandle));
+
+    mData = nullptr;
+    mSize = 0;
+    mFileHandle = nullptr;
+    mMappingHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string &fname)
+{
+    close();
+
+    const int fd = ::open(fname.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    const size_t size = static_cast<size_t>(fileStat.st_size);
+    void *view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+
+    if(view == MAP_FAILED)
+        return false;
+
+    mData = static_cast<const char*>(view);
+    mSize = size;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if(mData != nullptr)
+        munmap(const_cast<char*>(mData), mSize);
+
+    mData = nullptr;
+    mSize = 0;
+}
+
+#endif
+
+} // namespace Archives
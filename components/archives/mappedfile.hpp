@@ -0,0 +1,40 @@
+#ifndef COMPONENTS_ARCHIVES_MAPPEDFILE_HPP
+#define COMPONENTS_ARCHIVES_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+
+
+namespace Archives
+{
+
+// Read-only memory mapping of a whole file. The mapping stays valid until close() or
+// destruction, so views into it can be handed out without copying.
+class MappedFile {
+    const char *mData;
+    size_t mSize;
+
+#ifdef _WIN32
+    void *mFileHandle;
+    void *mMappingHandle;
+#endif
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    // Returns false if the file couldn't be opened or mapped. Empty files can't be mapped.
+    bool open(const std::string &fname);
+    void close();
+
+    bool isOpen() const { return mData != nullptr; }
+    const char *data() const { return mData; }
+    size_t size() const { return mSize; }
+};
+
+} // namespace Archives
+
+#endif /* COMPONENTS_ARCHIVES_MAPPEDFILE_HPP */
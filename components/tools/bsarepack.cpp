@@ -0,0 +1,207 @@
+// Repacks an Arena install's GLOBAL.BSA with LZ-compressed entries, then reopens the result
+// and checks that every entry decodes byte-identically to the original.
+//
+// Usage: bsarepack <Arena directory> <output archive>
+//
+// Only entries that shrink are compressed. The output is a drop-in GLOBAL.BSA replacement;
+// loose files next to it are left alone since the engine treats them differently (i.e., INF
+// decryption depends on whether the file came from the archive).
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../archives/bsaarchive.hpp"
+#include "../archives/lzcodec.hpp"
+
+
+namespace
+{
+    const size_t NAME_SIZE = 12;
+
+    std::vector<char> readEntry(Archives::BsaArchive &archive, size_t index)
+    {
+        const Archives::EntryView view = archive.openEntryView(index);
+        if(view.mData != nullptr)
+            return std::vector<char>(view.mData, view.mData + view.mSize);
+
+        Archives::IStreamPtr stream = archive.openEntry(index);
+        if(stream == nullptr)
+            throw std::runtime_error("Failed to open entry "+archive.list()[index]);
+        return std::vector<char>((std::istreambuf_iterator<char>(*stream)),
+            std::istreambuf_iterator<char>());
+    }
+
+    void writeLE16(std::ostream &stream, uint16_t value)
+    {
+        const char buf[2] = { char(value & 0xFF), char(value >> 8) };
+        stream.write(buf, sizeof(buf));
+    }
+
+    void writeLE32(std::ostream &stream, uint32_t value)
+    {
+        const char buf[4] = { char(value & 0xFF), char((value >> 8) & 0xFF),
+            char((value >> 16) & 0xFF), char(value >> 24) };
+        stream.write(buf, sizeof(buf));
+    }
+
+    struct FooterEntry {
+        std::string mName;
+        uint16_t mCompression;
+        uint32_t mSize;
+    };
+
+    // Writes every entry of 'source' to 'outPath'. Returns the total uncompressed entry size.
+    size_t repack(Archives::BsaArchive &source, const std::string &outPath, size_t &compressedCount)
+    {
+        const std::vector<std::string> &names = source.list();
+        if(names.size() > 0xFFFF)
+            throw std::runtime_error("Too many entries for a BSA ("+std::to_string(names.size())+")");
+
+        std::ofstream out(outPath, std::ios::binary);
+        if(!out.is_open())
+            throw std::runtime_error("Failed to create "+outPath);
+
+        writeLE16(out, static_cast<uint16_t>(names.size()));
+
+        std::vector<FooterEntry> footer;
+        footer.reserve(names.size());
+
+        size_t rawTotal = 0;
+        std::vector<uint8_t> packed;
+        for(size_t i = 0;i < names.size();++i)
+        {
+            if(names[i].size() > NAME_SIZE)
+                throw std::runtime_error("Entry name too long: "+names[i]);
+
+            const std::vector<char> data = readEntry(source, i);
+            rawTotal += data.size();
+
+            // Compressed layout: [u32 LE decoded size][LZ block].
+            packed.resize(4 + Archives::LZ::compressBound(data.size()));
+            const uint32_t decodedSize = static_cast<uint32_t>(data.size());
+            packed[0] = decodedSize & 0xFF;
+            packed[1] = (decodedSize >> 8) & 0xFF;
+            packed[2] = (decodedSize >> 16) & 0xFF;
+            packed[3] = decodedSize >> 24;
+            const size_t packedSize = 4 + Archives::LZ::compress(
+                reinterpret_cast<const uint8_t*>(data.data()), data.size(), packed.data() + 4);
+
+            FooterEntry entry;
+            entry.mName = names[i];
+            std::replace(entry.mName.begin(), entry.mName.end(), '/', '\\');
+            if(packedSize < data.size())
+            {
+                out.write(reinterpret_cast<const char*>(packed.data()), packedSize);
+                entry.mCompression = Archives::BsaArchive::LZCompressionFlag;
+                entry.mSize = static_cast<uint32_t>(packedSize);
+                compressedCount++;
+            }
+            else
+            {
+                out.write(data.data(), data.size());
+                entry.mCompression = 0;
+                entry.mSize = static_cast<uint32_t>(data.size());
+            }
+            footer.push_back(std::move(entry));
+        }
+
+        for(const FooterEntry &entry : footer)
+        {
+            std::string name = entry.mName;
+            name.resize(NAME_SIZE, '\0');
+            out.write(name.data(), NAME_SIZE);
+            writeLE16(out, entry.mCompression);
+            writeLE32(out, entry.mSize);
+        }
+
+        if(!out.good())
+            throw std::runtime_error("Failed writing "+outPath);
+
+        return rawTotal;
+    }
+
+    // Reopens the written archive through the normal reader and compares every entry with the
+    // source. Returns the number of mismatches.
+    size_t verify(Archives::BsaArchive &source, const std::string &outPath)
+    {
+        Archives::BsaArchive repacked;
+        repacked.load(outPath);
+
+        const std::vector<std::string> &names = source.list();
+        if(repacked.list() != names)
+        {
+            std::fprintf(stderr, "Entry names differ after repacking.\n");
+            return names.size();
+        }
+
+        size_t mismatches = 0;
+        for(size_t i = 0;i < names.size();++i)
+        {
+            if(readEntry(source, i) != readEntry(repacked, i))
+            {
+                std::fprintf(stderr, "Mismatch: %s\n", names[i].c_str());
+                mismatches++;
+            }
+        }
+
+        return mismatches;
+    }
+
+    size_t fileSize(const std::string &path)
+    {
+        std::ifstream stream(path, std::ios::binary | std::ios::ate);
+        return stream.is_open() ? static_cast<size_t>(stream.tellg()) : 0;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc != 3)
+    {
+        std::fprintf(stderr, "Usage: %s <Arena directory> <output archive>\n", argv[0]);
+        return 1;
+    }
+
+    std::string inPath = argv[1];
+    if(!inPath.empty() && inPath.back() != '/' && inPath.back() != '\\')
+        inPath.push_back('/');
+    inPath += "GLOBAL.BSA";
+    const std::string outPath = argv[2];
+
+    try
+    {
+        Archives::BsaArchive source;
+        source.load(inPath);
+
+        size_t compressedCount = 0;
+        const size_t rawTotal = repack(source, outPath, compressedCount);
+        const size_t mismatches = verify(source, outPath);
+
+        std::printf("%zu entries (%zu compressed), %zu bytes of entry data\n",
+            source.list().size(), compressedCount, rawTotal);
+        std::printf("%s: %zu bytes -> %s: %zu bytes\n", inPath.c_str(), fileSize(inPath),
+            outPath.c_str(), fileSize(outPath));
+
+        if(mismatches > 0)
+        {
+            std::fprintf(stderr, "Verification failed: %zu entries differ.\n", mismatches);
+            return 1;
+        }
+
+        std::printf("Verified: all entries decode byte-identically.\n");
+    }
+    catch(const std::exception &e)
+    {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
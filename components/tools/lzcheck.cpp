@@ -0,0 +1,413 @@
+// Round-trip and robustness checks for the LZ codec and compressed BSA entries, on synthetic
+// data only (no game files needed). Exits non-zero if any check fails.
+//
+// Usage: lzcheck [scratch directory]
+//
+// The scratch directory (default: the current one) gets a temporary archive for the
+// BsaArchive checks (decoding, the decoded entry cache and prefetching), which is removed
+// afterwards.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../archives/bsaarchive.hpp"
+#include "../archives/lzcodec.hpp"
+
+
+namespace
+{
+    // Bytes after the end of each decode buffer that must be left untouched.
+    const size_t GUARD_SIZE = 64;
+    const uint8_t GUARD_VALUE = 0xA5;
+
+    size_t gFailures = 0;
+
+    void check(bool condition, const std::string &what)
+    {
+        if(!condition)
+        {
+            std::fprintf(stderr, "FAILED: %s\n", what.c_str());
+            gFailures++;
+        }
+    }
+
+    // Small deterministic generator so failures are reproducible.
+    struct XorShift {
+        uint32_t mState;
+
+        explicit XorShift(uint32_t seed) : mState(seed) { }
+
+        uint32_t next()
+        {
+            mState ^= mState << 13;
+            mState ^= mState >> 17;
+            mState ^= mState << 5;
+            return mState;
+        }
+    };
+
+    std::vector<uint8_t> compress(const std::vector<uint8_t> &src)
+    {
+        std::vector<uint8_t> dst(Archives::LZ::compressBound(src.size()));
+        const size_t size = Archives::LZ::compress(src.data(), src.size(), dst.data());
+        check(size <= dst.size(), "compressed size within compressBound()");
+        dst.resize(size);
+        return dst;
+    }
+
+    // Decodes into a buffer of exactly dstSize bytes followed by a guard region, and checks
+    // that the decoder never wrote past the end. Returns whether the decode succeeded.
+    bool decompress(const std::vector<uint8_t> &src, size_t dstSize, std::vector<uint8_t> &dst,
+        const std::string &what)
+    {
+        // Copy the input so reads past its end land outside the allocation under a sanitizer.
+        const std::vector<uint8_t> input(src);
+        std::vector<uint8_t> buffer(dstSize + GUARD_SIZE, GUARD_VALUE);
+        const bool success = Archives::LZ::decompress(input.data(), input.size(),
+            buffer.data(), dstSize);
+
+        const bool guardIntact = std::all_of(buffer.begin() + dstSize, buffer.end(),
+            [](uint8_t value) { return value == GUARD_VALUE; });
+        check(guardIntact, what+": decoder wrote past the end of the output");
+
+        buffer.resize(dstSize);
+        dst = std::move(buffer);
+        return success;
+    }
+
+    void checkRoundTrip(const std::vector<uint8_t> &src, const std::string &what)
+    {
+        const std::vector<uint8_t> packed = compress(src);
+
+        std::vector<uint8_t> decoded;
+        const bool success = decompress(packed, src.size(), decoded, what);
+        check(success && decoded == src, what+": round trip");
+
+        // The decoded size is part of the contract; one byte off either way must fail.
+        if(src.size() > 0)
+            check(!decompress(packed, src.size() - 1, decoded, what), what+": short output accepted");
+        check(!decompress(packed, src.size() + 1, decoded, what), what+": long output accepted");
+    }
+
+    std::vector<uint8_t> makeRandom(size_t size, uint32_t seed)
+    {
+        XorShift rng(seed);
+        std::vector<uint8_t> data(size);
+        for(uint8_t &value : data)
+            value = static_cast<uint8_t>(rng.next());
+        return data;
+    }
+
+    // Text-like data: short words from a small vocabulary, so there are many short matches at
+    // varying offsets.
+    std::vector<uint8_t> makeText(size_t size, uint32_t seed)
+    {
+        static const char *words[] = { "the ", "imperial ", "city ", "of ", "tamriel ",
+            "dungeon ", "arena ", "staff ", "chaos ", "\n" };
+        XorShift rng(seed);
+        std::vector<uint8_t> data;
+        while(data.size() < size)
+        {
+            const char *word = words[rng.next() % (sizeof(words) / sizeof(words[0]))];
+            data.insert(data.end(), word, word + std::strlen(word));
+        }
+        data.resize(size);
+        return data;
+    }
+
+    void checkRoundTrips()
+    {
+        checkRoundTrip(std::vector<uint8_t>(), "empty input");
+
+        // Every size around the format's end-of-block limits, in each flavor.
+        for(size_t size = 1;size <= 40;++size)
+        {
+            const std::string suffix = " ("+std::to_string(size)+" bytes)";
+            checkRoundTrip(makeRandom(size, 1 + static_cast<uint32_t>(size)), "random"+suffix);
+            checkRoundTrip(std::vector<uint8_t>(size, 0x41), "single byte run"+suffix);
+            checkRoundTrip(makeText(size, static_cast<uint32_t>(size)), "text"+suffix);
+        }
+
+        // Incompressible input only grows by the literal length bytes.
+        const std::vector<uint8_t> random = makeRandom(256 * 1024, 7);
+        checkRoundTrip(random, "incompressible 256 KiB");
+        check(compress(random).size() <= Archives::LZ::compressBound(random.size()),
+            "incompressible input within compressBound()");
+
+        // Long matches: a single run (overlapping offset 1 copies), a repeated short pattern
+        // (overlapping copies with offsets 2-7), and a block repeated past the longest offset.
+        const std::vector<uint8_t> zeros(1024 * 1024, 0);
+        checkRoundTrip(zeros, "1 MiB of zeros");
+        check(compress(zeros).size() < (zeros.size() / 200), "1 MiB of zeros compresses");
+
+        for(size_t period = 2;period <= 7;++period)
+        {
+            std::vector<uint8_t> pattern(100000);
+            for(size_t i = 0;i < pattern.size();++i)
+                pattern[i] = static_cast<uint8_t>(i % period);
+            checkRoundTrip(pattern, "period "+std::to_string(period)+" pattern");
+        }
+
+        std::vector<uint8_t> farRepeat = makeRandom(70000, 11);
+        farRepeat.insert(farRepeat.end(), farRepeat.begin(), farRepeat.end());
+        checkRoundTrip(farRepeat, "block repeated beyond the max offset");
+
+        std::vector<uint8_t> nearRepeat = makeRandom(60000, 13);
+        nearRepeat.insert(nearRepeat.end(), nearRepeat.begin(), nearRepeat.end());
+        checkRoundTrip(nearRepeat, "block repeated within the max offset");
+        check(compress(nearRepeat).size() < (nearRepeat.size() * 3 / 4),
+            "block repeated within the max offset compresses");
+
+        checkRoundTrip(makeText(512 * 1024, 17), "text 512 KiB");
+    }
+
+    void checkTruncatedStreams()
+    {
+        const std::vector<std::vector<uint8_t>> sources =
+        {
+            makeText(4096, 3),
+            makeRandom(4096, 5),
+            std::vector<uint8_t>(4096, 0x7F)
+        };
+
+        for(const std::vector<uint8_t> &src : sources)
+        {
+            const std::vector<uint8_t> packed = compress(src);
+            for(size_t size = 0;size < packed.size();++size)
+            {
+                const std::vector<uint8_t> truncated(packed.begin(), packed.begin() + size);
+                std::vector<uint8_t> decoded;
+                check(!decompress(truncated, src.size(), decoded, "truncated stream"),
+                    "stream truncated to "+std::to_string(size)+" of "+
+                    std::to_string(packed.size())+" bytes accepted");
+            }
+        }
+    }
+
+    void checkCorruptStreams()
+    {
+        std::vector<uint8_t> decoded;
+
+        // Hand-made bad sequences. Each token is followed by what it needs, except for the
+        // field that is wrong.
+        const std::vector<std::pair<std::vector<uint8_t>, std::string>> badStreams =
+        {
+            { { }, "no token" },
+            { { 0x40, 'a', 'b' }, "literals run past the input" },
+            { { 0xF0 }, "missing literal length byte" },
+            { { 0xF0, 255, 255 }, "unterminated literal length" },
+            { { 0x10, 'a', 0x00 }, "missing offset byte" },
+            { { 0x10, 'a', 0x00, 0x00, 0x00 }, "zero offset" },
+            { { 0x10, 'a', 0x02, 0x00, 0x00 }, "offset before the start of the output" },
+            { { 0x1F, 'a', 0x01, 0x00 }, "missing match length byte" },
+            { { 0x1F, 'a', 0x01, 0x00, 255, 255, 255, 0x00 }, "match runs past the output" },
+            { { 0x10, 'a', 0x01, 0x00, 0x10, 'b' }, "output shorter than the decoded size" }
+        };
+
+        for(const auto &badStream : badStreams)
+        {
+            check(!decompress(badStream.first, 64, decoded, badStream.second),
+                "corrupt stream accepted: "+badStream.second);
+        }
+
+        // Random bit flips in valid streams. They may still decode, but must never write out
+        // of bounds (checked by the guard region) or crash.
+        XorShift rng(19);
+        const std::vector<uint8_t> src = makeText(8192, 23);
+        const std::vector<uint8_t> packed = compress(src);
+        for(int i = 0;i < 20000;++i)
+        {
+            std::vector<uint8_t> corrupt = packed;
+            const int flips = 1 + static_cast<int>(rng.next() % 4);
+            for(int j = 0;j < flips;++j)
+                corrupt[rng.next() % corrupt.size()] ^= static_cast<uint8_t>(1 << (rng.next() % 8));
+            decompress(corrupt, src.size(), decoded, "bit-flipped stream");
+        }
+
+        // Pure garbage.
+        for(uint32_t seed = 1;seed <= 2000;++seed)
+            decompress(makeRandom(1 + (seed % 300), seed), 1024, decoded, "random stream");
+    }
+
+    void writeLE16(std::ostream &stream, uint16_t value)
+    {
+        const char buf[2] = { char(value & 0xFF), char(value >> 8) };
+        stream.write(buf, sizeof(buf));
+    }
+
+    void writeLE32(std::ostream &stream, uint32_t value)
+    {
+        const char buf[4] = { char(value & 0xFF), char((value >> 8) & 0xFF),
+            char((value >> 16) & 0xFF), char(value >> 24) };
+        stream.write(buf, sizeof(buf));
+    }
+
+    std::vector<uint8_t> makePackedEntry(const std::vector<uint8_t> &src)
+    {
+        std::vector<uint8_t> packed = compress(src);
+        const uint32_t size = static_cast<uint32_t>(src.size());
+        const uint8_t header[4] = { uint8_t(size & 0xFF), uint8_t((size >> 8) & 0xFF),
+            uint8_t((size >> 16) & 0xFF), uint8_t(size >> 24) };
+        packed.insert(packed.begin(), header, header + 4);
+        return packed;
+    }
+
+    // Writes a small archive with a raw entry, a compressed entry, and a compressed entry with
+    // a corrupt block, then checks that loading doesn't decode anything and that each entry
+    // behaves when it's opened.
+    void checkArchive(const std::string &scratchDir)
+    {
+        const std::string path = scratchDir+"lzcheck.tmp.bsa";
+
+        const std::vector<uint8_t> raw = makeRandom(3000, 29);
+        const std::vector<uint8_t> text = makeText(20000, 31);
+        const std::vector<uint8_t> packed = makePackedEntry(text);
+        std::vector<uint8_t> corrupt = makePackedEntry(text);
+        corrupt.resize(corrupt.size() / 2);
+
+        struct FooterEntry {
+            const char *mName;
+            const std::vector<uint8_t> *mData;
+            uint16_t mCompression;
+        };
+
+        const FooterEntry footer[] =
+        {
+            { "RAW.DAT", &raw, 0 },
+            { "PACKED.DAT", &packed, Archives::BsaArchive::LZCompressionFlag },
+            { "CORRUPT.DAT", &corrupt, Archives::BsaArchive::LZCompressionFlag }
+        };
+
+        {
+            std::ofstream out(path, std::ios::binary);
+            if(!out.is_open())
+            {
+                check(false, "couldn't create "+path);
+                return;
+            }
+
+            writeLE16(out, static_cast<uint16_t>(sizeof(footer) / sizeof(footer[0])));
+            for(const FooterEntry &entry : footer)
+                out.write(reinterpret_cast<const char*>(entry.mData->data()), entry.mData->size());
+
+            for(const FooterEntry &entry : footer)
+            {
+                std::string name = entry.mName;
+                name.resize(12, '\0');
+                out.write(name.data(), name.size());
+                writeLE16(out, entry.mCompression);
+                writeLE32(out, static_cast<uint32_t>(entry.mData->size()));
+            }
+        }
+
+        try
+        {
+            Archives::BsaArchive archive;
+            archive.load(path);
+
+            auto viewBytes = [](const Archives::EntryView &view)
+            {
+                const uint8_t *data = reinterpret_cast<const uint8_t*>(view.mData);
+                return std::vector<uint8_t>(data, data + view.mSize);
+            };
+
+            if(archive.isMapped())
+                check(viewBytes(archive.openView("RAW.DAT")) == raw, "raw entry view");
+
+            check(viewBytes(archive.openView("PACKED.DAT")) == text, "compressed entry view");
+
+            // A second view is served from the same decoded bytes.
+            const Archives::EntryView first = archive.openView("PACKED.DAT");
+            const Archives::EntryView second = archive.openView("PACKED.DAT");
+            check(first.mData == second.mData, "compressed entry decoded once");
+
+            Archives::IStreamPtr stream = archive.open("PACKED.DAT");
+            const std::vector<uint8_t> streamed = (stream != nullptr) ?
+                std::vector<uint8_t>((std::istreambuf_iterator<char>(*stream)),
+                    std::istreambuf_iterator<char>()) : std::vector<uint8_t>();
+            check(streamed == text, "compressed entry stream");
+
+            bool threw = false;
+            try
+            {
+                archive.openView("CORRUPT.DAT");
+            }
+            catch(const std::runtime_error&)
+            {
+                threw = true;
+            }
+
+            check(threw, "corrupt compressed entry opened without an error");
+
+            // A view keeps its bytes after the cache evicts them, and a later view decodes
+            // the entry again.
+            archive.setDecodedCacheSize(0);
+            check(viewBytes(first) == text, "compressed entry view after eviction");
+            check(viewBytes(archive.openView("PACKED.DAT")) == text,
+                "compressed entry view with no cache");
+
+            // Prefetching decodes compressed entries up front (raw ones are skipped), and
+            // opens are then served from the cache.
+            archive.setDecodedCacheSize(Archives::BsaArchive::DefaultDecodedCacheSize);
+            const std::vector<std::string> &names = archive.list();
+            const size_t rawIndex = std::find(names.begin(), names.end(), "RAW.DAT") - names.begin();
+            const size_t packedIndex = std::find(names.begin(), names.end(), "PACKED.DAT") - names.begin();
+            int jobCount = -1;
+            archive.prefetch({ rawIndex, packedIndex, packedIndex },
+                [&jobCount](int count, const std::function<void(int)> &job)
+            {
+                jobCount = count;
+                for(int i = 0;i < count;++i)
+                    job(i);
+            });
+
+            check(jobCount == 1, "prefetch decodes each compressed entry once");
+            const Archives::EntryView prefetched = archive.openView("PACKED.DAT");
+            check(viewBytes(prefetched) == text, "prefetched entry view");
+            check(prefetched.mData == archive.openView("PACKED.DAT").mData,
+                "prefetched entry served from the cache");
+        }
+        catch(const std::exception &e)
+        {
+            check(false, std::string("archive with a corrupt entry failed to load: ")+e.what());
+        }
+
+        std::remove(path.c_str());
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc > 2)
+    {
+        std::fprintf(stderr, "Usage: %s [scratch directory]\n", argv[0]);
+        return 1;
+    }
+
+    std::string scratchDir = (argc == 2) ? argv[1] : "";
+    if(!scratchDir.empty() && scratchDir.back() != '/' && scratchDir.back() != '\\')
+        scratchDir.push_back('/');
+
+    checkRoundTrips();
+    checkTruncatedStreams();
+    checkCorruptStreams();
+    checkArchive(scratchDir);
+
+    if(gFailures > 0)
+    {
+        std::fprintf(stderr, "%zu checks failed.\n", gFailures);
+        return 1;
+    }
+
+    std::printf("All LZ codec checks passed.\n");
+    return 0;
+}
@@ -14,19 +14,75 @@
 #include <cstring>
 #include <fstream>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 #include "../archives/bsaarchive.hpp"
 
 namespace
 {
+	// Where an indexed file lives.
+	struct IndexEntry
+	{
+		std::string loosePath; // Full path of a loose file. Empty if in GLOBAL.BSA.
+		size_t bsaIndex; // Index into GLOBAL.BSA's entries if not a loose file.
+	};
+
 	std::vector<std::string> gRootPaths;
 	Archives::BsaArchive gGlobalBsa;
+
+	// Every file that can be opened, keyed by normalized name. Loose files replace archive
+	// entries and newer root paths replace older ones, like the old search order.
+	std::unordered_map<std::string, IndexEntry> gIndex;
+
+	// Index keys are uppercase with forward slashes, since Arena's files don't have
+	// consistent casing between versions.
+	std::string normalizeName(const char *name)
+	{
+		std::string normalized(name);
+		for (char &c : normalized)
+		{
+			c = (c == '\\') ? '/' : static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+		}
+
+		return normalized;
+	}
+
+	const IndexEntry *findEntry(const char *name)
+	{
+		const auto iter = gIndex.find(normalizeName(name));
+		return (iter != gIndex.end()) ? &iter->second : nullptr;
+	}
+
+	// Reads the rest of a stream into a view-owned buffer.
+	VFS::DataView readStream(std::istream &stream)
+	{
+		const std::streampos start = stream.tellg();
+		stream.seekg(0, std::ios::end);
+		const size_t size = static_cast<size_t>(stream.tellg() - start);
+		stream.seekg(start);
+
+		std::unique_ptr<uint8_t[]> buffer(new uint8_t[size]);
+		stream.read(reinterpret_cast<char*>(buffer.get()), size);
+		return VFS::DataView(std::move(buffer), size);
+	}
 }
 
 namespace VFS
 {
 
+DataView::DataView()
+	: mData(nullptr), mSize(0) { }
+
+DataView::DataView(const uint8_t *data, size_t size)
+	: mData(data), mSize(size) { }
+
+DataView::DataView(std::unique_ptr<uint8_t[]> buffer, size_t size)
+	: mData(buffer.get()), mSize(size), mBuffer(std::move(buffer)) { }
+
+DataView::DataView(const uint8_t *data, size_t size, std::shared_ptr<const void> owner)
+	: mData(data), mSize(size), mOwner(std::move(owner)) { }
+
 Manager::Manager()
 {
 }
@@ -39,6 +95,16 @@ void Manager::initialize(std::string&& rootPath)
 		rootPath += '/';
 
 	gGlobalBsa.load(rootPath + "GLOBAL.BSA");
+
+	gIndex.clear();
+	const std::vector<std::string> &bsaNames = gGlobalBsa.list();
+	gIndex.reserve(bsaNames.size());
+	for (size_t i = 0; i < bsaNames.size(); i++)
+	{
+		gIndex[normalizeName(bsaNames[i].c_str())] = IndexEntry { std::string(), i };
+	}
+
+	Manager::indexRootPath(rootPath);
 	gRootPaths.push_back(std::move(rootPath));
 }
 
@@ -49,30 +115,40 @@ void Manager::addDataPath(std::string&& path)
 	else if ((path.back() != '/') && (path.back() != '\\'))
 		path += '/';
 
+	Manager::indexRootPath(path);
 	gRootPaths.push_back(std::move(path));
 }
 
-IStreamPtr Manager::open(const char *name, bool &inGlobalBSA)
+void Manager::indexRootPath(const std::string &rootPath)
 {
-	std::unique_ptr<std::ifstream> stream(new std::ifstream());
+	std::vector<std::string> names;
+	Manager::addDir(rootPath + '.', std::string(), nullptr, names);
 
-	// Search in reverse, so newer paths take precedence.
-	const auto iter = std::find_if(gRootPaths.rbegin(), gRootPaths.rend(),
-		[name, &stream](const std::string &rootPath)
+	for (const std::string &name : names)
 	{
-		stream->open(rootPath + name, std::ios::binary);
-		return stream->good();
-	});
+		gIndex[normalizeName(name.c_str())] = IndexEntry { rootPath + name, 0 };
+	}
+}
 
-	if (iter != gRootPaths.rend())
+IStreamPtr Manager::open(const char *name, bool &inGlobalBSA)
+{
+	const IndexEntry *entry = findEntry(name);
+	if (entry == nullptr)
 	{
 		inGlobalBSA = false;
-		return IStreamPtr(std::move(stream));
+		return IStreamPtr(nullptr);
+	}
+
+	inGlobalBSA = entry->loosePath.empty();
+	if (inGlobalBSA)
+	{
+		return gGlobalBsa.openEntry(entry->bsaIndex);
 	}
 	else
 	{
-		inGlobalBSA = true;
-		return gGlobalBsa.open(name);
+		std::unique_ptr<std::ifstream> stream(
+			new std::ifstream(entry->loosePath, std::ios::binary));
+		return stream->good() ? IStreamPtr(std::move(stream)) : IStreamPtr(nullptr);
 	}
 }
 
@@ -95,54 +171,93 @@ IStreamPtr Manager::open(const std::string &name)
 
 IStreamPtr Manager::openCaseInsensitive(const std::string &name, bool &inGlobalBSA)
 {
-	// Since the given filename is assumed to be unique in its directory, we only need to
-	// worry about filenames just like it but with different casing.
-	std::string newName = name;
+	// The index is case-insensitive, so this is the same as open().
+	return this->open(name, inGlobalBSA);
+}
 
-	// Case 1: upper first character, lower rest.
-	newName.front() = std::toupper(newName.front());
-	std::for_each(newName.begin() + 1, newName.end(),
-		[](char &c) { c = std::tolower(c); });
+IStreamPtr Manager::openCaseInsensitive(const std::string &name)
+{
+	bool dummy;
+	return this->openCaseInsensitive(name, dummy);
+}
 
-	IStreamPtr stream = this->open(newName, inGlobalBSA);
+DataView Manager::openView(const char *name, bool &inGlobalBSA)
+{
+	const IndexEntry *entry = findEntry(name);
+	if (entry == nullptr)
+	{
+		inGlobalBSA = false;
+		return DataView();
+	}
 
-	if (stream != nullptr)
+	inGlobalBSA = entry->loosePath.empty();
+	if (!inGlobalBSA)
 	{
-		return stream;
+		std::ifstream stream(entry->loosePath, std::ios::binary);
+		return stream.good() ? readStream(stream) : DataView();
 	}
 	else
 	{
-		// Case 2: all uppercase.
-		for (char &c : newName)
+		const Archives::EntryView view = gGlobalBsa.openEntryView(entry->bsaIndex);
+		if (view.mData != nullptr)
 		{
-			c = std::toupper(c);
+			return DataView(reinterpret_cast<const uint8_t*>(view.mData), view.mSize,
+				view.mOwner);
 		}
 
-		stream = this->open(newName, inGlobalBSA);
-
-		// The caller does error checking to see if this is null.
-		return stream;
+		// The entry is neither mapped nor decompressed in memory, so copy it out of its stream.
+		IStreamPtr bsaStream = gGlobalBsa.openEntry(entry->bsaIndex);
+		return (bsaStream != nullptr) ? readStream(*bsaStream) : DataView();
 	}
 }
 
-IStreamPtr Manager::openCaseInsensitive(const std::string &name)
+DataView Manager::openView(const char *name)
 {
 	bool dummy;
-	return this->openCaseInsensitive(name, dummy);
+	return this->openView(name, dummy);
 }
 
-bool Manager::exists(const char *name)
+DataView Manager::openView(const std::string &name, bool &inGlobalBSA)
+{
+	return this->openView(name.c_str(), inGlobalBSA);
+}
+
+DataView Manager::openView(const std::string &name)
+{
+	bool dummy;
+	return this->openView(name, dummy);
+}
+
+DataView Manager::openViewCaseInsensitive(const std::string &name, bool &inGlobalBSA)
+{
+	// The index is case-insensitive, so this is the same as openView().
+	return this->openView(name, inGlobalBSA);
+}
+
+DataView Manager::openViewCaseInsensitive(const std::string &name)
+{
+	bool dummy;
+	return this->openViewCaseInsensitive(name, dummy);
+}
+
+void Manager::prefetch(const std::vector<std::string> &names, const ParallelFor &parallelFor)
 {
-	std::ifstream file;
-	const auto iter = std::find_if(gRootPaths.begin(), gRootPaths.end(),
-		[name, &file](const std::string &rootPath)
+	std::vector<size_t> bsaIndices;
+	for (const std::string &name : names)
 	{
-		file.open(rootPath + name, std::ios::binary);
-		return file.is_open();
-	});
+		const IndexEntry *entry = findEntry(name.c_str());
+		if ((entry != nullptr) && entry->loosePath.empty())
+		{
+			bsaIndices.push_back(entry->bsaIndex);
+		}
+	}
 
-	// If not in the root paths, then check inside GLOBAL.BSA.
-	return (iter != gRootPaths.end()) || gGlobalBsa.exists(name);
+	gGlobalBsa.prefetch(bsaIndices, parallelFor);
+}
+
+bool Manager::exists(const char *name)
+{
+	return findEntry(name) != nullptr;
 }
 
 void Manager::addDir(const std::string &path, const std::string &pre, const char *pattern,
@@ -158,7 +273,7 @@ void Manager::addDir(const std::string &path, const std::string &pre, const char
 			(std::strcmp(ent->d_name, "..") == 0))
 			continue;
 
-		if (!S_ISDIR(ent->d_type))
+		if (ent->d_type != DT_DIR)
 		{
 			std::string fname = pre + ent->d_name;
 			if ((pattern == nullptr) || (fnmatch(pattern, fname.c_str(), 0) == 0))
@@ -2,6 +2,8 @@
 #define COMPONENTS_VFS_MANAGER_HPP
 
 #include <array>
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -12,6 +14,10 @@ namespace VFS
 
 typedef std::shared_ptr<std::istream> IStreamPtr;
 
+// Calls job(i) for every i in [0, count), possibly in parallel, and returns when all calls
+// are done (i.e., a thread pool's run()).
+typedef std::function<void(int, const std::function<void(int)>&)> ParallelFor;
+
 inline uint32_t read_le32(std::istream &stream)
 {
 	std::array<char, 4> buf;
@@ -29,6 +35,33 @@ inline uint16_t read_le16(std::istream &stream)
 	return ((uint16_t(buf[0]) & 0x00ff) | (uint16_t(buf[1] << 8) & 0xff00));
 }
 
+// Read-only bytes of a whole file. Entries in GLOBAL.BSA point straight into the memory-mapped
+// archive, so nothing is copied; loose files are read into a buffer owned by the view, and
+// compressed entries share their decoded bytes with the archive's cache.
+class DataView {
+	const uint8_t *mData;
+	size_t mSize;
+	std::unique_ptr<uint8_t[]> mBuffer;
+	std::shared_ptr<const void> mOwner;
+
+public:
+	DataView();
+	DataView(const uint8_t *data, size_t size);
+	DataView(std::unique_ptr<uint8_t[]> buffer, size_t size);
+	DataView(const uint8_t *data, size_t size, std::shared_ptr<const void> owner);
+	DataView(DataView&&) = default;
+	DataView& operator=(DataView&&) = default;
+
+	// False if the file couldn't be opened.
+	bool isValid() const { return this->mData != nullptr; }
+
+	const uint8_t *data() const { return this->mData; }
+	size_t size() const { return this->mSize; }
+	const uint8_t *begin() const { return this->mData; }
+	const uint8_t *end() const { return this->mData + this->mSize; }
+	uint8_t front() const { return *this->mData; }
+};
+
 class Manager {
 	Manager(const Manager&) = delete;
 	Manager& operator=(const Manager&) = delete;
@@ -36,6 +69,9 @@ class Manager {
 	static void addDir(const std::string &path, const std::string &pre, const char *pattern,
 		std::vector<std::string> &names);
 
+	// Adds every file under a root path to the name index.
+	static void indexRootPath(const std::string &rootPath);
+
 	Manager();
 
 public:
@@ -47,13 +83,27 @@ public:
 	IStreamPtr open(const std::string &name, bool &inGlobalBSA);
 	IStreamPtr open(const std::string &name);
 
-	// Special open method intended for Unix systems since the Arena floppy and CD versions don't
-	// have consistent casing for some files (like SPELLSG.65). This method is specific to Arena's
-	// files and is not a general solution for case-insensitive file loading.
-	// - To do: replace with something using std::filesystem::equivalent() (C++17)?
+	// Files are looked up in one index built from GLOBAL.BSA and the root paths' contents when
+	// they're added, so files created afterwards aren't found. Names are case-insensitive since
+	// the Arena floppy and CD versions don't have consistent casing for some files (like
+	// SPELLSG.65). The case-insensitive methods are kept for existing callers.
 	IStreamPtr openCaseInsensitive(const std::string &name, bool &inGlobalBSA);
 	IStreamPtr openCaseInsensitive(const std::string &name);
 
+	// Same lookup rules as open(), but returns the file's bytes instead of a stream. Loaders
+	// that parse a whole file should prefer this, since GLOBAL.BSA entries aren't copied.
+	DataView openView(const char *name, bool &inGlobalBSA);
+	DataView openView(const char *name);
+	DataView openView(const std::string &name, bool &inGlobalBSA);
+	DataView openView(const std::string &name);
+	DataView openViewCaseInsensitive(const std::string &name, bool &inGlobalBSA);
+	DataView openViewCaseInsensitive(const std::string &name);
+
+	// Decodes the given files' compressed GLOBAL.BSA entries across the parallel-for, so a
+	// batch of loads doesn't decode them one at a time. Loose files and missing names are
+	// skipped.
+	void prefetch(const std::vector<std::string> &names, const ParallelFor &parallelFor);
+
 	bool exists(const char *name);
 	std::vector<std::string> list(const char *pattern = nullptr) const;
 